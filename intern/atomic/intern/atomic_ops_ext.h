@@ -159,6 +159,15 @@ ATOMIC_INLINE unsigned int atomic_cas_u(unsigned int *v, unsigned int old, unsig
 #endif
 }
 
+ATOMIC_INLINE unsigned int atomic_load_u(const unsigned int *v)
+{
+#if (LG_SIZEOF_INT == 8)
+  return (unsigned int)atomic_load_uint64((const uint64_t *)v);
+#elif (LG_SIZEOF_INT == 4)
+  return (unsigned int)atomic_load_uint32((const uint32_t *)v);
+#endif
+}
+
 /******************************************************************************/
 /* Char operations. */
 ATOMIC_INLINE char atomic_fetch_and_or_char(char *p, char b)
@@ -183,6 +192,15 @@ ATOMIC_INLINE void *atomic_cas_ptr(void **v, void *old, void *_new)
 #endif
 }
 
+ATOMIC_INLINE void *atomic_load_ptr(void *const *v)
+{
+#if (LG_SIZEOF_PTR == 8)
+  return (void *)atomic_load_uint64((const uint64_t *)v);
+#elif (LG_SIZEOF_PTR == 4)
+  return (void *)atomic_load_uint32((const uint32_t *)v);
+#endif
+}
+
 /******************************************************************************/
 /* float operations. */
 ATOMIC_STATIC_ASSERT(sizeof(float) == sizeof(uint32_t), "sizeof(float) != sizeof(uint32_t)");
@@ -209,6 +209,34 @@ ATOMIC_INLINE int8_t atomic_fetch_and_or_int8(int8_t *p, int8_t b)
 #endif
 }
 
+/******************************************************************************/
+/* Load operations. */
+/* Aligned loads of the native word size are atomic. Loads are not reordered with other loads on
+ * x86, only the compiler has to keep them in order, other architectures need a barrier. */
+#if defined(_M_IX86) || defined(_M_X64)
+#  define ATOMIC_LOAD_ACQUIRE_BARRIER() _ReadWriteBarrier()
+#else
+#  define ATOMIC_LOAD_ACQUIRE_BARRIER() MemoryBarrier()
+#endif
+
+#if (LG_SIZEOF_PTR == 8 || LG_SIZEOF_INT == 8)
+ATOMIC_INLINE uint64_t atomic_load_uint64(const uint64_t *v)
+{
+  const uint64_t value = *(const volatile uint64_t *)v;
+  ATOMIC_LOAD_ACQUIRE_BARRIER();
+  return value;
+}
+#endif
+
+ATOMIC_INLINE uint32_t atomic_load_uint32(const uint32_t *v)
+{
+  const uint32_t value = *(const volatile uint32_t *)v;
+  ATOMIC_LOAD_ACQUIRE_BARRIER();
+  return value;
+}
+
+#undef ATOMIC_LOAD_ACQUIRE_BARRIER
+
 #if defined(__clang__)
 #  pragma GCC diagnostic pop
 #endif
@@ -344,4 +344,37 @@ ATOMIC_INLINE int8_t atomic_fetch_and_or_int8(int8_t *p, int8_t b)
 #  error "Missing implementation for 8-bit atomic operations"
 #endif
 
+/******************************************************************************/
+/* Load operations. */
+#if defined(__ATOMIC_ACQUIRE)
+#  if (LG_SIZEOF_PTR == 8 || LG_SIZEOF_INT == 8)
+ATOMIC_INLINE uint64_t atomic_load_uint64(const uint64_t *v)
+{
+  return __atomic_load_n(v, __ATOMIC_ACQUIRE);
+}
+#  endif
+
+ATOMIC_INLINE uint32_t atomic_load_uint32(const uint32_t *v)
+{
+  return __atomic_load_n(v, __ATOMIC_ACQUIRE);
+}
+#else
+/* Aligned loads of the native word size are atomic, the barrier gives the ordering. */
+#  if (LG_SIZEOF_PTR == 8 || LG_SIZEOF_INT == 8)
+ATOMIC_INLINE uint64_t atomic_load_uint64(const uint64_t *v)
+{
+  const uint64_t value = *(const volatile uint64_t *)v;
+  __sync_synchronize();
+  return value;
+}
+#  endif
+
+ATOMIC_INLINE uint32_t atomic_load_uint32(const uint32_t *v)
+{
+  const uint32_t value = *(const volatile uint32_t *)v;
+  __sync_synchronize();
+  return value;
+}
+#endif
+
 #endif /* __ATOMIC_OPS_UNIX_H__ */
@@ -230,6 +230,10 @@ extern const char *(*MEM_name_ptr)(void *vmemh);
 /* Switch allocator to slower but fully guarded mode. */
 void MEM_use_guarded_allocator(void);
 
+/* Switch allocator to per-thread caches of size-classes for small blocks,
+ * blocks allocated before the switch stay valid. */
+void MEM_use_threadcache_allocator(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -208,4 +208,38 @@ size_t MEM_guarded_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
 const char *MEM_guarded_name_ptr(void *vmemh);
 #endif
 
+/* Prototypes for thread caching allocator functions, the functions not listed here are shared
+ * with the lock-free allocator. */
+void MEM_threadcache_init(void);
+size_t MEM_threadcache_allocN_len(const void *vmemh) ATTR_WARN_UNUSED_RESULT;
+void MEM_threadcache_freeN(void *vmemh);
+void *MEM_threadcache_dupallocN(const void *vmemh) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void *MEM_threadcache_reallocN_id(void *vmemh,
+                                  size_t len,
+                                  const char *UNUSED(str)) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(2);
+void *MEM_threadcache_recallocN_id(void *vmemh,
+                                   size_t len,
+                                   const char *UNUSED(str)) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(2);
+void *MEM_threadcache_callocN(size_t len, const char *UNUSED(str)) ATTR_MALLOC
+    ATTR_WARN_UNUSED_RESULT ATTR_ALLOC_SIZE(1) ATTR_NONNULL(2);
+void *MEM_threadcache_calloc_arrayN(size_t len,
+                                    size_t size,
+                                    const char *UNUSED(str)) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1, 2) ATTR_NONNULL(3);
+void *MEM_threadcache_mallocN(size_t len, const char *UNUSED(str)) ATTR_MALLOC
+    ATTR_WARN_UNUSED_RESULT ATTR_ALLOC_SIZE(1) ATTR_NONNULL(2);
+void *MEM_threadcache_malloc_arrayN(size_t len,
+                                    size_t size,
+                                    const char *UNUSED(str)) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT
+    ATTR_ALLOC_SIZE(1, 2) ATTR_NONNULL(3);
+void MEM_threadcache_printmemlist_stats(void);
+void MEM_threadcache_set_error_callback(void (*func)(const char *));
+void MEM_threadcache_set_memory_debug(void);
+size_t MEM_threadcache_get_memory_in_use(void);
+unsigned int MEM_threadcache_get_memory_blocks_in_use(void);
+void MEM_threadcache_reset_peak_memory(void);
+size_t MEM_threadcache_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
+
 #endif /* __MALLOCN_INTERN_H__ */
@@ -0,0 +1,763 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup MEM
+ *
+ * Memory allocation with per-thread caches of size-class slabs.
+ *
+ * Small blocks are carved from slabs, every size class keeps a free list per thread which is
+ * refilled from and returned to a shared depot by batches, so most allocations only touch
+ * memory of the calling thread. Bigger, aligned and mapped blocks are allocated by the lock-free
+ * allocator, the blocks of both allocators share the same header layout so that switching to
+ * this allocator keeps the blocks already allocated valid.
+ *
+ * The memory counters of the small blocks are kept per thread and added to the global ones when
+ * a thread cache exchanges a batch with the depot, the statistics functions add the counters of
+ * all the living thread caches.
+ */
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h> /* memcpy */
+#include <sys/types.h>
+
+#ifdef WIN32
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+#include "MEM_guardedalloc.h"
+
+/* to ensure strict conversions */
+#include "../../source/blender/blenlib/BLI_strict_flags.h"
+
+#include "atomic_ops.h"
+#include "mallocn_intern.h"
+
+typedef struct MemHead {
+  /* Length of allocated memory block. */
+  size_t len;
+} MemHead;
+
+/* Blocks allocated from the thread caches, the lock-free allocator never uses this bit. */
+#define MEMHEAD_SMALL_FLAG ((size_t)1 << (sizeof(size_t) * 8 - 1))
+/* Flags of the lock-free allocator. */
+#define MEMHEAD_LOCKFREE_FLAGS ((size_t)3)
+#define MEMHEAD_ALIGN_FLAG ((size_t)2)
+
+#define MEMHEAD_FROM_PTR(ptr) (((MemHead *)ptr) - 1)
+#define PTR_FROM_MEMHEAD(memhead) (memhead + 1)
+#define MEMHEAD_IS_SMALL(memhead) ((memhead)->len & MEMHEAD_SMALL_FLAG)
+#define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & MEMHEAD_ALIGN_FLAG)
+
+/* Size classes are spaced by 16 bytes up to 256 bytes, then by 64 bytes up to 1024 bytes. */
+#define SIZE_CLASS_MAX_LEN 1024
+#define SIZE_CLASS_NUM 28
+/* Size of the memory chunks the blocks are carved from. */
+#define SLAB_SIZE (64 * 1024)
+/* Approximate size of the batches exchanged between the thread caches and the depot. */
+#define BATCH_SIZE (8 * 1024)
+#define BATCH_MIN_BLOCKS 4
+#define BATCH_MAX_BLOCKS 64
+
+/* Free block, the links are stored in the memory of the block itself. */
+typedef struct FreeBlock {
+  struct FreeBlock *next;
+  /* Next batch in the depot, only used by the first block of a batch. */
+  struct FreeBlock *next_batch;
+} FreeBlock;
+
+/* Header of the slabs, they are never released and only kept in a list to stay reachable. */
+typedef struct Slab {
+  struct Slab *next;
+  size_t pad;
+} Slab;
+
+typedef struct SizeClassDepot {
+  unsigned int lock;
+  FreeBlock *batches;
+  /* Padding to avoid false sharing between the locks of the size classes. */
+  char pad[64 - sizeof(FreeBlock *) * 2];
+} SizeClassDepot;
+
+typedef struct ThreadCacheList {
+  FreeBlock *blocks;
+  unsigned int count;
+} ThreadCacheList;
+
+typedef struct ThreadCache {
+  struct ThreadCache *next, *prev;
+  ThreadCacheList lists[SIZE_CLASS_NUM];
+  /* Counters not yet added to the global ones, they wrap around when more memory was freed
+   * than allocated by this thread. Only written by the thread, atomically since other threads
+   * read them to get the memory in use. */
+  size_t mem_in_use;
+  unsigned int totblock;
+} ThreadCache;
+
+static unsigned int totblock = 0;
+static size_t mem_in_use = 0, peak_mem = 0;
+static bool malloc_debug_memset = false;
+
+static void (*error_callback)(const char *) = NULL;
+
+static SizeClassDepot depots[SIZE_CLASS_NUM];
+/* Number of blocks of the batches, computed once to keep divisions out of the fast path. */
+static unsigned int size_class_batches[SIZE_CLASS_NUM];
+
+static unsigned int slabs_lock = 0;
+static Slab *slabs = NULL;
+
+/* Protects the list of caches, and the counters flush so they are never counted twice. */
+static unsigned int caches_lock = 0;
+static ThreadCache *caches = NULL;
+
+#ifdef _MSC_VER
+#  define MEM_THREAD_LOCAL __declspec(thread)
+#else
+#  define MEM_THREAD_LOCAL __thread
+#endif
+
+static MEM_THREAD_LOCAL ThreadCache *thread_cache = NULL;
+
+/* Key used to release the cache of a thread when it exits. */
+#ifdef WIN32
+static DWORD thread_cache_key = FLS_OUT_OF_INDEXES;
+#else
+static pthread_key_t thread_cache_key;
+static bool thread_cache_key_valid = false;
+#endif
+
+MEM_INLINE void update_maximum(size_t *maximum_value, size_t value)
+{
+  atomic_fetch_and_update_max_z(maximum_value, value);
+}
+
+MEM_INLINE void spin_lock(unsigned int *lock)
+{
+  while (atomic_cas_u(lock, 0, 1) != 0) {
+    /* pass */
+  }
+}
+
+MEM_INLINE void spin_unlock(unsigned int *lock)
+{
+  atomic_cas_u(lock, 1, 0);
+}
+
+#ifdef __GNUC__
+__attribute__((format(printf, 1, 2)))
+#endif
+static void
+print_error(const char *str, ...)
+{
+  char buf[512];
+  va_list ap;
+
+  va_start(ap, str);
+  vsnprintf(buf, sizeof(buf), str, ap);
+  va_end(ap);
+  buf[sizeof(buf) - 1] = '\0';
+
+  if (error_callback) {
+    error_callback(buf);
+  }
+}
+
+MEM_INLINE unsigned int size_class_from_len(size_t len)
+{
+  if (len <= 256) {
+    return (len == 0) ? 0 : (unsigned int)((len - 1) / 16);
+  }
+  return 16 + (unsigned int)((len - 257) / 64);
+}
+
+MEM_INLINE size_t size_class_len(unsigned int size_class)
+{
+  if (size_class < 16) {
+    return (size_t)(size_class + 1) * 16;
+  }
+  return 256 + (size_t)(size_class - 15) * 64;
+}
+
+MEM_INLINE size_t size_class_stride(unsigned int size_class)
+{
+  return size_class_len(size_class) + sizeof(MemHead);
+}
+
+MEM_INLINE unsigned int size_class_batch(unsigned int size_class)
+{
+  return size_class_batches[size_class];
+}
+
+/* Move the counters of a thread to the global ones, caches_lock must be held. */
+static void thread_cache_flush_counters_locked(ThreadCache *cache)
+{
+  const size_t cache_mem_in_use = cache->mem_in_use;
+  const unsigned int cache_totblock = cache->totblock;
+  atomic_sub_and_fetch_z(&cache->mem_in_use, cache_mem_in_use);
+  atomic_sub_and_fetch_u(&cache->totblock, cache_totblock);
+  atomic_add_and_fetch_z(&mem_in_use, cache_mem_in_use);
+  atomic_add_and_fetch_u(&totblock, cache_totblock);
+
+  update_maximum(&peak_mem, MEM_lockfree_get_memory_in_use() + mem_in_use);
+}
+
+static void thread_cache_flush_counters(ThreadCache *cache)
+{
+  spin_lock(&caches_lock);
+  thread_cache_flush_counters_locked(cache);
+  spin_unlock(&caches_lock);
+}
+
+/* Give the first batch of blocks of a list back to the depot. */
+static void thread_cache_release_batch(ThreadCacheList *list,
+                                       unsigned int size_class,
+                                       unsigned int batch)
+{
+  FreeBlock *first = list->blocks;
+  FreeBlock *last = first;
+  for (unsigned int i = 1; i < batch; i++) {
+    last = last->next;
+  }
+  list->blocks = last->next;
+  list->count -= batch;
+  last->next = NULL;
+
+  SizeClassDepot *depot = &depots[size_class];
+  spin_lock(&depot->lock);
+  first->next_batch = depot->batches;
+  depot->batches = first;
+  spin_unlock(&depot->lock);
+}
+
+/* Carve a new slab in batches, keep one for the thread and give the others to the depot. */
+static bool thread_cache_alloc_slab(ThreadCacheList *list, unsigned int size_class)
+{
+  Slab *slab = (Slab *)malloc(SLAB_SIZE);
+  if (UNLIKELY(slab == NULL)) {
+    return false;
+  }
+
+  spin_lock(&slabs_lock);
+  slab->next = slabs;
+  slabs = slab;
+  spin_unlock(&slabs_lock);
+
+  const size_t stride = size_class_stride(size_class);
+  const unsigned int batch = size_class_batch(size_class);
+  const unsigned int num_blocks = (unsigned int)((SLAB_SIZE - sizeof(Slab)) / stride);
+  char *memory = (char *)(slab + 1);
+
+  FreeBlock *batches = NULL;
+  for (unsigned int first = 0; first < num_blocks; first += batch) {
+    const unsigned int last = (first + batch < num_blocks) ? first + batch : num_blocks;
+    FreeBlock *block = NULL;
+    for (unsigned int i = last; i-- > first;) {
+      FreeBlock *prev = (FreeBlock *)(memory + stride * i);
+      prev->next = block;
+      block = prev;
+    }
+    block->next_batch = batches;
+    batches = block;
+  }
+
+  /* The first batch may be shorter than the others, keep it for this thread. */
+  list->blocks = batches;
+  list->count = num_blocks - ((num_blocks - 1) / batch) * batch;
+  batches = batches->next_batch;
+
+  if (batches) {
+    FreeBlock *last = batches;
+    while (last->next_batch) {
+      last = last->next_batch;
+    }
+
+    SizeClassDepot *depot = &depots[size_class];
+    spin_lock(&depot->lock);
+    last->next_batch = depot->batches;
+    depot->batches = batches;
+    spin_unlock(&depot->lock);
+  }
+
+  return true;
+}
+
+static bool thread_cache_refill(ThreadCache *cache, unsigned int size_class)
+{
+  ThreadCacheList *list = &cache->lists[size_class];
+  SizeClassDepot *depot = &depots[size_class];
+
+  thread_cache_flush_counters(cache);
+
+  spin_lock(&depot->lock);
+  FreeBlock *batch = depot->batches;
+  if (batch) {
+    depot->batches = batch->next_batch;
+  }
+  spin_unlock(&depot->lock);
+
+  if (batch) {
+    unsigned int count = 0;
+    for (FreeBlock *block = batch; block; block = block->next) {
+      count++;
+    }
+    list->blocks = batch;
+    list->count = count;
+    return true;
+  }
+
+  return thread_cache_alloc_slab(list, size_class);
+}
+
+/* Give all the blocks of a thread back to the depot, remaining blocks which do not fill a batch
+ * are given as a shorter batch. */
+static void thread_cache_release(ThreadCache *cache)
+{
+  for (unsigned int size_class = 0; size_class < SIZE_CLASS_NUM; size_class++) {
+    ThreadCacheList *list = &cache->lists[size_class];
+    const unsigned int batch = size_class_batch(size_class);
+    while (list->count > 0) {
+      thread_cache_release_batch(list, size_class, (list->count < batch) ? list->count : batch);
+    }
+  }
+
+  spin_lock(&caches_lock);
+  if (cache->prev) {
+    cache->prev->next = cache->next;
+  }
+  else {
+    caches = cache->next;
+  }
+  if (cache->next) {
+    cache->next->prev = cache->prev;
+  }
+  thread_cache_flush_counters_locked(cache);
+  spin_unlock(&caches_lock);
+
+  free(cache);
+}
+
+#ifdef WIN32
+static void WINAPI thread_cache_exit(void *data)
+#else
+static void thread_cache_exit(void *data)
+#endif
+{
+  if (data) {
+    thread_cache = NULL;
+    thread_cache_release((ThreadCache *)data);
+  }
+}
+
+static ThreadCache *thread_cache_create(void)
+{
+  ThreadCache *cache = (ThreadCache *)calloc(1, sizeof(ThreadCache));
+  if (UNLIKELY(cache == NULL)) {
+    return NULL;
+  }
+
+  spin_lock(&caches_lock);
+  cache->next = caches;
+  if (caches) {
+    caches->prev = cache;
+  }
+  caches = cache;
+  spin_unlock(&caches_lock);
+
+#ifdef WIN32
+  if (thread_cache_key != FLS_OUT_OF_INDEXES) {
+    FlsSetValue(thread_cache_key, cache);
+  }
+#else
+  if (thread_cache_key_valid) {
+    pthread_setspecific(thread_cache_key, cache);
+  }
+#endif
+
+  thread_cache = cache;
+  return cache;
+}
+
+/* Allocate a small block, return NULL when the memory is exhausted. */
+MEM_INLINE MemHead *small_alloc(size_t len)
+{
+  ThreadCache *cache = thread_cache;
+  if (UNLIKELY(cache == NULL)) {
+    cache = thread_cache_create();
+    if (cache == NULL) {
+      return NULL;
+    }
+  }
+
+  const unsigned int size_class = size_class_from_len(len);
+  ThreadCacheList *list = &cache->lists[size_class];
+  if (UNLIKELY(list->blocks == NULL)) {
+    if (!thread_cache_refill(cache, size_class)) {
+      return NULL;
+    }
+  }
+
+  FreeBlock *block = list->blocks;
+  list->blocks = block->next;
+  list->count--;
+
+  atomic_add_and_fetch_z(&cache->mem_in_use, len);
+  atomic_add_and_fetch_u(&cache->totblock, 1);
+
+  MemHead *memh = (MemHead *)block;
+  memh->len = len | MEMHEAD_SMALL_FLAG;
+  return memh;
+}
+
+MEM_INLINE void small_free(MemHead *memh, size_t len)
+{
+  ThreadCache *cache = thread_cache;
+  if (UNLIKELY(cache == NULL)) {
+    cache = thread_cache_create();
+    if (cache == NULL) {
+      /* Keep the block out of the caches rather than losing the counters. */
+      atomic_sub_and_fetch_u(&totblock, 1);
+      atomic_sub_and_fetch_z(&mem_in_use, len);
+      return;
+    }
+  }
+
+  const unsigned int size_class = size_class_from_len(len);
+  ThreadCacheList *list = &cache->lists[size_class];
+  FreeBlock *block = (FreeBlock *)memh;
+  block->next = list->blocks;
+  list->blocks = block;
+  list->count++;
+
+  atomic_sub_and_fetch_z(&cache->mem_in_use, len);
+  atomic_sub_and_fetch_u(&cache->totblock, 1);
+
+  const unsigned int batch = size_class_batch(size_class);
+  if (UNLIKELY(list->count > batch * 2)) {
+    thread_cache_flush_counters(cache);
+    thread_cache_release_batch(list, size_class, batch);
+  }
+}
+
+void MEM_threadcache_init(void)
+{
+  for (unsigned int size_class = 0; size_class < SIZE_CLASS_NUM; size_class++) {
+    const size_t blocks = BATCH_SIZE / size_class_stride(size_class);
+    size_class_batches[size_class] = (blocks < BATCH_MIN_BLOCKS) ?
+                                         BATCH_MIN_BLOCKS :
+                                         (blocks > BATCH_MAX_BLOCKS) ? BATCH_MAX_BLOCKS :
+                                                                       (unsigned int)blocks;
+  }
+
+#ifdef WIN32
+  if (thread_cache_key == FLS_OUT_OF_INDEXES) {
+    thread_cache_key = FlsAlloc(thread_cache_exit);
+  }
+#else
+  if (!thread_cache_key_valid) {
+    thread_cache_key_valid = (pthread_key_create(&thread_cache_key, thread_cache_exit) == 0);
+  }
+#endif
+}
+
+size_t MEM_threadcache_allocN_len(const void *vmemh)
+{
+  if (vmemh) {
+    return MEMHEAD_FROM_PTR(vmemh)->len & ~(MEMHEAD_SMALL_FLAG | MEMHEAD_LOCKFREE_FLAGS);
+  }
+  else {
+    return 0;
+  }
+}
+
+void MEM_threadcache_freeN(void *vmemh)
+{
+  if (vmemh == NULL) {
+    print_error("Attempt to free NULL pointer\n");
+#ifdef WITH_ASSERT_ABORT
+    abort();
+#endif
+    return;
+  }
+
+  MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+  if (UNLIKELY(!MEMHEAD_IS_SMALL(memh))) {
+    MEM_lockfree_freeN(vmemh);
+    return;
+  }
+
+  const size_t len = MEM_threadcache_allocN_len(vmemh);
+  if (UNLIKELY(malloc_debug_memset && len)) {
+    memset(vmemh, 255, len);
+  }
+  small_free(memh, len);
+}
+
+void *MEM_threadcache_dupallocN(const void *vmemh)
+{
+  void *newp = NULL;
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    if (UNLIKELY(!MEMHEAD_IS_SMALL(memh))) {
+      return MEM_lockfree_dupallocN(vmemh);
+    }
+
+    const size_t prev_size = MEM_threadcache_allocN_len(vmemh);
+    newp = MEM_threadcache_mallocN(prev_size, "dupli_malloc");
+    if (newp) {
+      memcpy(newp, vmemh, prev_size);
+    }
+  }
+  return newp;
+}
+
+void *MEM_threadcache_reallocN_id(void *vmemh, size_t len, const char *str)
+{
+  void *newp = NULL;
+
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    if (UNLIKELY(MEMHEAD_IS_ALIGNED(memh) && !MEMHEAD_IS_SMALL(memh))) {
+      return MEM_lockfree_reallocN_id(vmemh, len, str);
+    }
+
+    size_t old_len = MEM_threadcache_allocN_len(vmemh);
+
+    newp = MEM_threadcache_mallocN(len, "realloc");
+
+    if (newp) {
+      if (len < old_len) {
+        /* shrink */
+        memcpy(newp, vmemh, len);
+      }
+      else {
+        /* grow (or remain same size) */
+        memcpy(newp, vmemh, old_len);
+      }
+    }
+
+    MEM_threadcache_freeN(vmemh);
+  }
+  else {
+    newp = MEM_threadcache_mallocN(len, str);
+  }
+
+  return newp;
+}
+
+void *MEM_threadcache_recallocN_id(void *vmemh, size_t len, const char *str)
+{
+  void *newp = NULL;
+
+  if (vmemh) {
+    MemHead *memh = MEMHEAD_FROM_PTR(vmemh);
+    if (UNLIKELY(MEMHEAD_IS_ALIGNED(memh) && !MEMHEAD_IS_SMALL(memh))) {
+      return MEM_lockfree_recallocN_id(vmemh, len, str);
+    }
+
+    size_t old_len = MEM_threadcache_allocN_len(vmemh);
+
+    newp = MEM_threadcache_mallocN(len, "recalloc");
+
+    if (newp) {
+      if (len < old_len) {
+        /* shrink */
+        memcpy(newp, vmemh, len);
+      }
+      else {
+        memcpy(newp, vmemh, old_len);
+
+        if (len > old_len) {
+          /* grow */
+          /* zero new bytes */
+          memset(((char *)newp) + old_len, 0, len - old_len);
+        }
+      }
+    }
+
+    MEM_threadcache_freeN(vmemh);
+  }
+  else {
+    newp = MEM_threadcache_callocN(len, str);
+  }
+
+  return newp;
+}
+
+void *MEM_threadcache_callocN(size_t len, const char *str)
+{
+  len = SIZET_ALIGN_4(len);
+
+  if (UNLIKELY(len > SIZE_CLASS_MAX_LEN)) {
+    void *ptr = MEM_lockfree_callocN(len, str);
+    update_maximum(&peak_mem, MEM_lockfree_get_memory_in_use() + mem_in_use);
+    return ptr;
+  }
+
+  MemHead *memh = small_alloc(len);
+
+  if (LIKELY(memh)) {
+    memset(PTR_FROM_MEMHEAD(memh), 0, len);
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Calloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)mem_in_use);
+  return NULL;
+}
+
+void *MEM_threadcache_calloc_arrayN(size_t len, size_t size, const char *str)
+{
+  size_t total_size;
+  if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+    print_error(
+        "Calloc array aborted due to integer overflow: "
+        "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+        SIZET_ARG(len),
+        SIZET_ARG(size),
+        str,
+        (unsigned int)mem_in_use);
+    abort();
+    return NULL;
+  }
+
+  return MEM_threadcache_callocN(total_size, str);
+}
+
+void *MEM_threadcache_mallocN(size_t len, const char *str)
+{
+  len = SIZET_ALIGN_4(len);
+
+  if (UNLIKELY(len > SIZE_CLASS_MAX_LEN)) {
+    void *ptr = MEM_lockfree_mallocN(len, str);
+    update_maximum(&peak_mem, MEM_lockfree_get_memory_in_use() + mem_in_use);
+    return ptr;
+  }
+
+  MemHead *memh = small_alloc(len);
+
+  if (LIKELY(memh)) {
+    if (UNLIKELY(malloc_debug_memset && len)) {
+      memset(memh + 1, 255, len);
+    }
+
+    return PTR_FROM_MEMHEAD(memh);
+  }
+  print_error("Malloc returns null: len=" SIZET_FORMAT " in %s, total %u\n",
+              SIZET_ARG(len),
+              str,
+              (unsigned int)mem_in_use);
+  return NULL;
+}
+
+void *MEM_threadcache_malloc_arrayN(size_t len, size_t size, const char *str)
+{
+  size_t total_size;
+  if (UNLIKELY(!MEM_size_safe_multiply(len, size, &total_size))) {
+    print_error(
+        "Malloc array aborted due to integer overflow: "
+        "len=" SIZET_FORMAT "x" SIZET_FORMAT " in %s, total %u\n",
+        SIZET_ARG(len),
+        SIZET_ARG(size),
+        str,
+        (unsigned int)mem_in_use);
+    abort();
+    return NULL;
+  }
+
+  return MEM_threadcache_mallocN(total_size, str);
+}
+
+void MEM_threadcache_printmemlist_stats(void)
+{
+  printf("\ntotal memory len: %.3f MB\n",
+         (double)MEM_threadcache_get_memory_in_use() / (double)(1024 * 1024));
+  printf("peak memory len: %.3f MB\n",
+         (double)MEM_threadcache_get_peak_memory() / (double)(1024 * 1024));
+
+  size_t slabs_size = 0;
+  spin_lock(&slabs_lock);
+  for (Slab *slab = slabs; slab; slab = slab->next) {
+    slabs_size += SLAB_SIZE;
+  }
+  spin_unlock(&slabs_lock);
+  printf("thread cache slabs len: %.3f MB\n", (double)slabs_size / (double)(1024 * 1024));
+
+  printf(
+      "\nFor more detailed per-block statistics run Blender with memory debugging command line "
+      "argument.\n");
+
+#ifdef HAVE_MALLOC_STATS
+  printf("System Statistics:\n");
+  malloc_stats();
+#endif
+}
+
+void MEM_threadcache_set_error_callback(void (*func)(const char *))
+{
+  error_callback = func;
+  MEM_lockfree_set_error_callback(func);
+}
+
+void MEM_threadcache_set_memory_debug(void)
+{
+  malloc_debug_memset = true;
+  MEM_lockfree_set_memory_debug();
+}
+
+size_t MEM_threadcache_get_memory_in_use(void)
+{
+  spin_lock(&caches_lock);
+  size_t len = atomic_add_and_fetch_z(&mem_in_use, 0);
+  for (ThreadCache *cache = caches; cache; cache = cache->next) {
+    len += atomic_add_and_fetch_z(&cache->mem_in_use, 0);
+  }
+  spin_unlock(&caches_lock);
+
+  return MEM_lockfree_get_memory_in_use() + len;
+}
+
+unsigned int MEM_threadcache_get_memory_blocks_in_use(void)
+{
+  spin_lock(&caches_lock);
+  unsigned int count = atomic_add_and_fetch_u(&totblock, 0);
+  for (ThreadCache *cache = caches; cache; cache = cache->next) {
+    count += atomic_add_and_fetch_u(&cache->totblock, 0);
+  }
+  spin_unlock(&caches_lock);
+
+  return MEM_lockfree_get_memory_blocks_in_use() + count;
+}
+
+void MEM_threadcache_reset_peak_memory(void)
+{
+  MEM_lockfree_reset_peak_memory();
+  peak_mem = MEM_threadcache_get_memory_in_use();
+}
+
+size_t MEM_threadcache_get_peak_memory(void)
+{
+  /* The peak is only updated when the thread caches exchange batches, include the current
+   * usage of the caches. */
+  update_maximum(&peak_mem, MEM_threadcache_get_memory_in_use());
+
+  const size_t lockfree_peak = MEM_lockfree_get_peak_memory();
+  return (peak_mem > lockfree_peak) ? peak_mem : lockfree_peak;
+}
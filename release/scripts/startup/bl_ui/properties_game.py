@@ -427,6 +427,7 @@ class SCENE_PT_game_navmesh(SceneButtonsPanel, Panel):
         row = col.row()
         row.prop(rd, "cell_size")
         row.prop(rd, "cell_height")
+        col.prop(rd, "tile_size")
 
         col = layout.column()
         col.label(text="Agent:")
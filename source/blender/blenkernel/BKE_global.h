@@ -193,6 +193,9 @@ enum {
   /** On write, restore paths after editing them (G_FILE_RELATIVE_REMAP) */
   G_FILE_SAVE_COPY = (1 << 27),
   /* #define G_FILE_GLSL_NO_ENV_LIGHTING (1 << 28) */ /* deprecated */
+  /** On write, compress the file in independent frames decompressed in parallel on read,
+   * has precedence over #G_FILE_COMPRESS. */
+  G_FILE_COMPRESS_CHUNKED = (1 << 29),
 };
 
 /** Don't overwrite these flags when reading a file. */
@@ -31,7 +31,7 @@
 
 #include "MEM_guardedalloc.h"
 
-#include "BLI_ghash.h"
+#include "BLI_ghash_lockfree.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_path_util.h"
@@ -58,7 +58,8 @@
 #include "BKE_packedFile.h"
 
 static CLG_LogRef LOG = {"bke.data_transfer"};
-static ThreadRWMutex vfont_rwlock = BLI_RWLOCK_INITIALIZER;
+/* Serializes the font loading, the characters are looked up without locking. */
+static ThreadMutex vfont_mutex = BLI_MUTEX_INITIALIZER;
 
 /**************************** Prototypes **************************/
 
@@ -138,27 +139,27 @@ IDTypeInfo IDType_ID_VF = {
 
 /***************************** VFont *******************************/
 
+static void vfont_char_free(void *val)
+{
+  VChar *che = val;
+
+  while (che->nurbsbase.first) {
+    Nurb *nu = che->nurbsbase.first;
+    if (nu->bezt) {
+      MEM_freeN(nu->bezt);
+    }
+    BLI_freelinkN(&che->nurbsbase, nu);
+  }
+
+  MEM_freeN(che);
+}
+
 /* The vfont code */
 void BKE_vfont_free_data(struct VFont *vfont)
 {
   if (vfont->data) {
     if (vfont->data->characters) {
-      GHashIterator gh_iter;
-      GHASH_ITER (gh_iter, vfont->data->characters) {
-        VChar *che = BLI_ghashIterator_getValue(&gh_iter);
-
-        while (che->nurbsbase.first) {
-          Nurb *nu = che->nurbsbase.first;
-          if (nu->bezt) {
-            MEM_freeN(nu->bezt);
-          }
-          BLI_freelinkN(&che->nurbsbase, nu);
-        }
-
-        MEM_freeN(che);
-      }
-
-      BLI_ghash_free(vfont->data->characters, NULL, NULL);
+      BLI_ghash_lockfree_free(vfont->data->characters, NULL, vfont_char_free);
     }
 
     MEM_freeN(vfont->data);
@@ -211,7 +212,7 @@ static VFontData *vfont_get_data(VFont *vfont)
   if (!vfont->data) {
     PackedFile *pf;
 
-    BLI_rw_mutex_lock(&vfont_rwlock, THREAD_LOCK_WRITE);
+    BLI_mutex_lock(&vfont_mutex);
 
     if (vfont->data) {
       /* Check data again, since it might have been already
@@ -219,7 +220,7 @@ static VFontData *vfont_get_data(VFont *vfont)
        * not accurate or threading, just prevents unneeded
        * lock if all the data is here for sure).
        */
-      BLI_rw_mutex_unlock(&vfont_rwlock);
+      BLI_mutex_unlock(&vfont_mutex);
       return vfont->data;
     }
 
@@ -262,7 +263,7 @@ static VFontData *vfont_get_data(VFont *vfont)
       }
     }
 
-    BLI_rw_mutex_unlock(&vfont_rwlock);
+    BLI_mutex_unlock(&vfont_mutex);
   }
 
   return vfont->data;
@@ -384,7 +385,7 @@ VFont *BKE_vfont_builtin_get(void)
 
 static VChar *find_vfont_char(VFontData *vfd, unsigned int character)
 {
-  return BLI_ghash_lookup(vfd->characters, POINTER_FROM_UINT(character));
+  return BLI_ghash_lockfree_lookup(vfd->characters, POINTER_FROM_UINT(character));
 }
 
 static void build_underline(Curve *cu,
@@ -881,9 +882,7 @@ static bool vfont_to_curve(Object *ob,
     }
 
     if (!ELEM(ascii, '\n', '\0')) {
-      BLI_rw_mutex_lock(&vfont_rwlock, THREAD_LOCK_READ);
       che = find_vfont_char(vfd, ascii);
-      BLI_rw_mutex_unlock(&vfont_rwlock);
 
       /*
        * The character wasn't in the current curve base so load it
@@ -891,9 +890,9 @@ static bool vfont_to_curve(Object *ob,
        * whole font is in the memory already
        */
       if (che == NULL && BKE_vfont_is_builtin(vfont) == false) {
-        BLI_rw_mutex_lock(&vfont_rwlock, THREAD_LOCK_WRITE);
+        BLI_mutex_lock(&vfont_mutex);
         /* Check it once again, char might have been already load
-         * between previous BLI_rw_mutex_unlock() and this BLI_rw_mutex_lock().
+         * between the previous lookup and this BLI_mutex_lock().
          *
          * Such a check should not be a bottleneck since it wouldn't
          * happen often once all the chars are load.
@@ -901,7 +900,7 @@ static bool vfont_to_curve(Object *ob,
         if ((che = find_vfont_char(vfd, ascii)) == NULL) {
           che = BLI_vfontchar_from_freetypefont(vfont, ascii);
         }
-        BLI_rw_mutex_unlock(&vfont_rwlock);
+        BLI_mutex_unlock(&vfont_mutex);
       }
     }
     else {
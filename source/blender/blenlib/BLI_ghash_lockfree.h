@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __BLI_GHASH_LOCKFREE_H__
+#define __BLI_GHASH_LOCKFREE_H__
+
+/** \file
+ * \ingroup bli
+ *
+ * LockfreeGHash is an insert-only hash-map which can be filled and read from many threads
+ * at once without locking, using the same hashing and comparison functions as #GHash.
+ *
+ * Entries are stored in open-addressing tables. When a table is half full its entries are copied
+ * to a table twice as big while other threads keep adding and reading, so the map grows without
+ * blocking. Entries can't be removed, and the replaced tables are only freed with the map:
+ * reserving the expected number of entries avoids the copies.
+ *
+ * This is also used to implement a 'set' (see #LockfreeGSet below).
+ */
+
+#include "BLI_compiler_attrs.h"
+#include "BLI_ghash.h"
+#include "BLI_sys_types.h" /* for bool */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct LockfreeGHash LockfreeGHash;
+
+typedef void (*LockfreeGHashForeachFP)(void *userdata, void *key, void *val);
+
+/* ************************************************************************** */
+/* NOTE: These functions are NOT safe for use from threads. */
+
+LockfreeGHash *BLI_ghash_lockfree_new_ex(GHashHashFP hashfp,
+                                         GHashCmpFP cmpfp,
+                                         const char *info,
+                                         const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+LockfreeGHash *BLI_ghash_lockfree_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+LockfreeGHash *BLI_ghash_lockfree_copy(const LockfreeGHash *gh,
+                                       GHashKeyCopyFP keycopyfp,
+                                       GHashValCopyFP valcopyfp) ATTR_MALLOC
+    ATTR_WARN_UNUSED_RESULT;
+void BLI_ghash_lockfree_free(LockfreeGHash *gh,
+                             GHashKeyFreeFP keyfreefp,
+                             GHashValFreeFP valfreefp);
+
+/* ************************************************************************** */
+/* NOTE: These functions are safe for use from threads. */
+
+bool BLI_ghash_lockfree_add(LockfreeGHash *gh, void *key, void *val);
+void *BLI_ghash_lockfree_lookup(const LockfreeGHash *gh,
+                                const void *key) ATTR_WARN_UNUSED_RESULT;
+bool BLI_ghash_lockfree_haskey(const LockfreeGHash *gh, const void *key) ATTR_WARN_UNUSED_RESULT;
+
+/* ************************************************************************** */
+/* NOTE: These functions must not run while other threads add entries,
+ * the parallel iteration uses the task scheduler threads. */
+
+unsigned int BLI_ghash_lockfree_len(const LockfreeGHash *gh) ATTR_WARN_UNUSED_RESULT;
+void BLI_ghash_lockfree_foreach(const LockfreeGHash *gh,
+                                LockfreeGHashForeachFP func,
+                                void *userdata);
+void BLI_ghash_lockfree_foreach_parallel(const LockfreeGHash *gh,
+                                         LockfreeGHashForeachFP func,
+                                         void *userdata);
+
+/**
+ * Wrapper LockfreeGHash Creation Functions
+ */
+
+LockfreeGHash *BLI_ghash_lockfree_ptr_new_ex(const char *info,
+                                             const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+LockfreeGHash *BLI_ghash_lockfree_str_new_ex(const char *info,
+                                             const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+LockfreeGHash *BLI_ghash_lockfree_int_new_ex(const char *info,
+                                             const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/* -------------------------------------------------------------------- */
+/** \name LockfreeGSet Types
+ * A 'set' implementation (unordered collection of unique elements).
+ *
+ * Internally this is a 'LockfreeGHash' without any keys,
+ * which is why this API's are in the same header & source file.
+ * \{ */
+
+typedef struct LockfreeGSet LockfreeGSet;
+
+typedef void (*LockfreeGSetForeachFP)(void *userdata, void *key);
+
+LockfreeGSet *BLI_gset_lockfree_new_ex(GSetHashFP hashfp,
+                                       GSetCmpFP cmpfp,
+                                       const char *info,
+                                       const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void BLI_gset_lockfree_free(LockfreeGSet *gs, GSetKeyFreeFP keyfreefp);
+
+bool BLI_gset_lockfree_add(LockfreeGSet *gs, void *key);
+bool BLI_gset_lockfree_haskey(const LockfreeGSet *gs, const void *key) ATTR_WARN_UNUSED_RESULT;
+unsigned int BLI_gset_lockfree_len(const LockfreeGSet *gs) ATTR_WARN_UNUSED_RESULT;
+void BLI_gset_lockfree_foreach_parallel(const LockfreeGSet *gs,
+                                        LockfreeGSetForeachFP func,
+                                        void *userdata);
+
+LockfreeGSet *BLI_gset_lockfree_ptr_new_ex(const char *info,
+                                           const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+LockfreeGSet *BLI_gset_lockfree_str_new_ex(const char *info,
+                                           const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+LockfreeGSet *BLI_gset_lockfree_int_new_ex(const char *info,
+                                           const unsigned int nentries_reserve)
+    ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/** \} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_GHASH_LOCKFREE_H__ */
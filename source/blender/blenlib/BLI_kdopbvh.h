@@ -102,6 +102,11 @@ enum {
   /* calculate IsectRayPrecalc data */
   BVH_RAYCAST_WATERTIGHT = (1 << 0),
 };
+enum {
+  /* Split nodes using the surface area heuristic instead of the median of the largest axis,
+   * slower to build but faster to ray-cast. */
+  BVH_BALANCE_SAH = (1 << 0),
+};
 #define BVH_RAYCAST_DEFAULT (BVH_RAYCAST_WATERTIGHT)
 #define BVH_RAYCAST_DIST_MAX (FLT_MAX / 2.0f)
 
@@ -148,6 +153,7 @@ void BLI_bvhtree_free(BVHTree *tree);
 
 /* construct: first insert points, then call balance */
 void BLI_bvhtree_insert(BVHTree *tree, int index, const float co[3], int numpoints);
+void BLI_bvhtree_balance_ex(BVHTree *tree, const int flag);
 void BLI_bvhtree_balance(BVHTree *tree);
 
 /* update: first update points/nodes, then call update_tree to refit the bounding volumes */
@@ -231,6 +237,16 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
                               BVHTree_RayCastCallback callback,
                               void *userdata);
 
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                const int rays_len,
+                                float radius,
+                                BVHTreeRayHit *hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag);
+
 float BLI_bvhtree_bb_raycast(const float bv[6],
                              const float light_start[3],
                              const float light_end[3],
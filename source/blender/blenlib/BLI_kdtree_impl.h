@@ -40,6 +40,13 @@ void BLI_kdtree_nd_(free)(KDTree *tree);
 void BLI_kdtree_nd_(balance)(KDTree *tree) ATTR_NONNULL(1);
 
 void BLI_kdtree_nd_(insert)(KDTree *tree, int index, const float co[KD_DIMS]) ATTR_NONNULL(1, 3);
+
+/* Update a balanced tree without balancing it again. */
+void BLI_kdtree_nd_(insert_dynamic)(KDTree *tree, int index, const float co[KD_DIMS])
+    ATTR_NONNULL(1, 3);
+bool BLI_kdtree_nd_(remove_dynamic)(KDTree *tree, int index, const float co[KD_DIMS])
+    ATTR_NONNULL(1, 3);
+
 int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
                                  const float co[KD_DIMS],
                                  KDTreeNearest *r_nearest) ATTR_NONNULL(1, 2);
@@ -67,6 +74,24 @@ void BLI_kdtree_nd_(range_search_cb)(
     bool (*search_cb)(void *user_data, int index, const float co[KD_DIMS], float dist_sq),
     void *user_data);
 
+/* Search many points at once, from multiple threads. */
+void BLI_kdtree_nd_(find_nearest_batch)(const KDTree *tree,
+                                        const float (*co)[KD_DIMS],
+                                        uint co_len,
+                                        KDTreeNearest *r_nearest) ATTR_NONNULL(1, 2, 4);
+void BLI_kdtree_nd_(find_nearest_n_batch)(const KDTree *tree,
+                                          const float (*co)[KD_DIMS],
+                                          uint co_len,
+                                          KDTreeNearest *r_nearest,
+                                          const uint nearest_len_capacity,
+                                          int *r_nearest_len) ATTR_NONNULL(1, 2, 4, 6);
+void BLI_kdtree_nd_(range_search_batch)(const KDTree *tree,
+                                        const float (*co)[KD_DIMS],
+                                        uint co_len,
+                                        const float range,
+                                        KDTreeNearest **r_nearest,
+                                        int *r_nearest_len) ATTR_NONNULL(1, 2, 5, 6);
+
 int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
                                          const float range,
                                          bool use_index_order,
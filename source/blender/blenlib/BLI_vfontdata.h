@@ -36,7 +36,7 @@ struct PackedFile;
 struct VFont;
 
 typedef struct VFontData {
-  struct GHash *characters;
+  struct LockfreeGHash *characters;
   char name[128];
   float scale;
   /* Calculated from the font. */
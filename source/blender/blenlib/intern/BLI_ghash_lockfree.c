@@ -0,0 +1,622 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bli
+ *
+ * Lock-free insert-only hash table, see BLI_ghash_lockfree.h.
+ *
+ * Every key has a probing window of #LOCKFREE_GHASH_PROBE_LEN consecutive slots in each table.
+ * Slots are claimed with a compare and swap and never go back to empty, so two threads adding
+ * the same key visit the same slots in the same order and the second one always finds the key
+ * of the first one. A key only goes to the next table when there is no empty slot left in its
+ * window, a lookup can thus stop at the first empty slot of a window.
+ *
+ * When a table is half full, the thread which added the entry over the limit closes all the
+ * empty slots of the table and copies its entries to the next table, which is twice as big.
+ * Lookups then start from the next table. Other threads keep adding and reading meanwhile,
+ * entries added during the copy go to the next table since they find no empty slot in their
+ * window. The old tables are only freed with the hash, readers may still be visiting them.
+ */
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_ghash_lockfree.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "BLI_strict_flags.h"
+
+#include "atomic_ops.h"
+
+/* Number of slots probed in a table before going to the next one. */
+#define LOCKFREE_GHASH_PROBE_LEN 32u
+/* Minimal size of the first table, in bits. */
+#define LOCKFREE_GHASH_MIN_BITS 6
+/* Number of slots handled by a task of the parallel iteration. */
+#define LOCKFREE_GHASH_ITER_CHUNK 1024u
+
+enum {
+  SLOT_EMPTY = 0,
+  /* The slot is claimed, its key is being written. */
+  SLOT_BUSY = 1,
+  SLOT_FULL = 2,
+  /* The table is copied to the next one, the slot can't be claimed anymore. */
+  SLOT_CLOSED = 3,
+};
+
+typedef struct LockfreeGHashSlot {
+  unsigned int state;
+  unsigned int hash;
+  void *key;
+  void *val;
+} LockfreeGHashSlot;
+
+typedef struct LockfreeGHashTable {
+  struct LockfreeGHashTable *next;
+  LockfreeGHashSlot *slots;
+  unsigned int size_bits;
+  /* Number of claimed slots. */
+  unsigned int nentries;
+  /* All the entries have been copied to the next table. */
+  unsigned int migrated;
+} LockfreeGHashTable;
+
+struct LockfreeGHash {
+  GHashHashFP hashfp;
+  GHashCmpFP cmpfp;
+  /* First table which has not been copied to the next one, lookups start from it. */
+  LockfreeGHashTable *head;
+  LockfreeGHashTable table;
+};
+
+/* -------------------------------------------------------------------- */
+/** \name Internal Utility API
+ *
+ * Shared members are read with acquire loads, they are paired with the compare and swap (a full
+ * barrier) which wrote them: a slot seen as full has its key and value written, a table seen as
+ * next or head is initialized.
+ * \{ */
+
+BLI_INLINE unsigned int slot_state(const LockfreeGHashSlot *slot)
+{
+  return atomic_load_u(&slot->state);
+}
+
+BLI_INLINE unsigned int table_slot_start(const LockfreeGHashTable *table, const unsigned int hash)
+{
+  /* Fibonacci hashing, the hashing functions of #GHash don't always mix the low bits. */
+  return (hash * 2654435769u) >> (32 - table->size_bits);
+}
+
+BLI_INLINE unsigned int table_size(const LockfreeGHashTable *table)
+{
+  return 1u << table->size_bits;
+}
+
+BLI_INLINE LockfreeGHashTable *table_next(const LockfreeGHashTable *table)
+{
+  return atomic_load_ptr((void *const *)&table->next);
+}
+
+BLI_INLINE bool table_is_migrated(const LockfreeGHashTable *table)
+{
+  return atomic_load_u(&table->migrated) != 0;
+}
+
+BLI_INLINE LockfreeGHashTable *ghash_head(const LockfreeGHash *gh)
+{
+  return atomic_load_ptr((void *const *)&gh->head);
+}
+
+static void table_init(LockfreeGHashTable *table, const unsigned int size_bits)
+{
+  table->next = NULL;
+  table->size_bits = size_bits;
+  table->nentries = 0;
+  table->migrated = 0;
+  table->slots = MEM_calloc_arrayN(
+      (size_t)1 << size_bits, sizeof(*table->slots), "LockfreeGHashTable slots");
+}
+
+static LockfreeGHashTable *table_next_ensure(LockfreeGHashTable *table)
+{
+  LockfreeGHashTable *next = table_next(table);
+  if (next != NULL) {
+    return next;
+  }
+
+  LockfreeGHashTable *table_new = MEM_mallocN(sizeof(*table_new), __func__);
+  table_init(table_new, table->size_bits + 1);
+
+  next = atomic_cas_ptr((void **)&table->next, NULL, table_new);
+  if (next != NULL) {
+    /* Another thread added the next table first. */
+    MEM_freeN(table_new->slots);
+    MEM_freeN(table_new);
+    return next;
+  }
+  return table_new;
+}
+
+/* Wait for a claimed slot to be written. */
+BLI_INLINE unsigned int slot_state_wait(const LockfreeGHashSlot *slot)
+{
+  unsigned int state;
+  while ((state = slot_state(slot)) == SLOT_BUSY) {
+    /* pass */
+  }
+  return state;
+}
+
+static LockfreeGHashSlot *ghash_lookup_slot(const LockfreeGHash *gh, const void *key)
+{
+  const unsigned int hash = gh->hashfp(key);
+
+  for (const LockfreeGHashTable *table = ghash_head(gh); table; table = table_next(table)) {
+    const unsigned int mask = table_size(table) - 1;
+    const unsigned int start = table_slot_start(table, hash);
+    const unsigned int probe_len = MIN2(LOCKFREE_GHASH_PROBE_LEN, mask + 1);
+
+    for (unsigned int i = 0; i < probe_len; i++) {
+      LockfreeGHashSlot *slot = &table->slots[(start + i) & mask];
+      const unsigned int state = slot_state_wait(slot);
+      if (state == SLOT_EMPTY) {
+        return NULL;
+      }
+      if (state == SLOT_FULL && slot->hash == hash && !gh->cmpfp(slot->key, key)) {
+        return slot;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+static void ghash_head_advance(LockfreeGHash *gh)
+{
+  LockfreeGHashTable *head;
+  while (table_is_migrated(head = ghash_head(gh))) {
+    atomic_cas_ptr((void **)&gh->head, head, head->next);
+  }
+}
+
+static bool table_add(LockfreeGHash *gh,
+                      LockfreeGHashTable *table,
+                      const unsigned int hash,
+                      void *key,
+                      void *val);
+
+/* Close the empty slots of a table and copy its entries to the next table. */
+static void table_migrate(LockfreeGHash *gh, LockfreeGHashTable *table)
+{
+  LockfreeGHashTable *next = table_next_ensure(table);
+  const unsigned int size = table_size(table);
+
+  for (unsigned int i = 0; i < size; i++) {
+    LockfreeGHashSlot *slot = &table->slots[i];
+    unsigned int state = atomic_cas_u(&slot->state, SLOT_EMPTY, SLOT_CLOSED);
+    if (state == SLOT_BUSY) {
+      state = slot_state_wait(slot);
+    }
+    if (state == SLOT_FULL) {
+      table_add(gh, next, slot->hash, slot->key, slot->val);
+    }
+  }
+
+  atomic_cas_u(&table->migrated, 0, 1);
+  ghash_head_advance(gh);
+}
+
+static bool table_add(LockfreeGHash *gh,
+                      LockfreeGHashTable *table,
+                      const unsigned int hash,
+                      void *key,
+                      void *val)
+{
+  for (;; table = table_next_ensure(table)) {
+    const unsigned int mask = table_size(table) - 1;
+    const unsigned int start = table_slot_start(table, hash);
+    const unsigned int probe_len = MIN2(LOCKFREE_GHASH_PROBE_LEN, mask + 1);
+
+    for (unsigned int i = 0; i < probe_len; i++) {
+      LockfreeGHashSlot *slot = &table->slots[(start + i) & mask];
+      unsigned int state = slot_state(slot);
+
+      if (state == SLOT_EMPTY) {
+        state = atomic_cas_u(&slot->state, SLOT_EMPTY, SLOT_BUSY);
+        if (state == SLOT_EMPTY) {
+          slot->hash = hash;
+          slot->key = key;
+          slot->val = val;
+          /* Publish the entry, the compare and swap is a full barrier. */
+          atomic_cas_u(&slot->state, SLOT_BUSY, SLOT_FULL);
+
+          /* Only the thread going over half of the table copies it. */
+          if (atomic_add_and_fetch_u(&table->nentries, 1) == table_size(table) / 2 + 1) {
+            table_migrate(gh, table);
+          }
+          return true;
+        }
+      }
+
+      if (state == SLOT_BUSY) {
+        state = slot_state_wait(slot);
+      }
+      if (state == SLOT_FULL && slot->hash == hash && !gh->cmpfp(slot->key, key)) {
+        return false;
+      }
+    }
+  }
+}
+
+static bool ghash_add(LockfreeGHash *gh, void *key, void *val)
+{
+  return table_add(gh, ghash_head(gh), gh->hashfp(key), key, val);
+}
+
+typedef struct ForeachParallelData {
+  const LockfreeGHashTable *table;
+  LockfreeGHashForeachFP func;
+  void *userdata;
+} ForeachParallelData;
+
+static void table_foreach_range(const LockfreeGHashTable *table,
+                                const unsigned int start,
+                                const unsigned int end,
+                                LockfreeGHashForeachFP func,
+                                void *userdata)
+{
+  for (unsigned int i = start; i < end; i++) {
+    LockfreeGHashSlot *slot = &table->slots[i];
+    if (slot->state == SLOT_FULL) {
+      func(userdata, slot->key, slot->val);
+    }
+  }
+}
+
+static void table_foreach_parallel_cb(void *__restrict userdata,
+                                      const int chunk,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ForeachParallelData *data = userdata;
+  const unsigned int start = (unsigned int)chunk * LOCKFREE_GHASH_ITER_CHUNK;
+  const unsigned int end = MIN2(start + LOCKFREE_GHASH_ITER_CHUNK, table_size(data->table));
+  table_foreach_range(data->table, start, end, data->func, data->userdata);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name LockfreeGHash Public API
+ * \{ */
+
+/**
+ * Creates a new, empty LockfreeGHash.
+ *
+ * \param hashfp: Hash callback.
+ * \param cmpfp: Comparison callback.
+ * \param info: Identifier string for the LockfreeGHash.
+ * \param nentries_reserve: Optionally reserve the number of members that the hash will hold.
+ * Going over this number copies the entries to bigger tables, the old ones are kept until the
+ * LockfreeGHash is freed.
+ * \return  An empty LockfreeGHash.
+ */
+LockfreeGHash *BLI_ghash_lockfree_new_ex(GHashHashFP hashfp,
+                                         GHashCmpFP cmpfp,
+                                         const char *info,
+                                         const unsigned int nentries_reserve)
+{
+  LockfreeGHash *gh = MEM_mallocN(sizeof(*gh), info);
+
+  gh->hashfp = hashfp;
+  gh->cmpfp = cmpfp;
+
+  /* Tables are copied to a bigger one when they are half full. */
+  unsigned int size_bits = LOCKFREE_GHASH_MIN_BITS;
+  while ((1u << size_bits) < nentries_reserve * 2 && size_bits < 31) {
+    size_bits++;
+  }
+  table_init(&gh->table, size_bits);
+  gh->head = &gh->table;
+
+  return gh;
+}
+
+/**
+ * Wraps #BLI_ghash_lockfree_new_ex with zero entries reserved.
+ */
+LockfreeGHash *BLI_ghash_lockfree_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+  return BLI_ghash_lockfree_new_ex(hashfp, cmpfp, info, 0);
+}
+
+typedef struct CopyData {
+  LockfreeGHash *gh;
+  GHashKeyCopyFP keycopyfp;
+  GHashValCopyFP valcopyfp;
+} CopyData;
+
+static void ghash_copy_cb(void *userdata, void *key, void *val)
+{
+  CopyData *data = userdata;
+  ghash_add(data->gh,
+            data->keycopyfp ? data->keycopyfp(key) : key,
+            data->valcopyfp ? data->valcopyfp(val) : val);
+}
+
+/**
+ * Copy given LockfreeGHash. Keys and values are also copied if relevant callback is provided,
+ * else pointers remain the same.
+ */
+LockfreeGHash *BLI_ghash_lockfree_copy(const LockfreeGHash *gh,
+                                       GHashKeyCopyFP keycopyfp,
+                                       GHashValCopyFP valcopyfp)
+{
+  CopyData data = {
+      .gh = BLI_ghash_lockfree_new_ex(
+          gh->hashfp, gh->cmpfp, __func__, BLI_ghash_lockfree_len(gh)),
+      .keycopyfp = keycopyfp,
+      .valcopyfp = valcopyfp,
+  };
+  BLI_ghash_lockfree_foreach(gh, ghash_copy_cb, &data);
+  return data.gh;
+}
+
+/**
+ * Frees the LockfreeGHash and its members.
+ *
+ * \param keyfreefp: Optional callback to free the key.
+ * \param valfreefp: Optional callback to free the value.
+ */
+void BLI_ghash_lockfree_free(LockfreeGHash *gh,
+                             GHashKeyFreeFP keyfreefp,
+                             GHashValFreeFP valfreefp)
+{
+  LockfreeGHashTable *table = &gh->table;
+  while (table) {
+    LockfreeGHashTable *table_next = table->next;
+
+    /* The entries of migrated tables are also in the next ones. */
+    if ((keyfreefp || valfreefp) && !table->migrated) {
+      const unsigned int size = table_size(table);
+      for (unsigned int i = 0; i < size; i++) {
+        LockfreeGHashSlot *slot = &table->slots[i];
+        if (slot->state == SLOT_FULL) {
+          if (keyfreefp) {
+            keyfreefp(slot->key);
+          }
+          if (valfreefp) {
+            valfreefp(slot->val);
+          }
+        }
+      }
+    }
+
+    MEM_freeN(table->slots);
+    if (table != &gh->table) {
+      MEM_freeN(table);
+    }
+    table = table_next;
+  }
+
+  MEM_freeN(gh);
+}
+
+/**
+ * Add \a key and \a val to \a gh if \a key isn't already in the hash.
+ *
+ * \return true if the entry was added, when false the key and value
+ * are not stored and remain owned by the caller.
+ */
+bool BLI_ghash_lockfree_add(LockfreeGHash *gh, void *key, void *val)
+{
+  return ghash_add(gh, key, val);
+}
+
+/**
+ * Lookup the value of \a key in \a gh.
+ *
+ * \return the value for \a key or NULL.
+ *
+ * \note When NULL is a valid value, use #BLI_ghash_lockfree_haskey.
+ */
+void *BLI_ghash_lockfree_lookup(const LockfreeGHash *gh, const void *key)
+{
+  LockfreeGHashSlot *slot = ghash_lookup_slot(gh, key);
+  return slot ? slot->val : NULL;
+}
+
+/**
+ * \return true if the \a key is in \a gh.
+ */
+bool BLI_ghash_lockfree_haskey(const LockfreeGHash *gh, const void *key)
+{
+  return (ghash_lookup_slot(gh, key) != NULL);
+}
+
+/**
+ * \return size of the LockfreeGHash, this visits all the slots.
+ */
+unsigned int BLI_ghash_lockfree_len(const LockfreeGHash *gh)
+{
+  unsigned int len = 0;
+  for (const LockfreeGHashTable *table = gh->head; table; table = table->next) {
+    if (table->migrated) {
+      continue;
+    }
+    const unsigned int size = table_size(table);
+    for (unsigned int i = 0; i < size; i++) {
+      if (table->slots[i].state == SLOT_FULL) {
+        len++;
+      }
+    }
+  }
+  return len;
+}
+
+/**
+ * Call \a func for every entry of \a gh, in no particular order.
+ */
+void BLI_ghash_lockfree_foreach(const LockfreeGHash *gh,
+                                LockfreeGHashForeachFP func,
+                                void *userdata)
+{
+  for (const LockfreeGHashTable *table = gh->head; table; table = table->next) {
+    if (table->migrated) {
+      continue;
+    }
+    table_foreach_range(table, 0, table_size(table), func, userdata);
+  }
+}
+
+/**
+ * Call \a func for every entry of \a gh from the task scheduler threads.
+ */
+void BLI_ghash_lockfree_foreach_parallel(const LockfreeGHash *gh,
+                                         LockfreeGHashForeachFP func,
+                                         void *userdata)
+{
+  for (const LockfreeGHashTable *table = gh->head; table; table = table->next) {
+    if (table->migrated) {
+      continue;
+    }
+    ForeachParallelData data = {
+        .table = table,
+        .func = func,
+        .userdata = userdata,
+    };
+    const unsigned int size = table_size(table);
+    const int num_chunks = (int)((size + LOCKFREE_GHASH_ITER_CHUNK - 1) /
+                                 LOCKFREE_GHASH_ITER_CHUNK);
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (num_chunks > 1);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, num_chunks, &data, table_foreach_parallel_cb, &settings);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Wrapper LockfreeGHash Creation Functions
+ * \{ */
+
+LockfreeGHash *BLI_ghash_lockfree_ptr_new_ex(const char *info,
+                                             const unsigned int nentries_reserve)
+{
+  return BLI_ghash_lockfree_new_ex(
+      BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+
+LockfreeGHash *BLI_ghash_lockfree_str_new_ex(const char *info,
+                                             const unsigned int nentries_reserve)
+{
+  return BLI_ghash_lockfree_new_ex(
+      BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+
+LockfreeGHash *BLI_ghash_lockfree_int_new_ex(const char *info,
+                                             const unsigned int nentries_reserve)
+{
+  return BLI_ghash_lockfree_new_ex(
+      BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name LockfreeGSet Public API
+ *
+ * Use ghash API to give 'set' functionality
+ * \{ */
+
+LockfreeGSet *BLI_gset_lockfree_new_ex(GSetHashFP hashfp,
+                                       GSetCmpFP cmpfp,
+                                       const char *info,
+                                       const unsigned int nentries_reserve)
+{
+  return (LockfreeGSet *)BLI_ghash_lockfree_new_ex(hashfp, cmpfp, info, nentries_reserve);
+}
+
+void BLI_gset_lockfree_free(LockfreeGSet *gs, GSetKeyFreeFP keyfreefp)
+{
+  BLI_ghash_lockfree_free((LockfreeGHash *)gs, keyfreefp, NULL);
+}
+
+/**
+ * Adds the key to the set if it isn't already in it.
+ *
+ * \return true if the key was added to the set.
+ */
+bool BLI_gset_lockfree_add(LockfreeGSet *gs, void *key)
+{
+  return ghash_add((LockfreeGHash *)gs, key, NULL);
+}
+
+bool BLI_gset_lockfree_haskey(const LockfreeGSet *gs, const void *key)
+{
+  return (ghash_lookup_slot((const LockfreeGHash *)gs, key) != NULL);
+}
+
+unsigned int BLI_gset_lockfree_len(const LockfreeGSet *gs)
+{
+  return BLI_ghash_lockfree_len((const LockfreeGHash *)gs);
+}
+
+typedef struct GSetForeachData {
+  LockfreeGSetForeachFP func;
+  void *userdata;
+} GSetForeachData;
+
+static void gset_foreach_cb(void *userdata, void *key, void *UNUSED(val))
+{
+  GSetForeachData *data = userdata;
+  data->func(data->userdata, key);
+}
+
+void BLI_gset_lockfree_foreach_parallel(const LockfreeGSet *gs,
+                                        LockfreeGSetForeachFP func,
+                                        void *userdata)
+{
+  GSetForeachData data = {
+      .func = func,
+      .userdata = userdata,
+  };
+  BLI_ghash_lockfree_foreach_parallel((const LockfreeGHash *)gs, gset_foreach_cb, &data);
+}
+
+LockfreeGSet *BLI_gset_lockfree_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+  return BLI_gset_lockfree_new_ex(
+      BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+
+LockfreeGSet *BLI_gset_lockfree_str_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+  return BLI_gset_lockfree_new_ex(
+      BLI_ghashutil_strhash_p, BLI_ghashutil_strcmp, info, nentries_reserve);
+}
+
+LockfreeGSet *BLI_gset_lockfree_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+  return BLI_gset_lockfree_new_ex(
+      BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+
+/** \} */
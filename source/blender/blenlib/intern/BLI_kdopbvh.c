@@ -30,6 +30,8 @@
  *
  * - Ray-cast:
  *   #BLI_bvhtree_ray_cast, #BVHRayCastData
+ * - Batched ray-cast (SIMD packets, multi-threaded):
+ *   #BLI_bvhtree_ray_cast_batch, #BVHRayCastPacket
  * - Nearest point on surface:
  *   #BLI_bvhtree_find_nearest, #BVHNearestData
  * - Overlapping 2 trees:
@@ -40,16 +42,23 @@
 
 #include <assert.h>
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_alloca.h"
 #include "BLI_heap_simple.h"
 #include "BLI_kdopbvh.h"
 #include "BLI_math.h"
+#include "BLI_math_bits.h"
 #include "BLI_stack.h"
 #include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_strict_flags.h"
 
 /* used for iterative_raycast */
@@ -859,6 +868,377 @@ static void non_recursive_bvh_div_nodes(const BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name SAH Balance
+ *
+ * Top-down build choosing each split with the surface area heuristic (SAH),
+ * evaluated on bins of the leaf centroids along the x, y and z axes.
+ *
+ * A branch is split in two, then its child with the largest surface area is split again
+ * until it has `tree_type` children. Unlike #non_recursive_bvh_div_nodes the resulting tree
+ * isn't implicit: branches are allocated in the order they are created (so children still have
+ * an index greater than their parent) and up to `totleaf - 1` of them may be needed.
+ * \{ */
+
+#define BVH_SAH_BINS 16
+/* Split at the median past this depth, so unbalanced splits don't make the tree too deep. */
+#define BVH_SAH_DEPTH_MAX 64
+
+typedef struct BVHSAHBuildData {
+  const BVHTree *tree;
+  BVHNode *branches_array;
+  BVHNode **leafs_array;
+  /* Number of branches used, incremented from all threads. */
+  int branches_len;
+} BVHSAHBuildData;
+
+typedef struct BVHSAHBuildTask {
+  BVHNode *node;
+  int leafs_begin;
+  int leafs_end;
+  int depth;
+} BVHSAHBuildTask;
+
+typedef struct BVHSAHBin {
+  float min[3], max[3];
+  int leafs_len;
+} BVHSAHBin;
+
+static void bvh_sah_node_centroid(const BVHNode *node, float r_centroid[3])
+{
+  const float *bv = node->bv;
+  r_centroid[0] = (bv[0] + bv[1]) * 0.5f;
+  r_centroid[1] = (bv[2] + bv[3]) * 0.5f;
+  r_centroid[2] = (bv[4] + bv[5]) * 0.5f;
+}
+
+static void bvh_sah_node_minmax(const BVHNode *node, float r_min[3], float r_max[3])
+{
+  const float *bv = node->bv;
+  for (int i = 0; i < 3; i++) {
+    r_min[i] = min_ff(r_min[i], bv[2 * i]);
+    r_max[i] = max_ff(r_max[i], bv[2 * i + 1]);
+  }
+}
+
+/* Half the surface area of a bounding box, enough to compare costs. */
+static float bvh_sah_half_area(const float min[3], const float max[3])
+{
+  const float size[3] = {max[0] - min[0], max[1] - min[1], max[2] - min[2]};
+  return size[0] * size[1] + size[1] * size[2] + size[2] * size[0];
+}
+
+static float bvh_sah_leafs_half_area(BVHNode **leafs_array, const int begin, const int end)
+{
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  for (int i = begin; i < end; i++) {
+    bvh_sah_node_minmax(leafs_array[i], min, max);
+  }
+  return bvh_sah_half_area(min, max);
+}
+
+static int bvh_sah_bin_index(const float centroid, const float centroid_min, const float scale)
+{
+  const int bin = (int)((centroid - centroid_min) * scale);
+  return CLAMPIS(bin, 0, BVH_SAH_BINS - 1);
+}
+
+/* Split the leafs in two halves along an axis, the fallback when binning finds no split. */
+static int bvh_sah_split_median(
+    BVHNode **leafs_array, const int begin, const int end, const int axis, float r_half_area[2])
+{
+  const int mid_median = (begin + end) / 2;
+  partition_nth_element(leafs_array, begin, end, mid_median, 2 * axis);
+  r_half_area[0] = bvh_sah_leafs_half_area(leafs_array, begin, mid_median);
+  r_half_area[1] = bvh_sah_leafs_half_area(leafs_array, mid_median, end);
+  return mid_median;
+}
+
+/**
+ * Partition the leafs in `[begin, end)` and return the first leaf of the second part,
+ * neither part is ever empty.
+ *
+ * \param r_half_area: The half surface area of the bounding box of both parts.
+ */
+static int bvh_sah_split(BVHNode **leafs_array,
+                         const int begin,
+                         const int end,
+                         const int depth,
+                         char *r_axis,
+                         float r_half_area[2])
+{
+  float centroid_min[3], centroid_max[3], centroid[3], extent[3];
+  INIT_MINMAX(centroid_min, centroid_max);
+  for (int i = begin; i < end; i++) {
+    bvh_sah_node_centroid(leafs_array[i], centroid);
+    minmax_v3v3_v3(centroid_min, centroid_max, centroid);
+  }
+  sub_v3_v3v3(extent, centroid_max, centroid_min);
+
+  const int axis_largest = axis_dominant_v3_single(extent);
+  *r_axis = (char)axis_largest;
+
+  if (extent[axis_largest] == 0.0f || depth > BVH_SAH_DEPTH_MAX) {
+    /* Any split is as good when all centroids are the same. */
+    return bvh_sah_split_median(leafs_array, begin, end, axis_largest, r_half_area);
+  }
+
+  float cost_best = FLT_MAX;
+  int axis_best = -1, bin_best = -1;
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (extent[axis] == 0.0f) {
+      continue;
+    }
+
+    BVHSAHBin bins[BVH_SAH_BINS];
+    for (int b = 0; b < BVH_SAH_BINS; b++) {
+      INIT_MINMAX(bins[b].min, bins[b].max);
+      bins[b].leafs_len = 0;
+    }
+
+    const float scale = ((float)BVH_SAH_BINS * (1.0f - FLT_EPSILON)) / extent[axis];
+    for (int i = begin; i < end; i++) {
+      bvh_sah_node_centroid(leafs_array[i], centroid);
+      BVHSAHBin *bin = &bins[bvh_sah_bin_index(centroid[axis], centroid_min[axis], scale)];
+      bvh_sah_node_minmax(leafs_array[i], bin->min, bin->max);
+      bin->leafs_len++;
+    }
+
+    /* Sweep from the right to store the cost of everything after each bin,
+     * then from the left to evaluate the splits. */
+    float half_area_right[BVH_SAH_BINS];
+    int leafs_len_right[BVH_SAH_BINS];
+    float min[3], max[3];
+    int leafs_len = 0;
+    INIT_MINMAX(min, max);
+    for (int b = BVH_SAH_BINS - 1; b > 0; b--) {
+      if (bins[b].leafs_len) {
+        minmax_v3v3_v3(min, max, bins[b].min);
+        minmax_v3v3_v3(min, max, bins[b].max);
+        leafs_len += bins[b].leafs_len;
+      }
+      leafs_len_right[b] = leafs_len;
+      half_area_right[b] = leafs_len ? bvh_sah_half_area(min, max) : 0.0f;
+    }
+
+    leafs_len = 0;
+    INIT_MINMAX(min, max);
+    for (int b = 0; b < BVH_SAH_BINS - 1; b++) {
+      if (bins[b].leafs_len) {
+        minmax_v3v3_v3(min, max, bins[b].min);
+        minmax_v3v3_v3(min, max, bins[b].max);
+        leafs_len += bins[b].leafs_len;
+      }
+      if (leafs_len == 0 || leafs_len_right[b + 1] == 0) {
+        continue;
+      }
+      const float half_area = bvh_sah_half_area(min, max);
+      const float cost = (float)leafs_len * half_area +
+                         (float)leafs_len_right[b + 1] * half_area_right[b + 1];
+      if (cost < cost_best) {
+        cost_best = cost;
+        axis_best = axis;
+        bin_best = b;
+        r_half_area[0] = half_area;
+        r_half_area[1] = half_area_right[b + 1];
+      }
+    }
+  }
+
+  if (axis_best == -1) {
+    /* No valid cost, with extents too small or too large for the bins. */
+    return bvh_sah_split_median(leafs_array, begin, end, axis_largest, r_half_area);
+  }
+  *r_axis = (char)axis_best;
+
+  const float scale = ((float)BVH_SAH_BINS * (1.0f - FLT_EPSILON)) / extent[axis_best];
+  int i = begin, j = end - 1;
+  while (i <= j) {
+    bvh_sah_node_centroid(leafs_array[i], centroid);
+    if (bvh_sah_bin_index(centroid[axis_best], centroid_min[axis_best], scale) <= bin_best) {
+      i++;
+    }
+    else {
+      SWAP(BVHNode *, leafs_array[i], leafs_array[j]);
+      j--;
+    }
+  }
+  BLI_assert(i > begin && i < end);
+  return i;
+}
+
+static void bvh_sah_build_task_cb(TaskPool *__restrict pool, void *taskdata, int thread_id);
+
+static void bvh_sah_build_branch(TaskPool *pool,
+                                 const int thread_id,
+                                 BVHSAHBuildData *data,
+                                 BVHNode *node,
+                                 const int leafs_begin,
+                                 const int leafs_end,
+                                 const int depth)
+{
+  const int tree_type = data->tree->tree_type;
+  int nth_positions[MAX_TREETYPE + 1];
+  float children_half_area[MAX_TREETYPE];
+  int children_len = 1;
+  int k;
+
+  refit_kdop_hull(data->tree, node, leafs_begin, leafs_end);
+
+  /* Split the largest child until the branch is full. */
+  nth_positions[0] = leafs_begin;
+  nth_positions[1] = leafs_end;
+  children_half_area[0] = FLT_MAX;
+  while (children_len < tree_type) {
+    int k_split = -1;
+    for (k = 0; k < children_len; k++) {
+      if ((nth_positions[k + 1] - nth_positions[k] > 1) &&
+          (k_split == -1 || children_half_area[k] > children_half_area[k_split])) {
+        k_split = k;
+      }
+    }
+    if (k_split == -1) {
+      break;
+    }
+
+    char split_axis;
+    float split_half_area[2];
+    const int mid = bvh_sah_split(data->leafs_array,
+                                  nth_positions[k_split],
+                                  nth_positions[k_split + 1],
+                                  depth,
+                                  &split_axis,
+                                  split_half_area);
+    if (children_len == 1) {
+      node->main_axis = split_axis;
+    }
+    memmove(&nth_positions[k_split + 2],
+            &nth_positions[k_split + 1],
+            sizeof(*nth_positions) * (size_t)(children_len - k_split));
+    memmove(&children_half_area[k_split + 1],
+            &children_half_area[k_split],
+            sizeof(*children_half_area) * (size_t)(children_len - k_split));
+    nth_positions[k_split + 1] = mid;
+    children_half_area[k_split] = split_half_area[0];
+    children_half_area[k_split + 1] = split_half_area[1];
+    children_len++;
+  }
+
+  for (k = 0; k < children_len; k++) {
+    const int child_leafs_begin = nth_positions[k];
+    const int child_leafs_end = nth_positions[k + 1];
+    BVHNode *child;
+
+    if (child_leafs_end - child_leafs_begin == 1) {
+      child = data->leafs_array[child_leafs_begin];
+    }
+    else {
+      child = &data->branches_array[atomic_fetch_and_add_int32(&data->branches_len, 1)];
+
+      if (pool && (child_leafs_end - child_leafs_begin > KDOPBVH_THREAD_LEAF_THRESHOLD)) {
+        BVHSAHBuildTask *task = MEM_mallocN(sizeof(*task), __func__);
+        task->node = child;
+        task->leafs_begin = child_leafs_begin;
+        task->leafs_end = child_leafs_end;
+        task->depth = depth + 1;
+        BLI_task_pool_push_from_thread(
+            pool, bvh_sah_build_task_cb, task, true, TASK_PRIORITY_HIGH, thread_id);
+      }
+      else {
+        bvh_sah_build_branch(
+            pool, thread_id, data, child, child_leafs_begin, child_leafs_end, depth + 1);
+      }
+    }
+    node->children[k] = child;
+    child->parent = node;
+  }
+  for (; k < tree_type; k++) {
+    node->children[k] = NULL;
+  }
+  node->totnode = (char)children_len;
+}
+
+static void bvh_sah_build_task_cb(TaskPool *__restrict pool, void *taskdata, int thread_id)
+{
+  BVHSAHBuildData *data = BLI_task_pool_userdata(pool);
+  BVHSAHBuildTask *task = taskdata;
+
+  bvh_sah_build_branch(
+      pool, thread_id, data, task->node, task->leafs_begin, task->leafs_end, task->depth);
+}
+
+/**
+ * Grow the node arrays so they can store \a nodes_len nodes,
+ * only valid before the tree is balanced.
+ */
+static void bvhtree_nodes_ensure(BVHTree *tree, const int nodes_len)
+{
+  const int nodes_len_alloc = (int)(MEM_allocN_len(tree->nodearray) / sizeof(*tree->nodearray));
+  const int tree_type = tree->tree_type;
+  const int axis = tree->axis;
+
+  BLI_assert(tree->totbranch == 0);
+
+  if (nodes_len <= nodes_len_alloc) {
+    return;
+  }
+
+  tree->nodes = MEM_recallocN(tree->nodes, sizeof(*tree->nodes) * (size_t)nodes_len);
+  tree->nodebv = MEM_recallocN(tree->nodebv, sizeof(float) * (size_t)(axis * nodes_len));
+  tree->nodechild = MEM_recallocN(tree->nodechild,
+                                  sizeof(BVHNode *) * (size_t)(tree_type * nodes_len));
+  tree->nodearray = MEM_recallocN(tree->nodearray, sizeof(BVHNode) * (size_t)nodes_len);
+
+  /* relink the dynamic bv and child links */
+  for (int i = 0; i < nodes_len; i++) {
+    tree->nodearray[i].bv = &tree->nodebv[i * axis];
+    tree->nodearray[i].children = &tree->nodechild[i * tree_type];
+  }
+  for (int i = 0; i < tree->totleaf; i++) {
+    tree->nodes[i] = &tree->nodearray[i];
+  }
+}
+
+/**
+ * Build the tree from the leafs with #bvh_sah_build_branch, the root is the first branch.
+ *
+ * \return the number of branches used.
+ */
+static int bvh_sah_build(BVHTree *tree)
+{
+  const int num_leafs = tree->totleaf;
+
+  /* Each branch has at least two children. */
+  bvhtree_nodes_ensure(tree, num_leafs + (num_leafs - 1));
+
+  BVHSAHBuildData data = {
+      .tree = tree,
+      .branches_array = tree->nodearray + num_leafs,
+      .leafs_array = tree->nodes,
+      .branches_len = 1,
+  };
+
+  BVHNode *root = &data.branches_array[0];
+  root->parent = NULL;
+
+  if (num_leafs > KDOPBVH_THREAD_LEAF_THRESHOLD) {
+    TaskPool *pool = BLI_task_pool_create(BLI_task_scheduler_get(), &data);
+    /* Not called from a task, so there is no thread to push the sub-trees from. */
+    bvh_sah_build_branch(pool, -1, &data, root, 0, num_leafs, 0);
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+  else {
+    bvh_sah_build_branch(NULL, -1, &data, root, 0, num_leafs, 0);
+  }
+
+  return data.branches_len;
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree API
  * \{ */
@@ -949,7 +1329,12 @@ void BLI_bvhtree_free(BVHTree *tree)
   }
 }
 
-void BLI_bvhtree_balance(BVHTree *tree)
+/**
+ * \param flag: #BVH_BALANCE_SAH to split the nodes with the surface area heuristic,
+ * this takes longer and may use more memory but ray-casts are faster.
+ * Only supported for trees with an axis aligned bounding box (all but 18-DOP).
+ */
+void BLI_bvhtree_balance_ex(BVHTree *tree, const int flag)
 {
   BVHNode **leafs_array = tree->nodes;
 
@@ -957,13 +1342,18 @@ void BLI_bvhtree_balance(BVHTree *tree)
    * (some big bug goes here if its being called more than once per tree) */
   BLI_assert(tree->totbranch == 0);
 
-  /* Build the implicit tree */
-  non_recursive_bvh_div_nodes(
-      tree, tree->nodearray + (tree->totleaf - 1), leafs_array, tree->totleaf);
+  if ((flag & BVH_BALANCE_SAH) && (tree->start_axis == 0) && (tree->totleaf > 1)) {
+    tree->totbranch = bvh_sah_build(tree);
+  }
+  else {
+    /* Build the implicit tree */
+    non_recursive_bvh_div_nodes(
+        tree, tree->nodearray + (tree->totleaf - 1), leafs_array, tree->totleaf);
+    tree->totbranch = implicit_needed_branches(tree->tree_type, tree->totleaf);
+  }
 
   /* current code expects the branches to be linked to the nodes array
    * we perform that linkage here */
-  tree->totbranch = implicit_needed_branches(tree->tree_type, tree->totleaf);
   for (int i = 0; i < tree->totbranch; i++) {
     tree->nodes[tree->totleaf + i] = &tree->nodearray[tree->totleaf + i];
   }
@@ -981,6 +1371,11 @@ void BLI_bvhtree_balance(BVHTree *tree)
 #endif
 }
 
+void BLI_bvhtree_balance(BVHTree *tree)
+{
+  BLI_bvhtree_balance_ex(tree, 0);
+}
+
 void BLI_bvhtree_insert(BVHTree *tree, int index, const float co[3], int numpoints)
 {
   axis_t axis_iter;
@@ -1989,6 +2384,243 @@ void BLI_bvhtree_ray_cast_all(BVHTree *tree,
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name BLI_bvhtree_ray_cast_batch
+ *
+ * Rays are cast in packets of #BVH_RAYCAST_PACKET_SIZE, traversing the tree once for all
+ * the rays of a packet and testing their bounding volume intersections together (with SSE2).
+ * Rays with a radius are cast one at a time with #dfs_raycast instead: their distance to the
+ * bounding volumes is computed differently and is zero for all the volumes containing the ray
+ * origin, the hit then depends on the traversal order of each ray.
+ * The packets are cast from multiple threads.
+ *
+ * \{ */
+
+#define BVH_RAYCAST_PACKET_SIZE 4
+
+typedef struct BVHRayCastPacket {
+  BVHRayCastData data[BVH_RAYCAST_PACKET_SIZE];
+
+  /* Packed copies of the rays of all lanes for the bounding volume test. */
+  float origin[3][BVH_RAYCAST_PACKET_SIZE];
+  float idot_axis[3][BVH_RAYCAST_PACKET_SIZE];
+  float hit_dist[BVH_RAYCAST_PACKET_SIZE];
+} BVHRayCastPacket;
+
+typedef struct BVHRayCastBatchData {
+  const BVHTree *tree;
+  const float (*co)[3];
+  const float (*dir)[3];
+  int rays_len;
+  float radius;
+  BVHTreeRayHit *hits;
+  BVHTree_RayCastCallback callback;
+  void *userdata;
+  int flag;
+} BVHRayCastBatchData;
+
+/**
+ * Intersect the rays of the packet with the axis aligned part of the bounding volume.
+ * Matches #fast_ray_nearest_hit.
+ *
+ * \return a mask of the lanes where the ray hits it closer than the current hit,
+ * \a r_dist is the distance to the bounding volume for those lanes.
+ */
+static int ray_packet_nearest_hit(const BVHRayCastPacket *packet,
+                                  const float bv[6],
+                                  float r_dist[BVH_RAYCAST_PACKET_SIZE])
+{
+#ifdef __SSE2__
+  __m128 near = _mm_set1_ps(-FLT_MAX);
+  __m128 far = _mm_set1_ps(FLT_MAX);
+
+  for (int i = 0; i < 3; i++) {
+    const __m128 origin = _mm_loadu_ps(packet->origin[i]);
+    const __m128 idot_axis = _mm_loadu_ps(packet->idot_axis[i]);
+    const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bv[2 * i]), origin), idot_axis);
+    const __m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bv[2 * i + 1]), origin), idot_axis);
+    near = _mm_max_ps(near, _mm_min_ps(t1, t2));
+    far = _mm_min_ps(far, _mm_max_ps(t1, t2));
+  }
+
+  const __m128 hit = _mm_and_ps(
+      _mm_and_ps(_mm_cmple_ps(near, far), _mm_cmpge_ps(far, _mm_setzero_ps())),
+      _mm_cmplt_ps(near, _mm_loadu_ps(packet->hit_dist)));
+  _mm_storeu_ps(r_dist, near);
+  return _mm_movemask_ps(hit);
+#else
+  int mask = 0;
+
+  for (int lane = 0; lane < BVH_RAYCAST_PACKET_SIZE; lane++) {
+    float near = -FLT_MAX;
+    float far = FLT_MAX;
+
+    for (int i = 0; i < 3; i++) {
+      const float t1 = (bv[2 * i] - packet->origin[i][lane]) * packet->idot_axis[i][lane];
+      const float t2 = (bv[2 * i + 1] - packet->origin[i][lane]) * packet->idot_axis[i][lane];
+      near = max_ff(near, min_ff(t1, t2));
+      far = min_ff(far, max_ff(t1, t2));
+    }
+
+    if (near <= far && far >= 0.0f && near < packet->hit_dist[lane]) {
+      mask |= 1 << lane;
+    }
+    r_dist[lane] = near;
+  }
+  return mask;
+#endif
+}
+
+static void dfs_raycast_packet(BVHRayCastPacket *packet, const BVHNode *node, int mask)
+{
+  float dist[BVH_RAYCAST_PACKET_SIZE];
+  int i;
+
+  mask &= ray_packet_nearest_hit(packet, node->bv, dist);
+  if (mask == 0) {
+    return;
+  }
+
+  if (node->totnode == 0) {
+    for (int lane = 0; lane < BVH_RAYCAST_PACKET_SIZE; lane++) {
+      if ((mask & (1 << lane)) == 0) {
+        continue;
+      }
+      BVHRayCastData *data = &packet->data[lane];
+      if (data->callback) {
+        data->callback(data->userdata, node->index, &data->ray, &data->hit);
+      }
+      else {
+        data->hit.index = node->index;
+        data->hit.dist = dist[lane];
+        madd_v3_v3v3fl(data->hit.co, data->ray.origin, data->ray.direction, dist[lane]);
+      }
+      packet->hit_dist[lane] = data->hit.dist;
+    }
+  }
+  else {
+    /* pick loop direction to dive into the tree (based on the direction of the first ray) */
+    const BVHRayCastData *data = &packet->data[bitscan_forward_i(mask)];
+    if (data->ray_dot_axis[node->main_axis] > 0.0f) {
+      for (i = 0; i != node->totnode; i++) {
+        dfs_raycast_packet(packet, node->children[i], mask);
+      }
+    }
+    else {
+      for (i = node->totnode - 1; i >= 0; i--) {
+        dfs_raycast_packet(packet, node->children[i], mask);
+      }
+    }
+  }
+}
+
+static void bvhtree_ray_cast_batch_task_cb(void *__restrict userdata,
+                                           const int packet_index,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BVHRayCastBatchData *batch_data = userdata;
+  const BVHTree *tree = batch_data->tree;
+  BVHNode *root = tree->nodes[tree->totleaf];
+
+  const int ray_begin = packet_index * BVH_RAYCAST_PACKET_SIZE;
+  const int lanes_len = min_ii(BVH_RAYCAST_PACKET_SIZE, batch_data->rays_len - ray_begin);
+  int lane;
+
+  BVHRayCastPacket packet;
+
+  for (lane = 0; lane < lanes_len; lane++) {
+    BVHRayCastData *data = &packet.data[lane];
+    const int ray_index = ray_begin + lane;
+
+    BLI_ASSERT_UNIT_V3(batch_data->dir[ray_index]);
+
+    data->tree = tree;
+    data->callback = batch_data->callback;
+    data->userdata = batch_data->userdata;
+
+    copy_v3_v3(data->ray.origin, batch_data->co[ray_index]);
+    copy_v3_v3(data->ray.direction, batch_data->dir[ray_index]);
+    data->ray.radius = batch_data->radius;
+
+    bvhtree_ray_cast_data_precalc(data, batch_data->flag);
+
+    data->hit = batch_data->hits[ray_index];
+
+    for (int i = 0; i < 3; i++) {
+      packet.origin[i][lane] = data->ray.origin[i];
+      packet.idot_axis[i][lane] = data->idot_axis[i];
+    }
+    packet.hit_dist[lane] = data->hit.dist;
+  }
+  /* Unused lanes never hit anything. */
+  for (; lane < BVH_RAYCAST_PACKET_SIZE; lane++) {
+    for (int i = 0; i < 3; i++) {
+      packet.origin[i][lane] = 0.0f;
+      packet.idot_axis[i][lane] = 0.0f;
+    }
+    packet.hit_dist[lane] = -FLT_MAX;
+  }
+
+  if (root) {
+    if (batch_data->radius == 0.0f) {
+      dfs_raycast_packet(&packet, root, (1 << lanes_len) - 1);
+    }
+    else {
+      for (lane = 0; lane < lanes_len; lane++) {
+        dfs_raycast(&packet.data[lane], root);
+      }
+    }
+  }
+
+  for (lane = 0; lane < lanes_len; lane++) {
+    batch_data->hits[ray_begin + lane] = packet.data[lane].hit;
+  }
+}
+
+/**
+ * Cast \a rays_len rays at once, giving the same hits as calling #BLI_bvhtree_ray_cast_ex
+ * for each of them.
+ *
+ * \param hits: As the \a hit argument of #BLI_bvhtree_ray_cast_ex but it must be initialized,
+ * with its index set to -1 and its dist to the maximum distance (#BVH_RAYCAST_DIST_MAX).
+ * \param callback: Called from multiple threads, it must be thread-safe.
+ *
+ * \note Packets of rays are faster when neighboring rays in the arrays are close to each other
+ * (casting from the pixels of an image for example). Only rays without \a radius are cast in
+ * packets, the others are cast one at a time from multiple threads.
+ */
+void BLI_bvhtree_ray_cast_batch(BVHTree *tree,
+                                const float (*co)[3],
+                                const float (*dir)[3],
+                                const int rays_len,
+                                float radius,
+                                BVHTreeRayHit *hits,
+                                BVHTree_RayCastCallback callback,
+                                void *userdata,
+                                int flag)
+{
+  BVHRayCastBatchData batch_data = {
+      .tree = tree,
+      .co = co,
+      .dir = dir,
+      .rays_len = rays_len,
+      .radius = radius,
+      .hits = hits,
+      .callback = callback,
+      .userdata = userdata,
+      .flag = flag,
+  };
+  const int packets_len = (rays_len + BVH_RAYCAST_PACKET_SIZE - 1) / BVH_RAYCAST_PACKET_SIZE;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (rays_len > KDOPBVH_THREAD_LEAF_THRESHOLD);
+  BLI_task_parallel_range(
+      0, packets_len, &batch_data, bvhtree_ray_cast_batch_task_cb, &settings);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name BLI_bvhtree_range_query
  *
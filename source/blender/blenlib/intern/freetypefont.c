@@ -35,7 +35,7 @@
 
 #include "MEM_guardedalloc.h"
 
-#include "BLI_ghash.h"
+#include "BLI_ghash_lockfree.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_string.h"
@@ -91,8 +91,6 @@ static VChar *freetypechar_to_vchar(FT_Face face, FT_ULong charcode, VFontData *
     che->index = charcode;
     che->width = glyph->advance.x * scale;
 
-    BLI_ghash_insert(vfd->characters, POINTER_FROM_UINT(che->index), che);
-
     /* Start converting the FT data */
     onpoints = (int *)MEM_callocN((ftoutline.n_contours) * sizeof(int), "onpoints");
 
@@ -247,6 +245,9 @@ static VChar *freetypechar_to_vchar(FT_Face face, FT_ULong charcode, VFontData *
 
     MEM_freeN(onpoints);
 
+    /* Only add the character once complete, lookups don't lock. */
+    BLI_ghash_lockfree_add(vfd->characters, POINTER_FROM_UINT(che->index), che);
+
     return che;
   }
 
@@ -357,7 +358,7 @@ static VFontData *objfnt_to_ftvfontdata(PackedFile *pf)
   }
 
   /* Load characters */
-  vfd->characters = BLI_ghash_int_new_ex(__func__, charcode_reserve);
+  vfd->characters = BLI_ghash_lockfree_int_new_ex(__func__, charcode_reserve);
 
   while (charcode < charcode_reserve) {
     /* Generate the font data */
@@ -451,7 +452,7 @@ VFontData *BLI_vfontdata_copy(const VFontData *vfont_src, const int UNUSED(flag)
   VFontData *vfont_dst = MEM_dupallocN(vfont_src);
 
   if (vfont_src->characters != NULL) {
-    vfont_dst->characters = BLI_ghash_copy(
+    vfont_dst->characters = BLI_ghash_lockfree_copy(
         vfont_src->characters, NULL, vfontdata_copy_characters_value_cb);
   }
 
@@ -23,6 +23,7 @@
 #include "BLI_kdtree_impl.h"
 #include "BLI_math.h"
 #include "BLI_strict_flags.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #define _CONCAT_AUX(MACRO_ARG1, MACRO_ARG2) MACRO_ARG1##MACRO_ARG2
@@ -45,10 +46,14 @@ typedef struct KDTreeNode {
 struct KDTree {
   KDTreeNode *nodes;
   uint nodes_len;
+  uint nodes_len_capacity; /* max size of the tree, grown by dynamic inserts */
   uint root;
+  /* Nodes removed from a balanced tree, they stay in the tree until the next balance. */
+  uint nodes_removed_len;
+  /* Nodes inserted or removed since the last balance. */
+  uint nodes_update_len;
 #ifdef DEBUG
-  bool is_balanced;        /* ensure we call balance first */
-  uint nodes_len_capacity; /* max size of the tree */
+  bool is_balanced; /* ensure we call balance first */
 #endif
 };
 
@@ -58,6 +63,19 @@ struct KDTree {
 
 #define KD_NODE_UNSET ((uint)-1)
 
+/* Index of nodes removed from a balanced tree, they are skipped by searches. */
+#define KD_INDEX_REMOVED -1
+
+/* Balance sub-trees with more nodes than this from multiple threads. */
+#ifdef DEBUG
+#  define KD_THREAD_NODES_THRESHOLD 0
+#else
+#  define KD_THREAD_NODES_THRESHOLD 10000
+#endif
+
+/* Number of queries handled at once by a thread of the batched searches. */
+#define KD_BATCH_CHUNK_SIZE 64
+
 /**
  * When set we know all values are unbalanced,
  * otherwise clear them when re-balancing: see T62210.
@@ -103,11 +121,13 @@ KDTree *BLI_kdtree_nd_(new)(uint nodes_len_capacity)
   tree = MEM_mallocN(sizeof(KDTree), "KDTree");
   tree->nodes = MEM_mallocN(sizeof(KDTreeNode) * nodes_len_capacity, "KDTreeNode");
   tree->nodes_len = 0;
+  tree->nodes_len_capacity = nodes_len_capacity;
   tree->root = KD_NODE_ROOT_IS_INIT;
+  tree->nodes_removed_len = 0;
+  tree->nodes_update_len = 0;
 
 #ifdef DEBUG
   tree->is_balanced = false;
-  tree->nodes_len_capacity = nodes_len_capacity;
 #endif
 
   return tree;
@@ -128,9 +148,7 @@ void BLI_kdtree_nd_(insert)(KDTree *tree, int index, const float co[KD_DIMS])
 {
   KDTreeNode *node = &tree->nodes[tree->nodes_len++];
 
-#ifdef DEBUG
   BLI_assert(tree->nodes_len <= tree->nodes_len_capacity);
-#endif
 
   /* note, array isn't calloc'd,
    * need to initialize all struct members */
@@ -145,19 +163,14 @@ void BLI_kdtree_nd_(insert)(KDTree *tree, int index, const float co[KD_DIMS])
 #endif
 }
 
-static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const uint ofs)
+/**
+ * Sort the nodes around their median on \a axis, return the median.
+ */
+static uint kdtree_median_partition(KDTreeNode *nodes, uint nodes_len, uint axis)
 {
-  KDTreeNode *node;
   float co;
   uint left, right, median, i, j;
 
-  if (nodes_len <= 0) {
-    return KD_NODE_UNSET;
-  }
-  else if (nodes_len == 1) {
-    return 0 + ofs;
-  }
-
   /* quicksort style sorting around median */
   left = 0;
   right = nodes_len - 1;
@@ -190,6 +203,31 @@ static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const u
     }
   }
 
+  return median;
+}
+
+/**
+ * The root of balanced nodes is always their median, this gives it without sorting them.
+ */
+BLI_INLINE uint kdtree_balance_root(uint nodes_len, const uint ofs)
+{
+  return (nodes_len == 0) ? KD_NODE_UNSET : (nodes_len / 2) + ofs;
+}
+
+static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const uint ofs)
+{
+  KDTreeNode *node;
+  uint median;
+
+  if (nodes_len <= 0) {
+    return KD_NODE_UNSET;
+  }
+  else if (nodes_len == 1) {
+    return 0 + ofs;
+  }
+
+  median = kdtree_median_partition(nodes, nodes_len, axis);
+
   /* set node and sort subnodes */
   node = &nodes[median];
   node->d = axis;
@@ -201,8 +239,114 @@ static uint kdtree_balance(KDTreeNode *nodes, uint nodes_len, uint axis, const u
   return median + ofs;
 }
 
+typedef struct KDTreeBalanceRange {
+  uint ofs, nodes_len, axis;
+} KDTreeBalanceRange;
+
+typedef struct KDTreeBalanceData {
+  KDTreeNode *nodes;
+  const KDTreeBalanceRange *ranges;
+  KDTreeBalanceRange *ranges_next;
+} KDTreeBalanceData;
+
+static void kdtree_balance_range_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBalanceData *data = userdata;
+  const KDTreeBalanceRange *range = &data->ranges[i];
+  KDTreeBalanceRange *range_left = &data->ranges_next[i * 2];
+  KDTreeBalanceRange *range_right = &data->ranges_next[i * 2 + 1];
+
+  range_left->nodes_len = range_right->nodes_len = 0;
+
+  if (range->nodes_len <= KD_THREAD_NODES_THRESHOLD) {
+    kdtree_balance(data->nodes + range->ofs, range->nodes_len, range->axis, range->ofs);
+    return;
+  }
+
+  /* Only sort around the median, the sub-trees are balanced at the next level. */
+  const uint median = kdtree_median_partition(
+      data->nodes + range->ofs, range->nodes_len, range->axis);
+  KDTreeNode *node = &data->nodes[range->ofs + median];
+
+  range_left->ofs = range->ofs;
+  range_left->nodes_len = median;
+  range_right->ofs = range->ofs + median + 1;
+  range_right->nodes_len = range->nodes_len - (median + 1);
+  range_left->axis = range_right->axis = (range->axis + 1) % KD_DIMS;
+
+  node->d = range->axis;
+  node->left = kdtree_balance_root(range_left->nodes_len, range_left->ofs);
+  node->right = kdtree_balance_root(range_right->nodes_len, range_right->ofs);
+}
+
+/**
+ * Same result as #kdtree_balance, the sub-trees of each level are balanced from multiple threads.
+ */
+static uint kdtree_balance_parallel(KDTreeNode *nodes, uint nodes_len)
+{
+  KDTreeBalanceRange *ranges = MEM_mallocN(sizeof(*ranges), __func__);
+  uint ranges_len = 1;
+
+  ranges[0].ofs = 0;
+  ranges[0].nodes_len = nodes_len;
+  ranges[0].axis = 0;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+
+  while (ranges_len != 0) {
+    KDTreeBalanceData data = {
+        .nodes = nodes,
+        .ranges = ranges,
+        .ranges_next = MEM_mallocN(sizeof(*ranges) * ranges_len * 2, __func__),
+    };
+    BLI_task_parallel_range(0, (int)ranges_len, &data, kdtree_balance_range_cb, &settings);
+
+    /* Keep the ranges which still need sorting. */
+    uint ranges_next_len = 0;
+    for (uint i = 0; i < ranges_len * 2; i++) {
+      if (data.ranges_next[i].nodes_len != 0) {
+        data.ranges_next[ranges_next_len++] = data.ranges_next[i];
+      }
+    }
+
+    MEM_freeN(ranges);
+    ranges = data.ranges_next;
+    ranges_len = ranges_next_len;
+  }
+
+  MEM_freeN(ranges);
+
+  return kdtree_balance_root(nodes_len, 0);
+}
+
+/**
+ * Remove the nodes tagged by #BLI_kdtree_3d_remove_dynamic.
+ */
+static void kdtree_remove_tagged(KDTree *tree)
+{
+  uint j = 0;
+  for (uint i = 0; i < tree->nodes_len; i++) {
+    if (tree->nodes[i].index != KD_INDEX_REMOVED) {
+      if (i != j) {
+        tree->nodes[j] = tree->nodes[i];
+      }
+      j++;
+    }
+  }
+  tree->nodes_len = j;
+  tree->nodes_removed_len = 0;
+}
+
 void BLI_kdtree_nd_(balance)(KDTree *tree)
 {
+  if (tree->nodes_removed_len != 0) {
+    kdtree_remove_tagged(tree);
+  }
+
   if (tree->root != KD_NODE_ROOT_IS_INIT) {
     for (uint i = 0; i < tree->nodes_len; i++) {
       tree->nodes[i].left = KD_NODE_UNSET;
@@ -210,7 +354,13 @@ void BLI_kdtree_nd_(balance)(KDTree *tree)
     }
   }
 
-  tree->root = kdtree_balance(tree->nodes, tree->nodes_len, 0, 0);
+  if (tree->nodes_len > KD_THREAD_NODES_THRESHOLD) {
+    tree->root = kdtree_balance_parallel(tree->nodes, tree->nodes_len);
+  }
+  else {
+    tree->root = kdtree_balance(tree->nodes, tree->nodes_len, 0, 0);
+  }
+  tree->nodes_update_len = 0;
 
 #ifdef DEBUG
   tree->is_balanced = true;
@@ -230,6 +380,277 @@ static uint *realloc_nodes(uint *stack, uint *stack_len_capacity, const bool is_
   return stack_new;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Dynamic Insert & Remove
+ *
+ * Update a balanced tree without balancing it again for every change.
+ * Inserted nodes are added as leaves and removed nodes are only tagged,
+ * the tree is balanced again once the changes add up to half of it.
+ * \{ */
+
+static void kdtree_update_done(KDTree *tree)
+{
+  tree->nodes_update_len++;
+
+  if (tree->nodes_update_len > tree->nodes_len / 2) {
+    BLI_kdtree_nd_(balance)(tree);
+  }
+}
+
+/**
+ * Count the nodes of the sub-tree starting at \a node_index,
+ * their indices are written to \a r_subtree_nodes when it isn't NULL.
+ */
+static uint kdtree_subtree_nodes(const KDTreeNode *nodes, uint node_index, uint *r_subtree_nodes)
+{
+  uint *stack, stack_default[KD_STACK_INIT];
+  uint stack_len_capacity, cur = 0;
+  uint subtree_len = 0;
+
+  if (node_index == KD_NODE_UNSET) {
+    return 0;
+  }
+
+  stack = stack_default;
+  stack_len_capacity = ARRAY_SIZE(stack_default);
+
+  stack[cur++] = node_index;
+
+  while (cur--) {
+    const KDTreeNode *node = &nodes[stack[cur]];
+
+    if (r_subtree_nodes) {
+      r_subtree_nodes[subtree_len] = stack[cur];
+    }
+    subtree_len++;
+
+    if (node->left != KD_NODE_UNSET) {
+      stack[cur++] = node->left;
+    }
+    if (node->right != KD_NODE_UNSET) {
+      stack[cur++] = node->right;
+    }
+
+    if (UNLIKELY(cur + KD_DIMS > stack_len_capacity)) {
+      stack = realloc_nodes(stack, &stack_len_capacity, stack_default != stack);
+    }
+  }
+
+  if (stack != stack_default) {
+    MEM_freeN(stack);
+  }
+
+  return subtree_len;
+}
+
+/**
+ * Balance the sub-tree starting at \a node_index in place, the nodes keep their slots.
+ *
+ * \return the new root of the sub-tree.
+ */
+static uint kdtree_balance_subtree(KDTreeNode *nodes, uint node_index, uint subtree_len)
+{
+  uint *subtree_nodes = MEM_mallocN(sizeof(uint) * subtree_len, __func__);
+  KDTreeNode *subtree = MEM_mallocN(sizeof(KDTreeNode) * subtree_len, __func__);
+  const uint axis = nodes[node_index].d;
+
+  kdtree_subtree_nodes(nodes, node_index, subtree_nodes);
+  for (uint i = 0; i < subtree_len; i++) {
+    subtree[i] = nodes[subtree_nodes[i]];
+    subtree[i].left = subtree[i].right = KD_NODE_UNSET;
+  }
+
+  const uint root = kdtree_balance(subtree, subtree_len, axis, 0);
+
+  for (uint i = 0; i < subtree_len; i++) {
+    KDTreeNode *node = &nodes[subtree_nodes[i]];
+    *node = subtree[i];
+    if (node->left != KD_NODE_UNSET) {
+      node->left = subtree_nodes[node->left];
+    }
+    if (node->right != KD_NODE_UNSET) {
+      node->right = subtree_nodes[node->right];
+    }
+  }
+
+  const uint root_index = subtree_nodes[root];
+  MEM_freeN(subtree_nodes);
+  MEM_freeN(subtree);
+  return root_index;
+}
+
+/**
+ * A new leaf is too deep, balance the lowest sub-tree on its path which is too high
+ * for its size (a 'scapegoat'), this brings the leaf depth back under the limit.
+ *
+ * \param path: The parents of \a node_index, starting from the root.
+ */
+static void kdtree_balance_scapegoat(KDTree *tree,
+                                     const uint *path,
+                                     const uint path_len,
+                                     const uint node_index)
+{
+  KDTreeNode *nodes = tree->nodes;
+  uint child = node_index;
+  uint child_len = 1;
+  uint i = path_len;
+
+  while (i--) {
+    const KDTreeNode *parent = &nodes[path[i]];
+    const uint sibling = (parent->left == child) ? parent->right : parent->left;
+    const uint parent_len = child_len + 1 + kdtree_subtree_nodes(nodes, sibling, NULL);
+    const uint height = path_len - i;
+
+    /* A sub-tree with weight balanced children has a height up to log(size) / log(3/2). */
+    if (i == 0 || (float)height > logf((float)parent_len) / logf(1.5f)) {
+      const uint root = kdtree_balance_subtree(nodes, path[i], parent_len);
+      if (i == 0) {
+        tree->root = root;
+      }
+      else {
+        KDTreeNode *grand_parent = &nodes[path[i - 1]];
+        if (grand_parent->left == path[i]) {
+          grand_parent->left = root;
+        }
+        else {
+          grand_parent->right = root;
+        }
+      }
+      return;
+    }
+
+    child = path[i];
+    child_len = parent_len;
+  }
+}
+
+/**
+ * Insert a point in a balanced tree, the tree can be searched right after.
+ * Unlike #BLI_kdtree_3d_insert, the tree grows when it is full.
+ */
+void BLI_kdtree_nd_(insert_dynamic)(KDTree *tree, int index, const float co[KD_DIMS])
+{
+  uint path[KD_STACK_INIT];
+  uint depth = 0;
+
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if (UNLIKELY(tree->nodes_len == tree->nodes_len_capacity)) {
+    tree->nodes_len_capacity = MAX2(tree->nodes_len_capacity * 2, 64u);
+    tree->nodes = MEM_reallocN(tree->nodes, sizeof(KDTreeNode) * tree->nodes_len_capacity);
+  }
+
+  const uint node_index = tree->nodes_len++;
+  KDTreeNode *node = &tree->nodes[node_index];
+  node->left = node->right = KD_NODE_UNSET;
+  copy_vn_vn(node->co, co);
+  node->index = index;
+  node->d = 0;
+
+  if (tree->root == KD_NODE_UNSET) {
+    tree->root = node_index;
+  }
+  else {
+    uint parent_index = tree->root;
+    while (true) {
+      KDTreeNode *parent = &tree->nodes[parent_index];
+      uint *child = (co[parent->d] < parent->co[parent->d]) ? &parent->left : &parent->right;
+      if (depth < ARRAY_SIZE(path)) {
+        path[depth] = parent_index;
+      }
+      depth++;
+      if (*child == KD_NODE_UNSET) {
+        *child = node_index;
+        node->d = (parent->d + 1) % KD_DIMS;
+        break;
+      }
+      parent_index = *child;
+    }
+  }
+
+  /* Balancing the sub-trees which get too deep keeps the depth under this limit,
+   * inserting sorted points would otherwise make long branches. */
+  const uint depth_max = 2 * log2_floor_u(tree->nodes_len) + 8;
+  if (UNLIKELY(depth > ARRAY_SIZE(path))) {
+    BLI_kdtree_nd_(balance)(tree);
+    return;
+  }
+  else if (depth > depth_max) {
+    kdtree_balance_scapegoat(tree, path, depth, node_index);
+  }
+
+  kdtree_update_done(tree);
+}
+
+/**
+ * Remove the point inserted with \a index and \a co from a balanced tree.
+ *
+ * \return false when the point isn't in the tree.
+ */
+bool BLI_kdtree_nd_(remove_dynamic)(KDTree *tree, int index, const float co[KD_DIMS])
+{
+  KDTreeNode *nodes = tree->nodes;
+  uint *stack, stack_default[KD_STACK_INIT];
+  uint stack_len_capacity, cur = 0;
+  KDTreeNode *found = NULL;
+
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+  BLI_assert(index != KD_INDEX_REMOVED);
+
+  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
+    return false;
+  }
+
+  stack = stack_default;
+  stack_len_capacity = ARRAY_SIZE(stack_default);
+
+  stack[cur++] = tree->root;
+
+  /* Points equal to a node on its axis can be on both sides of it. */
+  while (cur--) {
+    KDTreeNode *node = &nodes[stack[cur]];
+
+    if (node->index == index && len_squared_vnvn(node->co, co) == 0.0f) {
+      found = node;
+      break;
+    }
+
+    if (co[node->d] <= node->co[node->d]) {
+      if (node->left != KD_NODE_UNSET) {
+        stack[cur++] = node->left;
+      }
+    }
+    if (co[node->d] >= node->co[node->d]) {
+      if (node->right != KD_NODE_UNSET) {
+        stack[cur++] = node->right;
+      }
+    }
+
+    if (UNLIKELY(cur + KD_DIMS > stack_len_capacity)) {
+      stack = realloc_nodes(stack, &stack_len_capacity, stack_default != stack);
+    }
+  }
+
+  if (stack != stack_default) {
+    MEM_freeN(stack);
+  }
+
+  if (found == NULL) {
+    return false;
+  }
+
+  found->index = KD_INDEX_REMOVED;
+  tree->nodes_removed_len++;
+  kdtree_update_done(tree);
+  return true;
+}
+
+/** \} */
+
 /**
  * Find nearest returns index, and -1 if no node is found.
  */
@@ -255,8 +676,14 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
   stack_len_capacity = KD_STACK_INIT;
 
   root = &nodes[tree->root];
-  min_node = root;
-  min_dist = len_squared_vnvn(root->co, co);
+  if (root->index != KD_INDEX_REMOVED) {
+    min_node = root;
+    min_dist = len_squared_vnvn(root->co, co);
+  }
+  else {
+    min_node = NULL;
+    min_dist = FLT_MAX;
+  }
 
   if (co[root->d] < root->co[root->d]) {
     if (root->right != KD_NODE_UNSET) {
@@ -285,7 +712,7 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
 
       if (-cur_dist < min_dist) {
         cur_dist = len_squared_vnvn(node->co, co);
-        if (cur_dist < min_dist) {
+        if (cur_dist < min_dist && node->index != KD_INDEX_REMOVED) {
           min_dist = cur_dist;
           min_node = node;
         }
@@ -302,7 +729,7 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
 
       if (cur_dist < min_dist) {
         cur_dist = len_squared_vnvn(node->co, co);
-        if (cur_dist < min_dist) {
+        if (cur_dist < min_dist && node->index != KD_INDEX_REMOVED) {
           min_dist = cur_dist;
           min_node = node;
         }
@@ -319,16 +746,20 @@ int BLI_kdtree_nd_(find_nearest)(const KDTree *tree,
     }
   }
 
+  if (stack != stack_default) {
+    MEM_freeN(stack);
+  }
+
+  if (UNLIKELY(min_node == NULL)) {
+    return -1;
+  }
+
   if (r_nearest) {
     r_nearest->index = min_node->index;
     r_nearest->dist = sqrtf(min_dist);
     copy_vn_vn(r_nearest->co, min_node->co);
   }
 
-  if (stack != stack_default) {
-    MEM_freeN(stack);
-  }
-
   return min_node->index;
 }
 
@@ -367,7 +798,7 @@ int BLI_kdtree_nd_(find_nearest_cb)(
 #define NODE_TEST_NEAREST(node) \
   { \
     const float dist_sq = len_squared_vnvn((node)->co, co); \
-    if (dist_sq < min_dist) { \
+    if (dist_sq < min_dist && (node)->index != KD_INDEX_REMOVED) { \
       const int result = filter_cb(user_data, (node)->index, (node)->co, dist_sq); \
       if (result == 1) { \
         min_dist = dist_sq; \
@@ -512,9 +943,11 @@ int BLI_kdtree_nd_(find_nearest_n_with_len_squared_cb)(
 
   root = &nodes[tree->root];
 
-  cur_dist = len_sq_fn(co, root->co, user_data);
-  nearest_ordered_insert(
-      r_nearest, &nearest_len, nearest_len_capacity, root->index, cur_dist, root->co);
+  if (root->index != KD_INDEX_REMOVED) {
+    cur_dist = len_sq_fn(co, root->co, user_data);
+    nearest_ordered_insert(
+        r_nearest, &nearest_len, nearest_len_capacity, root->index, cur_dist, root->co);
+  }
 
   if (co[root->d] < root->co[root->d]) {
     if (root->right != KD_NODE_UNSET) {
@@ -544,7 +977,11 @@ int BLI_kdtree_nd_(find_nearest_n_with_len_squared_cb)(
       if (nearest_len < nearest_len_capacity || -cur_dist < r_nearest[nearest_len - 1].dist) {
         cur_dist = len_sq_fn(co, node->co, user_data);
 
-        if (nearest_len < nearest_len_capacity || cur_dist < r_nearest[nearest_len - 1].dist) {
+        if (node->index == KD_INDEX_REMOVED) {
+          /* pass */
+        }
+        else if (nearest_len < nearest_len_capacity ||
+                 cur_dist < r_nearest[nearest_len - 1].dist) {
           nearest_ordered_insert(
               r_nearest, &nearest_len, nearest_len_capacity, node->index, cur_dist, node->co);
         }
@@ -562,7 +999,11 @@ int BLI_kdtree_nd_(find_nearest_n_with_len_squared_cb)(
 
       if (nearest_len < nearest_len_capacity || cur_dist < r_nearest[nearest_len - 1].dist) {
         cur_dist = len_sq_fn(co, node->co, user_data);
-        if (nearest_len < nearest_len_capacity || cur_dist < r_nearest[nearest_len - 1].dist) {
+        if (node->index == KD_INDEX_REMOVED) {
+          /* pass */
+        }
+        else if (nearest_len < nearest_len_capacity ||
+                 cur_dist < r_nearest[nearest_len - 1].dist) {
           nearest_ordered_insert(
               r_nearest, &nearest_len, nearest_len_capacity, node->index, cur_dist, node->co);
         }
@@ -692,7 +1133,7 @@ int BLI_kdtree_nd_(range_search_with_len_squared_cb)(
     }
     else {
       dist_sq = len_sq_fn(co, node->co, user_data);
-      if (dist_sq <= range_sq) {
+      if (dist_sq <= range_sq && node->index != KD_INDEX_REMOVED) {
         nearest_add_in_range(
             &nearest, nearest_len++, &nearest_len_capacity, node->index, dist_sq, node->co);
       }
@@ -781,7 +1222,7 @@ void BLI_kdtree_nd_(range_search_cb)(
     }
     else {
       dist_sq = len_squared_vnvn(node->co, co);
-      if (dist_sq <= range_sq) {
+      if (dist_sq <= range_sq && node->index != KD_INDEX_REMOVED) {
         if (search_cb(user_data, node->index, node->co, dist_sq) == false) {
           goto finally;
         }
@@ -806,6 +1247,259 @@ finally:
   }
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Batched Searches
+ *
+ * Search many points at once from multiple threads. The points are first ordered by the leaf
+ * where their search starts, so each thread searches close points one after the other and keeps
+ * visiting the same nodes.
+ * \{ */
+
+typedef struct KDTreeBatchData {
+  const KDTree *tree;
+  const float (*co)[KD_DIMS];
+  uint *order;
+  uint co_len;
+
+  KDTreeNearest *nearest;
+  KDTreeNearest **nearest_range;
+  int *nearest_len;
+  uint nearest_len_capacity;
+  float range;
+} KDTreeBatchData;
+
+/**
+ * Balanced nodes are stored in the order of a depth first traversal of the tree,
+ * so the index of the leaf where a search starts locates the point in the tree.
+ */
+static uint kdtree_search_start(const KDTree *tree, const float co[KD_DIMS])
+{
+  const KDTreeNode *nodes = tree->nodes;
+  uint node_index = tree->root;
+  while (true) {
+    const KDTreeNode *node = &nodes[node_index];
+    const uint child = (co[node->d] < node->co[node->d]) ? node->left : node->right;
+    if (child == KD_NODE_UNSET) {
+      return node_index;
+    }
+    node_index = child;
+  }
+}
+
+static void kdtree_batch_start_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBatchData *data = userdata;
+  /* The order array is used to store the start nodes before sorting. */
+  data->order[i] = kdtree_search_start(data->tree, data->co[i]);
+}
+
+/**
+ * \return the indices of the points, sorted by where they are in the tree.
+ */
+static uint *kdtree_batch_order(const KDTree *tree, const float (*co)[KD_DIMS], uint co_len)
+{
+  uint *start = MEM_mallocN(sizeof(uint) * co_len, __func__);
+  uint *order = MEM_mallocN(sizeof(uint) * co_len, __func__);
+
+  KDTreeBatchData data = {
+      .tree = tree,
+      .co = co,
+      .order = start,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (co_len > KD_BATCH_CHUNK_SIZE);
+  settings.min_iter_per_thread = KD_BATCH_CHUNK_SIZE;
+  BLI_task_parallel_range(0, (int)co_len, &data, kdtree_batch_start_cb, &settings);
+
+  /* Counting sort on the start nodes, with at most as many buckets as points. */
+  const uint buckets_len = MIN2(tree->nodes_len, co_len);
+  uint *buckets = MEM_calloc_arrayN(buckets_len + 1, sizeof(uint), __func__);
+  for (uint i = 0; i < co_len; i++) {
+    start[i] = (uint)(((uint64_t)start[i] * buckets_len) / tree->nodes_len);
+    buckets[start[i] + 1]++;
+  }
+  for (uint i = 1; i <= buckets_len; i++) {
+    buckets[i] += buckets[i - 1];
+  }
+  for (uint i = 0; i < co_len; i++) {
+    order[buckets[start[i]]++] = i;
+  }
+
+  MEM_freeN(buckets);
+  MEM_freeN(start);
+
+  return order;
+}
+
+static void kdtree_batch_search(const KDTree *tree,
+                                const float (*co)[KD_DIMS],
+                                uint co_len,
+                                KDTreeBatchData *data,
+                                TaskParallelRangeFunc func)
+{
+  data->tree = tree;
+  data->co = co;
+  data->co_len = co_len;
+  data->order = kdtree_batch_order(tree, co, co_len);
+
+  const uint chunks_len = (co_len + KD_BATCH_CHUNK_SIZE - 1) / KD_BATCH_CHUNK_SIZE;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (chunks_len > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, (int)chunks_len, data, func, &settings);
+
+  MEM_freeN(data->order);
+}
+
+static void kdtree_find_nearest_batch_cb(void *__restrict userdata,
+                                         const int chunk,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBatchData *data = userdata;
+  const uint start = (uint)chunk * KD_BATCH_CHUNK_SIZE;
+  const uint end = MIN2(start + KD_BATCH_CHUNK_SIZE, data->co_len);
+  for (uint j = start; j < end; j++) {
+    const uint i = data->order[j];
+    if (BLI_kdtree_nd_(find_nearest)(data->tree, data->co[i], &data->nearest[i]) == -1) {
+      data->nearest[i].index = -1;
+    }
+  }
+}
+
+/**
+ * Find the nearest point of every point of \a co, using multiple threads.
+ *
+ * \param r_nearest: An array of \a co_len nearest, the index is -1 when no point is found.
+ */
+void BLI_kdtree_nd_(find_nearest_batch)(const KDTree *tree,
+                                        const float (*co)[KD_DIMS],
+                                        uint co_len,
+                                        KDTreeNearest *r_nearest)
+{
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
+    for (uint i = 0; i < co_len; i++) {
+      r_nearest[i].index = -1;
+    }
+    return;
+  }
+
+  KDTreeBatchData data = {
+      .nearest = r_nearest,
+  };
+  kdtree_batch_search(tree, co, co_len, &data, kdtree_find_nearest_batch_cb);
+}
+
+static void kdtree_find_nearest_n_batch_cb(void *__restrict userdata,
+                                           const int chunk,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBatchData *data = userdata;
+  const uint start = (uint)chunk * KD_BATCH_CHUNK_SIZE;
+  const uint end = MIN2(start + KD_BATCH_CHUNK_SIZE, data->co_len);
+  for (uint j = start; j < end; j++) {
+    const uint i = data->order[j];
+    data->nearest_len[i] = BLI_kdtree_nd_(find_nearest_n)(
+        data->tree,
+        data->co[i],
+        &data->nearest[(size_t)i * data->nearest_len_capacity],
+        data->nearest_len_capacity);
+  }
+}
+
+/**
+ * Find the \a nearest_len_capacity nearest points of every point of \a co,
+ * using multiple threads.
+ *
+ * \param r_nearest: An array of \a co_len * \a nearest_len_capacity nearest,
+ * the results of each point start at its index times \a nearest_len_capacity.
+ * \param r_nearest_len: An array of \a co_len, the number of points found for each point.
+ */
+void BLI_kdtree_nd_(find_nearest_n_batch)(const KDTree *tree,
+                                          const float (*co)[KD_DIMS],
+                                          uint co_len,
+                                          KDTreeNearest *r_nearest,
+                                          const uint nearest_len_capacity,
+                                          int *r_nearest_len)
+{
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
+    for (uint i = 0; i < co_len; i++) {
+      r_nearest_len[i] = 0;
+    }
+    return;
+  }
+
+  KDTreeBatchData data = {
+      .nearest = r_nearest,
+      .nearest_len = r_nearest_len,
+      .nearest_len_capacity = nearest_len_capacity,
+  };
+  kdtree_batch_search(tree, co, co_len, &data, kdtree_find_nearest_n_batch_cb);
+}
+
+static void kdtree_range_search_batch_cb(void *__restrict userdata,
+                                         const int chunk,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KDTreeBatchData *data = userdata;
+  const uint start = (uint)chunk * KD_BATCH_CHUNK_SIZE;
+  const uint end = MIN2(start + KD_BATCH_CHUNK_SIZE, data->co_len);
+  for (uint j = start; j < end; j++) {
+    const uint i = data->order[j];
+    data->nearest_len[i] = BLI_kdtree_nd_(range_search)(
+        data->tree, data->co[i], &data->nearest_range[i], data->range);
+  }
+}
+
+/**
+ * Range search of every point of \a co, using multiple threads.
+ *
+ * \param r_nearest: An array of \a co_len arrays of nearest, sorted by distance
+ * (caller is responsible for freeing them, they are NULL when no point is found).
+ * \param r_nearest_len: An array of \a co_len, the number of points found for each point.
+ */
+void BLI_kdtree_nd_(range_search_batch)(const KDTree *tree,
+                                        const float (*co)[KD_DIMS],
+                                        uint co_len,
+                                        const float range,
+                                        KDTreeNearest **r_nearest,
+                                        int *r_nearest_len)
+{
+#ifdef DEBUG
+  BLI_assert(tree->is_balanced == true);
+#endif
+
+  if (UNLIKELY(tree->root == KD_NODE_UNSET)) {
+    for (uint i = 0; i < co_len; i++) {
+      r_nearest[i] = NULL;
+      r_nearest_len[i] = 0;
+    }
+    return;
+  }
+
+  KDTreeBatchData data = {
+      .nearest_range = r_nearest,
+      .nearest_len = r_nearest_len,
+      .range = range,
+  };
+  kdtree_batch_search(tree, co, co_len, &data, kdtree_range_search_batch_cb);
+}
+
+/** \} */
+
 /**
  * Use when we want to loop over nodes ordered by index.
  * Requires indices to be aligned with nodes.
@@ -851,7 +1545,8 @@ static void deduplicate_recursive(const struct DeDuplicateParams *p, uint i)
     }
   }
   else {
-    if ((p->search != node->index) && (p->duplicates[node->index] == -1)) {
+    if ((node->index != KD_INDEX_REMOVED) && (p->search != node->index) &&
+        (p->duplicates[node->index] == -1)) {
       if (len_squared_vnvn(node->co, p->search_co) <= p->range_sq) {
         p->duplicates[node->index] = (int)p->search;
         *p->duplicates_found += 1;
@@ -899,6 +1594,8 @@ int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
   };
 
   if (use_index_order) {
+    /* Removed nodes leave holes in the indices. */
+    BLI_assert(tree->nodes_removed_len == 0);
     uint *order = kdtree_order(tree);
     for (uint i = 0; i < tree->nodes_len; i++) {
       const uint node_index = order[i];
@@ -920,6 +1617,9 @@ int BLI_kdtree_nd_(calc_duplicates_fast)(const KDTree *tree,
     for (uint i = 0; i < tree->nodes_len; i++) {
       const uint node_index = i;
       const int index = p.nodes[node_index].index;
+      if (index == KD_INDEX_REMOVED) {
+        continue;
+      }
       if (ELEM(duplicates[index], -1, index)) {
         p.search = index;
         copy_vn_vn(p.search_co, tree->nodes[node_index].co);
@@ -976,6 +1676,9 @@ int BLI_kdtree_nd_(deduplicate)(KDTree *tree)
 #ifdef DEBUG
   tree->is_balanced = false;
 #endif
+  if (tree->nodes_removed_len != 0) {
+    kdtree_remove_tagged(tree);
+  }
   qsort(tree->nodes, (size_t)tree->nodes_len, sizeof(*tree->nodes), kdtree_node_cmp_deduplicate);
   uint j = 0;
   for (uint i = 0; i < tree->nodes_len; i++) {
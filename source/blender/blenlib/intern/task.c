@@ -160,9 +160,15 @@ typedef struct TaskThreadLocalStorage {
 struct TaskPool {
   TaskScheduler *scheduler;
 
-  volatile size_t num;
+  /* Number of pushed tasks which are not done yet, updated atomically. */
+  size_t num;
   ThreadMutex num_mutex;
   ThreadCondition num_cond;
+  /* Number of threads waiting on num_cond in work_and_wait(), and number of pushes to the
+   * scheduler queues. A waiting thread is only woken up by a push when it may have missed the
+   * pushed task while looking for work. */
+  int num_waiting;
+  uint32_t num_pushed;
 
   void *userdata;
   ThreadMutex user_mutex;
@@ -201,15 +207,47 @@ struct TaskPool {
 #endif
 };
 
+/* Queue of the tasks pushed by a thread.
+ *
+ * Each thread pushes its tasks to its own queue and takes the next task to run from the head
+ * of it, an idle thread steals tasks from the tail of the queues of the other threads. Every
+ * queue has its own lock so the threads only contend when they access the same queue, instead
+ * of all of them contending on a single scheduler queue.
+ *
+ * The tasks pushed with TASK_PRIORITY_HIGH go to a queue shared by all the threads, which they
+ * check before their own queue, so the high priority tasks run before the others across the
+ * scheduler.
+ *
+ * The queues are lists so that the tasks of a pool can be found and removed by
+ * work_and_wait() and cancel(), which only handle the tasks of their pool.
+ */
+typedef struct TaskQueue {
+  SpinLock lock;
+  ListBase tasks;
+  /* Number of tasks in the queue, read without lock to skip the empty queues. */
+  volatile int num_tasks;
+} TaskQueue;
+
 struct TaskScheduler {
   pthread_t *threads;
   struct TaskThread *task_threads;
   int num_threads;
   bool background_thread_only;
 
-  ListBase queue;
-  ThreadMutex queue_mutex;
-  ThreadCondition queue_cond;
+  /* Tasks pushed with TASK_PRIORITY_HIGH, shared by all the threads. */
+  TaskQueue high_queue;
+
+  /* Number of tasks in all the queues, and of the tasks of the background pools.
+   * The counters are increased before the tasks are added to the queues and decreased after
+   * they are removed, so they are never lower than the actual number of queued tasks.
+   */
+  int num_queued;
+  int num_queued_background;
+
+  /* Worker threads wait on the condition when they found no task to run. */
+  ThreadMutex sleep_mutex;
+  ThreadCondition sleep_cond;
+  int num_sleeping;
 
   ThreadMutex startup_mutex;
   ThreadCondition startup_cond;
@@ -225,6 +263,9 @@ typedef struct TaskThread {
   TaskScheduler *scheduler;
   int id;
   TaskThreadLocalStorage tls;
+  /* Tasks pushed by this thread, the main thread and the threads unknown to the scheduler
+   * share the queue of ID 0. */
+  TaskQueue queue;
 } TaskThread;
 
 /* Helper */
@@ -330,78 +371,190 @@ static void task_free(TaskPool *pool, Task *task, const int thread_id)
 
 static void task_pool_num_decrease(TaskPool *pool, size_t done)
 {
+  size_t num = atomic_add_and_fetch_z(&pool->num, 0);
+  BLI_assert(num >= done);
+
+  /* Tasks remain, no thread can be woken up by the decrease. */
+  while (num > done) {
+    const size_t prev_num = atomic_cas_z(&pool->num, num, num - done);
+    if (prev_num == num) {
+      return;
+    }
+    num = prev_num;
+  }
+
+  /* The last tasks are done, the pool can be freed as soon as the mutex is released so the
+   * decrease and the notification are done with the mutex locked. */
   BLI_mutex_lock(&pool->num_mutex);
+  atomic_sub_and_fetch_z(&pool->num, done);
+  BLI_condition_notify_all(&pool->num_cond);
+  BLI_mutex_unlock(&pool->num_mutex);
+}
 
-  BLI_assert(pool->num >= done);
+static void task_pool_num_increase(TaskPool *pool, size_t new)
+{
+  atomic_add_and_fetch_z(&pool->num, new);
+}
 
-  pool->num -= done;
+/* Called once pushed tasks are in a scheduler queue and the queue is unlocked, wakes up the
+ * thread of work_and_wait() which may have missed them. The pusher must hold an extra count of
+ * the pool tasks so that the pool isn't freed if the pushed tasks are already done, it is
+ * released here. */
+static void task_pool_notify_pushed(TaskPool *pool)
+{
+  atomic_add_and_fetch_uint32(&pool->num_pushed, 1);
 
-  if (pool->num == 0) {
+  if (atomic_add_and_fetch_int32(&pool->num_waiting, 0) > 0) {
+    BLI_mutex_lock(&pool->num_mutex);
     BLI_condition_notify_all(&pool->num_cond);
+    BLI_mutex_unlock(&pool->num_mutex);
   }
 
-  BLI_mutex_unlock(&pool->num_mutex);
+  task_pool_num_decrease(pool, 1);
 }
 
-static void task_pool_num_increase(TaskPool *pool, size_t new)
+BLI_INLINE TaskQueue *task_scheduler_queue(TaskScheduler *scheduler, const int thread_id)
 {
-  BLI_mutex_lock(&pool->num_mutex);
+  return &scheduler->task_threads[thread_id].queue;
+}
 
-  pool->num += new;
-  BLI_condition_notify_all(&pool->num_cond);
+/* ID of the calling thread, 0 for the main thread and the threads unknown to the scheduler. */
+static int task_scheduler_current_thread_id(TaskScheduler *scheduler)
+{
+  TaskThread *thread = pthread_getspecific(scheduler->tls_id_key);
+  return (thread != NULL) ? thread->id : 0;
+}
 
-  BLI_mutex_unlock(&pool->num_mutex);
+static void task_scheduler_queued_add(TaskScheduler *scheduler, TaskPool *pool, int num_tasks)
+{
+  atomic_add_and_fetch_int32(&scheduler->num_queued, num_tasks);
+  if (pool->run_in_background) {
+    atomic_add_and_fetch_int32(&scheduler->num_queued_background, num_tasks);
+  }
 }
 
-static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler, Task **task)
+/* Wake up sleeping worker threads after tasks were added to a queue. */
+static void task_scheduler_wake(TaskScheduler *scheduler, const bool all)
 {
-  bool found_task = false;
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  if (atomic_add_and_fetch_int32(&scheduler->num_sleeping, 0) == 0) {
+    return;
+  }
+
+  BLI_mutex_lock(&scheduler->sleep_mutex);
+  if (all) {
+    BLI_condition_notify_all(&scheduler->sleep_cond);
+  }
+  else {
+    BLI_condition_notify_one(&scheduler->sleep_cond);
+  }
+  BLI_mutex_unlock(&scheduler->sleep_mutex);
+}
 
-  while (!scheduler->queue.first && !scheduler->do_exit) {
-    BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+/* Remove a task from a queue, from its tail when stealing it from another thread.
+ * When a pool is given only its tasks are considered, else if background_only is set only the
+ * tasks of the background pools are.
+ */
+static Task *task_queue_pop(TaskScheduler *scheduler,
+                            TaskQueue *queue,
+                            TaskPool *pool,
+                            const bool background_only,
+                            const bool steal)
+{
+  if (queue->num_tasks == 0) {
+    return NULL;
   }
 
-  do {
-    Task *current_task;
+  Task *task = NULL;
 
-    /* Assuming we can only have a void queue in 'exit' case here seems logical
-     * (we should only be here after our worker thread has been woken up from a
-     * condition_wait(), which only happens after a new task was added to the queue),
-     * but it is wrong.
-     * Waiting on condition may wake up the thread even if condition is not signaled
-     * (spurious wake-ups), and some race condition may also empty the queue **after**
-     * condition has been signaled, but **before** awoken thread reaches this point...
-     * See http://stackoverflow.com/questions/8594591
-     *
-     * So we only abort here if do_exit is set.
-     */
-    if (scheduler->do_exit) {
-      BLI_mutex_unlock(&scheduler->queue_mutex);
-      return false;
+  BLI_spin_lock(&queue->lock);
+
+  if (pool != NULL) {
+    for (task = queue->tasks.first; task != NULL && task->pool != pool; task = task->next) {
+      /* Pass. */
+    }
+  }
+  else if (background_only) {
+    for (task = queue->tasks.first; task != NULL && !task->pool->run_in_background;
+         task = task->next) {
+      /* Pass. */
     }
+  }
+  else {
+    task = steal ? queue->tasks.last : queue->tasks.first;
+  }
+
+  if (task != NULL) {
+    BLI_remlink(&queue->tasks, task);
+    queue->num_tasks--;
+  }
 
-    for (current_task = scheduler->queue.first; current_task != NULL;
-         current_task = current_task->next) {
-      TaskPool *pool = current_task->pool;
+  BLI_spin_unlock(&queue->lock);
 
-      if (scheduler->background_thread_only && !pool->run_in_background) {
-        continue;
-      }
+  if (task != NULL) {
+    task_scheduler_queued_add(scheduler, task->pool, -1);
+  }
 
-      *task = current_task;
-      found_task = true;
-      BLI_remlink(&scheduler->queue, *task);
-      break;
+  return task;
+}
+
+/* Get a high priority task, a task from the queue of the thread, or steal one from the other
+ * threads. */
+static Task *task_scheduler_get(TaskScheduler *scheduler,
+                                TaskPool *pool,
+                                const int thread_id,
+                                const bool background_only)
+{
+  Task *task = task_queue_pop(scheduler, &scheduler->high_queue, pool, background_only, false);
+  if (task != NULL) {
+    return task;
+  }
+
+  task = task_queue_pop(
+      scheduler, task_scheduler_queue(scheduler, thread_id), pool, background_only, false);
+  if (task != NULL) {
+    return task;
+  }
+
+  /* Start with the next thread so that the thieves don't all hit the same queue first. */
+  const int num_queues = scheduler->num_threads + 1;
+  for (int i = 1; i < num_queues; i++) {
+    TaskQueue *queue = task_scheduler_queue(scheduler, (thread_id + i) % num_queues);
+    task = task_queue_pop(scheduler, queue, pool, background_only, true);
+    if (task != NULL) {
+      return task;
     }
-    if (!found_task) {
-      BLI_condition_wait(&scheduler->queue_cond, &scheduler->queue_mutex);
+  }
+
+  return NULL;
+}
+
+static bool task_scheduler_thread_wait_pop(TaskScheduler *scheduler,
+                                           const int thread_id,
+                                           Task **task)
+{
+  const bool background_only = scheduler->background_thread_only;
+  int *num_queued = background_only ? &scheduler->num_queued_background :
+                                      &scheduler->num_queued;
+
+  while (!scheduler->do_exit) {
+    *task = task_scheduler_get(scheduler, NULL, thread_id, background_only);
+    if (*task != NULL) {
+      return true;
     }
-  } while (!found_task);
 
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+    /* The queued tasks counter is increased before the sleeping threads are checked by a push,
+     * and the sleeping threads counter before the queued tasks are checked here, so either the
+     * push wakes this thread up or this thread sees the pushed task. */
+    BLI_mutex_lock(&scheduler->sleep_mutex);
+    atomic_add_and_fetch_int32(&scheduler->num_sleeping, 1);
+    while (atomic_add_and_fetch_int32(num_queued, 0) == 0 && !scheduler->do_exit) {
+      BLI_condition_wait(&scheduler->sleep_cond, &scheduler->sleep_mutex);
+    }
+    atomic_sub_and_fetch_int32(&scheduler->num_sleeping, 1);
+    BLI_mutex_unlock(&scheduler->sleep_mutex);
+  }
 
-  return true;
+  return false;
 }
 
 BLI_INLINE void handle_local_queue(TaskThreadLocalStorage *tls, const int thread_id)
@@ -442,7 +595,7 @@ static void *task_scheduler_thread_run(void *thread_p)
   BLI_mutex_unlock(&scheduler->startup_mutex);
 
   /* keep popping off tasks */
-  while (task_scheduler_thread_wait_pop(scheduler, &task)) {
+  while (task_scheduler_thread_wait_pop(scheduler, thread_id, &task)) {
     TaskPool *pool = task->pool;
 
     /* run task */
@@ -463,6 +616,22 @@ static void *task_scheduler_thread_run(void *thread_p)
   return NULL;
 }
 
+static void task_queue_init(TaskQueue *queue)
+{
+  BLI_spin_init(&queue->lock);
+  BLI_listbase_clear(&queue->tasks);
+  queue->num_tasks = 0;
+}
+
+static void task_queue_free(TaskQueue *queue)
+{
+  for (Task *task = queue->tasks.first; task; task = task->next) {
+    task_data_free(task, 0);
+  }
+  BLI_freelistN(&queue->tasks);
+  BLI_spin_end(&queue->lock);
+}
+
 TaskScheduler *BLI_task_scheduler_create(int num_threads)
 {
   TaskScheduler *scheduler = MEM_callocN(sizeof(TaskScheduler), "TaskScheduler");
@@ -471,9 +640,11 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
    * threads, so we keep track of the number of users. */
   scheduler->do_exit = false;
 
-  BLI_listbase_clear(&scheduler->queue);
-  BLI_mutex_init(&scheduler->queue_mutex);
-  BLI_condition_init(&scheduler->queue_cond);
+  scheduler->num_queued = 0;
+  scheduler->num_queued_background = 0;
+  scheduler->num_sleeping = 0;
+  BLI_mutex_init(&scheduler->sleep_mutex);
+  BLI_condition_init(&scheduler->sleep_cond);
 
   BLI_mutex_init(&scheduler->startup_mutex);
   BLI_condition_init(&scheduler->startup_cond);
@@ -496,6 +667,12 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
   scheduler->task_threads = MEM_mallocN(sizeof(TaskThread) * (num_threads + 1),
                                         "TaskScheduler task threads");
 
+  /* Initialize the queues before any thread starts stealing from them. */
+  task_queue_init(&scheduler->high_queue);
+  for (int i = 0; i < num_threads + 1; i++) {
+    task_queue_init(&scheduler->task_threads[i].queue);
+  }
+
   /* Initialize TLS for main thread. */
   initialize_task_tls(&scheduler->task_threads[0].tls);
 
@@ -536,13 +713,11 @@ TaskScheduler *BLI_task_scheduler_create(int num_threads)
 
 void BLI_task_scheduler_free(TaskScheduler *scheduler)
 {
-  Task *task;
-
   /* stop all waiting threads */
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  BLI_mutex_lock(&scheduler->sleep_mutex);
   scheduler->do_exit = true;
-  BLI_condition_notify_all(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  BLI_condition_notify_all(&scheduler->sleep_cond);
+  BLI_mutex_unlock(&scheduler->sleep_mutex);
 
   pthread_key_delete(scheduler->tls_id_key);
 
@@ -559,25 +734,22 @@ void BLI_task_scheduler_free(TaskScheduler *scheduler)
     MEM_freeN(scheduler->threads);
   }
 
-  /* Delete task thread data */
+  /* Delete task thread data and leftover tasks. */
   if (scheduler->task_threads) {
     for (int i = 0; i < scheduler->num_threads + 1; i++) {
       TaskThreadLocalStorage *tls = &scheduler->task_threads[i].tls;
       free_task_tls(tls);
+
+      task_queue_free(&scheduler->task_threads[i].queue);
     }
 
     MEM_freeN(scheduler->task_threads);
   }
-
-  /* delete leftover tasks */
-  for (task = scheduler->queue.first; task; task = task->next) {
-    task_data_free(task, 0);
-  }
-  BLI_freelistN(&scheduler->queue);
+  task_queue_free(&scheduler->high_queue);
 
   /* delete mutex/condition */
-  BLI_mutex_end(&scheduler->queue_mutex);
-  BLI_condition_end(&scheduler->queue_cond);
+  BLI_mutex_end(&scheduler->sleep_mutex);
+  BLI_condition_end(&scheduler->sleep_cond);
   BLI_mutex_end(&scheduler->startup_mutex);
   BLI_condition_end(&scheduler->startup_cond);
 
@@ -589,68 +761,104 @@ int BLI_task_scheduler_num_threads(TaskScheduler *scheduler)
   return scheduler->num_threads + 1;
 }
 
-static void task_scheduler_push(TaskScheduler *scheduler, Task *task, TaskPriority priority)
+static void task_scheduler_push(TaskScheduler *scheduler,
+                                Task *task,
+                                TaskPriority priority,
+                                int thread_id)
 {
-  task_pool_num_increase(task->pool, 1);
+  TaskPool *pool = task->pool;
 
-  /* add task to queue */
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  if (thread_id == -1) {
+    thread_id = task_scheduler_current_thread_id(scheduler);
+  }
+
+  /* One more count keeps the pool alive until task_pool_notify_pushed(). */
+  task_pool_num_increase(pool, 2);
+  task_scheduler_queued_add(scheduler, pool, 1);
 
+  /* add task to queue */
   if (priority == TASK_PRIORITY_HIGH) {
-    BLI_addhead(&scheduler->queue, task);
+    TaskQueue *queue = &scheduler->high_queue;
+    BLI_spin_lock(&queue->lock);
+    BLI_addhead(&queue->tasks, task);
+    queue->num_tasks++;
+    BLI_spin_unlock(&queue->lock);
   }
   else {
-    BLI_addtail(&scheduler->queue, task);
+    TaskQueue *queue = task_scheduler_queue(scheduler, thread_id);
+    BLI_spin_lock(&queue->lock);
+    BLI_addtail(&queue->tasks, task);
+    queue->num_tasks++;
+    BLI_spin_unlock(&queue->lock);
   }
 
-  BLI_condition_notify_one(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  task_pool_notify_pushed(pool);
+  task_scheduler_wake(scheduler, false);
 }
 
-static void task_scheduler_push_all(TaskScheduler *scheduler,
-                                    TaskPool *pool,
-                                    Task **tasks,
-                                    int num_tasks)
+static void task_scheduler_push_all(
+    TaskScheduler *scheduler, TaskPool *pool, Task **tasks, int num_tasks, const int thread_id)
 {
   if (num_tasks == 0) {
     return;
   }
 
-  task_pool_num_increase(pool, num_tasks);
+  /* One more count keeps the pool alive until task_pool_notify_pushed(). */
+  task_pool_num_increase(pool, num_tasks + 1);
+  task_scheduler_queued_add(scheduler, pool, num_tasks);
 
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  TaskQueue *queue = task_scheduler_queue(scheduler, thread_id);
+  BLI_spin_lock(&queue->lock);
 
   for (int i = 0; i < num_tasks; i++) {
-    BLI_addhead(&scheduler->queue, tasks[i]);
+    BLI_addhead(&queue->tasks, tasks[i]);
   }
+  queue->num_tasks += num_tasks;
+
+  BLI_spin_unlock(&queue->lock);
 
-  BLI_condition_notify_all(&scheduler->queue_cond);
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+  task_pool_notify_pushed(pool);
+  task_scheduler_wake(scheduler, true);
 }
 
-static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
+/* Remove the tasks of a pool from a queue, return the number of removed tasks. */
+static int task_queue_clear(TaskQueue *queue, TaskPool *pool)
 {
   Task *task, *nexttask;
-  size_t done = 0;
+  int num_removed = 0;
 
-  BLI_mutex_lock(&scheduler->queue_mutex);
+  BLI_spin_lock(&queue->lock);
 
-  /* free all tasks from this pool from the queue */
-  for (task = scheduler->queue.first; task; task = nexttask) {
+  for (task = queue->tasks.first; task; task = nexttask) {
     nexttask = task->next;
 
     if (task->pool == pool) {
       task_data_free(task, pool->thread_id);
-      BLI_freelinkN(&scheduler->queue, task);
+      BLI_freelinkN(&queue->tasks, task);
 
-      done++;
+      num_removed++;
     }
   }
+  queue->num_tasks -= num_removed;
+
+  BLI_spin_unlock(&queue->lock);
+
+  return num_removed;
+}
 
-  BLI_mutex_unlock(&scheduler->queue_mutex);
+static void task_scheduler_clear(TaskScheduler *scheduler, TaskPool *pool)
+{
+  /* free all tasks from this pool from the queues */
+  size_t done = task_queue_clear(&scheduler->high_queue, pool);
+  for (int i = 0; i < scheduler->num_threads + 1; i++) {
+    done += task_queue_clear(task_scheduler_queue(scheduler, i), pool);
+  }
+  task_scheduler_queued_add(scheduler, pool, -(int)done);
 
   /* notify done */
-  task_pool_num_decrease(pool, done);
+  if (done > 0) {
+    task_pool_num_decrease(pool, done);
+  }
 }
 
 /* Task Pool */
@@ -677,6 +885,8 @@ static TaskPool *task_pool_create_ex(TaskScheduler *scheduler,
 
   pool->scheduler = scheduler;
   pool->num = 0;
+  pool->num_waiting = 0;
+  pool->num_pushed = 0;
   pool->do_cancel = false;
   pool->do_work = false;
   pool->is_suspended = is_suspended;
@@ -841,7 +1051,7 @@ static void task_pool_push(TaskPool *pool,
     }
     /* If we are in the delayed tasks push mode, we push tasks to a
      * temporary local queue first without any locks, and then move them
-     * to global execution queue with a single lock.
+     * to the thread queue with a single lock.
      */
     if (tls->do_delayed_push && tls->num_delayed_queue < DELAYED_QUEUE_SIZE) {
       tls->delayed_queue[tls->num_delayed_queue] = task;
@@ -849,10 +1059,8 @@ static void task_pool_push(TaskPool *pool,
       return;
     }
   }
-  /* Do push to a global execution pool, slowest possible method,
-   * causes quite reasonable amount of threading overhead.
-   */
-  task_scheduler_push(pool->scheduler, task, priority);
+  /* Do push to the queue of the thread, the other threads have to steal the task from it. */
+  task_scheduler_push(pool->scheduler, task, priority, thread_id);
 }
 
 void BLI_task_pool_push_ex(TaskPool *pool,
@@ -888,13 +1096,18 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
   if (atomic_fetch_and_and_uint8((uint8_t *)&pool->is_suspended, 0)) {
     if (pool->num_suspended) {
+      const int num_suspended = (int)pool->num_suspended;
       task_pool_num_increase(pool, pool->num_suspended);
-      BLI_mutex_lock(&scheduler->queue_mutex);
+      task_scheduler_queued_add(scheduler, pool, num_suspended);
 
-      BLI_movelisttolist(&scheduler->queue, &pool->suspended_queue);
+      /* Put the tasks at the head of the queue, this thread looks for them first. */
+      TaskQueue *queue = task_scheduler_queue(scheduler, pool->thread_id);
+      BLI_spin_lock(&queue->lock);
+      BLI_movelisttolist_reverse(&queue->tasks, &pool->suspended_queue);
+      queue->num_tasks += num_suspended;
+      BLI_spin_unlock(&queue->lock);
 
-      BLI_condition_notify_all(&scheduler->queue_cond);
-      BLI_mutex_unlock(&scheduler->queue_mutex);
+      task_scheduler_wake(scheduler, true);
 
       pool->num_suspended = 0;
     }
@@ -906,57 +1119,44 @@ void BLI_task_pool_work_and_wait(TaskPool *pool)
 
   handle_local_queue(tls, pool->thread_id);
 
-  BLI_mutex_lock(&pool->num_mutex);
-
-  while (pool->num != 0) {
-    Task *task, *work_task = NULL;
-    bool found_task = false;
-
-    BLI_mutex_unlock(&pool->num_mutex);
-
-    BLI_mutex_lock(&scheduler->queue_mutex);
+  while (atomic_add_and_fetch_z(&pool->num, 0) != 0) {
+    const uint32_t num_pushed = atomic_add_and_fetch_uint32(&pool->num_pushed, 0);
 
     /* find task from this pool. if we get a task from another pool,
      * we can get into deadlock */
-
-    for (task = scheduler->queue.first; task; task = task->next) {
-      if (task->pool == pool) {
-        work_task = task;
-        found_task = true;
-        BLI_remlink(&scheduler->queue, task);
-        break;
-      }
-    }
-
-    BLI_mutex_unlock(&scheduler->queue_mutex);
+    Task *work_task = task_scheduler_get(scheduler, pool, pool->thread_id, false);
 
     /* if found task, do it, otherwise wait until other tasks are done */
-    if (found_task) {
+    if (work_task != NULL) {
       /* run task */
       BLI_assert(!tls->do_delayed_push);
       work_task->run(pool, work_task->taskdata, pool->thread_id);
       BLI_assert(!tls->do_delayed_push);
 
       /* delete task */
-      task_free(pool, task, pool->thread_id);
+      task_free(pool, work_task, pool->thread_id);
 
       /* Handle all tasks from local queue. */
       handle_local_queue(tls, pool->thread_id);
 
       /* notify pool task was done */
       task_pool_num_decrease(pool, 1);
+      continue;
     }
 
+    /* Sleep until the tasks are done or a new task is pushed after the queues were checked. */
     BLI_mutex_lock(&pool->num_mutex);
-    if (pool->num == 0) {
-      break;
-    }
-
-    if (!found_task) {
+    atomic_add_and_fetch_int32(&pool->num_waiting, 1);
+    if (atomic_add_and_fetch_z(&pool->num, 0) != 0 &&
+        atomic_add_and_fetch_uint32(&pool->num_pushed, 0) == num_pushed) {
       BLI_condition_wait(&pool->num_cond, &pool->num_mutex);
     }
+    atomic_sub_and_fetch_int32(&pool->num_waiting, 1);
+    BLI_mutex_unlock(&pool->num_mutex);
   }
 
+  /* Wait for the thread which did the last decrease to release the mutex. */
+  BLI_mutex_lock(&pool->num_mutex);
   BLI_mutex_unlock(&pool->num_mutex);
 
   BLI_assert(tls->num_local_queue == 0);
@@ -978,7 +1178,7 @@ void BLI_task_pool_cancel(TaskPool *pool)
 
   /* wait until all entries are cleared */
   BLI_mutex_lock(&pool->num_mutex);
-  while (pool->num) {
+  while (atomic_add_and_fetch_z(&pool->num, 0)) {
     BLI_condition_wait(&pool->num_cond, &pool->num_mutex);
   }
   BLI_mutex_unlock(&pool->num_mutex);
@@ -1016,7 +1216,8 @@ void BLI_task_pool_delayed_push_end(TaskPool *pool, int thread_id)
     ASSERT_THREAD_ID(pool->scheduler, thread_id);
     TaskThreadLocalStorage *tls = get_task_tls(pool, thread_id);
     BLI_assert(tls->do_delayed_push);
-    task_scheduler_push_all(pool->scheduler, pool, tls->delayed_queue, tls->num_delayed_queue);
+    task_scheduler_push_all(
+        pool->scheduler, pool, tls->delayed_queue, tls->num_delayed_queue, thread_id);
     tls->do_delayed_push = false;
     tls->num_delayed_queue = 0;
   }
@@ -73,4 +73,24 @@ enum {
 
 #define BLEN_THUMB_MEMSIZE_FILE(_x, _y) (sizeof(int) * (2 + (size_t)(_x) * (size_t)(_y)))
 
+/**
+ * Chunked compression of blend files, see #G_FILE_COMPRESS_CHUNKED.
+ *
+ * The blend file data is split in frames of #BLEND_CHUNK_FRAME_SIZE bytes compressed
+ * independently with zlib, so that they can be decompressed in parallel. The file contains:
+ * - #BLEND_CHUNK_MAGIC.
+ * - The compressed frames.
+ * - The frame index, for each frame the offset of its compressed data from the file start
+ *   (uint64), its compressed size (uint32) and its uncompressed size (uint32).
+ * - The trailer, the offset of the index (uint64), the number of frames (uint64)
+ *   and #BLEND_CHUNK_MAGIC.
+ *
+ * All the integers are little endian.
+ */
+#define BLEND_CHUNK_MAGIC "BLZCHNK1"
+#define BLEND_CHUNK_MAGIC_LEN 8
+#define BLEND_CHUNK_FRAME_SIZE (1 << 20)
+#define BLEND_CHUNK_INDEX_ENTRY_SIZE 16
+#define BLEND_CHUNK_TRAILER_SIZE (16 + BLEND_CHUNK_MAGIC_LEN)
+
 #endif /* __BLO_BLEND_DEFS_H__ */
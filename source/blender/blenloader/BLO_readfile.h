@@ -54,6 +54,18 @@ typedef enum eBlenFileType {
   BLENFILETYPE_RUNTIME = 3,
 } eBlenFileType;
 
+/** Time spent in the phases of a blend file read, in seconds. */
+typedef struct BlendFileReadTimings {
+  /** Reading the block headers, and the data of the blocks that aren't read on demand. */
+  double read;
+  /** Conversion of the data blocks to the current DNA, done in parallel. */
+  double reconstruct;
+  /** Reading and direct linking of the IDs, library reading and linking. */
+  double link;
+  /** Versioning before and after linking. */
+  double versioning;
+} BlendFileReadTimings;
+
 typedef struct BlendFileData {
   struct Main *main;
   struct UserDef *user;
@@ -67,6 +79,8 @@ typedef struct BlendFileData {
   struct ViewLayer *cur_view_layer; /* layer to activate in workspaces when reading without UI */
 
   eBlenFileType type;
+
+  BlendFileReadTimings timings;
 } BlendFileData;
 
 typedef struct WorkspaceConfigFileData {
@@ -33,11 +33,13 @@
 
 #include "BLI_utildefines.h"
 #ifndef WIN32
-#  include <unistd.h>  // for read close
+#  include <sys/mman.h>  // for mmap
+#  include <unistd.h>    // for read close
 #else
 #  include "BLI_winstuff.h"
 #  include "winsock2.h"
 #  include <io.h>  // for open close read
+#  include "mmap_win.h"
 #endif
 
 /* allow readfile to use deprecated functionality */
@@ -109,8 +111,11 @@
 #include "BLI_linklist.h"
 #include "BLI_math.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
+#include "PIL_time.h"
+
 #include "BLT_translation.h"
 
 #include "BKE_action.h"
@@ -241,6 +246,17 @@
  */
 #define USE_BHEAD_READ_ON_DEMAND
 
+/**
+ * Map uncompressed files in memory, the delayed blocks are then read straight from the mapping
+ * instead of seeking and reading the file, and the blocks needing a DNA reconstruction are
+ * converted from the mapping without an intermediate copy.
+ *
+ * \note Requires #USE_BHEAD_READ_ON_DEMAND.
+ */
+#ifdef USE_BHEAD_READ_ON_DEMAND
+#  define USE_BHEAD_MMAP
+#endif
+
 /* use GHash for BHead name-based lookups (speeds up linking) */
 #define USE_GHASH_BHEAD
 
@@ -259,6 +275,10 @@
 /* local prototypes */
 static void read_libraries(FileData *basefd, ListBase *mainlist);
 static void *read_struct(FileData *fd, BHead *bh, const char *blockname);
+static int fd_read_from_memory(FileData *filedata,
+                               void *buffer,
+                               uint size,
+                               bool *r_is_memchunck_identical);
 static void direct_link_modifiers(FileData *fd, ListBase *lb, Object *ob);
 static BHead *find_bhead_from_code_name(FileData *fd, const short idcode, const char *name);
 static BHead *find_bhead_from_idname(FileData *fd, const char *idname);
@@ -278,6 +298,8 @@ typedef struct BHeadN {
   bool has_data;
 #endif
   bool is_memchunk_identical;
+  /** Data converted in advance by #read_structs_parallel, owned by the block until it's read. */
+  void *data_prefetched;
   struct BHead bhead;
 } BHeadN;
 
@@ -878,6 +900,7 @@ static BHeadN *get_bhead(FileData *fd)
           new_bhead->file_offset = fd->file_offset;
           new_bhead->has_data = false;
           new_bhead->is_memchunk_identical = false;
+          new_bhead->data_prefetched = NULL;
           new_bhead->bhead = bhead;
           off64_t seek_new = fd->seek(fd, bhead.len, SEEK_CUR);
           if (seek_new == -1) {
@@ -901,6 +924,7 @@ static BHeadN *get_bhead(FileData *fd)
           new_bhead->has_data = true;
 #endif
           new_bhead->is_memchunk_identical = false;
+          new_bhead->data_prefetched = NULL;
           new_bhead->bhead = bhead;
 
           readsize = fd->read(fd, new_bhead + 1, bhead.len, &new_bhead->is_memchunk_identical);
@@ -983,11 +1007,41 @@ BHead *blo_bhead_next(FileData *fd, BHead *thisblock)
 }
 
 #ifdef USE_BHEAD_READ_ON_DEMAND
+/**
+ * \return The data of a delayed block referenced in place in the mapped file or memory buffer,
+ * NULL if the block data was read or the file data isn't in memory.
+ *
+ * \note Doesn't change the file data, so it can be used from multiple threads.
+ */
+static const void *blo_bhead_data_in_memory(const FileData *fd, BHead *thisblock)
+{
+  const BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
+  if (new_bhead->has_data) {
+    return NULL;
+  }
+#  ifdef USE_BHEAD_MMAP
+  if (fd->mmap_data != NULL) {
+    BLI_assert(new_bhead->file_offset + new_bhead->bhead.len <= fd->mmap_size);
+    return fd->mmap_data + fd->mmap_offset + new_bhead->file_offset;
+  }
+#  endif
+  if (fd->read == fd_read_from_memory) {
+    BLI_assert(new_bhead->file_offset + new_bhead->bhead.len <= fd->buffersize);
+    return fd->buffer + new_bhead->file_offset;
+  }
+  return NULL;
+}
+
 static bool blo_bhead_read_data(FileData *fd, BHead *thisblock, void *buf)
 {
   bool success = true;
   BHeadN *new_bhead = BHEADN_FROM_BHEAD(thisblock);
   BLI_assert(new_bhead->has_data == false && new_bhead->file_offset != 0);
+  const void *data = blo_bhead_data_in_memory(fd, thisblock);
+  if (data != NULL) {
+    memcpy(buf, data, new_bhead->bhead.len);
+    return true;
+  }
   off64_t offset_backup = fd->file_offset;
   if (UNLIKELY(fd->seek(fd, new_bhead->file_offset, SEEK_SET) == -1)) {
     success = false;
@@ -1012,6 +1066,7 @@ static BHead *blo_bhead_read_full(FileData *fd, BHead *thisblock)
   new_bhead_data->file_offset = new_bhead->file_offset;
   new_bhead_data->has_data = true;
   new_bhead_data->is_memchunk_identical = false;
+  new_bhead_data->data_prefetched = NULL;
   if (!blo_bhead_read_data(fd, thisblock, new_bhead_data + 1)) {
     MEM_freeN(new_bhead_data);
     return NULL;
@@ -1222,6 +1277,226 @@ static int fd_read_from_memory(FileData *filedata,
   return (readsize);
 }
 
+/**
+ * Seek in data of a known size held in memory.
+ * \return The new offset or -1 if it's out of the data.
+ */
+static off64_t fd_seek_in_size(FileData *filedata, off64_t offset, int whence, size_t size)
+{
+  off64_t new_offset;
+  switch (whence) {
+    case SEEK_SET:
+      new_offset = offset;
+      break;
+    case SEEK_CUR:
+      new_offset = filedata->file_offset + offset;
+      break;
+    case SEEK_END:
+      new_offset = (off64_t)size + offset;
+      break;
+    default:
+      return -1;
+  }
+
+  if (new_offset < 0 || new_offset > (off64_t)size) {
+    return -1;
+  }
+  filedata->file_offset = new_offset;
+  return new_offset;
+}
+
+static off64_t fd_seek_from_memory(FileData *filedata, off64_t offset, int whence)
+{
+  return fd_seek_in_size(filedata, offset, whence, (size_t)filedata->buffersize);
+}
+
+/* Chunked compressed file reading, see #BLEND_CHUNK_MAGIC for the file layout. */
+
+typedef struct ChunkedFrame {
+  const char *compressed;
+  size_t compressed_len;
+  char *uncompressed;
+  size_t uncompressed_offset;
+  size_t uncompressed_len;
+  bool ok;
+} ChunkedFrame;
+
+static uint32_t chunked_get_uint32(const char *src)
+{
+  uint32_t value;
+  memcpy(&value, src, sizeof(value));
+#ifdef __BIG_ENDIAN__
+  BLI_endian_switch_uint32(&value);
+#endif
+  return value;
+}
+
+static uint64_t chunked_get_uint64(const char *src)
+{
+  uint64_t value;
+  memcpy(&value, src, sizeof(value));
+#ifdef __BIG_ENDIAN__
+  BLI_endian_switch_uint64(&value);
+#endif
+  return value;
+}
+
+static void chunked_decompress_frame(void *__restrict userdata,
+                                     const int index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ChunkedFrame *frame = &((ChunkedFrame *)userdata)[index];
+  uLongf len = frame->uncompressed_len;
+  frame->ok = (uncompress((Bytef *)frame->uncompressed,
+                          &len,
+                          (const Bytef *)frame->compressed,
+                          frame->compressed_len) == Z_OK) &&
+              (len == frame->uncompressed_len);
+}
+
+/**
+ * Read chunked compressed blend file data and decompress its frames in parallel.
+ *
+ * \param offset: Start of the chunked data in the file.
+ * \param size: Size of the chunked data.
+ * \return The uncompressed blend file data or NULL if the data is invalid.
+ */
+static char *blo_chunked_read(int file, off64_t offset, size_t size, int *r_size)
+{
+  if (size < BLEND_CHUNK_MAGIC_LEN + BLEND_CHUNK_TRAILER_SIZE || size > INT_MAX) {
+    return NULL;
+  }
+
+  /* Read all the compressed data at once, the frames are then decompressed from memory. */
+  char *data = MEM_mallocN(size, __func__);
+  if (BLI_lseek(file, offset, SEEK_SET) == -1 || read(file, data, size) != (int)size) {
+    MEM_freeN(data);
+    return NULL;
+  }
+
+  const char *trailer = data + size - BLEND_CHUNK_TRAILER_SIZE;
+  const uint64_t index_offset = chunked_get_uint64(trailer);
+  const uint64_t frames_num = chunked_get_uint64(trailer + 8);
+  const size_t index_end = size - BLEND_CHUNK_TRAILER_SIZE;
+
+  if (memcmp(data, BLEND_CHUNK_MAGIC, BLEND_CHUNK_MAGIC_LEN) != 0 ||
+      memcmp(trailer + 16, BLEND_CHUNK_MAGIC, BLEND_CHUNK_MAGIC_LEN) != 0 ||
+      index_offset < BLEND_CHUNK_MAGIC_LEN || index_offset > index_end ||
+      frames_num != (index_end - index_offset) / BLEND_CHUNK_INDEX_ENTRY_SIZE ||
+      frames_num * BLEND_CHUNK_INDEX_ENTRY_SIZE != index_end - index_offset) {
+    MEM_freeN(data);
+    return NULL;
+  }
+
+  ChunkedFrame *frames = MEM_mallocN(sizeof(ChunkedFrame) * MAX2(frames_num, 1), __func__);
+  size_t total_len = 0;
+  bool ok = true;
+
+  for (uint64_t i = 0; i < frames_num; i++) {
+    const char *entry = data + index_offset + i * BLEND_CHUNK_INDEX_ENTRY_SIZE;
+    const uint64_t frame_offset = chunked_get_uint64(entry);
+    const uint32_t compressed_len = chunked_get_uint32(entry + 8);
+    const uint32_t uncompressed_len = chunked_get_uint32(entry + 12);
+
+    if (frame_offset < BLEND_CHUNK_MAGIC_LEN || frame_offset > index_offset ||
+        compressed_len > index_offset - frame_offset ||
+        uncompressed_len > BLEND_CHUNK_FRAME_SIZE || total_len + uncompressed_len > INT_MAX) {
+      ok = false;
+      break;
+    }
+
+    frames[i].compressed = data + frame_offset;
+    frames[i].compressed_len = compressed_len;
+    frames[i].uncompressed_offset = total_len;
+    frames[i].uncompressed_len = uncompressed_len;
+    total_len += uncompressed_len;
+  }
+
+  char *buffer = NULL;
+  if (ok) {
+    buffer = MEM_mallocN(MAX2(total_len, 1), __func__);
+    for (uint64_t i = 0; i < frames_num; i++) {
+      frames[i].uncompressed = buffer + frames[i].uncompressed_offset;
+    }
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, (int)frames_num, frames, chunked_decompress_frame, &settings);
+
+    for (uint64_t i = 0; i < frames_num; i++) {
+      if (!frames[i].ok) {
+        ok = false;
+        break;
+      }
+    }
+  }
+
+  MEM_freeN(frames);
+  MEM_freeN(data);
+
+  if (!ok) {
+    MEM_SAFE_FREE(buffer);
+    return NULL;
+  }
+
+  *r_size = (int)total_len;
+  return buffer;
+}
+
+#ifdef USE_BHEAD_MMAP
+/* Memory mapped file reading. */
+
+static int fd_read_from_mmap(FileData *filedata,
+                             void *buffer,
+                             uint size,
+                             bool *UNUSED(r_is_memchunck_identical))
+{
+  /* don't read more bytes then there are available in the mapping */
+  int readsize = (int)MIN2((size_t)size, filedata->mmap_size - (size_t)filedata->file_offset);
+
+  memcpy(buffer, filedata->mmap_data + filedata->mmap_offset + filedata->file_offset, readsize);
+  filedata->file_offset += readsize;
+
+  return (readsize);
+}
+
+static off64_t fd_seek_from_mmap(FileData *filedata, off64_t offset, int whence)
+{
+  return fd_seek_in_size(filedata, offset, whence, filedata->mmap_size);
+}
+
+/**
+ * Map the blend file data of the file descriptor in memory and read from the mapping.
+ *
+ * \param offset: Start of the blend file data in the file.
+ * \param size: Size of the blend file data.
+ * \return False if the file couldn't be mapped, the file is then read as before.
+ *
+ * \note The file must not be truncated while it's mapped.
+ */
+static bool fd_mmap_file(FileData *fd, size_t offset, size_t size)
+{
+  if (size == 0 || size == (size_t)-1) {
+    return false;
+  }
+
+  /* Map from the file start, the mapping offset must be aligned on the page size. */
+  void *data = mmap(NULL, offset + size, PROT_READ, MAP_PRIVATE, fd->filedes, 0);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+
+  fd->mmap_data = data;
+  fd->mmap_size = size;
+  fd->mmap_offset = offset;
+  fd->file_offset = 0;
+  fd->read = fd_read_from_mmap;
+  fd->seek = fd_seek_from_mmap;
+  return true;
+}
+#endif
+
 /* MemFile reading. */
 
 static int fd_read_from_memfile(FileData *filedata,
@@ -1339,6 +1614,33 @@ static FileData *blo_decode_and_check(FileData *fd, ReportList *reports)
   return fd;
 }
 
+/**
+ * Decompress chunked blend file data in memory, the file descriptor isn't owned by the file data.
+ */
+static FileData *blo_filedata_from_chunked(
+    const char *filepath, ReportList *reports, int file, off64_t offset, size_t size)
+{
+  int buffersize;
+  char *buffer = blo_chunked_read(file, offset, size, &buffersize);
+  if (buffer == NULL) {
+    BKE_reportf(reports,
+                RPT_WARNING,
+                "Unable to read '%s': %s",
+                filepath,
+                TIP_("invalid compressed data"));
+    return NULL;
+  }
+
+  FileData *fd = filedata_new();
+
+  fd->buffer = buffer;
+  fd->buffersize = buffersize;
+  fd->read = fd_read_from_memory;
+  fd->seek = fd_seek_from_memory;
+
+  return fd;
+}
+
 static FileData *blo_filedata_from_file_descriptor(const char *filepath,
                                                    ReportList *reports,
                                                    int file)
@@ -1348,7 +1650,9 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
   gzFile gzfile = (gzFile)Z_NULL;
 
-  char header[7];
+  /* Long enough for #BLEND_CHUNK_MAGIC, other formats only need the first 7 bytes. */
+  char header[BLEND_CHUNK_MAGIC_LEN];
+  const int header_min_len = 7;
 
 #ifdef WITH_GAMEENGINE_BPPLAYER
   const int typeencryption = SPINDLE_CheckEncryptionFromFile(filepath);
@@ -1357,7 +1661,8 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
 
     /* Regular file. */
     errno = 0;
-    if (read(file, header, sizeof(header)) != sizeof(header)) {
+    const int header_len = (int)read(file, header, sizeof(header));
+    if (header_len < header_min_len) {
       BKE_reportf(reports,
                   RPT_WARNING,
                   "Unable to read '%s': %s",
@@ -1370,11 +1675,18 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     }
 
     /* Regular file. */
-    if (memcmp(header, "BLENDER", sizeof(header)) == 0) {
+    if (memcmp(header, "BLENDER", header_min_len) == 0) {
       read_fn = fd_read_data_from_file;
       seek_fn = fd_seek_data_from_file;
     }
 
+    /* Chunked compressed file. */
+    if ((read_fn == NULL) && (header_len == BLEND_CHUNK_MAGIC_LEN) &&
+        (memcmp(header, BLEND_CHUNK_MAGIC, BLEND_CHUNK_MAGIC_LEN) == 0)) {
+      return blo_filedata_from_chunked(
+          filepath, reports, file, 0, BLI_file_descriptor_size(file));
+    }
+
     /* Gzip file. */
     errno = 0;
     if ((read_fn == NULL) &&
@@ -1410,6 +1722,12 @@ static FileData *blo_filedata_from_file_descriptor(const char *filepath,
     fd->read = read_fn;
     fd->seek = seek_fn;
 
+#ifdef USE_BHEAD_MMAP
+    if (read_fn == fd_read_data_from_file) {
+      fd_mmap_file(fd, 0, BLI_file_descriptor_size(file));
+    }
+#endif
+
     return fd;
 #ifdef WITH_GAMEENGINE_BPPLAYER
   }
@@ -1574,6 +1892,12 @@ FileData *blo_filedata_from_memfile(MemFile *memfile,
 void blo_filedata_free(FileData *fd)
 {
   if (fd) {
+#ifdef USE_BHEAD_MMAP
+    if (fd->mmap_data != NULL) {
+      munmap((void *)fd->mmap_data, fd->mmap_offset + fd->mmap_size);
+    }
+#endif
+
     if (fd->filedes != -1) {
       close(fd->filedes);
     }
@@ -1593,6 +1917,11 @@ void blo_filedata_free(FileData *fd)
       fd->buffer = NULL;
     }
 
+    /* Free the converted data of the blocks that weren't read. */
+    LISTBASE_FOREACH (BHeadN *, new_bhead, &fd->bhead_list) {
+      MEM_SAFE_FREE(new_bhead->data_prefetched);
+    }
+
     /* Free all BHeadN data blocks */
 #ifndef NDEBUG
     BLI_freelistN(&fd->bhead_list);
@@ -2351,6 +2680,16 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
   void *temp = NULL;
 
   if (bh->len) {
+    BHeadN *new_bhead = BHEADN_FROM_BHEAD(bh);
+    if (new_bhead->data_prefetched) {
+      temp = new_bhead->data_prefetched;
+      new_bhead->data_prefetched = NULL;
+      if (!new_bhead->is_memchunk_identical) {
+        fd->are_memchunks_identical = false;
+      }
+      return temp;
+    }
+
 #ifdef USE_BHEAD_READ_ON_DEMAND
     BHead *bh_orig = bh;
 #endif
@@ -2371,17 +2710,25 @@ static void *read_struct(FileData *fd, BHead *bh, const char *blockname)
 
     if (fd->compflags[bh->SDNAnr] != SDNA_CMP_REMOVED) {
       if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+        const void *data = NULL;
 #ifdef USE_BHEAD_READ_ON_DEMAND
-        if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
-          bh = blo_bhead_read_full(fd, bh);
-          if (UNLIKELY(bh == NULL)) {
-            fd->flags &= ~FD_FLAGS_FILE_OK;
-            return NULL;
+        /* Reconstruct from the file data in memory, without a copy of the block. */
+        data = blo_bhead_data_in_memory(fd, bh);
+#endif
+        if (data == NULL) {
+#ifdef USE_BHEAD_READ_ON_DEMAND
+          if (BHEADN_FROM_BHEAD(bh)->has_data == false) {
+            bh = blo_bhead_read_full(fd, bh);
+            if (UNLIKELY(bh == NULL)) {
+              fd->flags &= ~FD_FLAGS_FILE_OK;
+              return NULL;
+            }
           }
-        }
 #endif
+          data = (bh + 1);
+        }
         temp = DNA_struct_reconstruct(
-            fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, (bh + 1));
+            fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, data);
       }
       else {
         /* SDNA_CMP_EQUAL */
@@ -9487,6 +9834,103 @@ static BHead *read_data_into_oldnewmap(FileData *fd, BHead *bhead, const char *a
   return bhead;
 }
 
+typedef struct ReadStructsData {
+  FileData *fd;
+  BHead **bheads;
+  const char **allocnames;
+} ReadStructsData;
+
+static void read_structs_parallel_cb(void *__restrict userdata,
+                                     const int index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ReadStructsData *data = userdata;
+  FileData *fd = data->fd;
+  BHead *bh = data->bheads[index];
+  BHeadN *new_bhead = BHEADN_FROM_BHEAD(bh);
+
+  const void *src = (bh + 1);
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (!new_bhead->has_data) {
+    src = blo_bhead_data_in_memory(fd, bh);
+  }
+#endif
+
+  if (fd->compflags[bh->SDNAnr] == SDNA_CMP_NOT_EQUAL) {
+    new_bhead->data_prefetched = DNA_struct_reconstruct(
+        fd->memsdna, fd->filesdna, fd->compflags, bh->SDNAnr, bh->nr, src);
+  }
+  else {
+    new_bhead->data_prefetched = MEM_mallocN(bh->len, data->allocnames[index]);
+    memcpy(new_bhead->data_prefetched, src, bh->len);
+  }
+}
+
+/** Whether the data of a block can be converted without changing the file data. */
+static bool read_struct_can_prefetch(FileData *fd, BHead *bh)
+{
+  if (bh->len == 0 || fd->compflags[bh->SDNAnr] == SDNA_CMP_REMOVED) {
+    return false;
+  }
+#ifdef USE_BHEAD_READ_ON_DEMAND
+  if (!BHEADN_FROM_BHEAD(bh)->has_data && blo_bhead_data_in_memory(fd, bh) == NULL) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+/**
+ * Convert the data blocks of all the IDs of the file to the current DNA on the task scheduler,
+ * #read_struct then returns the converted data instead of converting the block.
+ *
+ * The blocks whose data would have to be read from the file are left for #read_struct, as the
+ * file reading isn't thread safe, and so are all the blocks of files needing an endian switch,
+ * which converts the block data in place.
+ *
+ * \note The block headers must be read already.
+ */
+static void read_structs_parallel(FileData *fd)
+{
+  if (fd->flags & FD_FLAGS_SWITCH_ENDIAN) {
+    return;
+  }
+
+  int bheads_len = 0;
+  LISTBASE_FOREACH (BHeadN *, new_bhead, &fd->bhead_list) {
+    bheads_len++;
+  }
+
+  ReadStructsData data = {
+      .fd = fd,
+      .bheads = MEM_mallocN(sizeof(*data.bheads) * bheads_len, __func__),
+      .allocnames = MEM_mallocN(sizeof(*data.allocnames) * bheads_len, __func__),
+  };
+
+  int bheads_num = 0;
+  const char *allocname = NULL;
+  LISTBASE_FOREACH (BHeadN *, new_bhead, &fd->bhead_list) {
+    BHead *bh = &new_bhead->bhead;
+    if (bh->code != DATA) {
+      /* Only the data of the IDs is read with #read_data_into_oldnewmap. */
+      allocname = BKE_idtype_idcode_is_valid(bh->code) ? dataname(bh->code) : NULL;
+    }
+    else if (allocname && read_struct_can_prefetch(fd, bh)) {
+      data.bheads[bheads_num] = bh;
+      data.allocnames[bheads_num] = allocname;
+      bheads_num++;
+    }
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 32;
+  BLI_task_parallel_range(0, bheads_num, &data, read_structs_parallel_cb, &settings);
+
+  MEM_freeN(data.bheads);
+  MEM_freeN(data.allocnames);
+}
+
 static BHead *read_libblock(FileData *fd,
                             Main *main,
                             BHead *bhead,
@@ -10399,8 +10843,17 @@ static BHead *read_userdef(BlendFileData *bfd, FileData *fd, BHead *bhead)
 /** \name Read File (Internal)
  * \{ */
 
+/** Add the time elapsed since the previous step to a phase of the read. */
+static void blo_read_timing_step(double *time, double *r_phase)
+{
+  const double time_step = PIL_check_seconds_timer();
+  *r_phase += time_step - *time;
+  *time = time_step;
+}
+
 BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 {
+  double time = PIL_check_seconds_timer();
   BHead *bhead = blo_bhead_first(fd);
   BlendFileData *bfd;
   ListBase mainlist = {NULL, NULL};
@@ -10440,6 +10893,18 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  /* Read all the block headers first to convert the data of the IDs in parallel,
+   * not in undo case where the file data is read sequentially. */
+  if (fd->memfile == NULL && (fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
+    for (BHead *bh = bhead; bh && bh->code != ENDB; bh = blo_bhead_next(fd, bh)) {
+      /* pass */
+    }
+    blo_read_timing_step(&time, &bfd->timings.read);
+
+    read_structs_parallel(fd);
+    blo_read_timing_step(&time, &bfd->timings.reconstruct);
+  }
+
   while (bhead) {
     switch (bhead->code) {
       case DATA:
@@ -10491,6 +10956,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  blo_read_timing_step(&time, &bfd->timings.link);
+
   /* do before read_libraries, but skip undo case */
   if (fd->memfile == NULL) {
     if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
@@ -10502,6 +10969,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     }
   }
 
+  blo_read_timing_step(&time, &bfd->timings.versioning);
+
   if ((fd->skip_flags & BLO_READ_SKIP_DATA) == 0) {
     read_libraries(fd, &mainlist);
 
@@ -10509,6 +10978,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 
     lib_link_all(fd, bfd->main);
 
+    blo_read_timing_step(&time, &bfd->timings.link);
+
     /* Skip in undo case. */
     if (fd->memfile == NULL) {
       /* Note that we can't recompute user-counts at this point in undo case, we play too much with
@@ -10535,6 +11006,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
 
       /* After all data has been read and versioned, uses LIB_TAG_NEW. */
       ntreeUpdateAllNew(bfd->main);
+
+      blo_read_timing_step(&time, &bfd->timings.versioning);
     }
 
     placeholders_ensure_valid(bfd->main);
@@ -10554,6 +11027,8 @@ BlendFileData *blo_read_file_internal(FileData *fd, const char *filepath)
     fix_relpaths_library(fd->relabase, bfd->main);
 
     link_global(fd, bfd); /* as last */
+
+    blo_read_timing_step(&time, &bfd->timings.link);
   }
 
   fd->mainlist = NULL; /* Safety, this is local variable, shall not be used afterward. */
@@ -12770,10 +13245,31 @@ BlendFileData *blo_read_blendafterruntime(int file,
                                           ReportList *reports)
 {
   BlendFileData *bfd = NULL;
-  FileData *fd = filedata_new();
-  fd->filedes = file;
-  fd->buffersize = actualsize;
-  fd->read = fd_read_data_from_file;
+  FileData *fd;
+  const off64_t offset = BLI_lseek(file, 0, SEEK_CUR);
+  char header[BLEND_CHUNK_MAGIC_LEN];
+
+  if (offset != -1 && read(file, header, sizeof(header)) == sizeof(header) &&
+      memcmp(header, BLEND_CHUNK_MAGIC, sizeof(header)) == 0) {
+    fd = blo_filedata_from_chunked(name, reports, file, offset, (size_t)actualsize);
+    close(file);
+    if (!fd) {
+      return NULL;
+    }
+  }
+  else {
+    BLI_lseek(file, offset, SEEK_SET);
+
+    fd = filedata_new();
+    fd->filedes = file;
+    fd->buffersize = actualsize;
+    fd->read = fd_read_data_from_file;
+#ifdef USE_BHEAD_MMAP
+    if (offset != -1 && actualsize > 0) {
+      fd_mmap_file(fd, (size_t)offset, (size_t)actualsize);
+    }
+#endif
+  }
 
   /* needed for library_append and read_libraries */
   BLI_strncpy(fd->relabase, name, sizeof(fd->relabase));
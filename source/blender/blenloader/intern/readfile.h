@@ -92,6 +92,12 @@ typedef struct FileData {
    * to detect unchanged data from memfile. */
   short undo_direction;
 
+  /** Variables needed for reading from a memory mapped file, see #USE_BHEAD_MMAP.
+   * The data starts at `mmap_offset` bytes in the mapping. */
+  const char *mmap_data;
+  size_t mmap_size;
+  size_t mmap_offset;
+
   /** Variables needed for reading from file. */
   gzFile gzfiledes;
   /** Gzip stream for memory decompression. */
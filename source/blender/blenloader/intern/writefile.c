@@ -151,7 +151,9 @@
 
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
+#include "BLI_endian_switch.h"
 #include "BLI_mempool.h"
+#include "BLI_task.h"
 #include "MEM_guardedalloc.h"  // MEM_freeN
 
 #include "BKE_action.h"
@@ -209,6 +211,7 @@
 typedef enum {
   WW_WRAP_NONE = 1,
   WW_WRAP_ZLIB,
+  WW_WRAP_CHUNKED,
 } eWriteWrapType;
 
 typedef struct WriteWrap WriteWrap;
@@ -225,6 +228,7 @@ struct WriteWrap {
   union {
     int file_handle;
     gzFile gz_handle;
+    struct WriteWrapChunked *chunked;
   } _user_data;
 };
 
@@ -282,6 +286,201 @@ static size_t ww_write_zlib(WriteWrap *ww, const char *buf, size_t buf_len)
 }
 #undef FILE_HANDLE
 
+/* chunked, see #BLEND_CHUNK_MAGIC for the file layout */
+#define FILE_HANDLE(ww) (ww)->_user_data.chunked
+
+/** Number of frames compressed in parallel. */
+#define WW_CHUNKED_BATCH 16
+
+typedef struct WriteWrapChunked {
+  int file_handle;
+  /** Offset of the next write in the file. */
+  uint64_t file_offset;
+
+  /** Uncompressed data of the frames of the current batch. */
+  char *batch;
+  size_t batch_len;
+
+  /** Compressed data of the frames of the batch, each with a size of `compressed_stride`. */
+  char *compressed;
+  size_t compressed_stride;
+  uLongf compressed_len[WW_CHUNKED_BATCH];
+  bool compressed_ok[WW_CHUNKED_BATCH];
+
+  /** Frame index, #BLEND_CHUNK_INDEX_ENTRY_SIZE bytes per frame. */
+  char *index;
+  uint64_t frames_num;
+  uint64_t frames_len_alloc;
+} WriteWrapChunked;
+
+static void ww_chunked_put_uint32(char *dst, uint32_t value)
+{
+#ifdef __BIG_ENDIAN__
+  BLI_endian_switch_uint32(&value);
+#endif
+  memcpy(dst, &value, sizeof(value));
+}
+
+static void ww_chunked_put_uint64(char *dst, uint64_t value)
+{
+#ifdef __BIG_ENDIAN__
+  BLI_endian_switch_uint64(&value);
+#endif
+  memcpy(dst, &value, sizeof(value));
+}
+
+static bool ww_chunked_write_raw(WriteWrapChunked *chunked, const char *buf, size_t buf_len)
+{
+  if ((size_t)write(chunked->file_handle, buf, buf_len) != buf_len) {
+    return false;
+  }
+  chunked->file_offset += buf_len;
+  return true;
+}
+
+static void ww_chunked_compress_frame(void *__restrict userdata,
+                                      const int frame,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  WriteWrapChunked *chunked = userdata;
+  const size_t offset = (size_t)frame * BLEND_CHUNK_FRAME_SIZE;
+  const size_t len = MIN2(chunked->batch_len - offset, BLEND_CHUNK_FRAME_SIZE);
+
+  chunked->compressed_len[frame] = chunked->compressed_stride;
+  chunked->compressed_ok[frame] = (compress2((Bytef *)chunked->compressed +
+                                                 frame * chunked->compressed_stride,
+                                             &chunked->compressed_len[frame],
+                                             (const Bytef *)chunked->batch + offset,
+                                             len,
+                                             Z_BEST_SPEED) == Z_OK);
+}
+
+/** Compress the frames of the batch in parallel, then write them and add them to the index. */
+static bool ww_chunked_flush_batch(WriteWrapChunked *chunked)
+{
+  if (chunked->batch_len == 0) {
+    return true;
+  }
+
+  const int frames_num = (int)((chunked->batch_len + BLEND_CHUNK_FRAME_SIZE - 1) /
+                               BLEND_CHUNK_FRAME_SIZE);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, frames_num, chunked, ww_chunked_compress_frame, &settings);
+
+  if (chunked->frames_num + frames_num > chunked->frames_len_alloc) {
+    chunked->frames_len_alloc = MAX2(chunked->frames_len_alloc * 2, WW_CHUNKED_BATCH);
+    chunked->index = MEM_reallocN(chunked->index,
+                                  chunked->frames_len_alloc * BLEND_CHUNK_INDEX_ENTRY_SIZE);
+  }
+
+  for (int frame = 0; frame < frames_num; frame++) {
+    if (!chunked->compressed_ok[frame]) {
+      return false;
+    }
+
+    const size_t len = MIN2(chunked->batch_len - (size_t)frame * BLEND_CHUNK_FRAME_SIZE,
+                            BLEND_CHUNK_FRAME_SIZE);
+    char *entry = chunked->index + chunked->frames_num * BLEND_CHUNK_INDEX_ENTRY_SIZE;
+    ww_chunked_put_uint64(entry, chunked->file_offset);
+    ww_chunked_put_uint32(entry + 8, (uint32_t)chunked->compressed_len[frame]);
+    ww_chunked_put_uint32(entry + 12, (uint32_t)len);
+    chunked->frames_num++;
+
+    if (!ww_chunked_write_raw(chunked,
+                              chunked->compressed + frame * chunked->compressed_stride,
+                              chunked->compressed_len[frame])) {
+      return false;
+    }
+  }
+
+  chunked->batch_len = 0;
+  return true;
+}
+
+static void ww_chunked_free(WriteWrapChunked *chunked)
+{
+  MEM_SAFE_FREE(chunked->index);
+  MEM_freeN(chunked->batch);
+  MEM_freeN(chunked->compressed);
+  MEM_freeN(chunked);
+}
+
+static bool ww_open_chunked(WriteWrap *ww, const char *filepath)
+{
+  int file;
+
+  file = BLI_open(filepath, O_BINARY + O_WRONLY + O_CREAT + O_TRUNC, 0666);
+
+  if (file == -1) {
+    return false;
+  }
+
+  WriteWrapChunked *chunked = MEM_callocN(sizeof(*chunked), __func__);
+  chunked->file_handle = file;
+  chunked->batch = MEM_mallocN(WW_CHUNKED_BATCH * BLEND_CHUNK_FRAME_SIZE, __func__);
+  chunked->compressed_stride = compressBound(BLEND_CHUNK_FRAME_SIZE);
+  chunked->compressed = MEM_mallocN(WW_CHUNKED_BATCH * chunked->compressed_stride, __func__);
+
+  if (!ww_chunked_write_raw(chunked, BLEND_CHUNK_MAGIC, BLEND_CHUNK_MAGIC_LEN)) {
+    close(file);
+    ww_chunked_free(chunked);
+    return false;
+  }
+
+  FILE_HANDLE(ww) = chunked;
+  return true;
+}
+static bool ww_close_chunked(WriteWrap *ww)
+{
+  WriteWrapChunked *chunked = FILE_HANDLE(ww);
+  bool ok = ww_chunked_flush_batch(chunked);
+
+  if (ok) {
+    char trailer[BLEND_CHUNK_TRAILER_SIZE];
+    ww_chunked_put_uint64(trailer, chunked->file_offset);
+    ww_chunked_put_uint64(trailer + 8, chunked->frames_num);
+    memcpy(trailer + 16, BLEND_CHUNK_MAGIC, BLEND_CHUNK_MAGIC_LEN);
+
+    ok = ww_chunked_write_raw(chunked,
+                              chunked->index,
+                              chunked->frames_num * BLEND_CHUNK_INDEX_ENTRY_SIZE) &&
+         ww_chunked_write_raw(chunked, trailer, sizeof(trailer));
+  }
+
+  if (close(chunked->file_handle) == -1) {
+    ok = false;
+  }
+
+  ww_chunked_free(chunked);
+
+  return ok;
+}
+static size_t ww_write_chunked(WriteWrap *ww, const char *buf, size_t buf_len)
+{
+  WriteWrapChunked *chunked = FILE_HANDLE(ww);
+  size_t written = 0;
+
+  while (written < buf_len) {
+    const size_t len = MIN2(buf_len - written,
+                            WW_CHUNKED_BATCH * BLEND_CHUNK_FRAME_SIZE - chunked->batch_len);
+    memcpy(chunked->batch + chunked->batch_len, buf + written, len);
+    chunked->batch_len += len;
+    written += len;
+
+    if (chunked->batch_len == WW_CHUNKED_BATCH * BLEND_CHUNK_FRAME_SIZE) {
+      if (!ww_chunked_flush_batch(chunked)) {
+        return 0;
+      }
+    }
+  }
+
+  return written;
+}
+#undef FILE_HANDLE
+
 /* --- end compression types --- */
 
 static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
@@ -296,6 +495,13 @@ static void ww_handle_init(eWriteWrapType ww_type, WriteWrap *r_ww)
       r_ww->use_buf = false;
       break;
     }
+    case WW_WRAP_CHUNKED: {
+      r_ww->open = ww_open_chunked;
+      r_ww->close = ww_close_chunked;
+      r_ww->write = ww_write_chunked;
+      r_ww->use_buf = false;
+      break;
+    }
     default: {
       r_ww->open = ww_open_none;
       r_ww->close = ww_close_none;
@@ -4547,7 +4753,10 @@ bool BLO_write_file(Main *mainvar,
   /* open temporary file, so we preserve the original in case we crash */
   BLI_snprintf(tempname, sizeof(tempname), "%s@", filepath);
 
-  if (write_flags & G_FILE_COMPRESS) {
+  if (write_flags & G_FILE_COMPRESS_CHUNKED) {
+    ww_type = WW_WRAP_CHUNKED;
+  }
+  else if (write_flags & G_FILE_COMPRESS) {
     ww_type = WW_WRAP_ZLIB;
   }
   else {
@@ -190,6 +190,11 @@ bool DEG_is_active(const struct Depsgraph *depsgraph);
 void DEG_make_active(struct Depsgraph *depsgraph);
 void DEG_make_inactive(struct Depsgraph *depsgraph);
 
+/* Sparse evaluation only visits the operations affected by the tagged updates, instead of all the
+ * operations of the graph. */
+bool DEG_is_sparse_evaluation(const struct Depsgraph *depsgraph);
+void DEG_sparse_evaluation_set(struct Depsgraph *depsgraph, const bool use_sparse);
+
 /* Evaluation Debug ------------------------------ */
 
 void DEG_debug_print_begin(struct Depsgraph *depsgraph);
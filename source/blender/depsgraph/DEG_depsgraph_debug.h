@@ -53,6 +53,10 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+void DEG_stats_evaluation(const struct Depsgraph *graph,
+                          size_t *r_visited_operations,
+                          size_t *r_updated_operations);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
@@ -63,6 +67,19 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Trace */
+
+/* Record when and on which thread every operation is evaluated, over all the evaluations
+ * between begin and end. Must not be called while the graph is evaluating. */
+void DEG_debug_trace_begin(struct Depsgraph *graph);
+void DEG_debug_trace_end(struct Depsgraph *graph);
+bool DEG_debug_trace_is_recording(const struct Depsgraph *graph);
+
+/* Write the recorded evaluations in the Chrome trace event format,
+ * which can be opened in chrome://tracing or Perfetto. */
+void DEG_debug_trace_chrome_json(const struct Depsgraph *graph, FILE *stream);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
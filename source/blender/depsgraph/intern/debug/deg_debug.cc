@@ -35,7 +35,11 @@
 namespace DEG {
 
 DepsgraphDebug::DepsgraphDebug()
-    : flags(G.debug), is_ever_evaluated(false), graph_evaluation_start_time_(0)
+    : flags(G.debug),
+      is_ever_evaluated(false),
+      num_visited_operations(0),
+      num_updated_operations(0),
+      graph_evaluation_start_time_(0)
 {
 }
 
@@ -68,6 +72,9 @@ void DepsgraphDebug::end_graph_evaluation()
   const double graph_eval_end_time = PIL_check_seconds_timer();
   printf("Depsgraph updated in %f seconds.\n", graph_eval_end_time - graph_evaluation_start_time_);
   printf("Depsgraph evaluation FPS: %f\n", 1.0f / fps_samples_.get_averaged());
+  printf("Depsgraph evaluation visited %zu operations, %zu updated.\n",
+         num_visited_operations,
+         num_updated_operations);
 
   is_ever_evaluated = true;
 }
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "intern/debug/deg_debug_trace.h"
 #include "intern/debug/deg_time_average.h"
 #include "intern/depsgraph_type.h"
 
@@ -52,6 +53,14 @@ class DepsgraphDebug {
    * This is NOT an indication that depsgraph is at its evaluated state. */
   bool is_ever_evaluated;
 
+  /* Number of operations initialized and scheduled by the last evaluation, and number of
+   * operations tagged for update it evaluated. Both are zero when nothing was tagged. */
+  size_t num_visited_operations;
+  size_t num_updated_operations;
+
+  /* Timeline of the operations evaluation, see DEG_debug_trace_begin(). */
+  DepsgraphTrace trace;
+
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
@@ -0,0 +1,241 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include "DEG_depsgraph_debug.h"
+
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+#include "intern/depsgraph.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace DEG {
+
+namespace {
+
+/* Row of the evaluation stages, sorted before the threads rows. */
+const int STAGES_THREAD_ID = -1;
+
+string json_escape(const string &str)
+{
+  string result;
+  result.reserve(str.size());
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          char buffer[8];
+          snprintf(buffer, sizeof(buffer), "\\u%04x", (unsigned int)c);
+          result += buffer;
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+DepsgraphTrace::DepsgraphTrace()
+    : is_recording_(false),
+      begin_time_(0),
+      evaluation_start_time_(0),
+      num_evaluations_(0),
+      num_threads_(0)
+{
+}
+
+void DepsgraphTrace::begin()
+{
+  events_.clear();
+  thread_records_.clear();
+  num_evaluations_ = 0;
+  num_threads_ = 0;
+  begin_time_ = PIL_check_seconds_timer();
+  is_recording_ = true;
+}
+
+void DepsgraphTrace::end()
+{
+  is_recording_ = false;
+  thread_records_.clear();
+}
+
+bool DepsgraphTrace::is_recording() const
+{
+  return is_recording_;
+}
+
+void DepsgraphTrace::begin_evaluation(const int num_threads)
+{
+  BLI_assert(is_recording_);
+  if (thread_records_.size() < (size_t)num_threads) {
+    thread_records_.resize(num_threads);
+  }
+  num_threads_ = max(num_threads_, num_threads);
+  evaluation_start_time_ = PIL_check_seconds_timer();
+}
+
+void DepsgraphTrace::end_evaluation()
+{
+  BLI_assert(is_recording_);
+  const double end_time = PIL_check_seconds_timer();
+
+  for (int thread_id = 0; thread_id < (int)thread_records_.size(); thread_id++) {
+    for (const OperationRecord &record : thread_records_[thread_id]) {
+      const OperationNode *operation_node = record.operation_node;
+      Event event;
+      event.name = operation_node->full_identifier();
+      event.category = nodeTypeAsString(operation_node->owner->type);
+      event.thread_id = thread_id;
+      event.start_time = record.start_time;
+      event.end_time = record.end_time;
+      events_.push_back(event);
+    }
+    thread_records_[thread_id].clear();
+  }
+
+  Event event;
+  event.name = "Evaluation " + to_string(num_evaluations_);
+  event.category = "EVALUATION";
+  event.thread_id = STAGES_THREAD_ID;
+  event.start_time = evaluation_start_time_;
+  event.end_time = end_time;
+  events_.push_back(event);
+  num_evaluations_++;
+}
+
+void DepsgraphTrace::record_operation(const OperationNode *operation_node,
+                                      const int thread_id,
+                                      const double start_time,
+                                      const double end_time)
+{
+  BLI_assert(thread_id >= 0 && thread_id < (int)thread_records_.size());
+  OperationRecord record = {operation_node, start_time, end_time};
+  thread_records_[thread_id].push_back(record);
+}
+
+void DepsgraphTrace::record_stage(const char *name,
+                                  const double start_time,
+                                  const double end_time)
+{
+  Event event;
+  event.name = name;
+  event.category = "STAGE";
+  event.thread_id = STAGES_THREAD_ID;
+  event.start_time = start_time;
+  event.end_time = end_time;
+  events_.push_back(event);
+}
+
+void DepsgraphTrace::write_chrome_json(FILE *stream, const string &graph_name) const
+{
+  fprintf(stream, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+
+  /* Names of the rows. */
+  fprintf(stream,
+          "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": 0, "
+          "\"args\": {\"name\": \"%s\"}},\n",
+          json_escape(graph_name.empty() ? string("Depsgraph") : graph_name).c_str());
+  fprintf(stream,
+          "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+          "\"args\": {\"name\": \"Evaluation\"}},\n",
+          STAGES_THREAD_ID);
+  fprintf(stream,
+          "{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+          "\"args\": {\"sort_index\": %d}}",
+          STAGES_THREAD_ID,
+          STAGES_THREAD_ID);
+  for (int thread_id = 0; thread_id < num_threads_; thread_id++) {
+    fprintf(stream,
+            ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+            "\"args\": {\"name\": \"Thread %d\"}}",
+            thread_id,
+            thread_id);
+  }
+
+  /* Complete events, with times in microseconds. */
+  for (const Event &event : events_) {
+    fprintf(stream,
+            ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, "
+            "\"ts\": %.3f, \"dur\": %.3f}",
+            json_escape(event.name).c_str(),
+            event.category,
+            event.thread_id,
+            (event.start_time - begin_time_) * 1e6,
+            (event.end_time - event.start_time) * 1e6);
+  }
+
+  fprintf(stream, "\n]}\n");
+}
+
+}  // namespace DEG
+
+void DEG_debug_trace_begin(Depsgraph *depsgraph)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+  BLI_assert(!deg_graph->is_evaluating);
+  deg_graph->debug.trace.begin();
+}
+
+void DEG_debug_trace_end(Depsgraph *depsgraph)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+  BLI_assert(!deg_graph->is_evaluating);
+  deg_graph->debug.trace.end();
+}
+
+bool DEG_debug_trace_is_recording(const Depsgraph *depsgraph)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(depsgraph);
+  return deg_graph->debug.trace.is_recording();
+}
+
+void DEG_debug_trace_chrome_json(const Depsgraph *depsgraph, FILE *f)
+{
+  if (depsgraph == nullptr) {
+    return;
+  }
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(depsgraph);
+  deg_graph->debug.trace.write_chrome_json(f, deg_graph->debug.name);
+}
@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "intern/depsgraph_type.h"
+
+namespace DEG {
+
+struct OperationNode;
+
+/* Records when and on which thread every operation is evaluated, for all the evaluations
+ * between begin() and end(), and writes it in the Chrome trace event format.
+ *
+ * Operations are recorded to per-thread buffers, so recording doesn't add synchronization
+ * between the evaluation threads. The buffers are turned into named events at the end of every
+ * evaluation, while the operation nodes are still valid. */
+class DepsgraphTrace {
+ public:
+  DepsgraphTrace();
+
+  void begin();
+  void end();
+  bool is_recording() const;
+
+  /* Called by the evaluation engine, num_threads is the number of threads of the task scheduler
+   * used for the evaluation. */
+  void begin_evaluation(int num_threads);
+  void end_evaluation();
+  void record_operation(const OperationNode *operation_node,
+                        int thread_id,
+                        double start_time,
+                        double end_time);
+  /* Evaluation stages are shown on their own row, above the threads. */
+  void record_stage(const char *name, double start_time, double end_time);
+
+  void write_chrome_json(FILE *stream, const string &graph_name) const;
+
+ protected:
+  struct OperationRecord {
+    const OperationNode *operation_node;
+    double start_time, end_time;
+  };
+
+  struct Event {
+    string name;
+    const char *category;
+    int thread_id;
+    double start_time, end_time;
+  };
+
+  bool is_recording_;
+  /* Time the recording began, event times are written relative to it. */
+  double begin_time_;
+  double evaluation_start_time_;
+  int num_evaluations_;
+  int num_threads_;
+
+  /* Operations of the current evaluation, indexed by thread. */
+  vector<vector<OperationRecord>> thread_records_;
+  vector<Event> events_;
+};
+
+}  // namespace DEG
@@ -69,6 +69,7 @@ template<typename T> static void remove_from_vector(vector<T> *vector, const T &
 Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluationMode mode)
     : time_source(nullptr),
       need_update(true),
+      use_sparse_evaluation(false),
       need_update_time(false),
       bmain(bmain),
       scene(scene),
@@ -238,6 +239,7 @@ void Depsgraph::add_entry_tag(OperationNode *node)
 
 void Depsgraph::clear_all_nodes()
 {
+  affected_operations.clear();
   clear_id_nodes();
   if (time_source != nullptr) {
     OBJECT_GUARDED_DELETE(time_source, TimeSourceNode);
@@ -351,3 +353,15 @@ void DEG_make_inactive(struct Depsgraph *depsgraph)
   DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
   deg_graph->is_active = false;
 }
+
+bool DEG_is_sparse_evaluation(const struct Depsgraph *depsgraph)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(depsgraph);
+  return deg_graph->use_sparse_evaluation;
+}
+
+void DEG_sparse_evaluation_set(struct Depsgraph *depsgraph, const bool use_sparse)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+  deg_graph->use_sparse_evaluation = use_sparse;
+}
@@ -121,6 +121,15 @@ struct Depsgraph {
   /* Nodes which have been tagged as "directly modified". */
   GSet *entry_tags;
 
+  /* Operations tagged for update by the last flush, in the order they were tagged. Entry tags
+   * are included. Cleared along with the tags once the graph is evaluated. */
+  OperationNodes affected_operations;
+
+  /* Only initialize and schedule the affected operations on evaluation instead of all the
+   * operations of the graph, so the cost of an update depends on what was tagged and not on the
+   * graph size. */
+  bool use_sparse_evaluation;
+
   /* Special entry tag for time source. Allows to tag invisible dependency graphs for update when
    * scene frame changes, so then when dependency graph becomes visible it is on a proper state. */
   bool need_update_time;
@@ -247,6 +247,26 @@ void DEG_stats_simple(const Depsgraph *graph,
   }
 }
 
+/**
+ * Obtain statistics about the last evaluation of the depsgraph
+ * \param[out] r_visited_operations  The number of operation nodes initialized and scheduled, all
+ *                                   of them or only the affected ones with sparse evaluation
+ * \param[out] r_updated_operations  The number of operation nodes tagged for update
+ */
+void DEG_stats_evaluation(const Depsgraph *graph,
+                          size_t *r_visited_operations,
+                          size_t *r_updated_operations)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+
+  if (r_visited_operations) {
+    *r_visited_operations = deg_graph->debug.num_visited_operations;
+  }
+  if (r_updated_operations) {
+    *r_updated_operations = deg_graph->debug.num_updated_operations;
+  }
+}
+
 static DEG::string depsgraph_name_for_logging(struct Depsgraph *depsgraph)
 {
   const char *name = DEG_debug_name_get(depsgraph);
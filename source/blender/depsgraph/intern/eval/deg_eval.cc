@@ -95,22 +95,35 @@ enum class EvaluationStage {
 
 struct DepsgraphEvalState {
   Depsgraph *graph;
+  /* Operations to initialize and schedule, all the operations of the graph or only the ones
+   * affected by the flush with sparse evaluation. */
+  const Depsgraph::OperationNodes *operations;
   bool do_stats;
+  /* Record the operations to the trace, see DEG_debug_trace_begin(). */
+  bool do_trace;
   EvaluationStage stage;
   bool need_single_thread_pass;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+void evaluate_node(const DepsgraphEvalState *state,
+                   OperationNode *operation_node,
+                   const int thread_id)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
   /* Perform operation. */
-  if (state->do_stats) {
+  if (state->do_stats || state->do_trace) {
     const double start_time = PIL_check_seconds_timer();
     operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    const double end_time = PIL_check_seconds_timer();
+    if (state->do_stats) {
+      operation_node->stats.current_time += end_time - start_time;
+    }
+    if (state->do_trace) {
+      state->graph->debug.trace.record_operation(operation_node, thread_id, start_time, end_time);
+    }
   }
   else {
     operation_node->evaluate(depsgraph);
@@ -124,7 +137,7 @@ void deg_task_run_func(TaskPool *pool, void *taskdata, int thread_id)
 
   /* Evaluate node. */
   OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
-  evaluate_node(state, operation_node);
+  evaluate_node(state, operation_node, thread_id);
 
   /* Schedule children. */
   BLI_task_pool_delayed_push_begin(pool, thread_id);
@@ -175,19 +188,19 @@ void calculate_pending_parents_for_node(OperationNode *node)
   }
 }
 
-void calculate_pending_parents(Depsgraph *graph)
+void calculate_pending_parents(DepsgraphEvalState *state)
 {
-  for (OperationNode *node : graph->operations) {
+  for (OperationNode *node : *state->operations) {
     calculate_pending_parents_for_node(node);
   }
 }
 
-void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
+void initialize_execution(DepsgraphEvalState *state)
 {
   const bool do_stats = state->do_stats;
-  calculate_pending_parents(graph);
+  calculate_pending_parents(state);
   /* Clear tags and other things which needs to be clear. */
-  for (OperationNode *node : graph->operations) {
+  for (OperationNode *node : *state->operations) {
     if (do_stats) {
       node->stats.reset_current();
     }
@@ -286,7 +299,7 @@ void schedule_graph(DepsgraphEvalState *state,
                     ScheduleFunction *schedule_function,
                     ScheduleFunctionArgs... schedule_function_args)
 {
-  for (OperationNode *node : state->graph->operations) {
+  for (OperationNode *node : *state->operations) {
     schedule_node(state, node, false, -1, schedule_function, schedule_function_args...);
   }
 }
@@ -330,13 +343,27 @@ void evaluate_graph_single_threaded(DepsgraphEvalState *state)
     OperationNode *operation_node;
     BLI_gsqueue_pop(evaluation_queue, &operation_node);
 
-    evaluate_node(state, operation_node);
+    evaluate_node(state, operation_node, 0);
     schedule_children(state, operation_node, 0, schedule_node_to_queue, evaluation_queue);
   }
 
   BLI_gsqueue_free(evaluation_queue);
 }
 
+/* Record the stage which began at stage_start_time to the trace,
+ * and set stage_start_time to the start of the next stage. */
+void deg_eval_trace_stage(const DepsgraphEvalState *state,
+                          const char *name,
+                          double *stage_start_time)
+{
+  if (!state->do_trace) {
+    return;
+  }
+  const double end_time = PIL_check_seconds_timer();
+  state->graph->debug.trace.record_stage(name, *stage_start_time, end_time);
+  *stage_start_time = end_time;
+}
+
 void depsgraph_ensure_view_layer(Depsgraph *graph)
 {
   /* We update copy-on-write scene in the following cases:
@@ -366,6 +393,8 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
 {
   /* Nothing to update, early out. */
   if (BLI_gset_len(graph->entry_tags) == 0) {
+    graph->debug.num_visited_operations = 0;
+    graph->debug.num_updated_operations = 0;
     return;
   }
 
@@ -376,7 +405,10 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   /* Set up evaluation state. */
   DepsgraphEvalState state;
   state.graph = graph;
+  state.operations = graph->use_sparse_evaluation ? &graph->affected_operations :
+                                                    &graph->operations;
   state.do_stats = graph->debug.do_time_debug();
+  state.do_trace = graph->debug.trace.is_recording();
   state.need_single_thread_pass = false;
   /* Set up task scheduler and pull for threaded evaluation. */
   TaskScheduler *task_scheduler;
@@ -390,8 +422,13 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     need_free_scheduler = false;
   }
   TaskPool *task_pool = BLI_task_pool_create_suspended(task_scheduler, &state);
+  if (state.do_trace) {
+    graph->debug.trace.begin_evaluation(BLI_task_scheduler_num_threads(task_scheduler));
+  }
   /* Prepare all nodes for evaluation. */
-  initialize_execution(&state, graph);
+  double stage_start_time = PIL_check_seconds_timer();
+  initialize_execution(&state);
+  deg_eval_trace_stage(&state, "Initialize", &stage_start_time);
 
   /* Do actual evaluation now. */
 
@@ -399,18 +436,28 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   state.stage = EvaluationStage::COPY_ON_WRITE;
   schedule_graph(&state, schedule_node_to_pool, task_pool);
   BLI_task_pool_work_wait_and_reset(task_pool);
+  deg_eval_trace_stage(&state, "Copy-on-Write", &stage_start_time);
 
   /* After that, process all other nodes. */
   state.stage = EvaluationStage::THREADED_EVALUATION;
   schedule_graph(&state, schedule_node_to_pool, task_pool);
   BLI_task_pool_work_and_wait(task_pool);
   BLI_task_pool_free(task_pool);
+  deg_eval_trace_stage(&state, "Threaded Evaluation", &stage_start_time);
 
   if (state.need_single_thread_pass) {
     state.stage = EvaluationStage::SINGLE_THREADED_WORKAROUND;
     evaluate_graph_single_threaded(&state);
+    deg_eval_trace_stage(&state, "Single Threaded Evaluation", &stage_start_time);
   }
 
+  if (state.do_trace) {
+    graph->debug.trace.end_evaluation();
+  }
+
+  graph->debug.num_visited_operations = state.operations->size();
+  graph->debug.num_updated_operations = graph->affected_operations.size();
+
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
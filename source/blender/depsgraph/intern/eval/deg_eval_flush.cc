@@ -85,6 +85,20 @@ enum {
 
 typedef deque<OperationNode *> FlushQueue;
 
+/* State of the flush.
+ *
+ * The full flush resets the scratch flags of all the nodes first. The sparse flush can't rely on
+ * the flags of the nodes it didn't visit, since other traversals of the graph leave them set, so
+ * it keeps track of the visited nodes itself and only resets the flags of the modified IDs. */
+struct FlushState {
+  Depsgraph *graph;
+  bool is_sparse;
+  set<OperationNode *> scheduled_operations;
+  set<IDNode *> modified_id_nodes_set;
+  /* Modified ID nodes in the order they were reached, only used by the sparse flush. */
+  vector<IDNode *> modified_id_nodes;
+};
+
 namespace {
 
 void flush_init_id_node_func(void *__restrict data_v,
@@ -99,8 +113,13 @@ void flush_init_id_node_func(void *__restrict data_v,
   GHASH_FOREACH_END();
 }
 
-BLI_INLINE void flush_prepare(Depsgraph *graph)
+BLI_INLINE void flush_prepare(FlushState *state)
 {
+  Depsgraph *graph = state->graph;
+  if (state->is_sparse) {
+    return;
+  }
+
   for (OperationNode *node : graph->operations) {
     node->scheduled = false;
   }
@@ -114,11 +133,42 @@ BLI_INLINE void flush_prepare(Depsgraph *graph)
   }
 }
 
-BLI_INLINE void flush_schedule_entrypoints(Depsgraph *graph, FlushQueue *queue)
+BLI_INLINE bool flush_is_scheduled(FlushState *state, OperationNode *op_node)
+{
+  if (state->is_sparse) {
+    return state->scheduled_operations.find(op_node) != state->scheduled_operations.end();
+  }
+  return op_node->scheduled;
+}
+
+BLI_INLINE void flush_mark_scheduled(FlushState *state, OperationNode *op_node)
+{
+  if (state->is_sparse) {
+    state->scheduled_operations.insert(op_node);
+  }
+  else {
+    op_node->scheduled = true;
+  }
+}
+
+/* Tag operation for update and remember it as affected. Entry tags are already tagged and are
+ * added to the affected operations when scheduled. */
+BLI_INLINE void flush_tag_operation(Depsgraph *graph, OperationNode *op_node)
 {
+  if (op_node->flag & DEPSOP_FLAG_NEEDS_UPDATE) {
+    return;
+  }
+  op_node->flag |= DEPSOP_FLAG_NEEDS_UPDATE;
+  graph->affected_operations.push_back(op_node);
+}
+
+BLI_INLINE void flush_schedule_entrypoints(FlushState *state, FlushQueue *queue)
+{
+  Depsgraph *graph = state->graph;
   GSET_FOREACH_BEGIN (OperationNode *, op_node, graph->entry_tags) {
     queue->push_back(op_node);
-    op_node->scheduled = true;
+    flush_mark_scheduled(state, op_node);
+    graph->affected_operations.push_back(op_node);
     DEG_DEBUG_PRINTF((::Depsgraph *)graph,
                      EVAL,
                      "Operation is entry point for update: %s\n",
@@ -127,13 +177,21 @@ BLI_INLINE void flush_schedule_entrypoints(Depsgraph *graph, FlushQueue *queue)
   GSET_FOREACH_END();
 }
 
-BLI_INLINE void flush_handle_id_node(IDNode *id_node)
+BLI_INLINE void flush_handle_id_node(FlushState *state, IDNode *id_node)
 {
+  if (state->is_sparse && state->modified_id_nodes_set.insert(id_node).second) {
+    /* First time the ID is reached, its component flags are not reset by the preparation. */
+    GHASH_FOREACH_BEGIN (ComponentNode *, comp_node, id_node->components)
+      comp_node->custom_flags = COMPONENT_STATE_NONE;
+    GHASH_FOREACH_END();
+    state->modified_id_nodes.push_back(id_node);
+  }
   id_node->custom_flags = ID_STATE_MODIFIED;
 }
 
 /* TODO(sergey): We can reduce number of arguments here. */
-BLI_INLINE void flush_handle_component_node(IDNode *id_node,
+BLI_INLINE void flush_handle_component_node(Depsgraph *graph,
+                                            IDNode *id_node,
                                             ComponentNode *comp_node,
                                             FlushQueue *queue)
 {
@@ -149,7 +207,7 @@ BLI_INLINE void flush_handle_component_node(IDNode *id_node,
   if (comp_node->type != NodeType::PARTICLE_SETTINGS &&
       comp_node->type != NodeType::PARTICLE_SYSTEM) {
     for (OperationNode *op : comp_node->operations) {
-      op->flag |= DEPSOP_FLAG_NEEDS_UPDATE;
+      flush_tag_operation(graph, op);
     }
   }
   /* when some target changes bone, we might need to re-run the
@@ -170,7 +228,9 @@ BLI_INLINE void flush_handle_component_node(IDNode *id_node,
  * return value, so it can start being handled right away, without building too
  * much of a queue.
  */
-BLI_INLINE OperationNode *flush_schedule_children(OperationNode *op_node, FlushQueue *queue)
+BLI_INLINE OperationNode *flush_schedule_children(FlushState *state,
+                                                  OperationNode *op_node,
+                                                  FlushQueue *queue)
 {
   if (op_node->flag & DEPSOP_FLAG_USER_MODIFIED) {
     IDNode *id_node = op_node->owner->owner;
@@ -194,7 +254,7 @@ BLI_INLINE OperationNode *flush_schedule_children(OperationNode *op_node, FlushQ
      * to their parents. */
     to_node->flag |= (op_node->flag & DEPSOP_FLAG_FLUSH);
     /* Flush update over the relation, if it was not flushed yet. */
-    if (to_node->scheduled) {
+    if (flush_is_scheduled(state, to_node)) {
       continue;
     }
     if (result != nullptr) {
@@ -203,7 +263,7 @@ BLI_INLINE OperationNode *flush_schedule_children(OperationNode *op_node, FlushQ
     else {
       result = to_node;
     }
-    to_node->scheduled = true;
+    flush_mark_scheduled(state, to_node);
   }
   return result;
 }
@@ -220,9 +280,12 @@ void flush_engine_data_update(ID *id)
 }
 
 /* NOTE: It will also accumulate flags from changed components. */
-void flush_editors_id_update(Depsgraph *graph, const DEGEditorUpdateContext *update_ctx)
+void flush_editors_id_update(const FlushState *state, const DEGEditorUpdateContext *update_ctx)
 {
-  for (IDNode *id_node : graph->id_nodes) {
+  Depsgraph *graph = state->graph;
+  const vector<IDNode *> &id_nodes = state->is_sparse ? state->modified_id_nodes :
+                                                        graph->id_nodes;
+  for (IDNode *id_node : id_nodes) {
     if (id_node->custom_flags != ID_STATE_MODIFIED) {
       continue;
     }
@@ -296,10 +359,12 @@ void invalidate_tagged_evaluated_geometry(ID *id)
 }
 #endif
 
-void invalidate_tagged_evaluated_data(Depsgraph *graph)
+void invalidate_tagged_evaluated_data(const FlushState *state)
 {
 #ifdef INVALIDATE_ON_FLUSH
-  for (IDNode *id_node : graph->id_nodes) {
+  const vector<IDNode *> &id_nodes = state->is_sparse ? state->modified_id_nodes :
+                                                        state->graph->id_nodes;
+  for (IDNode *id_node : id_nodes) {
     if (id_node->custom_flags != ID_STATE_MODIFIED) {
       continue;
     }
@@ -325,7 +390,7 @@ void invalidate_tagged_evaluated_data(Depsgraph *graph)
     GHASH_FOREACH_END();
   }
 #else
-  (void)graph;
+  (void)state;
 #endif
 }
 
@@ -351,10 +416,13 @@ void deg_graph_flush_updates(Main *bmain, Depsgraph *graph)
     return;
   }
   /* Reset all flags, get ready for the flush. */
-  flush_prepare(graph);
+  FlushState state;
+  state.graph = graph;
+  state.is_sparse = graph->use_sparse_evaluation;
+  flush_prepare(&state);
   /* Starting from the tagged "entry" nodes, flush outwards. */
   FlushQueue queue;
-  flush_schedule_entrypoints(graph, &queue);
+  flush_schedule_entrypoints(&state, &queue);
   /* Prepare update context for editors. */
   DEGEditorUpdateContext update_ctx;
   update_ctx.bmain = bmain;
@@ -367,31 +435,49 @@ void deg_graph_flush_updates(Main *bmain, Depsgraph *graph)
     queue.pop_front();
     while (op_node != nullptr) {
       /* Tag operation as required for update. */
-      op_node->flag |= DEPSOP_FLAG_NEEDS_UPDATE;
+      flush_tag_operation(graph, op_node);
       /* Inform corresponding ID and component nodes about the change. */
       ComponentNode *comp_node = op_node->owner;
       IDNode *id_node = comp_node->owner;
-      flush_handle_id_node(id_node);
-      flush_handle_component_node(id_node, comp_node, &queue);
+      flush_handle_id_node(&state, id_node);
+      flush_handle_component_node(graph, id_node, comp_node, &queue);
       /* Flush to nodes along links. */
-      op_node = flush_schedule_children(op_node, &queue);
+      op_node = flush_schedule_children(&state, op_node, &queue);
     }
   }
   /* Inform editors about all changes. */
-  flush_editors_id_update(graph, &update_ctx);
+  flush_editors_id_update(&state, &update_ctx);
   /* Reset evaluation result tagged which is tagged for update to some state
    * which is obvious to catch. */
-  invalidate_tagged_evaluated_data(graph);
+  invalidate_tagged_evaluated_data(&state);
+}
+
+BLI_INLINE void clear_operation_tags(OperationNode *node)
+{
+  node->flag &= ~(DEPSOP_FLAG_DIRECTLY_MODIFIED | DEPSOP_FLAG_NEEDS_UPDATE |
+                  DEPSOP_FLAG_USER_MODIFIED);
 }
 
 /* Clear tags from all operation nodes. */
 void deg_graph_clear_tags(Depsgraph *graph)
 {
-  /* Go over all operation nodes, clearing tags. */
-  for (OperationNode *node : graph->operations) {
-    node->flag &= ~(DEPSOP_FLAG_DIRECTLY_MODIFIED | DEPSOP_FLAG_NEEDS_UPDATE |
-                    DEPSOP_FLAG_USER_MODIFIED);
+  if (graph->use_sparse_evaluation) {
+    /* Only the affected operations and the entry tags added since the flush are tagged. */
+    for (OperationNode *node : graph->affected_operations) {
+      clear_operation_tags(node);
+    }
+    GSET_FOREACH_BEGIN (OperationNode *, node, graph->entry_tags) {
+      clear_operation_tags(node);
+    }
+    GSET_FOREACH_END();
+  }
+  else {
+    /* Go over all operation nodes, clearing tags. */
+    for (OperationNode *node : graph->operations) {
+      clear_operation_tags(node);
+    }
   }
+  graph->affected_operations.clear();
   /* Clear any entry tags which haven't been flushed. */
   BLI_gset_clear(graph->entry_tags, nullptr);
 }
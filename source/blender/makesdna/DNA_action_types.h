@@ -686,6 +686,10 @@ typedef enum eAction_Flags {
   ACT_MUTED = (1 << 9),
   /* ACT_PROTECTED = (1 << 10), */ /* UNUSED */
   /* ACT_DISABLED = (1 << 11), */  /* UNUSED */
+
+  /* game engine */
+  /** Sample the action at each frame when converted, playback interpolates the samples. */
+  ACT_GAME_BAKE = (1 << 12),
 } eAction_Flags;
 
 /* ************************************************ */
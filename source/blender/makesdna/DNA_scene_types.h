@@ -834,7 +834,8 @@ typedef struct RecastData {
   float detailsamplemaxerror;
   char partitioning;
   char _pad1;
-  short _pad2;
+  /* Size in cells of the game engine navigation mesh tiles, 0 for a single static mesh. */
+  short tilesize;
 } RecastData;
 
 /* RecastData.partitioning */
@@ -942,6 +943,7 @@ typedef struct GameData {
 #define GAME_USE_UNDO (1 << 19)
 #define GAME_USE_UI_ANTI_FLICKER (1 << 20)
 #define GAME_USE_VIEWPORT_RENDER (1 << 21)
+#define GAME_INTERPOLATE_TRANSFORMS (1 << 22)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
@@ -851,6 +851,14 @@ static void rna_def_action(BlenderRNA *brna)
                            "DO NOT CHANGE UNLESS YOU KNOW WHAT YOU ARE DOING");
   RNA_def_property_translation_context(prop, BLT_I18NCONTEXT_ID_ID);
 
+  prop = RNA_def_property(srna, "use_game_bake", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", ACT_GAME_BAKE);
+  RNA_def_property_ui_text(prop,
+                           "Game Engine Bake",
+                           "Sample the action at each frame when the game engine plays it, "
+                           "the playback linearly interpolates the samples instead of "
+                           "evaluating the F-Curves");
+
   /* API calls */
   RNA_api_action(srna);
 }
@@ -244,6 +244,43 @@ static void rna_Depsgraph_debug_stats_gnuplot(Depsgraph *depsgraph,
   fclose(f);
 }
 
+static void rna_Depsgraph_debug_trace_begin(Depsgraph *depsgraph, ReportList *reports)
+{
+  if (DEG_is_evaluating(depsgraph)) {
+    BKE_report(reports, RPT_ERROR, "Dependency graph trace can not begin during evaluation");
+    return;
+  }
+  DEG_debug_trace_begin(depsgraph);
+}
+
+static void rna_Depsgraph_debug_trace_end(Depsgraph *depsgraph, ReportList *reports)
+{
+  if (DEG_is_evaluating(depsgraph)) {
+    BKE_report(reports, RPT_ERROR, "Dependency graph trace can not end during evaluation");
+    return;
+  }
+  DEG_debug_trace_end(depsgraph);
+}
+
+static bool rna_Depsgraph_debug_trace_is_recording_get(PointerRNA *ptr)
+{
+  Depsgraph *depsgraph = (Depsgraph *)ptr->data;
+  return DEG_debug_trace_is_recording(depsgraph);
+}
+
+static void rna_Depsgraph_debug_trace_chrome_json(Depsgraph *depsgraph,
+                                                  ReportList *reports,
+                                                  const char *filename)
+{
+  FILE *f = fopen(filename, "w");
+  if (f == NULL) {
+    BKE_reportf(reports, RPT_ERROR, "Could not open file '%s' for writing", filename);
+    return;
+  }
+  DEG_debug_trace_chrome_json(depsgraph, f);
+  fclose(f);
+}
+
 static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
 {
   DEG_graph_tag_relations_update(depsgraph);
@@ -643,6 +680,33 @@ static void rna_def_depsgraph(BlenderRNA *brna)
                                   "File name where gnuplot script will save the result");
   RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
 
+  func = RNA_def_function(srna, "debug_trace_begin", "rna_Depsgraph_debug_trace_begin");
+  RNA_def_function_ui_description(
+      func,
+      "Begin recording the time and thread of every operation evaluated by the following "
+      "updates, discarding the previous recording");
+  RNA_def_function_flag(func, FUNC_USE_REPORTS);
+
+  func = RNA_def_function(srna, "debug_trace_end", "rna_Depsgraph_debug_trace_end");
+  RNA_def_function_ui_description(
+      func, "End recording the evaluations, the recording can still be written to a file");
+  RNA_def_function_flag(func, FUNC_USE_REPORTS);
+
+  prop = RNA_def_property(srna, "is_debug_trace_recording", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_funcs(prop, "rna_Depsgraph_debug_trace_is_recording_get", NULL);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop, "Is Trace Recording", "Evaluations are recorded, see debug_trace_begin()");
+
+  func = RNA_def_function(
+      srna, "debug_trace_chrome_json", "rna_Depsgraph_debug_trace_chrome_json");
+  RNA_def_function_ui_description(
+      func, "Write the recorded evaluations in the Chrome trace event format (JSON)");
+  RNA_def_function_flag(func, FUNC_USE_REPORTS);
+  parm = RNA_def_string_file_path(
+      func, "filename", NULL, FILE_MAX, "File Name", "Output path for the trace file");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
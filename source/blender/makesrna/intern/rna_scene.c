@@ -4970,6 +4970,16 @@ static void rna_def_scene_game_recast_data(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Max Sample Error", "Detail mesh simplification max sample error");
   RNA_def_property_update(prop, NC_SCENE, NULL);
+
+  prop = RNA_def_property(srna, "tile_size", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "tilesize");
+  RNA_def_property_range(prop, 0, 4096);
+  RNA_def_property_ui_range(prop, 0, 1024, 8, -1);
+  RNA_def_property_ui_text(prop,
+                           "Tile Size",
+                           "Size in cells of the navigation mesh tiles used by the game engine, "
+                           "tiles can be rebuilt individually at runtime (0 for a single mesh)");
+  RNA_def_property_update(prop, NC_SCENE, NULL);
 }
 
 static void rna_def_bake_data(BlenderRNA *brna)
@@ -5486,6 +5496,13 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
                            "Respect the frame rate from the Physics panel in the world properties "
                            "rather than rendering as many frames as possible");
 
+  prop = RNA_def_property(srna, "use_transform_interpolation", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_INTERPOLATE_TRANSFORMS);
+  RNA_def_property_ui_text(prop,
+                           "Interpolate Transforms",
+                           "Render the objects between their last two logic states, allowing to "
+                           "render more frames than the logic tic rate without stuttering");
+
   prop = RNA_def_property(srna, "use_deprecation_warnings", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, NULL, "flag", GAME_IGNORE_DEPRECATION_WARNINGS);
   RNA_def_property_ui_text(prop,
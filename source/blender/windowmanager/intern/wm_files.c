@@ -1422,6 +1422,8 @@ static bool wm_file_write(bContext *C, const char *filepath, int fileflags, Repo
     }
 
     SET_FLAG_FROM_TEST(G.fileflags, fileflags & G_FILE_COMPRESS, G_FILE_COMPRESS);
+    SET_FLAG_FROM_TEST(
+        G.fileflags, fileflags & G_FILE_COMPRESS_CHUNKED, G_FILE_COMPRESS_CHUNKED);
     SET_FLAG_FROM_TEST(G.fileflags, fileflags & G_FILE_AUTOPLAY, G_FILE_AUTOPLAY);
 
     /* prevent background mode scripts from clobbering history */
@@ -1537,7 +1539,8 @@ void wm_autosave_timer(Main *bmain, wmWindowManager *wm, wmTimer *UNUSED(wt))
   }
   else {
     /* Save as regular blend file. */
-    int fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_HISTORY | G_FILE_AUTOPLAY);
+    int fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_COMPRESS_CHUNKED | G_FILE_HISTORY |
+                                    G_FILE_AUTOPLAY);
 
     ED_editors_flush_edits(bmain);
 
@@ -1670,7 +1673,8 @@ static int wm_homefile_write_exec(bContext *C, wmOperator *op)
   ED_editors_flush_edits(bmain);
 
   /* Force save as regular blend file. */
-  fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_HISTORY | G_FILE_AUTOPLAY);
+  fileflags = G.fileflags &
+              ~(G_FILE_COMPRESS | G_FILE_COMPRESS_CHUNKED | G_FILE_HISTORY | G_FILE_AUTOPLAY);
 
   if (BLO_write_file(bmain, filepath, fileflags, op->reports, NULL) == 0) {
     printf("fail\n");
@@ -2557,6 +2561,11 @@ static void save_set_compress(wmOperator *op)
       RNA_property_boolean_set(op->ptr, prop, (U.flag & USER_FILECOMPRESS) != 0);
     }
   }
+
+  prop = RNA_struct_find_property(op->ptr, "compress_chunked");
+  if (!RNA_property_is_set(op->ptr, prop) && G.save_over) { /* keep flag for existing file */
+    RNA_property_boolean_set(op->ptr, prop, (G.fileflags & G_FILE_COMPRESS_CHUNKED) != 0);
+  }
 }
 
 static void save_set_filepath(bContext *C, wmOperator *op)
@@ -2614,6 +2623,8 @@ static int wm_save_as_mainfile_exec(bContext *C, wmOperator *op)
 
   /* set compression flag */
   SET_FLAG_FROM_TEST(fileflags, RNA_boolean_get(op->ptr, "compress"), G_FILE_COMPRESS);
+  SET_FLAG_FROM_TEST(
+      fileflags, RNA_boolean_get(op->ptr, "compress_chunked"), G_FILE_COMPRESS_CHUNKED);
   SET_FLAG_FROM_TEST(fileflags, RNA_boolean_get(op->ptr, "relative_remap"), G_FILE_RELATIVE_REMAP);
   SET_FLAG_FROM_TEST(
       fileflags,
@@ -2678,6 +2689,11 @@ void WM_OT_save_as_mainfile(wmOperatorType *ot)
                                  FILE_DEFAULTDISPLAY,
                                  FILE_SORT_ALPHA);
   RNA_def_boolean(ot->srna, "compress", false, "Compress", "Write compressed .blend file");
+  RNA_def_boolean(ot->srna,
+                  "compress_chunked",
+                  false,
+                  "Compress Chunked",
+                  "Write .blend file compressed in blocks decompressed in parallel on load");
   RNA_def_boolean(ot->srna,
                   "relative_remap",
                   true,
@@ -2750,6 +2766,11 @@ void WM_OT_save_mainfile(wmOperatorType *ot)
                                  FILE_DEFAULTDISPLAY,
                                  FILE_SORT_ALPHA);
   RNA_def_boolean(ot->srna, "compress", false, "Compress", "Write compressed .blend file");
+  RNA_def_boolean(ot->srna,
+                  "compress_chunked",
+                  false,
+                  "Compress Chunked",
+                  "Write .blend file compressed in blocks decompressed in parallel on load");
   RNA_def_boolean(ot->srna,
                   "relative_remap",
                   false,
@@ -590,7 +590,8 @@ void WM_exit_ex(bContext *C, const bool do_python)
         Main *bmain = CTX_data_main(C);
         char filename[FILE_MAX];
         bool has_edited;
-        int fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_AUTOPLAY | G_FILE_HISTORY);
+        int fileflags = G.fileflags & ~(G_FILE_COMPRESS | G_FILE_COMPRESS_CHUNKED |
+                                        G_FILE_AUTOPLAY | G_FILE_HISTORY);
 
         BLI_join_dirfile(filename, sizeof(filename), BKE_tempdir_base(), BLENDER_QUIT_FILE);
 
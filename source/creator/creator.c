@@ -287,17 +287,27 @@ int main(int argc,
    *       guarded allocator before any allocation happened.
    */
   {
+    bool use_thread_cache = false;
     int i;
     for (i = 0; i < argc; i++) {
       if (STR_ELEM(argv[i], "-d", "--debug", "--debug-memory", "--debug-all")) {
         printf("Switching to fully guarded memory allocator.\n");
         MEM_use_guarded_allocator();
+        use_thread_cache = false;
         break;
       }
+      else if (STREQ(argv[i], "--thread-cache-memory")) {
+        use_thread_cache = true;
+      }
       else if (STREQ(argv[i], "--")) {
         break;
       }
     }
+
+    if (use_thread_cache) {
+      printf("Switching to thread cache memory allocator.\n");
+      MEM_use_threadcache_allocator();
+    }
   }
 
 #ifdef BUILD_DATE
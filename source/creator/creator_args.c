@@ -632,6 +632,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_argsPrintArgDoc(ba, "--factory-startup");
   BLI_argsPrintArgDoc(ba, "--disable-library-override");
   BLI_argsPrintArgDoc(ba, "--enable-event-simulate");
+  BLI_argsPrintArgDoc(ba, "--thread-cache-memory");
   printf("\n");
   BLI_argsPrintArgDoc(ba, "--env-system-datafiles");
   BLI_argsPrintArgDoc(ba, "--env-system-scripts");
@@ -764,6 +765,18 @@ static int arg_handle_abort_handler_disable(int UNUSED(argc),
   return 0;
 }
 
+static const char arg_handle_thread_cache_memory_set_doc[] =
+    "\n\t"
+    "Use per-thread caches for small memory allocations, faster with many threads\n"
+    "\tbut keeping more memory reserved. Ignored with memory debugging.";
+static int arg_handle_thread_cache_memory_set(int UNUSED(argc),
+                                              const char **UNUSED(argv),
+                                              void *UNUSED(data))
+{
+  /* The allocator is switched in main() before any allocation. */
+  return 0;
+}
+
 static const char arg_handle_background_mode_set_doc[] =
     "\n\t"
     "Run in background (often used for UI-less rendering).";
@@ -2141,6 +2154,8 @@ void main_args_setup(bContext *C, bArgs *ba, SYS_SystemHandle *syshandle)
 
   BLI_argsAdd(ba, 1, NULL, "--disable-crash-handler", CB(arg_handle_crash_handler_disable), NULL);
   BLI_argsAdd(ba, 1, NULL, "--disable-abort-handler", CB(arg_handle_abort_handler_disable), NULL);
+  BLI_argsAdd(
+      ba, 1, NULL, "--thread-cache-memory", CB(arg_handle_thread_cache_memory_set), NULL);
 
   BLI_argsAdd(ba, 1, "-b", "--background", CB(arg_handle_background_mode_set), NULL);
 
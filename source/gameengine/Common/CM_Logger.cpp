@@ -0,0 +1,452 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Logger.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "termcolor.hpp"
+
+/// Number of messages of the ring buffer, a power of two.
+#define LOG_RING_SIZE 4096
+/// Delay of the background thread when no message is pending, in milliseconds.
+#define LOG_POLL_DELAY 5
+/// Duration of the rate limiting window, in seconds.
+#define LOG_RATE_WINDOW 1.0
+
+/** Bounded lock-free queue with multiple producers and a single consumer.
+ * Each slot has a sequence number telling if it is free for the producer of a position or
+ * written for the consumer of a position, a producer reserves a position with a compare and swap.
+ */
+struct CM_LogRing {
+  struct Slot {
+    std::atomic<unsigned int> sequence;
+    CM_Logger::Level level;
+    double time;
+    std::string text;
+  };
+
+  Slot slots[LOG_RING_SIZE];
+  std::atomic<unsigned int> enqueuePos;
+  /// Only accessed by the consumer.
+  unsigned int dequeuePos;
+
+  CM_LogRing() : enqueuePos(0), dequeuePos(0)
+  {
+    for (unsigned int i = 0; i < LOG_RING_SIZE; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /// \return False if the ring is full.
+  bool Push(CM_Logger::Level level, double time, const std::string &text)
+  {
+    unsigned int pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+      slot = &slots[pos & (LOG_RING_SIZE - 1)];
+      const unsigned int sequence = slot->sequence.load(std::memory_order_acquire);
+      const int diff = (int)(sequence - pos);
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+
+    slot->level = level;
+    slot->time = time;
+    slot->text = text;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// \return False if the ring is empty.
+  bool Pop(CM_Logger::Level &level, double &time, std::string &text)
+  {
+    Slot &slot = slots[dequeuePos & (LOG_RING_SIZE - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+      return false;
+    }
+
+    level = slot.level;
+    time = slot.time;
+    text.swap(slot.text);
+    slot.text.clear();
+    slot.sequence.store(dequeuePos + LOG_RING_SIZE, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+  }
+};
+
+/// Rate limiting state of an identical message.
+struct CM_LogRate {
+  CM_Logger::Level level;
+  double windowStart;
+  unsigned int count;
+  unsigned int suppressed;
+};
+
+static std::atomic<int> logFormat(CM_Logger::FORMAT_TEXT);
+static std::atomic<bool> logAsync(false);
+/// Number of threads pushing a message, the ring is freed once no thread uses it.
+static std::atomic<int> logProducers(0);
+static std::atomic<bool> logRunning(false);
+static std::atomic<unsigned int> logDropped(0);
+static CM_LogRing *logRing = nullptr;
+static std::thread *logThread = nullptr;
+static unsigned int logRateLimit = 0;
+
+static double CurrentTime()
+{
+  return std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+/// Apply a color of the message text to a stream, termcolor ignores it if not a terminal.
+static void ApplyColor(std::ostream &stream, char color)
+{
+#ifdef WIN32
+  // The console attributes apply to the text written after, write the previous text first.
+  stream.flush();
+#endif
+  switch (color) {
+    case CM_Logger::COLOR_RESET: {
+      stream << termcolor::reset;
+      break;
+    }
+    case CM_Logger::COLOR_BOLD: {
+      stream << termcolor::bold;
+      break;
+    }
+    case CM_Logger::COLOR_GREEN: {
+      stream << termcolor::green;
+      break;
+    }
+    case CM_Logger::COLOR_YELLOW: {
+      stream << termcolor::yellow;
+      break;
+    }
+    case CM_Logger::COLOR_RED: {
+      stream << termcolor::red;
+      break;
+    }
+  }
+}
+
+/// Write formatted lines to the standard output, converting their color markers.
+static void WriteLines(const std::string &lines)
+{
+  static std::mutex writeMutex;
+  std::lock_guard<std::mutex> lock(writeMutex);
+
+  size_t begin = 0;
+  while (begin < lines.size()) {
+    const size_t marker = lines.find(CM_LOG_COLOR_MARKER, begin);
+    const size_t end = (marker == std::string::npos) ? lines.size() : marker;
+    std::cout.write(lines.data() + begin, end - begin);
+    if (end + 1 >= lines.size()) {
+      break;
+    }
+    ApplyColor(std::cout, lines[end + 1]);
+    begin = end + 2;
+  }
+  std::cout.flush();
+}
+
+/// Append a message text as a JSON string content, without its color markers.
+static void AppendEscaped(std::string &line, const std::string &text)
+{
+  for (size_t i = 0, size = text.size(); i < size; ++i) {
+    const char c = text[i];
+    switch (c) {
+      case CM_LOG_COLOR_MARKER: {
+        ++i;
+        break;
+      }
+      case '"': {
+        line += "\\\"";
+        break;
+      }
+      case '\\': {
+        line += "\\\\";
+        break;
+      }
+      case '\n': {
+        line += "\\n";
+        break;
+      }
+      case '\r': {
+        line += "\\r";
+        break;
+      }
+      case '\t': {
+        line += "\\t";
+        break;
+      }
+      default: {
+        if ((unsigned char)c < 0x20) {
+          char code[8];
+          snprintf(code, sizeof(code), "\\u%04x", c);
+          line += code;
+        }
+        else {
+          line += c;
+        }
+        break;
+      }
+    }
+  }
+}
+
+/// Append a formatted message with its trailing new line.
+static void AppendLine(std::string &line,
+                       CM_Logger::Level level,
+                       double time,
+                       const std::string &text,
+                       unsigned int suppressed)
+{
+  if (logFormat.load(std::memory_order_relaxed) == CM_Logger::FORMAT_JSON) {
+    static const char *names[] = {"info", "debug", "warning", "error"};
+    char timeStr[32];
+    snprintf(timeStr, sizeof(timeStr), "%.3f", time);
+
+    line += "{\"time\":";
+    line += timeStr;
+    line += ",\"level\":\"";
+    line += names[level];
+    line += "\",\"message\":\"";
+    AppendEscaped(line, text);
+    line += "\"";
+    if (suppressed > 0) {
+      line += ",\"suppressed\":" + std::to_string(suppressed);
+    }
+    line += "}\n";
+    return;
+  }
+
+  std::ostringstream prefix;
+  switch (level) {
+    case CM_Logger::LEVEL_MESSAGE: {
+      break;
+    }
+    case CM_Logger::LEVEL_DEBUG: {
+      prefix << CM_Logger::COLOR_BOLD << "Debug" << CM_Logger::COLOR_RESET << ": ";
+      break;
+    }
+    case CM_Logger::LEVEL_WARNING: {
+      prefix << CM_Logger::COLOR_YELLOW << CM_Logger::COLOR_BOLD << "Warning"
+             << CM_Logger::COLOR_RESET << ": ";
+      break;
+    }
+    case CM_Logger::LEVEL_ERROR: {
+      prefix << CM_Logger::COLOR_RED << CM_Logger::COLOR_BOLD << "Error"
+             << CM_Logger::COLOR_RESET << ": ";
+      break;
+    }
+  }
+  line += prefix.str();
+
+  line += text;
+  if (suppressed > 0) {
+    line += " (repeated " + std::to_string(suppressed) + " more times)";
+  }
+  line += '\n';
+}
+
+/// Write the summaries of the suppressed messages of the windows ended before a time.
+static void FlushRates(std::unordered_map<std::string, CM_LogRate> &rates,
+                       double time,
+                       std::string &lines)
+{
+  for (auto it = rates.begin(); it != rates.end();) {
+    CM_LogRate &rate = it->second;
+    if (time - rate.windowStart < LOG_RATE_WINDOW) {
+      ++it;
+      continue;
+    }
+
+    if (rate.suppressed > 0) {
+      AppendLine(lines, rate.level, rate.windowStart, it->first, rate.suppressed);
+    }
+    it = rates.erase(it);
+  }
+}
+
+static void LogThread()
+{
+  std::unordered_map<std::string, CM_LogRate> rates;
+  std::string lines;
+  std::string text;
+  CM_Logger::Level level;
+  double time;
+  double lastFlush = CurrentTime();
+
+  while (true) {
+    // Read the running state before draining so that the messages pushed before a stop are kept.
+    const bool running = logRunning.load(std::memory_order_acquire);
+
+    while (logRing->Pop(level, time, text)) {
+      if (logRateLimit > 0) {
+        CM_LogRate &rate = rates[text];
+        if (rate.count == 0 || time - rate.windowStart >= LOG_RATE_WINDOW) {
+          if (rate.suppressed > 0) {
+            AppendLine(lines, rate.level, rate.windowStart, text, rate.suppressed);
+          }
+          rate.level = level;
+          rate.windowStart = time;
+          rate.count = 0;
+          rate.suppressed = 0;
+        }
+
+        if (++rate.count > logRateLimit) {
+          ++rate.suppressed;
+          continue;
+        }
+      }
+
+      AppendLine(lines, level, time, text, 0);
+    }
+
+    const unsigned int dropped = logDropped.exchange(0);
+    if (dropped > 0) {
+      AppendLine(lines,
+                 CM_Logger::LEVEL_WARNING,
+                 CurrentTime(),
+                 std::to_string(dropped) + " log messages dropped, the log buffer is full",
+                 0);
+    }
+
+    const double now = CurrentTime();
+    if (!running || now - lastFlush >= LOG_RATE_WINDOW) {
+      FlushRates(rates, running ? now : HUGE_VAL, lines);
+      lastFlush = now;
+    }
+
+    if (!lines.empty()) {
+      WriteLines(lines);
+      lines.clear();
+    }
+
+    if (!running) {
+      break;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(LOG_POLL_DELAY));
+  }
+}
+
+CM_Logger::Format CM_Logger::GetFormat()
+{
+  return (Format)logFormat.load(std::memory_order_relaxed);
+}
+
+void CM_Logger::SetFormat(Format format)
+{
+  logFormat.store(format, std::memory_order_relaxed);
+}
+
+void CM_Logger::StartAsync(unsigned int rateLimit)
+{
+  if (logThread) {
+    return;
+  }
+
+  logRing = new CM_LogRing();
+  logRateLimit = rateLimit;
+  logDropped.store(0);
+  logRunning.store(true);
+  logThread = new std::thread(LogThread);
+  logAsync.store(true, std::memory_order_release);
+}
+
+void CM_Logger::StopAsync()
+{
+  if (!logThread) {
+    return;
+  }
+
+  // New messages are written directly, wait for the threads still pushing to the ring.
+  logAsync.store(false);
+  while (logProducers.load() > 0) {
+    std::this_thread::yield();
+  }
+
+  logRunning.store(false, std::memory_order_release);
+  logThread->join();
+  delete logThread;
+  logThread = nullptr;
+  delete logRing;
+  logRing = nullptr;
+}
+
+void CM_Logger::Log(Level level, const std::string &text)
+{
+  logProducers.fetch_add(1);
+  if (logAsync.load()) {
+    if (!logRing->Push(level, CurrentTime(), text)) {
+      logDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    logProducers.fetch_sub(1);
+    return;
+  }
+  logProducers.fetch_sub(1);
+
+  // Write the whole line at once so that the messages of different threads are not mixed.
+  std::string line;
+  AppendLine(line, level, CurrentTime(), text, 0);
+  WriteLines(line);
+}
+
+std::ostream &operator<<(std::ostream &stream, CM_Logger::Color color)
+{
+  return stream << CM_LOG_COLOR_MARKER << (char)color;
+}
+
+CM_LogStream::CM_LogStream(CM_Logger::Level level) : m_level(level)
+{
+}
+
+CM_LogStream::~CM_LogStream()
+{
+  CM_Logger::Log(m_level, str());
+}
+
+std::ostream &CM_LogStream::Stream()
+{
+  return *this;
+}
@@ -0,0 +1,95 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Logger.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_LOGGER_H__
+#define __CM_LOGGER_H__
+
+#include <ostream>
+#include <sstream>
+#include <string>
+
+/** Output of the messages of CM_Message.h.
+ * By default a message is written to the standard output by the thread producing it. In
+ * asynchronous mode the messages are pushed to a lock-free ring buffer and written by a
+ * background thread, the messages are dropped when the buffer is full. The background thread can
+ * also limit the number of identical messages written per second.
+ */
+class CM_Logger {
+ public:
+  enum Level { LEVEL_MESSAGE = 0, LEVEL_DEBUG, LEVEL_WARNING, LEVEL_ERROR };
+
+  /** Colors of the message parts. They are stored in the message text as CM_LOG_COLOR_MARKER
+   * followed by the color, and applied by the text output with termcolor.
+   */
+  enum Color {
+    COLOR_RESET = '0',
+    COLOR_BOLD = 'b',
+    COLOR_GREEN = 'g',
+    COLOR_YELLOW = 'y',
+    COLOR_RED = 'r'
+  };
+
+  enum Format {
+    /// Lines prefixed by the level, colored on a terminal.
+    FORMAT_TEXT = 0,
+    /// One JSON object per line with the time, the level and the message.
+    FORMAT_JSON
+  };
+
+  static Format GetFormat();
+  static void SetFormat(Format format);
+
+  /** Write the messages from a background thread.
+   * \param rateLimit Maximum number of identical messages written per second, 0 for no limit.
+   */
+  static void StartAsync(unsigned int rateLimit);
+  /// Write the pending messages and stop the background thread.
+  static void StopAsync();
+
+  /// Write a message or push it to the background thread.
+  static void Log(Level level, const std::string &text);
+};
+
+/// Start of a color in a message text, see CM_Logger::Color.
+#define CM_LOG_COLOR_MARKER '\x01'
+
+/// Append the marker of a color to a message stream.
+std::ostream &operator<<(std::ostream &stream, CM_Logger::Color color);
+
+/** Stream formatting a message, the message is logged when the stream is destructed at the end of
+ * the statement of the CM_ macros.
+ */
+class CM_LogStream : public std::ostringstream {
+ private:
+  CM_Logger::Level m_level;
+
+ public:
+  CM_LogStream(CM_Logger::Level level);
+  ~CM_LogStream();
+
+  /// Return the stream as a lvalue for the stream operators of the temporary.
+  std::ostream &Stream();
+};
+
+#endif  // __CM_LOGGER_H__
@@ -27,7 +27,6 @@
 #include "CM_Message.h"
 
 #include "BLI_path_util.h"
-#include "termcolor.hpp"
 
 #include "SCA_ILogicBrick.h"
 
@@ -40,23 +39,10 @@ extern "C" {
 
 #endif  // WITH_PYTHON
 
-std::ostream &_CM_PrefixWarning(std::ostream &stream)
-{
-  stream << termcolor::yellow << termcolor::bold << "Warning" << termcolor::reset << ": ";
-  return stream;
-}
-
-std::ostream &_CM_PrefixError(std::ostream &stream)
-{
-  stream << termcolor::red << termcolor::bold << "Error" << termcolor::reset << ": ";
-  return stream;
-}
-
-std::ostream &_CM_PrefixDebug(std::ostream &stream)
-{
-  stream << termcolor::bold << "Debug" << termcolor::reset << ": ";
-  return stream;
-}
+// Colors of the message parts, applied by the logger output.
+static const CM_Logger::Color bold = CM_Logger::COLOR_BOLD;
+static const CM_Logger::Color green = CM_Logger::COLOR_GREEN;
+static const CM_Logger::Color reset = CM_Logger::COLOR_RESET;
 
 #ifdef WITH_PYTHON
 
@@ -72,8 +58,7 @@ std::ostream &_CM_PythonPrefix(std::ostream &stream)
 
   BLI_split_file_part(path, file, sizeof(file));
 
-  stream << termcolor::bold << file << termcolor::reset << "(" << termcolor::bold << line
-         << termcolor::reset << "), ";
+  stream << bold << file << reset << "(" << bold << line << reset << "), ";
   return stream;
 }
 
@@ -84,8 +69,8 @@ _CM_PythonAttributPrefix::_CM_PythonAttributPrefix(std::string className, std::s
 
 std::ostream &operator<<(std::ostream &stream, const _CM_PythonAttributPrefix &prefix)
 {
-  stream << termcolor::green << prefix.m_className << termcolor::reset << "." << termcolor::green
-         << termcolor::bold << prefix.m_attributName << termcolor::reset << ", ";
+  stream << green << prefix.m_className << reset << "." << green << bold << prefix.m_attributName
+         << reset << ", ";
   return stream;
 }
 
@@ -96,8 +81,8 @@ _CM_PythonFunctionPrefix::_CM_PythonFunctionPrefix(std::string className, std::s
 
 std::ostream &operator<<(std::ostream &stream, const _CM_PythonFunctionPrefix &prefix)
 {
-  stream << termcolor::green << prefix.m_className << termcolor::reset << "." << termcolor::green
-         << termcolor::bold << prefix.m_attributName << termcolor::reset << "(...), ";
+  stream << green << prefix.m_className << reset << "." << green << bold << prefix.m_attributName
+         << reset << "(...), ";
   return stream;
 }
 
@@ -116,8 +101,8 @@ _CM_LogicBrickPrefix::_CM_LogicBrickPrefix(SCA_ILogicBrick *brick)
 
 std::ostream &operator<<(std::ostream &stream, const _CM_LogicBrickPrefix &prefix)
 {
-  stream << termcolor::bold << prefix.m_brickName << termcolor::reset << "(" << termcolor::bold
-         << prefix.m_objectName << termcolor::reset << "), ";
+  stream << bold << prefix.m_brickName << reset << "(" << bold << prefix.m_objectName << reset
+         << "), ";
   return stream;
 }
 
@@ -132,6 +117,6 @@ std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix)
   const size_t begin = functionName.substr(0, colons).rfind(" ") + 1;
   const size_t end = functionName.rfind("(") - begin;
 
-  stream << termcolor::bold << functionName.substr(begin, end) << termcolor::reset << "(...), ";
+  stream << bold << functionName.substr(begin, end) << reset << "(...), ";
   return stream;
 }
@@ -30,11 +30,9 @@
 #include <iostream>
 #include <string>
 
-class SCA_ILogicBrick;
+#include "CM_Logger.h"
 
-std::ostream &_CM_PrefixWarning(std::ostream &stream);
-std::ostream &_CM_PrefixError(std::ostream &stream);
-std::ostream &_CM_PrefixDebug(std::ostream &stream);
+class SCA_ILogicBrick;
 
 #ifdef WITH_PYTHON
 
@@ -93,22 +91,22 @@ class _CM_FunctionPrefix {
 
 std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix);
 
-#define CM_Message(msg) std::cout << msg << std::endl;
+#define CM_Message(msg) CM_LogStream(CM_Logger::LEVEL_MESSAGE).Stream() << msg;
 
 /** Format message:
  * Warning: msg
  */
-#define CM_Warning(msg) std::cout << _CM_PrefixWarning << msg << std::endl;
+#define CM_Warning(msg) CM_LogStream(CM_Logger::LEVEL_WARNING).Stream() << msg;
 
 /** Format message:
  * Error: msg
  */
-#define CM_Error(msg) std::cout << _CM_PrefixError << msg << std::endl;
+#define CM_Error(msg) CM_LogStream(CM_Logger::LEVEL_ERROR).Stream() << msg;
 
 /** Format message:
  * Debug: msg
  */
-#define CM_Debug(msg) std::cout << _CM_PrefixDebug << msg << std::endl;
+#define CM_Debug(msg) CM_LogStream(CM_Logger::LEVEL_DEBUG).Stream() << msg;
 
 #ifdef _MSC_VER
 #  define CM_FunctionName __FUNCSIG__
@@ -120,91 +118,92 @@ std::ostream &operator<<(std::ostream &stream, const _CM_FunctionPrefix &prefix)
  * Warning: class::function(...) msg
  */
 #define CM_FunctionWarning(msg) \
-  std::cout << _CM_PrefixWarning << _CM_FunctionPrefix(CM_FunctionName) << msg << std::endl;
+  CM_LogStream(CM_Logger::LEVEL_WARNING).Stream() << _CM_FunctionPrefix(CM_FunctionName) << msg;
 
 /** Format message:
  * Error: class::function(...) msg
  */
 #define CM_FunctionError(msg) \
-  std::cout << _CM_PrefixError << _CM_FunctionPrefix(CM_FunctionName) << msg << std::endl;
+  CM_LogStream(CM_Logger::LEVEL_ERROR).Stream() << _CM_FunctionPrefix(CM_FunctionName) << msg;
 
 /** Format message:
  * Debug: class::function(...) msg
  */
 #define CM_FunctionDebug(msg) \
-  std::cout << _CM_PrefixDebug << _CM_FunctionPrefix(CM_FunctionName) << msg << std::endl;
+  CM_LogStream(CM_Logger::LEVEL_DEBUG).Stream() << _CM_FunctionPrefix(CM_FunctionName) << msg;
 
 #ifdef WITH_PYTHON
 
 /** Format message:
- * prefix: script(line), msg
+ * level: script(line), msg
  */
-#  define _CM_PythonMsg(prefix, msg) std::cout << prefix << _CM_PythonPrefix << msg << std::endl;
+#  define _CM_PythonMsg(level, msg) \
+    CM_LogStream(level).Stream() << _CM_PythonPrefix << msg;
 
 /** Format message:
  * Warning: script(line), msg
  */
-#  define CM_PythonWarning(msg) _CM_PythonMsg(_CM_PrefixWarning, msg)
+#  define CM_PythonWarning(msg) _CM_PythonMsg(CM_Logger::LEVEL_WARNING, msg)
 
 /** Format message:
  * Error: script(line), msg
  */
-#  define CM_PythonError(msg) _CM_PythonMsg(_CM_PrefixError, msg)
+#  define CM_PythonError(msg) _CM_PythonMsg(CM_Logger::LEVEL_ERROR, msg)
 
 /** Format message:
- * prefix: script(line), class.attribut, msg
+ * level: script(line), class.attribut, msg
  */
-#  define _CM_PythonAttributMsg(prefix, class, attribut, msg) \
-    std::cout << prefix << _CM_PythonPrefix << _CM_PythonAttributPrefix(class, attribut) << msg \
-              << std::endl;
+#  define _CM_PythonAttributMsg(level, class, attribut, msg) \
+    CM_LogStream(level).Stream() << _CM_PythonPrefix << _CM_PythonAttributPrefix(class, attribut) \
+                                 << msg;
 
 /** Format message:
  * Warning: script(line), class.attribut, msg
  */
 #  define CM_PythonAttributWarning(class, attribut, msg) \
-    _CM_PythonAttributMsg(_CM_PrefixWarning, class, attribut, msg)
+    _CM_PythonAttributMsg(CM_Logger::LEVEL_WARNING, class, attribut, msg)
 
 /** Format message:
  * Error: script(line), class.attribut, msg
  */
 #  define CM_PythonAttributError(class, attribut, msg) \
-    _CM_PythonAttributMsg(_CM_PrefixError, class, attribut, msg)
+    _CM_PythonAttributMsg(CM_Logger::LEVEL_ERROR, class, attribut, msg)
 
 /** Format message:
- * prefix: script(line), class.function(...), msg
+ * level: script(line), class.function(...), msg
  */
-#  define _CM_PythonFunctionMsg(prefix, class, function, msg) \
-    std::cout << prefix << _CM_PythonPrefix << _CM_PythonFunctionPrefix(class, function) << msg \
-              << std::endl;
+#  define _CM_PythonFunctionMsg(level, class, function, msg) \
+    CM_LogStream(level).Stream() << _CM_PythonPrefix \
+                                 << _CM_PythonFunctionPrefix(class, function) << msg;
 
 /** Format message:
  * Warning: script(line), class.function(...), msg
  */
 #  define CM_PythonFunctionWarning(class, function, msg) \
-    _CM_PythonFunctionMsg(_CM_PrefixWarning, class, function, msg)
+    _CM_PythonFunctionMsg(CM_Logger::LEVEL_WARNING, class, function, msg)
 
 /** Format message:
  * Error: script(line), class.function(...), msg
  */
 #  define CM_PythonFunctionError(class, function, msg) \
-    _CM_PythonFunctionMsg(_CM_PrefixError, class, function, msg)
+    _CM_PythonFunctionMsg(CM_Logger::LEVEL_ERROR, class, function, msg)
 
 #endif  // WITH_PYTHON
 
 /** Format message:
- * prefix: brick(object), msg
+ * level: brick(object), msg
  */
-#define _CM_LogicBrickMsg(prefix, brick, msg) \
-  std::cout << prefix << _CM_LogicBrickPrefix(brick) << msg << std::endl;
+#define _CM_LogicBrickMsg(level, brick, msg) \
+  CM_LogStream(level).Stream() << _CM_LogicBrickPrefix(brick) << msg;
 
 /** Format message:
  * Warning: brick(object), msg
  */
-#define CM_LogicBrickWarning(brick, msg) _CM_LogicBrickMsg(_CM_PrefixWarning, brick, msg)
+#define CM_LogicBrickWarning(brick, msg) _CM_LogicBrickMsg(CM_Logger::LEVEL_WARNING, brick, msg)
 
 /** Format message:
  * Error: brick(object), msg
  */
-#define CM_LogicBrickError(brick, msg) _CM_LogicBrickMsg(_CM_PrefixError, brick, msg)
+#define CM_LogicBrickError(brick, msg) _CM_LogicBrickMsg(CM_Logger::LEVEL_ERROR, brick, msg)
 
 #endif  // __CM_MESSAGE_H__
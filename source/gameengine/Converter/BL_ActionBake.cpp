@@ -0,0 +1,278 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_ActionBake.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_ActionBake.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "BKE_action.h"
+#include "BKE_fcurve.h"
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_curve_types.h"
+#include "MEM_guardedalloc.h"
+
+#include "CM_Message.h"
+
+/// Maximum number of samples of a bake, bigger actions are evaluated from their F-Curves.
+#define BAKE_MAX_SAMPLES (1 << 24)
+
+/** Find how a curve can be computed from its samples at integer frames. The keys must be at
+ * integer frames and use the same kind of interpolation, constant keys are only exact when
+ * sampled without interpolation. Modifiers and sampled points are evaluated.
+ */
+static bool GetCurveSampleMode(const FCurve *fcu, bool &step)
+{
+  if (fcu->modifiers.first || !fcu->bezt) {
+    return false;
+  }
+
+  unsigned int numConstant = 0;
+  for (unsigned int i = 0; i < fcu->totvert; ++i) {
+    const BezTriple *bezt = &fcu->bezt[i];
+    if (bezt->vec[1][0] != std::floor(bezt->vec[1][0])) {
+      return false;
+    }
+    // The interpolation of the last key is not used.
+    if (bezt->ipo == BEZT_IPO_CONST && i + 1 < fcu->totvert) {
+      ++numConstant;
+    }
+  }
+
+  if (numConstant == 0) {
+    step = false;
+    return true;
+  }
+  if (numConstant == fcu->totvert - 1) {
+    step = true;
+    return true;
+  }
+  return false;
+}
+
+BL_ActionBake::BL_ActionBake(bAction *action) : m_start(0.0f), m_numFrames(0)
+{
+  for (FCurve *fcu = (FCurve *)action->curves.first; fcu; fcu = fcu->next) {
+    if (fcu->rna_path) {
+      m_curves.push_back(fcu);
+    }
+  }
+
+  if (m_curves.empty()) {
+    return;
+  }
+
+  float start, end;
+  calc_action_range(action, &start, &end, false);
+  start = std::floor(start);
+  end = std::ceil(end);
+
+  const unsigned int numChannels = m_curves.size();
+  const double numSamples = (double(end - start) + 1.0) * numChannels;
+  if (numSamples > BAKE_MAX_SAMPLES) {
+    CM_Warning("action \"" << action->id.name + 2 << "\" is too long to be baked");
+    return;
+  }
+
+  m_start = start;
+  m_numFrames = (unsigned int)(end - start) + 1;
+  m_samples.resize(m_numFrames * numChannels);
+  m_modes.resize(numChannels);
+
+  for (unsigned int channel = 0; channel < numChannels; ++channel) {
+    FCurve *fcu = m_curves[channel];
+    bool step;
+    if (!GetCurveSampleMode(fcu, step)) {
+      m_modes[channel] = SAMPLE_EVALUATE;
+      continue;
+    }
+
+    m_modes[channel] = step ? SAMPLE_STEP : SAMPLE_LINEAR;
+    for (unsigned int frame = 0; frame < m_numFrames; ++frame) {
+      m_samples[frame * numChannels + channel] = evaluate_fcurve(fcu, m_start + frame);
+    }
+  }
+}
+
+BL_ActionBake::~BL_ActionBake()
+{
+}
+
+unsigned int BL_ActionBake::GetNumChannels() const
+{
+  return m_curves.size();
+}
+
+bool BL_ActionBake::GetRows(float frame,
+                            const float *&row1,
+                            const float *&row2,
+                            float &factor) const
+{
+  const float time = frame - m_start;
+  if (m_numFrames == 0 || time < 0.0f || time > float(m_numFrames - 1)) {
+    return false;
+  }
+
+  const unsigned int numChannels = m_curves.size();
+  const unsigned int index = std::min((unsigned int)time, m_numFrames - 1);
+  row1 = &m_samples[index * numChannels];
+
+  if (index == m_numFrames - 1) {
+    row2 = row1;
+    factor = 0.0f;
+  }
+  else {
+    row2 = row1 + numChannels;
+    factor = time - float(index);
+  }
+
+  return true;
+}
+
+float BL_ActionBake::GetSample(
+    unsigned int channel, float frame, const float *row1, const float *row2, float factor) const
+{
+  switch (m_modes[channel]) {
+    case SAMPLE_LINEAR: {
+      return row1[channel] + (row2[channel] - row1[channel]) * factor;
+    }
+    case SAMPLE_STEP: {
+      return row1[channel];
+    }
+    case SAMPLE_EVALUATE: {
+      break;
+    }
+  }
+
+  return evaluate_fcurve(m_curves[channel], frame);
+}
+
+bool BL_ActionBake::GetValue(unsigned int channel, float frame, float &value) const
+{
+  const float *row1;
+  const float *row2;
+  float factor;
+  if (!GetRows(frame, row1, row2, factor)) {
+    return false;
+  }
+
+  value = GetSample(channel, frame, row1, row2, factor);
+  return true;
+}
+
+bool BL_ActionBake::ResolvePoseTargets(PoseTargets &targets) const
+{
+  targets.bones.clear();
+  targets.channels.resize(m_curves.size());
+
+  for (unsigned int channel = 0, size = m_curves.size(); channel < size; ++channel) {
+    FCurve *fcu = m_curves[channel];
+    PoseTarget &target = targets.channels[channel];
+    target.bone = -1;
+    target.offset = 0;
+
+    // Curves skipped by the action evaluation.
+    if ((fcu->grp && (fcu->grp->flag & AGRP_MUTED)) ||
+        (fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) || BKE_fcurve_is_empty(fcu)) {
+      continue;
+    }
+
+    if (!STRPREFIX(fcu->rna_path, "pose.bones[")) {
+      return false;
+    }
+
+    const char *prop = strstr(fcu->rna_path, "\"].");
+    if (!prop || fcu->array_index < 0) {
+      return false;
+    }
+    prop += 3;
+
+    const unsigned int index = fcu->array_index;
+    if (STREQ(prop, "location") && index < 3) {
+      target.offset = offsetof(bPoseChannel, loc) + index * sizeof(float);
+    }
+    else if (STREQ(prop, "rotation_quaternion") && index < 4) {
+      target.offset = offsetof(bPoseChannel, quat) + index * sizeof(float);
+    }
+    else if (STREQ(prop, "rotation_euler") && index < 3) {
+      target.offset = offsetof(bPoseChannel, eul) + index * sizeof(float);
+    }
+    else if (STREQ(prop, "rotation_axis_angle") && index < 4) {
+      target.offset = (index == 0) ? offsetof(bPoseChannel, rotAngle) :
+                                     offsetof(bPoseChannel, rotAxis) + (index - 1) * sizeof(float);
+    }
+    else if (STREQ(prop, "scale") && index < 3) {
+      target.offset = offsetof(bPoseChannel, size) + index * sizeof(float);
+    }
+    else {
+      return false;
+    }
+
+    char *name = BLI_str_quoted_substrN(fcu->rna_path, "pose.bones[");
+    if (!name) {
+      return false;
+    }
+    // The curves of a bone are usually grouped, share its name with the previous curve.
+    if (targets.bones.empty() || targets.bones.back() != name) {
+      targets.bones.emplace_back(name);
+    }
+    MEM_freeN(name);
+    target.bone = (int)targets.bones.size() - 1;
+  }
+
+  return true;
+}
+
+bool BL_ActionBake::Apply(float frame, bPose *pose, const PoseTargets &targets) const
+{
+  const float *row1;
+  const float *row2;
+  float factor;
+  if (!GetRows(frame, row1, row2, factor)) {
+    return false;
+  }
+
+  int bone = -1;
+  bPoseChannel *pchan = nullptr;
+  for (unsigned int channel = 0, size = targets.channels.size(); channel < size; ++channel) {
+    const PoseTarget &target = targets.channels[channel];
+    if (target.bone == -1) {
+      continue;
+    }
+    if (target.bone != bone) {
+      bone = target.bone;
+      pchan = BKE_pose_channel_find_name(pose, targets.bones[bone].c_str());
+    }
+    if (pchan) {
+      *(float *)((char *)pchan + target.offset) = GetSample(channel, frame, row1, row2, factor);
+    }
+  }
+
+  return true;
+}
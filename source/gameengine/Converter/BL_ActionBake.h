@@ -0,0 +1,114 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_ActionBake.h
+ *  \ingroup bgeconv
+ */
+
+#ifndef __BL_ACTIONBAKE_H__
+#define __BL_ACTIONBAKE_H__
+
+#include <string>
+#include <vector>
+
+struct bAction;
+struct bPose;
+struct FCurve;
+
+/** Samples of the F-Curves of an action at each frame of its range.
+ * The samples of a frame are contiguous, one value per channel (F-Curve), so that evaluating
+ * the whole action at a frame only reads two rows and interpolates them linearly. The bake is
+ * shared by all the objects playing the action in a scene.
+ * The curves that can't be reproduced from the samples at integer frames are still evaluated.
+ */
+class BL_ActionBake {
+ public:
+  /// Pose channel value written by a channel of the bake.
+  struct PoseTarget {
+    /// Index of the bone in PoseTargets::bones, -1 for the muted curves.
+    int bone;
+    /// Offset of the value in the bPoseChannel.
+    unsigned int offset;
+  };
+
+  /** The pose values written by all the channels. The bones are found by name when applying,
+   * so the targets stay valid when the pose is rebuilt or replaced.
+   */
+  struct PoseTargets {
+    std::vector<std::string> bones;
+    std::vector<PoseTarget> channels;
+  };
+
+ private:
+  /// How the value of a channel is computed between two frames.
+  enum SampleMode {
+    /// Linear interpolation of the samples.
+    SAMPLE_LINEAR,
+    /// Sample of the previous frame, for constant interpolation keys at integer frames.
+    SAMPLE_STEP,
+    /// Evaluation of the F-Curve, nothing is baked.
+    SAMPLE_EVALUATE
+  };
+
+  /// The baked F-Curves, the index of a curve is its channel.
+  std::vector<FCurve *> m_curves;
+  /// The sample mode of each channel.
+  std::vector<SampleMode> m_modes;
+  /// Frame of the first row.
+  float m_start;
+  unsigned int m_numFrames;
+  /// Samples of all the channels, frame major.
+  std::vector<float> m_samples;
+
+  /** Compute the rows to interpolate at a frame.
+   * \return False if the frame is outside the baked range.
+   */
+  bool GetRows(float frame, const float *&row1, const float *&row2, float &factor) const;
+
+  /// Compute the value of a channel from the rows returned by GetRows.
+  float GetSample(
+      unsigned int channel, float frame, const float *row1, const float *row2, float factor) const;
+
+ public:
+  /// Bake the F-Curves of the action with a RNA path.
+  BL_ActionBake(bAction *action);
+  ~BL_ActionBake();
+
+  /// The channels are the F-Curves with a RNA path in the action order.
+  unsigned int GetNumChannels() const;
+
+  /** Interpolate the value of a channel at a frame.
+   * \return False if the frame is outside the baked range.
+   */
+  bool GetValue(unsigned int channel, float frame, float &value) const;
+
+  /** Find the pose channel value written by each baked channel.
+   * \return False if a curve doesn't animate a bone transform.
+   */
+  bool ResolvePoseTargets(PoseTargets &targets) const;
+
+  /** Write all the channels at a frame to the targets of the pose returned by
+   * ResolvePoseTargets, the bones missing in the pose are skipped.
+   * \return False if the frame is outside the baked range, nothing is written.
+   */
+  bool Apply(float frame, bPose *pose, const PoseTargets &targets) const;
+};
+
+#endif  // __BL_ACTIONBAKE_H__
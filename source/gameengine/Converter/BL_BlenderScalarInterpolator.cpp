@@ -30,6 +30,7 @@
  */
 
 #include "BL_BlenderScalarInterpolator.h"
+#include "BL_ActionBake.h"
 
 #include <cstring>
 
@@ -40,17 +41,27 @@
 float BL_ScalarInterpolator::GetValue(float currentTime) const
 {
   // XXX 2.4x IPO_GetFloatValue(m_blender_adt, m_channel, currentTime);
+  float value;
+  if (m_bake && m_bake->GetValue(m_channel, currentTime, value)) {
+    return value;
+  }
   return evaluate_fcurve(m_fcu, currentTime);
 }
 
-BL_InterpolatorList::BL_InterpolatorList(bAction *action) : m_action(action)
+BL_InterpolatorList::BL_InterpolatorList(bAction *action) : m_action(action), m_bake(nullptr)
 {
   if (action == nullptr)
     return;
 
+  if (action->flag & ACT_GAME_BAKE) {
+    m_bake = new BL_ActionBake(action);
+  }
+
   for (FCurve *fcu = (FCurve *)action->curves.first; fcu; fcu = fcu->next) {
     if (fcu->rna_path) {
-      BL_ScalarInterpolator *new_ipo = new BL_ScalarInterpolator(fcu);
+      // The bake uses the same curves in the same order.
+      const int channel = m_bake ? m_interpolators.size() : -1;
+      BL_ScalarInterpolator *new_ipo = new BL_ScalarInterpolator(fcu, m_bake, channel);
       // assert(new_ipo);
       m_interpolators.push_back(new_ipo);
     }
@@ -62,6 +73,10 @@ BL_InterpolatorList::~BL_InterpolatorList()
   for (BL_ScalarInterpolator *interp : m_interpolators) {
     delete interp;
   }
+
+  if (m_bake) {
+    delete m_bake;
+  }
 }
 
 bAction *BL_InterpolatorList::GetAction() const
@@ -69,6 +84,11 @@ bAction *BL_InterpolatorList::GetAction() const
   return m_action;
 }
 
+const BL_ActionBake *BL_InterpolatorList::GetBake() const
+{
+  return m_bake;
+}
+
 BL_ScalarInterpolator *BL_InterpolatorList::GetScalarInterpolator(const char *rna_path,
                                                                   int array_index)
 {
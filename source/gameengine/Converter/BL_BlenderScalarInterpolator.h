@@ -36,16 +36,18 @@
 
 #include "KX_IScalarInterpolator.h"
 
+class BL_ActionBake;
 struct bAction;
 
 typedef unsigned short BL_IpoChannel;
 
 class BL_ScalarInterpolator : public KX_IScalarInterpolator {
  public:
-  BL_ScalarInterpolator()
+  BL_ScalarInterpolator() : m_fcu(nullptr), m_bake(nullptr), m_channel(-1)
   {
   }  // required for use in STL list
-  BL_ScalarInterpolator(struct FCurve *fcu) : m_fcu(fcu)
+  BL_ScalarInterpolator(struct FCurve *fcu, const BL_ActionBake *bake = nullptr, int channel = -1)
+      : m_fcu(fcu), m_bake(bake), m_channel(channel)
   {
   }
 
@@ -61,18 +63,24 @@ class BL_ScalarInterpolator : public KX_IScalarInterpolator {
 
  private:
   struct FCurve *m_fcu;
+  /// Samples of the curve if the action is baked, the curve is evaluated outside the samples.
+  const BL_ActionBake *m_bake;
+  int m_channel;
 };
 
 class BL_InterpolatorList {
  private:
   bAction *m_action;
   std::vector<BL_ScalarInterpolator *> m_interpolators;
+  /// Samples of the action, null if the action is not baked.
+  BL_ActionBake *m_bake;
 
  public:
   BL_InterpolatorList(struct bAction *action);
   ~BL_InterpolatorList();
 
   bAction *GetAction() const;
+  const BL_ActionBake *GetBake() const;
 
   BL_ScalarInterpolator *GetScalarInterpolator(const char *rna_path, int array_index);
 };
@@ -30,7 +30,9 @@
 
 #include "GHOST_Types.h"
 
-DEV_InputDevice::DEV_InputDevice()
+#include "DEV_InputRecord.h"
+
+DEV_InputDevice::DEV_InputDevice() : m_record(nullptr)
 {
   m_reverseKeyTranslateTable[GHOST_kKeyA] = AKEY;
   m_reverseKeyTranslateTable[GHOST_kKeyB] = BKEY;
@@ -168,18 +170,32 @@ DEV_InputDevice::~DEV_InputDevice()
 {
 }
 
+void DEV_InputDevice::SetRecord(DEV_InputRecord *record)
+{
+  m_record = record;
+}
+
 void DEV_InputDevice::ConvertKeyEvent(int incode, int val, unsigned int unicode)
 {
+  if (m_record) {
+    m_record->WriteKeyEvent(incode, val, unicode);
+  }
   ConvertEvent(m_reverseKeyTranslateTable[incode], val, unicode);
 }
 
 void DEV_InputDevice::ConvertButtonEvent(int incode, int val)
 {
+  if (m_record) {
+    m_record->WriteButtonEvent(incode, val);
+  }
   ConvertEvent(m_reverseButtonTranslateTable[incode], val, 0);
 }
 
 void DEV_InputDevice::ConvertWindowEvent(int incode)
 {
+  if (m_record) {
+    m_record->WriteWindowEvent(incode);
+  }
   ConvertEvent(m_reverseWindowTranslateTable[incode], 1, 0);
 }
 
@@ -206,6 +222,10 @@ void DEV_InputDevice::ConvertEvent(SCA_IInputDevice::SCA_EnumInputs type,
 
 void DEV_InputDevice::ConvertMoveEvent(int x, int y)
 {
+  if (m_record) {
+    m_record->WriteMoveEvent(x, y);
+  }
+
   SCA_InputEvent &xevent = m_inputsTable[MOUSEX];
   xevent.m_values.push_back(x);
   if (xevent.m_status[xevent.m_status.size() - 1] != SCA_InputEvent::ACTIVE) {
@@ -223,6 +243,10 @@ void DEV_InputDevice::ConvertMoveEvent(int x, int y)
 
 void DEV_InputDevice::ConvertWheelEvent(int z)
 {
+  if (m_record) {
+    m_record->WriteWheelEvent(z);
+  }
+
   SCA_InputEvent &event = m_inputsTable[(z > 0) ? WHEELUPMOUSE : WHEELDOWNMOUSE];
   event.m_values.push_back(z);
   if (event.m_status[event.m_status.size() - 1] != SCA_InputEvent::ACTIVE) {
@@ -31,8 +31,13 @@
 
 #include "SCA_IInputDevice.h"
 
+class DEV_InputRecord;
+
 class DEV_InputDevice : public SCA_IInputDevice {
  protected:
+  /// Optional record receiving all the converted events.
+  DEV_InputRecord *m_record;
+
   /// These maps converts GHOST input number to SCA input enum.
   std::map<int, SCA_EnumInputs> m_reverseKeyTranslateTable;
   std::map<int, SCA_EnumInputs> m_reverseButtonTranslateTable;
@@ -42,6 +47,9 @@ class DEV_InputDevice : public SCA_IInputDevice {
   DEV_InputDevice();
   virtual ~DEV_InputDevice();
 
+  /// Set the record to write the events into, nullptr to stop recording.
+  void SetRecord(DEV_InputRecord *record);
+
   void ConvertKeyEvent(int incode, int val, unsigned int unicode);
   void ConvertButtonEvent(int incode, int val);
   void ConvertWindowEvent(int incode);
@@ -0,0 +1,231 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Device/DEV_InputRecord.cpp
+ *  \ingroup device
+ */
+
+#include "DEV_InputRecord.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "BLI_fileops.h"
+
+#include "CM_Message.h"
+#include "DEV_InputDevice.h"
+
+static const char recordMagic[4] = {'B', 'G', 'E', 'I'};
+static const uint16_t recordVersion = 1;
+
+DEV_InputRecord::DEV_InputRecord(const std::string &filepath, Mode mode)
+    : m_mode(mode), m_file(nullptr), m_nextType(RECORD_NONE), m_numFrames(0)
+{
+  m_file = BLI_fopen(filepath.c_str(), (m_mode == MODE_RECORD) ? "wb" : "rb");
+  if (!m_file) {
+    CM_Error("failed to open input record \"" << filepath << "\"");
+    return;
+  }
+
+  if (m_mode == MODE_RECORD) {
+    Write(recordMagic, sizeof(recordMagic));
+    Write(&recordVersion, sizeof(recordVersion));
+  }
+  else {
+    char magic[4];
+    uint16_t version;
+    if (!Read(magic, sizeof(magic)) || memcmp(magic, recordMagic, sizeof(magic)) != 0 ||
+        !Read(&version, sizeof(version)) || version != recordVersion) {
+      CM_Error("invalid input record \"" << filepath << "\"");
+      fclose(m_file);
+      m_file = nullptr;
+      return;
+    }
+    ReadType();
+  }
+}
+
+DEV_InputRecord::~DEV_InputRecord()
+{
+  if (m_file) {
+    fclose(m_file);
+  }
+}
+
+bool DEV_InputRecord::IsValid() const
+{
+  return (m_file != nullptr);
+}
+
+DEV_InputRecord::Mode DEV_InputRecord::GetMode() const
+{
+  return m_mode;
+}
+
+unsigned int DEV_InputRecord::GetNumFrames() const
+{
+  return m_numFrames;
+}
+
+void DEV_InputRecord::WriteType(RecordType type)
+{
+  Write(&type, sizeof(type));
+}
+
+void DEV_InputRecord::Write(const void *data, size_t size)
+{
+  if (m_file) {
+    fwrite(data, size, 1, m_file);
+  }
+}
+
+bool DEV_InputRecord::Read(void *data, size_t size)
+{
+  return (fread(data, size, 1, m_file) == 1);
+}
+
+void DEV_InputRecord::ReadType()
+{
+  if (!Read(&m_nextType, sizeof(m_nextType))) {
+    m_nextType = RECORD_NONE;
+  }
+}
+
+void DEV_InputRecord::WriteKeyEvent(int incode, int val, unsigned int unicode)
+{
+  const uint16_t code = incode;
+  const uint8_t value = val;
+  const uint32_t character = unicode;
+  WriteType(RECORD_KEY);
+  Write(&code, sizeof(code));
+  Write(&value, sizeof(value));
+  Write(&character, sizeof(character));
+}
+
+void DEV_InputRecord::WriteButtonEvent(int incode, int val)
+{
+  const uint16_t code = incode;
+  const uint8_t value = val;
+  WriteType(RECORD_BUTTON);
+  Write(&code, sizeof(code));
+  Write(&value, sizeof(value));
+}
+
+void DEV_InputRecord::WriteWindowEvent(int incode)
+{
+  const uint16_t code = incode;
+  WriteType(RECORD_WINDOW);
+  Write(&code, sizeof(code));
+}
+
+void DEV_InputRecord::WriteMoveEvent(int x, int y)
+{
+  const int32_t pos[2] = {x, y};
+  WriteType(RECORD_MOVE);
+  Write(pos, sizeof(pos));
+}
+
+void DEV_InputRecord::WriteWheelEvent(int z)
+{
+  const int16_t value = z;
+  WriteType(RECORD_WHEEL);
+  Write(&value, sizeof(value));
+}
+
+void DEV_InputRecord::WriteFrame(double clockTime)
+{
+  WriteType(RECORD_FRAME);
+  Write(&clockTime, sizeof(clockTime));
+  ++m_numFrames;
+}
+
+bool DEV_InputRecord::ReadFrame(double &clockTime)
+{
+  if (m_nextType != RECORD_FRAME || !Read(&clockTime, sizeof(clockTime))) {
+    return false;
+  }
+
+  ReadType();
+  ++m_numFrames;
+  return true;
+}
+
+void DEV_InputRecord::ReadEvents(DEV_InputDevice *device)
+{
+  while (m_nextType != RECORD_NONE && m_nextType != RECORD_FRAME) {
+    bool valid = false;
+    switch (m_nextType) {
+      case RECORD_KEY: {
+        uint16_t code;
+        uint8_t value;
+        uint32_t character;
+        valid = Read(&code, sizeof(code)) && Read(&value, sizeof(value)) &&
+                Read(&character, sizeof(character));
+        if (valid) {
+          device->ConvertKeyEvent(code, value, character);
+        }
+        break;
+      }
+      case RECORD_BUTTON: {
+        uint16_t code;
+        uint8_t value;
+        valid = Read(&code, sizeof(code)) && Read(&value, sizeof(value));
+        if (valid) {
+          device->ConvertButtonEvent(code, value);
+        }
+        break;
+      }
+      case RECORD_WINDOW: {
+        uint16_t code;
+        valid = Read(&code, sizeof(code));
+        if (valid) {
+          device->ConvertWindowEvent(code);
+        }
+        break;
+      }
+      case RECORD_MOVE: {
+        int32_t pos[2];
+        valid = Read(pos, sizeof(pos));
+        if (valid) {
+          device->ConvertMoveEvent(pos[0], pos[1]);
+        }
+        break;
+      }
+      case RECORD_WHEEL: {
+        int16_t value;
+        valid = Read(&value, sizeof(value));
+        if (valid) {
+          device->ConvertWheelEvent(value);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (!valid) {
+      CM_Error("corrupted input record, stop replay");
+      m_nextType = RECORD_NONE;
+      return;
+    }
+
+    ReadType();
+  }
+}
@@ -0,0 +1,99 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file DEV_InputRecord.h
+ *  \ingroup device
+ */
+
+#ifndef __DEV_INPUTRECORD_H__
+#define __DEV_INPUTRECORD_H__
+
+#include <stdio.h>
+#include <string>
+
+class DEV_InputDevice;
+
+/** Binary record of the input events received by a DEV_InputDevice and of the engine clock
+ * time of each frame. A record can be replayed to run exactly the same session again with the
+ * engine driven by an external clock.
+ *
+ * Only the keyboard, mouse and window events are recorded. Joysticks are read from SDL by
+ * DEV_Joystick and are not part of the record, a session using them doesn't replay the same.
+ *
+ * The file starts with a header followed by records made of a one byte type and a fixed size
+ * payload. Values are stored in native byte order, a record is meant to be replayed on the
+ * same kind of machine.
+ */
+class DEV_InputRecord {
+ public:
+  enum Mode { MODE_RECORD = 0, MODE_REPLAY };
+
+ private:
+  enum RecordType : unsigned char {
+    RECORD_NONE = 0,
+    RECORD_FRAME,
+    RECORD_KEY,
+    RECORD_BUTTON,
+    RECORD_WINDOW,
+    RECORD_MOVE,
+    RECORD_WHEEL
+  };
+
+  Mode m_mode;
+  FILE *m_file;
+  /// Type of the next record to read in replay mode, RECORD_NONE at end of file.
+  RecordType m_nextType;
+  /// Number of frames written or read.
+  unsigned int m_numFrames;
+
+  void WriteType(RecordType type);
+  void Write(const void *data, size_t size);
+  bool Read(void *data, size_t size);
+  /// Read the type of the next record, set RECORD_NONE at end of file or on error.
+  void ReadType();
+
+ public:
+  DEV_InputRecord(const std::string &filepath, Mode mode);
+  ~DEV_InputRecord();
+
+  /// Return true if the file was opened and its header is valid.
+  bool IsValid() const;
+  Mode GetMode() const;
+  unsigned int GetNumFrames() const;
+
+  /// \section Recording functions, called by DEV_InputDevice.
+  void WriteKeyEvent(int incode, int val, unsigned int unicode);
+  void WriteButtonEvent(int incode, int val);
+  void WriteWindowEvent(int incode);
+  void WriteMoveEvent(int x, int y);
+  void WriteWheelEvent(int z);
+  /// Write the engine clock time of the frame, events written after belong to the next frame.
+  void WriteFrame(double clockTime);
+
+  /// \section Replay functions.
+  /** Read the clock time of the next frame.
+   * \return False when the record is finished.
+   */
+  bool ReadFrame(double &clockTime);
+  /// Send all the events recorded until the next frame to the input device.
+  void ReadEvents(DEV_InputDevice *device);
+};
+
+#endif  // __DEV_INPUTRECORD_H__
@@ -175,6 +175,14 @@ class SCA_IObject : public CValue {
     return m_ignore_activity_culling;
   }
 
+  /**
+   * Return true if the object is suspended by the activity culling.
+   */
+  bool IsSuspended() const
+  {
+    return m_suspended;
+  }
+
   /**
    * Suspend all progress.
    */
@@ -32,6 +32,7 @@
 
 #include "BLI_math.h"
 
+#include "DetourTileNavMesh.h"
 #include "EXP_ListWrapper.h"
 #include "KX_GameObject.h"
 #include "KX_Globals.h"
@@ -114,6 +115,7 @@ CValue *SCA_SteeringActuator::GetReplica()
 
 void SCA_SteeringActuator::ProcessReplica()
 {
+  m_pathRequest.reset();
   if (m_target)
     m_target->RegisterActuator(this);
   if (m_navmesh)
@@ -136,6 +138,7 @@ bool SCA_SteeringActuator::UnlinkObject(SCA_IObject *clientobj)
   }
   else if (clientobj == m_navmesh) {
     m_navmesh = nullptr;
+    m_pathRequest.reset();
     return true;
   }
   return false;
@@ -157,6 +160,7 @@ void SCA_SteeringActuator::Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_ma
       m_navmesh->UnregisterActuator(this);
     m_navmesh = navobj;
     m_navmesh->RegisterActuator(this);
+    m_pathRequest.reset();
   }
 }
 
@@ -168,6 +172,9 @@ bool SCA_SteeringActuator::Update(double curtime)
   if (m_posevent && !m_isActive) {
     delta = 0.0;
     m_pathUpdateTime = -1.0;
+    m_pathRequest.reset();
+    m_pathLen = 0;
+    m_wayPointIdx = -1;
     m_updateTime = curtime;
     m_isActive = true;
   }
@@ -216,12 +223,28 @@ bool SCA_SteeringActuator::Update(double curtime)
 
         static const MT_Scalar WAYPOINT_RADIUS(0.25f);
 
-        if (m_pathUpdateTime < 0 ||
-            (m_pathUpdatePeriod >= 0 &&
-             curtime - m_pathUpdateTime > ((double)m_pathUpdatePeriod / 1000.0))) {
-          m_pathUpdateTime = curtime;
-          m_pathLen = m_navmesh->FindPath(mypos, targpos, m_path, MAX_PATH_LENGTH);
+        // The previous path is followed until the requested one is found.
+        if (m_pathRequest && m_pathRequest->status != KX_NavMeshPathQueue::REQUEST_PENDING) {
+          const std::vector<float> &path = m_pathRequest->path;
+          m_pathLen = path.size() / 3;
+          std::copy(path.begin(), path.end(), m_path);
           m_wayPointIdx = m_pathLen > 1 ? 1 : -1;
+          m_pathRequest.reset();
+        }
+
+        if (!m_pathRequest &&
+            (m_pathUpdateTime < 0 ||
+             (m_pathUpdatePeriod >= 0 &&
+              curtime - m_pathUpdateTime > ((double)m_pathUpdatePeriod / 1000.0)))) {
+          m_pathUpdateTime = curtime;
+          if (m_pathLen == 0 || m_wayPointIdx < 0) {
+            // No path to follow meanwhile, find it now so the actuator steers this frame.
+            m_pathLen = m_navmesh->FindPath(mypos, targpos, m_path, MAX_PATH_LENGTH);
+            m_wayPointIdx = m_pathLen > 1 ? 1 : -1;
+          }
+          else {
+            m_pathRequest = m_navmesh->RequestPath(mypos, targpos, MAX_PATH_LENGTH);
+          }
         }
 
         if (m_wayPointIdx > 0) {
@@ -395,6 +418,35 @@ static bool getNavmeshNormal(dtStatNavMesh *navmesh, const MT_Vector3 &pos, MT_V
   return false;
 }
 
+static bool getTiledNavmeshNormal(dtTiledNavMesh *navmesh,
+                                  const MT_Vector3 &pos,
+                                  MT_Vector3 &normal)
+{
+  static const float polyPickExt[3] = {2, 4, 2};
+  float spos[3];
+  pos.getValue(spos);
+  flipAxes(spos);
+  dtTilePolyRef polyRef = navmesh->findNearestPoly(spos, polyPickExt);
+  if (polyRef == 0)
+    return false;
+  const dtTilePoly *p = navmesh->getPolyByRef(polyRef);
+  const float *verts = navmesh->getPolyVertsByRef(polyRef);
+  if (!p || !verts || p->nv < 3)
+    return false;
+
+  // The tile polygons are planar, use the first triangle.
+  MT_Vector3 tri[3];
+  for (size_t j = 0; j < 3; j++) {
+    const float *v = &verts[p->v[j] * 3];
+    tri[j].setValue(v[0], v[2], v[1]);
+  }
+  MT_Vector3 a, b;
+  a = tri[1] - tri[0];
+  b = tri[2] - tri[0];
+  normal = b.cross(a).safe_normalized();
+  return true;
+}
+
 void SCA_SteeringActuator::HandleActorFace(MT_Vector3 &velocity)
 {
   if (m_facingMode == 0 && (!m_navmesh || !m_normalUp))
@@ -410,9 +462,11 @@ void SCA_SteeringActuator::HandleActorFace(MT_Vector3 &velocity)
 
   if (m_navmesh && m_normalUp) {
     dtStatNavMesh *navmesh = m_navmesh->GetNavMesh();
+    dtTiledNavMesh *tiledNavmesh = m_navmesh->GetTiledNavMesh();
     MT_Vector3 normal;
     MT_Vector3 trpos = m_navmesh->TransformToLocalCoords(curobj->NodeGetWorldPosition());
-    if (getNavmeshNormal(navmesh, trpos, normal)) {
+    if ((navmesh && getNavmeshNormal(navmesh, trpos, normal)) ||
+        (tiledNavmesh && getTiledNavmeshNormal(tiledNavmesh, trpos, normal))) {
 
       left = (dir.cross(up)).safe_normalized();
       dir = (-left.cross(normal)).safe_normalized();
@@ -626,6 +680,7 @@ int SCA_SteeringActuator::pyattr_set_navmesh(PyObjectPlus *self,
     actuator->m_navmesh->UnregisterActuator(actuator);
 
   actuator->m_navmesh = static_cast<KX_NavMeshObject *>(gameobj);
+  actuator->m_pathRequest.reset();
 
   if (actuator->m_navmesh)
     actuator->m_navmesh->RegisterActuator(actuator);
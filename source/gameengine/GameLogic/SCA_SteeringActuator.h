@@ -27,6 +27,7 @@
 #ifndef __SCA_SteeringActuator_H__
 #define __SCA_SteeringActuator_H__
 
+#include "KX_NavMeshPathQueue.h"
 #include "MT_Matrix3x3.h"
 #include "SCA_IActuator.h"
 #include "SCA_LogicManager.h"
@@ -61,6 +62,8 @@ class SCA_SteeringActuator : public SCA_IActuator {
   int m_pathLen;
   int m_pathUpdatePeriod;
   double m_pathUpdateTime;
+  /// Path searched asynchronously by the navigation mesh, replaces the path once finished.
+  KX_NavMeshPathQueue::RequestPtr m_pathRequest;
   bool m_lockzvel;
   int m_wayPointIdx;
   MT_Matrix3x3 m_parentlocalmat;
@@ -456,7 +456,7 @@ static void usage(const std::string &program, bool isBlenderPlayer)
       CM_Message("usage:   " << program << " [--options] " << example_filename << std::endl);
   CM_Message("Available options are: [-w [w h l t]] [-f [fw fh fb ff]] "
              << consoleoption << "[-g gamengineoptions] "
-             << "[-s stereomode] [-m aasamples]");
+             << "[-s stereomode] [-m aasamples] [-M allocator]");
   CM_Message("Optional parameters must be passed in order.");
   CM_Message("Default values are set in the blend file." << std::endl);
   CM_Message("  -h: Prints this command summary" << std::endl);
@@ -500,6 +500,8 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("  -d: debugging options:");
   CM_Message("       memory        Debug memory leaks");
   CM_Message("       gpu           Debug gpu error and warnings" << std::endl);
+  CM_Message("  -M: memory allocator:");
+  CM_Message("       threadcache   Per-thread caches for small allocations" << std::endl);
   CM_Message("  -g: game engine options:" << std::endl);
   CM_Message("       Name                       Default      Description");
   CM_Message("       ------------------------------------------------------------------------");
@@ -513,8 +515,26 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
-  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
-             << std::endl);
+  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings");
+  CM_Message("       record_input                             Record the keyboard, mouse and");
+  CM_Message("                                                window events and frame times to");
+  CM_Message("                                                the given file (no joysticks)");
+  CM_Message("       replay_input                             Replay a file written with");
+  CM_Message("                                                record_input");
+  CM_Message("       benchmark_frames               0         Run the given number of frames with");
+  CM_Message("                                                a fixed clock step and print the");
+  CM_Message("                                                profile statistics as JSON");
+  CM_Message("       benchmark_output                         Write the benchmark JSON to the");
+  CM_Message("                                                given file");
+  CM_Message("       log_async                      0         Write the messages from a background");
+  CM_Message("                                                thread");
+  CM_Message("       log_json                       0         Write the messages as JSON lines");
+  CM_Message("       log_rate_limit                 0         Maximum number of identical messages");
+  CM_Message("                                                per second with log_async, 0 for no");
+  CM_Message("                                                limit");
+  CM_Message("       depsgraph_sparse               1         Evaluate only the depsgraph operations");
+  CM_Message("                                                affected by the tagged updates, 0");
+  CM_Message("                                                for a full evaluation" << std::endl);
   CM_Message("  -p: override python main loop script");
   CM_Message(std::endl);
   CM_Message(
@@ -697,6 +717,8 @@ int main(int argc,
 #endif  // WITH_GAMEENGINE_BPPLAYER
   RAS_Rasterizer::StereoMode stereomode = RAS_Rasterizer::RAS_STEREO_NOSTEREO;
   bool stereoWindow = false;
+  bool useGuardedAlloc = false;
+  bool useThreadCacheAlloc = false;
   bool stereoParFound = false;
   int windowLeft = 100;
   int windowTop = 100;
@@ -973,6 +995,7 @@ int main(int argc,
 
             CM_Debug("Switching to fully guarded memory allocator.");
             MEM_use_guarded_allocator();
+            useGuardedAlloc = true;
 
             MEM_set_memory_debug();
 #ifndef NDEBUG
@@ -984,6 +1007,20 @@ int main(int argc,
             CM_Error("debug mode '" << argv[i] << "' unrecognized.");
           }
 
+          break;
+        }
+        case 'M':  // memory allocator
+        {
+          ++i;
+
+          if (strcmp(argv[i], "threadcache") == 0) {
+            useThreadCacheAlloc = true;
+            ++i;
+          }
+          else {
+            CM_Error("memory allocator '" << argv[i] << "' unrecognized.");
+          }
+
           break;
         }
 #ifdef WITH_GAMEENGINE_BPPLAYER
@@ -1186,6 +1223,14 @@ int main(int argc,
     usage(argv[0], isBlenderPlayer);
     return 0;
   }
+
+  /* Blocks allocated by the lock-free allocator stay valid with the thread cache allocator,
+   * the guarded allocator used for memory debugging can't be replaced. */
+  if (useThreadCacheAlloc && !useGuardedAlloc) {
+    CM_Debug("Switching to thread cache memory allocator.");
+    MEM_use_threadcache_allocator();
+  }
+
   GHOST_ISystem *system = nullptr;
 #ifdef WIN32
   if (scr_saver_mode != SCREEN_SAVER_MODE_CONFIGURATION)
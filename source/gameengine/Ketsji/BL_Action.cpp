@@ -26,6 +26,7 @@
 
 #include "BL_Action.h"
 
+#include "BL_ActionBake.h"
 #include "BL_ArmatureObject.h"
 #include "BL_BlenderConverter.h"
 #include "BL_IpoConvert.h"
@@ -65,6 +66,7 @@ BL_Action::BL_Action(class KX_GameObject *gameobj)
       m_blendpose(nullptr),
       m_blendinpose(nullptr),
       m_obj(gameobj),
+      m_bake(nullptr),
       m_startframe(0.f),
       m_endframe(0.f),
       m_localframe(0.f),
@@ -199,10 +201,18 @@ bool BL_Action::Play(const std::string &name,
   m_ipo_flags = ipo_flags;
   InitIPO();
 
+  m_bake = nullptr;
+
   // Setup blendin shapes/poses
   if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
     obj->GetPose(&m_blendinpose);
+
+    // Use the baked samples only if they cover all the animated pose values.
+    const BL_ActionBake *bake = GetAdtList(m_action, kxscene)->GetBake();
+    if (bake && bake->ResolvePoseTargets(m_bakeTargets)) {
+      m_bake = bake;
+    }
   }
   else {
   }
@@ -282,6 +292,47 @@ void BL_Action::SetPlayMode(short play_mode)
   m_playmode = play_mode;
 }
 
+void BL_Action::GetState(BL_ActionState &state)
+{
+  state.name = GetName();
+  state.start = m_startframe;
+  state.end = m_endframe;
+  state.frame = m_localframe;
+  state.blendin = m_blendin;
+  state.blendframe = m_blendframe;
+  state.layerWeight = m_layer_weight;
+  state.speed = m_speed;
+  state.priority = m_priority;
+  state.playMode = m_playmode;
+  state.ipoFlags = m_ipo_flags;
+  state.blendMode = m_blendmode;
+}
+
+bool BL_Action::MatchState(const BL_ActionState &state)
+{
+  return (!IsDone() && GetName() == state.name && m_startframe == state.start &&
+          m_endframe == state.end && m_blendin == state.blendin &&
+          m_layer_weight == state.layerWeight && m_speed == state.speed &&
+          m_priority == state.priority && m_ipo_flags == state.ipoFlags &&
+          m_blendmode == state.blendMode);
+}
+
+void BL_Action::SetState(const BL_ActionState &state)
+{
+  m_playmode = state.playMode;
+  SetFrame(state.frame);
+
+  // The blend in progress is computed from its start time.
+  m_blendframe = state.blendframe;
+  if (m_blendframe > 0.0f) {
+    m_blendstart = KX_GetActiveEngine()->GetFrameTime() -
+                   m_blendframe / (float)KX_GetActiveEngine()->GetAnimFrameRate();
+  }
+  else {
+    m_blendstart = 0.0f;
+  }
+}
+
 void BL_Action::SetLocalTime(float curtime)
 {
   float dt = (curtime - m_starttime) * (float)KX_GetActiveEngine()->GetAnimFrameRate() * m_speed;
@@ -424,8 +475,11 @@ void BL_Action::Update(float curtime, bool applyToObject)
     if (m_layer_weight >= 0)
       obj->GetPose(&m_blendpose);
 
-    // Extract the pose from the action
-    obj->SetPoseByAction(m_action, m_localframe);
+    // Extract the pose from the action, outside the baked frames the curves are evaluated.
+    if (!m_bake ||
+        !m_bake->Apply(m_localframe, obj->GetArmatureObject()->pose, m_bakeTargets)) {
+      obj->SetPoseByAction(m_action, m_localframe);
+    }
 
     ignore_parent_tx_bge(CTX_data_main(C), depsgraph, scene, ob);
 
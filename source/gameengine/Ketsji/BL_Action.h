@@ -30,6 +30,26 @@
 #include <string>
 #include <vector>
 
+#include "BL_ActionBake.h"
+
+/// Playback settings and progress of the action of a layer, saved by the scene snapshots.
+struct BL_ActionState {
+  short layer;
+  std::string name;
+  float start;
+  float end;
+  float frame;
+  /// Blend in duration and elapsed blend in frames.
+  float blendin;
+  float blendframe;
+  float layerWeight;
+  float speed;
+  short priority;
+  short playMode;
+  short ipoFlags;
+  short blendMode;
+};
+
 class BL_Action {
  private:
   struct bAction *m_action;
@@ -39,6 +59,10 @@ class BL_Action {
   class KX_GameObject *m_obj;
   std::vector<float> m_blendshape;
   std::vector<float> m_blendinshape;
+  /// Samples of the action for armatures, null if the action is not baked.
+  const BL_ActionBake *m_bake;
+  /// Pose values written by each channel of the bake.
+  BL_ActionBake::PoseTargets m_bakeTargets;
 
   float m_startframe;
   float m_endframe;
@@ -121,9 +145,16 @@ class BL_Action {
 
   struct bAction *GetAction();
 
+  /// Fill the state except its layer.
+  void GetState(BL_ActionState &state);
+  /// Return true if the action plays the action of the state with the same settings.
+  bool MatchState(const BL_ActionState &state);
+
   // Mutators
   void SetFrame(float frame);
   void SetPlayMode(short play_mode);
+  /// Restore the progress of a state matched by MatchState.
+  void SetState(const BL_ActionState &state);
 
   enum {
     ACT_MODE_PLAY = 0,
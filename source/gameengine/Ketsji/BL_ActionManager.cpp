@@ -29,6 +29,8 @@
 #include "BL_Action.h"
 #include "DNA_ID.h"
 
+#include <algorithm>
+
 #define IS_TAGGED(_id) ((_id) && (((ID *)_id)->tag & LIB_TAG_DOIT))
 
 BL_ActionManager::BL_ActionManager(class KX_GameObject *obj) : m_obj(obj)
@@ -152,6 +154,64 @@ bool BL_ActionManager::IsActionDone(short layer)
   return action ? action->IsDone() : true;
 }
 
+void BL_ActionManager::GetActionStates(std::vector<BL_ActionState> &states)
+{
+  for (const auto &pair : m_layers) {
+    BL_Action *action = pair.second;
+    if (action->IsDone()) {
+      continue;
+    }
+
+    BL_ActionState state;
+    state.layer = pair.first;
+    action->GetState(state);
+    states.push_back(state);
+  }
+}
+
+void BL_ActionManager::SetActionStates(const std::vector<BL_ActionState> &states)
+{
+  // Stop the actions of the layers without state.
+  for (BL_ActionMap::iterator it = m_layers.begin(); it != m_layers.end();) {
+    const short layer = it->first;
+    const bool found = std::any_of(states.begin(),
+                                   states.end(),
+                                   [layer](const BL_ActionState &state) {
+                                     return state.layer == layer;
+                                   });
+    if (!found) {
+      delete it->second;
+      m_layers.erase(it++);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  for (const BL_ActionState &state : states) {
+    BL_Action *action = GetAction(state.layer);
+    if (!action || !action->MatchState(state)) {
+      StopAction(state.layer);
+      if (!PlayAction(state.name,
+                      state.start,
+                      state.end,
+                      state.layer,
+                      state.priority,
+                      state.blendin,
+                      state.playMode,
+                      state.layerWeight,
+                      state.ipoFlags,
+                      state.speed,
+                      state.blendMode)) {
+        continue;
+      }
+      action = GetAction(state.layer);
+    }
+
+    action->SetState(state);
+  }
+}
+
 void BL_ActionManager::Update(float curtime, bool applyToObject)
 {
   for (const auto &pair : m_layers) {
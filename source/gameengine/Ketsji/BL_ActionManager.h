@@ -29,6 +29,7 @@
 
 #include <iostream>
 #include <map>
+#include <vector>
 
 // Currently, we use the max value of a short.
 // We should switch to unsigned short; doesn't make sense to support negative layers.
@@ -36,6 +37,7 @@
 #define MAX_ACTION_LAYERS 32767
 
 class BL_Action;
+struct BL_ActionState;
 
 /**
  * BL_ActionManager is responsible for handling a KX_GameObject's actions.
@@ -107,6 +109,13 @@ class BL_ActionManager {
    */
   bool IsActionDone(short layer);
 
+  /// Fill the states of the playing actions.
+  void GetActionStates(std::vector<BL_ActionState> &states);
+  /** Replace the playing actions by the actions of the states, the actions playing with the same
+   * settings are only moved to the state frame.
+   */
+  void SetActionStates(const std::vector<BL_ActionState> &states);
+
   /**
    * Update any running actions
    * \param curtime The current time used to compute the actions' frame.
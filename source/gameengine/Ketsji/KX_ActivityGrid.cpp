@@ -0,0 +1,288 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_ActivityGrid.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "KX_GameObject.h"
+
+/* Tolerance on the cell bounds relative to the cell size, a cell is considered fully inside or
+ * outside the activity box only if it stays so with this margin. It avoids precision issues
+ * between the cell of an object and its position. */
+#define CELL_BOUND_EPSILON 1e-4f
+/* Smallest cell size, a null activity radius would give infinite cell coordinates. */
+#define CELL_SIZE_MIN 1e-3f
+/* Cell coordinates are clamped to stay in the integer range for far objects. */
+#define CELL_COORD_MAX 1e9f
+
+static int cell_coord(float coord)
+{
+  return (int)std::max(-CELL_COORD_MAX, std::min(std::floor(coord), CELL_COORD_MAX));
+}
+
+bool KX_ActivityGrid::CellKey::operator==(const CellKey &other) const
+{
+  return (x == other.x && y == other.y && z == other.z);
+}
+
+size_t KX_ActivityGrid::CellKeyHash::operator()(const CellKey &key) const
+{
+  return ((size_t)key.x * 73856093) ^ ((size_t)key.y * 19349663) ^ ((size_t)key.z * 83492791);
+}
+
+KX_ActivityGrid::KX_ActivityGrid()
+    : m_radius(0.0f), m_cameraPosition(0.0f, 0.0f, 0.0f), m_valid(false)
+{
+}
+
+KX_ActivityGrid::~KX_ActivityGrid()
+{
+}
+
+KX_ActivityGrid::CellKey KX_ActivityGrid::GetCellKey(const MT_Vector3 &position) const
+{
+  return {cell_coord(position.x() / m_radius),
+          cell_coord(position.y() / m_radius),
+          cell_coord(position.z() / m_radius)};
+}
+
+KX_ActivityGrid::CellRelation KX_ActivityGrid::GetCellRelation(const CellKey &key,
+                                                               const MT_Vector3 &center) const
+{
+  const int cell[3] = {key.x, key.y, key.z};
+  const float margin = m_radius * CELL_BOUND_EPSILON;
+  bool inside = true;
+
+  for (unsigned short axis = 0; axis < 3; ++axis) {
+    const float cellMin = cell[axis] * m_radius;
+    const float cellMax = cellMin + m_radius;
+    const float boxMin = center[axis] - m_radius;
+    const float boxMax = center[axis] + m_radius;
+
+    if ((cellMax + margin) < boxMin || (cellMin - margin) > boxMax) {
+      return CELL_OUTSIDE;
+    }
+    if ((cellMin - margin) < boxMin || (cellMax + margin) > boxMax) {
+      inside = false;
+    }
+  }
+
+  return inside ? CELL_INSIDE : CELL_CROSS;
+}
+
+void KX_ActivityGrid::InsertObject(KX_GameObject *gameobj, ObjectCell &cell, const CellKey &key)
+{
+  std::vector<KX_GameObject *> &objects = m_cells[key];
+  cell.key = key;
+  cell.index = objects.size();
+  objects.push_back(gameobj);
+}
+
+void KX_ActivityGrid::EraseObject(const ObjectCell &cell)
+{
+  const auto it = m_cells.find(cell.key);
+  BLI_assert(it != m_cells.end());
+
+  // The order in a cell doesn't matter, the last object takes the place of the erased one.
+  std::vector<KX_GameObject *> &objects = it->second;
+  KX_GameObject *last = objects.back();
+  objects[cell.index] = last;
+  m_objectCells[last].index = cell.index;
+  objects.pop_back();
+
+  if (objects.empty()) {
+    m_cells.erase(it);
+  }
+}
+
+void KX_ActivityGrid::UpdateObject(KX_GameObject *gameobj, const MT_Vector3 &cameraPosition) const
+{
+  if (gameobj->GetIgnoreActivityCulling()) {
+    return;
+  }
+
+  const MT_Vector3 &position = gameobj->NodeGetWorldPosition();
+  const bool outside = (std::fabs(cameraPosition[0] - position[0]) > m_radius) ||
+                       (std::fabs(cameraPosition[1] - position[1]) > m_radius) ||
+                       (std::fabs(cameraPosition[2] - position[2]) > m_radius);
+
+  if (outside != gameobj->IsSuspended()) {
+    if (outside) {
+      gameobj->SuspendDynamics();
+    }
+    else {
+      gameobj->ResumeDynamics();
+    }
+  }
+}
+
+void KX_ActivityGrid::UpdateCell(const std::vector<KX_GameObject *> &objects,
+                                 const MT_Vector3 &cameraPosition) const
+{
+  for (KX_GameObject *gameobj : objects) {
+    UpdateObject(gameobj, cameraPosition);
+  }
+}
+
+void KX_ActivityGrid::Rebuild(CListValue<KX_GameObject> *objects,
+                              const MT_Vector3 &cameraPosition)
+{
+  m_cells.clear();
+  m_objectCells.clear();
+  m_movedObjects.clear();
+
+  for (KX_GameObject *gameobj : *objects) {
+    InsertObject(gameobj, m_objectCells[gameobj], GetCellKey(gameobj->NodeGetWorldPosition()));
+    UpdateObject(gameobj, cameraPosition);
+  }
+
+  m_cameraPosition = cameraPosition;
+  m_valid = true;
+}
+
+void KX_ActivityGrid::Invalidate()
+{
+  m_valid = false;
+}
+
+void KX_ActivityGrid::AddObject(KX_GameObject *gameobj)
+{
+  if (!m_valid) {
+    return;
+  }
+
+  const auto result = m_objectCells.emplace(gameobj, ObjectCell());
+  if (!result.second) {
+    return;
+  }
+
+  InsertObject(gameobj, result.first->second, GetCellKey(gameobj->NodeGetWorldPosition()));
+  // The object is placed after its creation, test it at the next update.
+  ObjectMoved(gameobj);
+}
+
+void KX_ActivityGrid::RemoveObject(KX_GameObject *gameobj)
+{
+  // The object may stay in the moved objects, they are only used as keys of m_objectCells.
+  const auto it = m_objectCells.find(gameobj);
+  if (it != m_objectCells.end()) {
+    EraseObject(it->second);
+    m_objectCells.erase(it);
+  }
+}
+
+void KX_ActivityGrid::ObjectMoved(KX_GameObject *gameobj)
+{
+  if (!m_valid) {
+    return;
+  }
+
+  m_movedLock.Lock();
+  m_movedObjects.push_back(gameobj);
+  m_movedLock.Unlock();
+}
+
+void KX_ActivityGrid::Update(CListValue<KX_GameObject> *objects,
+                             const MT_Vector3 &cameraPosition,
+                             float radius)
+{
+  radius = std::max(radius, CELL_SIZE_MIN);
+  if (!m_valid || radius != m_radius) {
+    m_radius = radius;
+    Rebuild(objects, cameraPosition);
+    return;
+  }
+
+  // Move the objects to their new cell and test them.
+  for (KX_GameObject *gameobj : m_movedObjects) {
+    const auto it = m_objectCells.find(gameobj);
+    // Objects of other lists (e.g inactive objects) and removed objects are not managed.
+    if (it == m_objectCells.end()) {
+      continue;
+    }
+
+    const CellKey key = GetCellKey(gameobj->NodeGetWorldPosition());
+    if (!(key == it->second.key)) {
+      EraseObject(it->second);
+      InsertObject(gameobj, it->second, key);
+    }
+
+    UpdateObject(gameobj, cameraPosition);
+  }
+  m_movedObjects.clear();
+
+  if (cameraPosition == m_cameraPosition) {
+    return;
+  }
+
+  /* Only the cells intersecting the previous or the current activity box can contain objects
+   * changing of state, and among them the cells fully inside or fully outside both boxes don't
+   * need any test. */
+  const MT_Vector3 &previousPosition = m_cameraPosition;
+  const MT_Vector3 lower(std::min(previousPosition.x(), cameraPosition.x()) - m_radius,
+                         std::min(previousPosition.y(), cameraPosition.y()) - m_radius,
+                         std::min(previousPosition.z(), cameraPosition.z()) - m_radius);
+  const MT_Vector3 upper(std::max(previousPosition.x(), cameraPosition.x()) + m_radius,
+                         std::max(previousPosition.y(), cameraPosition.y()) + m_radius,
+                         std::max(previousPosition.z(), cameraPosition.z()) + m_radius);
+  const CellKey lowerKey = GetCellKey(lower);
+  const CellKey upperKey = GetCellKey(upper);
+
+  const auto visitCell = [this, &previousPosition, &cameraPosition](
+                             const CellKey &key, const std::vector<KX_GameObject *> &cellObjects) {
+    const CellRelation previousRelation = GetCellRelation(key, previousPosition);
+    const CellRelation relation = GetCellRelation(key, cameraPosition);
+    if (relation != previousRelation || relation == CELL_CROSS) {
+      UpdateCell(cellObjects, cameraPosition);
+    }
+  };
+
+  const double numCells = double(upperKey.x - lowerKey.x + 1) *
+                          double(upperKey.y - lowerKey.y + 1) *
+                          double(upperKey.z - lowerKey.z + 1);
+
+  // In case of a large camera jump iterating over the existing cells is cheaper.
+  if (numCells > m_cells.size()) {
+    for (const auto &pair : m_cells) {
+      visitCell(pair.first, pair.second);
+    }
+  }
+  else {
+    CellKey key;
+    for (key.x = lowerKey.x; key.x <= upperKey.x; ++key.x) {
+      for (key.y = lowerKey.y; key.y <= upperKey.y; ++key.y) {
+        for (key.z = lowerKey.z; key.z <= upperKey.z; ++key.z) {
+          const auto it = m_cells.find(key);
+          if (it != m_cells.end()) {
+            visitCell(key, it->second);
+          }
+        }
+      }
+    }
+  }
+
+  m_cameraPosition = cameraPosition;
+}
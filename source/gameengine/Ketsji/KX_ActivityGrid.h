@@ -0,0 +1,119 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityGrid.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_ACTIVITYGRID_H__
+#define __KX_ACTIVITYGRID_H__
+
+#include <unordered_map>
+#include <vector>
+
+#include "CM_Thread.h"
+#include "EXP_ListValue.h"
+#include "MT_Vector3.h"
+
+class KX_GameObject;
+
+/** Uniform grid of the objects used by the activity culling.
+ * The cell size is the activity box radius, objects are stored in the cell of their world
+ * position. At each update only the objects which moved and the objects of the cells crossing
+ * the boundary of the previous or the current activity box are tested, and objects are
+ * suspended or resumed only when their state changes.
+ */
+class KX_ActivityGrid {
+ private:
+  struct CellKey {
+    int x;
+    int y;
+    int z;
+
+    bool operator==(const CellKey &other) const;
+  };
+
+  struct CellKeyHash {
+    size_t operator()(const CellKey &key) const;
+  };
+
+  /// Position of an object in the grid.
+  struct ObjectCell {
+    CellKey key;
+    /// Index of the object in the objects of its cell.
+    unsigned int index;
+  };
+
+  enum CellRelation { CELL_OUTSIDE = 0, CELL_INSIDE, CELL_CROSS };
+
+  /// Objects of each non empty cell.
+  std::unordered_map<CellKey, std::vector<KX_GameObject *>, CellKeyHash> m_cells;
+  /// Cell of each object.
+  std::unordered_map<KX_GameObject *, ObjectCell> m_objectCells;
+
+  /** Objects which transform changed since the last update, can contain duplicates and removed
+   * objects, which are skipped as they are not in m_objectCells anymore.
+   */
+  std::vector<KX_GameObject *> m_movedObjects;
+  CM_ThreadSpinLock m_movedLock;
+
+  /// Activity box radius and cell size.
+  float m_radius;
+  /// Camera position of the last update.
+  MT_Vector3 m_cameraPosition;
+  /// False when the grid must be rebuilt at the next update.
+  bool m_valid;
+
+  CellKey GetCellKey(const MT_Vector3 &position) const;
+  CellRelation GetCellRelation(const CellKey &key, const MT_Vector3 &center) const;
+
+  void InsertObject(KX_GameObject *gameobj, ObjectCell &cell, const CellKey &key);
+  void EraseObject(const ObjectCell &cell);
+
+  /// Suspend or resume the object dynamics if its state changes.
+  void UpdateObject(KX_GameObject *gameobj, const MT_Vector3 &cameraPosition) const;
+  void UpdateCell(const std::vector<KX_GameObject *> &objects,
+                  const MT_Vector3 &cameraPosition) const;
+
+  void Rebuild(CListValue<KX_GameObject> *objects, const MT_Vector3 &cameraPosition);
+
+ public:
+  KX_ActivityGrid();
+  ~KX_ActivityGrid();
+
+  /** Force a full update at the next call to Update(), needed when objects are added to the
+   * scene without calling AddObject().
+   */
+  void Invalidate();
+
+  void AddObject(KX_GameObject *gameobj);
+  void RemoveObject(KX_GameObject *gameobj);
+  /// Register an object which transform changed, thread safe.
+  void ObjectMoved(KX_GameObject *gameobj);
+
+  /** Update the activity of the objects.
+   * \param objects The scene object list, used when the grid is rebuilt.
+   * \param cameraPosition The center of the activity box.
+   * \param radius The activity box radius.
+   */
+  void Update(CListValue<KX_GameObject> *objects, const MT_Vector3 &cameraPosition, float radius);
+};
+
+#endif  // __KX_ACTIVITYGRID_H__
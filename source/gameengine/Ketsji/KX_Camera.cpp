@@ -121,6 +121,18 @@ MT_Transform KX_Camera::GetCameraToWorld() const
   return MT_Transform(NodeGetWorldPosition(), NodeGetWorldOrientation());
 }
 
+MT_Transform KX_Camera::GetRenderWorldToCamera() const
+{
+  const float factor = KX_GetActiveEngine()->GetInterpolationFactor();
+  const SG_Node *node = GetSGNode();
+
+  MT_Transform camtrans;
+  camtrans.invert(MT_Transform(node->GetInterpolatedWorldPosition(factor),
+                               node->GetInterpolatedWorldOrientation(factor)));
+
+  return camtrans;
+}
+
 /**
  * Sets the projection matrix that is used by the rasterizer.
  */
@@ -322,6 +334,9 @@ PyMethodDef KX_Camera::Methods[] = {
     KX_PYMETHODTABLE(KX_Camera, sphereInsideFrustum),
     KX_PYMETHODTABLE_O(KX_Camera, boxInsideFrustum),
     KX_PYMETHODTABLE_O(KX_Camera, pointInsideFrustum),
+    KX_PYMETHODTABLE_O(KX_Camera, spheresInsideFrustum),
+    KX_PYMETHODTABLE_O(KX_Camera, boxesInsideFrustum),
+    KX_PYMETHODTABLE_NOARGS(KX_Camera, getObjectsInsideFrustum),
     KX_PYMETHODTABLE_NOARGS(KX_Camera, getCameraToWorld),
     KX_PYMETHODTABLE_NOARGS(KX_Camera, getWorldToCamera),
     KX_PYMETHODTABLE(KX_Camera, setViewport),
@@ -511,6 +526,72 @@ KX_PYMETHODDEF_DOC_O(KX_Camera,
   return nullptr;
 }
 
+KX_PYMETHODDEF_DOC_O(KX_Camera,
+                     spheresInsideFrustum,
+                     "spheresInsideFrustum(spheres) -> bytes\n"
+                     "\treturns a bit mask of the spheres inside or intersecting this camera's "
+                     "viewing frustum.\n\n"
+                     "\tspheres = a float buffer of the center and radius of each sphere: "
+                     "x, y, z, radius (in world coordinates.)\n")
+{
+  Py_buffer view;
+  if (!PyFloatBufferGet(
+          value, &view, false, 4, "camera.spheresInsideFrustum(spheres): KX_Camera")) {
+    return nullptr;
+  }
+
+  const unsigned int count = view.len / (sizeof(float) * 4);
+  PyObject *mask = PyBytes_FromStringAndSize(nullptr, (count + 7) / 8);
+  if (mask) {
+    GetFrustum().SpheresInsideFrustum(
+        (const float *)view.buf, count, (unsigned char *)PyBytes_AS_STRING(mask));
+  }
+
+  PyBuffer_Release(&view);
+  return mask;
+}
+
+KX_PYMETHODDEF_DOC_O(KX_Camera,
+                     boxesInsideFrustum,
+                     "boxesInsideFrustum(boxes) -> bytes\n"
+                     "\treturns a bit mask of the axis aligned boxes inside or intersecting this "
+                     "camera's viewing frustum.\n\n"
+                     "\tboxes = a float buffer of the bounds of each box: "
+                     "min x, min y, min z, max x, max y, max z (in world coordinates.)\n")
+{
+  Py_buffer view;
+  if (!PyFloatBufferGet(value, &view, false, 6, "camera.boxesInsideFrustum(boxes): KX_Camera")) {
+    return nullptr;
+  }
+
+  const unsigned int count = view.len / (sizeof(float) * 6);
+  PyObject *mask = PyBytes_FromStringAndSize(nullptr, (count + 7) / 8);
+  if (mask) {
+    GetFrustum().AabbsInsideFrustum(
+        (const float *)view.buf, count, (unsigned char *)PyBytes_AS_STRING(mask));
+  }
+
+  PyBuffer_Release(&view);
+  return mask;
+}
+
+KX_PYMETHODDEF_DOC_NOARGS(KX_Camera,
+                          getObjectsInsideFrustum,
+                          "getObjectsInsideFrustum() -> list\n"
+                          "\treturns the objects of the scene whose bounds intersect this "
+                          "camera's viewing frustum.\n")
+{
+  std::vector<KX_GameObject *> objects;
+  GetScene()->GetObjectsInsideFrustum(GetFrustum(), objects);
+
+  PyObject *list = PyList_New(objects.size());
+  for (unsigned int i = 0, size = objects.size(); i < size; ++i) {
+    PyList_SET_ITEM(list, i, objects[i]->GetProxy());
+  }
+
+  return list;
+}
+
 KX_PYMETHODDEF_DOC_NOARGS(KX_Camera,
                           getCameraToWorld,
                           "getCameraToWorld() -> Matrix4x4\n"
@@ -147,6 +147,10 @@ class KX_Camera : public KX_GameObject {
 
   MT_Transform GetWorldToCamera() const;
   MT_Transform GetCameraToWorld() const;
+  /** World to camera transform of the rendered view, interpolated between the logic frames like
+   * the drawn objects. Used for the view matrix so culling and lod follow the drawn camera.
+   */
+  MT_Transform GetRenderWorldToCamera() const;
 
   /** Sets the projection matrix that is used by the rasterizer. */
   void SetProjectionMatrix(const MT_Matrix4x4 &mat);
@@ -255,6 +259,9 @@ class KX_Camera : public KX_GameObject {
   KX_PYMETHOD_DOC_VARARGS(KX_Camera, sphereInsideFrustum);
   KX_PYMETHOD_DOC_O(KX_Camera, boxInsideFrustum);
   KX_PYMETHOD_DOC_O(KX_Camera, pointInsideFrustum);
+  KX_PYMETHOD_DOC_O(KX_Camera, spheresInsideFrustum);
+  KX_PYMETHOD_DOC_O(KX_Camera, boxesInsideFrustum);
+  KX_PYMETHOD_DOC_NOARGS(KX_Camera, getObjectsInsideFrustum);
 
   KX_PYMETHOD_DOC_NOARGS(KX_Camera, getCameraToWorld);
   KX_PYMETHOD_DOC_NOARGS(KX_Camera, getWorldToCamera);
@@ -31,6 +31,8 @@
 
 #include "KX_CollisionEventManager.h"
 
+#include <algorithm>
+
 #include "KX_CollisionContactPoints.h"
 #include "KX_GameObject.h"
 #include "PHY_IPhysicsController.h"
@@ -57,10 +59,8 @@ KX_CollisionEventManager::~KX_CollisionEventManager()
 
 void KX_CollisionEventManager::RemoveNewCollisions()
 {
-  for (std::set<NewCollision>::iterator it = m_newCollisions.begin(), end = m_newCollisions.end();
-       it != end;
-       ++it) {
-    delete it->colldata;
+  for (const NewCollision &collision : m_newCollisions) {
+    delete collision.colldata;
   }
   m_newCollisions.clear();
 }
@@ -72,7 +72,7 @@ bool KX_CollisionEventManager::NewHandleCollision(void *object1,
   PHY_IPhysicsController *obj1 = static_cast<PHY_IPhysicsController *>(object1);
   PHY_IPhysicsController *obj2 = static_cast<PHY_IPhysicsController *>(object2);
 
-  m_newCollisions.insert(NewCollision(obj1, obj2, coll_data));
+  m_newCollisions.push_back({obj1, obj2, coll_data});
 
   return false;
 }
@@ -196,40 +196,56 @@ void KX_CollisionEventManager::NextFrame()
     static_cast<SCA_CollisionSensor *>(sensor)->SynchronizeTransform();
   }
 
-  for (std::set<NewCollision>::iterator cit = m_newCollisions.begin();
-       cit != m_newCollisions.end();
-       ++cit) {
-    // Controllers
-    PHY_IPhysicsController *ctrl1 = (*cit).first;
-    PHY_IPhysicsController *ctrl2 = (*cit).second;
-    // Sensor iterator
-    std::list<SCA_ISensor *>::iterator sit;
-
-    // First client info
-    KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
-        ctrl1->GetNewClientInfo());
-    // First gameobject
-    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info);
-    // Invoke sensor response for each object
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl1, ctrl2, nullptr);
-      }
+  /* The same collision can be reported several times, the duplicates share the same collision
+   * data which is freed only once. */
+  std::sort(m_newCollisions.begin(), m_newCollisions.end());
+  m_newCollisions.erase(std::unique(m_newCollisions.begin(), m_newCollisions.end()),
+                        m_newCollisions.end());
+
+  // Invoke sensor response for each object, each sensor handles all its collisions at once.
+  if (!m_sensors.empty()) {
+    m_collisionEvents.clear();
+    for (const NewCollision &collision : m_newCollisions) {
+      m_collisionEvents.push_back({collision.first, collision.second});
+      m_collisionEvents.push_back({collision.second, collision.first});
     }
+    std::sort(m_collisionEvents.begin(), m_collisionEvents.end());
+
+    for (std::vector<CollisionEvent>::const_iterator begin = m_collisionEvents.begin(),
+                                                     end = m_collisionEvents.end();
+         begin != end;) {
+      PHY_IPhysicsController *receiver = begin->receiver;
+      std::vector<CollisionEvent>::const_iterator groupEnd = begin;
+      while (groupEnd != end && groupEnd->receiver == receiver) {
+        ++groupEnd;
+      }
 
-    // Second client info
-    client_info = static_cast<KX_ClientObjectInfo *>(ctrl2->GetNewClientInfo());
-    // Second gameobject
-    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info);
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl2, ctrl1, nullptr);
+      KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
+          receiver->GetNewClientInfo());
+      if (client_info) {
+        for (SCA_ISensor *sensor : client_info->m_sensors) {
+          SCA_CollisionSensor *collisionSensor = static_cast<SCA_CollisionSensor *>(sensor);
+          for (std::vector<CollisionEvent>::const_iterator it = begin; it != groupEnd; ++it) {
+            collisionSensor->NewHandleCollision(receiver, it->other, nullptr);
+          }
+        }
       }
+
+      begin = groupEnd;
     }
-    // Run python callbacks
-    const PHY_CollData *colldata = cit->colldata;
-    KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(colldata, true);
-    KX_CollisionContactPointList contactPointList1 = KX_CollisionContactPointList(colldata, false);
+  }
+
+  // Run python callbacks
+  for (const NewCollision &collision : m_newCollisions) {
+    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(
+        static_cast<KX_ClientObjectInfo *>(collision.first->GetNewClientInfo()));
+    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(
+        static_cast<KX_ClientObjectInfo *>(collision.second->GetNewClientInfo()));
+
+    KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(
+        collision.colldata, true);
+    KX_CollisionContactPointList contactPointList1 = KX_CollisionContactPointList(
+        collision.colldata, false);
     kxObj1->RunCollisionCallbacks(kxObj2, contactPointList0);
     kxObj2->RunCollisionCallbacks(kxObj1, contactPointList1);
   }
@@ -241,18 +257,6 @@ void KX_CollisionEventManager::NextFrame()
   RemoveNewCollisions();
 }
 
-KX_CollisionEventManager::NewCollision::NewCollision(PHY_IPhysicsController *first,
-                                                     PHY_IPhysicsController *second,
-                                                     const PHY_CollData *colldata)
-    : first(first), second(second), colldata(colldata)
-{
-}
-
-KX_CollisionEventManager::NewCollision::NewCollision(const NewCollision &to_copy)
-    : first(to_copy.first), second(to_copy.second), colldata(to_copy.colldata)
-{
-}
-
 bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other) const
 {
   // see strict weak ordering: https://support.microsoft.com/en-us/kb/949171
@@ -264,3 +268,16 @@ bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other
   }
   return first < other.first;
 }
+
+bool KX_CollisionEventManager::NewCollision::operator==(const NewCollision &other) const
+{
+  return (first == other.first && second == other.second && colldata == other.colldata);
+}
+
+bool KX_CollisionEventManager::CollisionEvent::operator<(const CollisionEvent &event) const
+{
+  if (receiver == event.receiver) {
+    return other < event.other;
+  }
+  return receiver < event.receiver;
+}
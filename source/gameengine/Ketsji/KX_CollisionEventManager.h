@@ -32,7 +32,6 @@
 #ifndef __KX_TOUCHEVENTMANAGER_H__
 #define __KX_TOUCHEVENTMANAGER_H__
 
-#include <set>
 #include <vector>
 
 #include "KX_GameObject.h"
@@ -45,30 +44,31 @@ class PHY_IPhysicsEnvironment;
 class KX_CollisionEventManager : public SCA_EventManager {
   /**
    * Contains two colliding objects and the first contact point.
+   * The collision data is allocated by the physics environment and freed by the manager.
    */
-  class NewCollision {
-   public:
+  struct NewCollision {
     PHY_IPhysicsController *first;
     PHY_IPhysicsController *second;
     const PHY_CollData *colldata;
 
-    /**
-     * Creates a copy of the given PHY_CollData; freeing that copy should be done by the owner of
-     * the NewCollision object.
-     *
-     * This allows us to efficiently store NewCollision objects in a std::set without creating more
-     * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't
-     * clone it again. */
-    NewCollision(PHY_IPhysicsController *first,
-                 PHY_IPhysicsController *second,
-                 const PHY_CollData *colldata);
-    NewCollision(const NewCollision &to_copy);
     bool operator<(const NewCollision &other) const;
+    bool operator==(const NewCollision &other) const;
+  };
+
+  /// A collision seen from one of its objects.
+  struct CollisionEvent {
+    PHY_IPhysicsController *receiver;
+    PHY_IPhysicsController *other;
+
+    bool operator<(const CollisionEvent &event) const;
   };
 
   PHY_IPhysicsEnvironment *m_physEnv;
 
-  std::set<NewCollision> m_newCollisions;
+  /// Collisions of the frame, appended by the physics callbacks and sorted once in NextFrame.
+  std::vector<NewCollision> m_newCollisions;
+  /// Collisions of the frame grouped by receiving object, reused between the frames.
+  std::vector<CollisionEvent> m_collisionEvents;
 
   static bool newCollisionResponse(void *client_data,
                                    void *object1,
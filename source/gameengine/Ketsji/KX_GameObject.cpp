@@ -250,8 +250,10 @@ void KX_GameObject::SetBlenderObject(Object *obj)
 
 void KX_GameObject::TagForUpdate(bool is_overlay_pass)
 {
+  // Render the transform between the last two logic frames when the interpolation is enabled.
   float obmat[4][4];
-  NodeGetWorldTransform().getValue(&obmat[0][0]);
+  m_pSGNode->GetInterpolatedWorldTransform(KX_GetActiveEngine()->GetInterpolationFactor())
+      .getValue(&obmat[0][0]);
   m_staticObject = compare_m4m4(m_prevObmat, obmat, FLT_MIN);
 
   Scene *sc = GetScene()->GetBlenderScene();
@@ -509,6 +511,7 @@ void KX_GameObject::AddDummyLodManager(RAS_MeshObject *meshObj)
 {
   m_lodManager = new KX_LodManager(meshObj);
   m_lodManager->AddRef();
+  GetScene()->InvalidateLodObjects();
 }
 
 bool KX_GameObject::IsReplica()
@@ -654,6 +657,7 @@ void KX_GameObject::SetParent(KX_GameObject *obj, bool addToCompound, bool ghost
     NodeSetLocalPosition(MT_Vector3(newpos[0], newpos[1], newpos[2]));
     NodeSetLocalOrientation(invori * NodeGetWorldOrientation());
     NodeUpdateGS(0.f);
+    GetSGNode()->ResetPreviousWorldTransform();
     // object will now be a child, it must be removed from the parent list
     CListValue<KX_GameObject> *rootlist = scene->GetRootParentList();
     if (rootlist->RemoveValue(this))
@@ -688,6 +692,7 @@ void KX_GameObject::RemoveParent()
     // Remove us from our parent
     GetSGNode()->DisconnectFromParent();
     NodeUpdateGS(0.f);
+    GetSGNode()->ResetPreviousWorldTransform();
 
     KX_Scene *scene = GetScene();
     // the object is now a root object, add it to the parentlist
@@ -763,6 +768,21 @@ void KX_GameObject::RemoveTaggedActions()
   GetActionManager()->RemoveTaggedActions();
 }
 
+void KX_GameObject::GetActionStates(std::vector<BL_ActionState> &states)
+{
+  // Don't create an action manager for the objects never animated.
+  if (m_actionManager) {
+    m_actionManager->GetActionStates(states);
+  }
+}
+
+void KX_GameObject::SetActionStates(const std::vector<BL_ActionState> &states)
+{
+  if (m_actionManager || !states.empty()) {
+    GetActionManager()->SetActionStates(states);
+  }
+}
+
 bool KX_GameObject::IsActionDone(short layer)
 {
   return GetActionManager()->IsActionDone(layer);
@@ -1002,6 +1022,8 @@ void KX_GameObject::SetLodManager(KX_LodManager *lodManager)
   if (m_lodManager) {
     m_lodManager->AddRef();
   }
+
+  GetScene()->InvalidateLodObjects();
 }
 
 KX_LodManager *KX_GameObject::GetLodManager() const
@@ -1009,20 +1031,19 @@ KX_LodManager *KX_GameObject::GetLodManager() const
   return m_lodManager;
 }
 
-void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
+KX_LodLevel *KX_GameObject::ComputeLodLevel(float distance2)
 {
-  if (!m_lodManager) {
-    return;
-  }
-
-  KX_Scene *scene = GetScene();
-  const float distance2 = NodeGetWorldPosition().distance2(cam_pos) * (lodfactor * lodfactor);
-  KX_LodLevel *lodLevel = m_lodManager->GetLevel(scene, m_currentLodLevel, distance2);
+  return m_lodManager->GetLevel(GetScene(), m_currentLodLevel, distance2);
+}
 
+bool KX_GameObject::ApplyLodLevel(KX_LodLevel *lodLevel)
+{
+  bool changed = false;
   if (lodLevel) {
     RAS_MeshObject *mesh = lodLevel->GetMesh();
     if (mesh != m_meshes[0]) {
-      scene->ReplaceMesh(this, mesh, true, false);
+      GetScene()->ReplaceMesh(this, mesh, true, false);
+      changed = true;
     }
     m_currentLodLevel = lodLevel->GetLevel();
   }
@@ -1036,13 +1057,21 @@ void KX_GameObject::UpdateLod(const MT_Vector3 &cam_pos, float lodfactor)
 
     /* Here we want to change the object which will be rendered, then the evaluated object by the
      * depsgraph */
-    Object *ob_eval = DEG_get_evaluated_object(depsgraph, GetBlenderObject());
+    Object *ob_orig = GetBlenderObject();
+    Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob_orig);
 
-    Object *eval_lod_ob = DEG_get_evaluated_object(depsgraph,
-                                                   currentMeshObject->GetOriginalObject());
-    /* Try to get the object with all modifiers applied */
-    ob_eval->data = eval_lod_ob->data;
+    Object *lod_ob = currentMeshObject->GetOriginalObject();
+    /* The evaluated object data may be the one of a lower level, restore its own evaluated data
+     * when the level uses the mesh of the object. */
+    void *data = (lod_ob == ob_orig) ?
+                     DEG_get_evaluated_id(depsgraph, (ID *)ob_orig->data) :
+                     DEG_get_evaluated_object(depsgraph, lod_ob)->data;
+    if (ob_eval->data != data) {
+      ob_eval->data = data;
+    }
   }
+
+  return changed;
 }
 
 void KX_GameObject::UpdateTransform()
@@ -1055,6 +1084,7 @@ void KX_GameObject::UpdateTransform()
 void KX_GameObject::UpdateTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
   ((KX_GameObject *)gameobj)->UpdateTransform();
+  ((KX_Scene *)scene)->NotifyObjectMoved((KX_GameObject *)gameobj);
 }
 
 void KX_GameObject::SynchronizeTransform()
@@ -1534,6 +1564,8 @@ void KX_GameObject::NodeSetWorldPosition(const MT_Vector3 &trans)
   else {
     NodeSetLocalPosition(trans);
   }
+  // Setting the world position is a teleport, it must not be interpolated.
+  m_pSGNode->ResetPreviousWorldTransform();
 }
 
 void KX_GameObject::NodeUpdateGS(double time)
@@ -62,6 +62,7 @@ class RAS_MeshObject;
 class PHY_IPhysicsEnvironment;
 class PHY_IPhysicsController;
 class BL_ActionManager;
+struct BL_ActionState;
 struct Object;
 class KX_ObstacleSimulation;
 class KX_CollisionContactPointList;
@@ -300,6 +301,16 @@ class KX_GameObject : public SCA_IObject {
    */
   bool IsActionDone(short layer);
 
+  /**
+   * Get the state of the playing actions
+   */
+  void GetActionStates(std::vector<BL_ActionState> &states);
+
+  /**
+   * Replace the playing actions by the actions of the states
+   */
+  void SetActionStates(const std::vector<BL_ActionState> &states);
+
   /**
    * Kick the object's action manager
    * \param curtime The current time used to compute the actions frame.
@@ -634,10 +645,15 @@ class KX_GameObject : public SCA_IObject {
   /// Get current lod manager.
   KX_LodManager *GetLodManager() const;
 
-  /**
-   * Updates the current lod level based on distance from camera.
+  /** Return the lod level to use for a squared distance to the camera or nullptr if the level
+   * doesn't change. Safe to call from multiple threads.
+   */
+  KX_LodLevel *ComputeLodLevel(float distance2);
+  /** Switch to the lod level returned by ComputeLodLevel if not nullptr and make the evaluated
+   * object use the mesh of the current level.
+   * \return True if the level changed.
    */
-  void UpdateLod(const MT_Vector3 &cam_pos, float lodfactor);
+  bool ApplyLodLevel(KX_LodLevel *lodLevel);
 
   /**
    * Pick out a mesh associated with the integer 'num'.
@@ -36,7 +36,9 @@
 
 #include "KX_KetsjiEngine.h"
 
+#include <algorithm>
 #include <boost/format.hpp>
+#include <cctype>
 
 #include "BLI_task.h"
 #include "DNA_scene_types.h"
@@ -144,6 +146,7 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system, bContext *C)
       m_previousAnimTime(0.0f),
       m_timescale(1.0f),
       m_previousRealTime(0.0f),
+      m_interpolationFactor(1.0f),
       m_maxLogicFrame(5),
       m_maxPhysicsFrame(5),
       m_ticrate(DEFAULT_LOGIC_TIC_RATE),
@@ -156,6 +159,16 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system, bContext *C)
       m_overrideCamZoom(1.0f),
       m_logger(KX_TimeCategoryLogger(25)),
       m_average_framerate(0.0),
+      m_numActiveBodies(0),
+      m_numBodies(0),
+      m_totalActiveBodies(0.0),
+      m_totalBodies(0.0),
+      m_numBodyMeasurements(0),
+      m_numVisitedOperations(0),
+      m_numOperations(0),
+      m_totalVisitedOperations(0.0),
+      m_totalOperations(0.0),
+      m_numOperationMeasurements(0),
       m_showBoundingBox(KX_DebugOption::DISABLE),
       m_showArmature(KX_DebugOption::DISABLE),
       m_showCameraFrustum(KX_DebugOption::DISABLE),
@@ -207,6 +220,20 @@ void KX_KetsjiEngine::EndCountDepsgraphTime()
 {
   m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
 }
+
+void KX_KetsjiEngine::AddDepsgraphStats(unsigned int numVisitedOperations,
+                                        unsigned int numOperations)
+{
+  // Evaluations without any tagged update don't visit the graph.
+  if (numVisitedOperations == 0) {
+    return;
+  }
+
+  m_numVisitedOperations += numVisitedOperations;
+  m_numOperations += numOperations;
+  m_totalVisitedOperations += numVisitedOperations;
+  m_totalOperations += numOperations;
+}
 /* End of EEVEE integration */
 
 void KX_KetsjiEngine::SetInputDevice(SCA_IInputDevice *inputDevice)
@@ -240,6 +267,41 @@ PyObject *KX_KetsjiEngine::GetPyProfileDict()
 }
 #endif
 
+void KX_KetsjiEngine::WriteProfileJson(std::ostream &stream) const
+{
+  const unsigned int numFrames = m_logger.GetLogger(tc_first).GetNumTotalMeasurements();
+  double total = 0.0;
+
+  stream << "{\n  \"frames\": " << numFrames << ",\n  \"categories\": {";
+  for (int i = tc_first; i < tc_numCategories; ++i) {
+    const KX_TimeLogger &logger = m_logger.GetLogger((KX_TimeCategory)i);
+    const double time = logger.GetTotal();
+    total += time;
+
+    // Labels are used as keys without their trailing colon.
+    std::string name = m_profileLabels[i].substr(0, m_profileLabels[i].size() - 1);
+    for (char &c : name) {
+      c = (c == ' ') ? '_' : std::tolower(c);
+    }
+
+    stream << ((i == tc_first) ? "\n" : ",\n") << "    \"" << name << "\": {"
+           << "\"total\": " << time * 1000.0
+           << ", \"mean\": " << ((numFrames > 0) ? time * 1000.0 / numFrames : 0.0)
+           << ", \"min\": " << logger.GetMinimum() * 1000.0
+           << ", \"max\": " << logger.GetMaximum() * 1000.0 << "}";
+  }
+  stream << "\n  },\n  \"physics_bodies\": {\"active\": "
+         << ((m_numBodyMeasurements > 0) ? m_totalActiveBodies / m_numBodyMeasurements : 0.0)
+         << ", \"total\": "
+         << ((m_numBodyMeasurements > 0) ? m_totalBodies / m_numBodyMeasurements : 0.0) << "}";
+  const unsigned int numOperationMeasurements = std::max(m_numOperationMeasurements, 1u);
+  stream << ",\n  \"depsgraph_operations\": {\"visited\": "
+         << m_totalVisitedOperations / numOperationMeasurements
+         << ", \"total\": " << m_totalOperations / numOperationMeasurements << "}";
+  stream << ",\n  \"total\": " << total * 1000.0
+         << ",\n  \"mean\": " << ((numFrames > 0) ? total * 1000.0 / numFrames : 0.0) << "\n}\n";
+}
+
 void KX_KetsjiEngine::SetConverter(BL_BlenderConverter *converter)
 {
   BLI_assert(converter);
@@ -310,7 +372,8 @@ bool KX_KetsjiEngine::NextFrame()
   /*
    * Clock advancement. There is basically two case:
    *   - USE_EXTERNAL_CLOCK is true, the user is responsible to advance the time
-   *   manually using setClockTime, so here, we do not do anything.
+   *   manually using setClockTime, so here, we do not do anything except computing
+   *   the time step from the clock advance with EXTERNAL_CLOCK_TIMESTEP.
    *   - USE_EXTERNAL_CLOCK is false, we consider how much
    *   time has elapsed since last call and we scale this time by the time
    *   scaling parameter. If m_timescale is 1.0 (default value), the clock
@@ -344,6 +407,10 @@ bool KX_KetsjiEngine::NextFrame()
       timestep = dt * m_timescale;
     }
   }
+  else if ((m_flags & EXTERNAL_CLOCK_TIMESTEP) && !(m_flags & FIXED_FRAMERATE)) {
+    // Proceed of the time elapsed since the last frame as the internal clock does.
+    timestep = m_clockTime - m_frameTime;
+  }
 
   double deltatime = m_clockTime - m_frameTime;
   if (deltatime < 0.0) {
@@ -369,7 +436,12 @@ bool KX_KetsjiEngine::NextFrame()
     frames = m_maxPhysicsFrame;
   }
 
-  bool doRender = frames > 0;
+  /* With the interpolation each render shows a new intermediate state, even without logic frame.
+   * It only applies to the fixed framerate, a variable step runs a logic frame per render.
+   */
+  const bool interpolate = (m_flags & FIXED_FRAMERATE) && (m_flags & INTERPOLATE_TRANSFORMS);
+
+  bool doRender = frames > 0 || interpolate;
 
   if (frames > m_maxLogicFrame) {
     framestep = (frames * timestep) / m_maxLogicFrame;
@@ -394,6 +466,9 @@ bool KX_KetsjiEngine::NextFrame()
     }
 #endif  // WITH_SDL
 
+    m_numActiveBodies = 0;
+    m_numBodies = 0;
+
     // for each scene, call the proceed functions
     for (KX_Scene *scene : m_scenes) {
       /* Suspension holds the physics and logic processing for an
@@ -402,6 +477,10 @@ bool KX_KetsjiEngine::NextFrame()
        * update. */
       m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
 
+      if (interpolate) {
+        scene->SavePreviousTransforms();
+      }
+
       scene->UpdateObjectActivity();
 
       m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
@@ -439,12 +518,22 @@ bool KX_KetsjiEngine::NextFrame()
       scene->GetPhysicsEnvironment()->ProceedDeltaTime(
           m_frameTime, timestep, framestep);  // m_deltatimerealDeltaTime);
 
+      unsigned int numActiveBodies;
+      unsigned int numBodies;
+      scene->GetPhysicsEnvironment()->GetNumBodies(numActiveBodies, numBodies);
+      m_numActiveBodies += numActiveBodies;
+      m_numBodies += numBodies;
+
       m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
       scene->UpdateParents(m_frameTime);
 
       m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
     }
 
+    m_totalActiveBodies += m_numActiveBodies;
+    m_totalBodies += m_numBodies;
+    ++m_numBodyMeasurements;
+
     m_logger.StartLog(tc_network, m_kxsystem->GetTimeInSeconds());
     m_networkMessageManager->ClearMessages();
 
@@ -459,6 +548,19 @@ bool KX_KetsjiEngine::NextFrame()
 
   }
 
+  if (interpolate && timestep > 0.0) {
+    // The clock time is between the current logic frame and the next one.
+    m_interpolationFactor = std::min(std::max((m_clockTime - m_frameTime) / timestep, 0.0), 1.0);
+  }
+  else {
+    m_interpolationFactor = 1.0f;
+  }
+
+  if (doRender && !m_doRender) {
+    // EndFrame is not called, go to next profiling measurement here.
+    m_logger.NextMeasurement(m_kxsystem->GetTimeInSeconds());
+  }
+
   // Start logging time spent outside main loop
   m_logger.StartLog(tc_outside, m_kxsystem->GetTimeInSeconds());
 
@@ -481,8 +583,10 @@ KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
   if (usestereo) {
     rendercam = new KX_Camera(scene, scene->m_callbacks, *camera->GetCameraData(), true, true);
     rendercam->SetName("__stereo_" + camera->GetName() + "_" + std::to_string(eye) + "__");
-    rendercam->NodeSetGlobalOrientation(camera->NodeGetWorldOrientation());
-    rendercam->NodeSetWorldPosition(camera->NodeGetWorldPosition());
+    const SG_Node *node = camera->GetSGNode();
+    rendercam->NodeSetGlobalOrientation(
+        node->GetInterpolatedWorldOrientation(m_interpolationFactor));
+    rendercam->NodeSetWorldPosition(node->GetInterpolatedWorldPosition(m_interpolationFactor));
     rendercam->NodeSetWorldScale(camera->NodeGetWorldScaling());
     rendercam->NodeUpdateGS(0.0);
   }
@@ -505,7 +609,7 @@ KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
   GetSceneViewport(scene, rendercam, displayArea, area, viewport);
   // Compute the camera matrices: modelview and projection.
   const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(
-      eye, rendercam->GetWorldToCamera(), rendercam->GetCameraData()->m_perspective);
+      eye, rendercam->GetRenderWorldToCamera(), rendercam->GetCameraData()->m_perspective);
   const MT_Matrix4x4 projmat = GetCameraProjectionMatrix(scene, rendercam, eye, viewport, area);
   rendercam->SetModelviewMatrix(viewmat);
   rendercam->SetProjectionMatrix(projmat);
@@ -579,7 +683,7 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
       // Compute the camera matrices: modelview and projection.
       const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(
           RAS_Rasterizer::RAS_STEREO_LEFTEYE,
-          overrideCullingCam->GetWorldToCamera(),
+          overrideCullingCam->GetRenderWorldToCamera(),
           overrideCullingCam->GetCameraData()->m_perspective);
       const MT_Matrix4x4 projmat = GetCameraProjectionMatrix(
           scene, overrideCullingCam, RAS_Rasterizer::RAS_STEREO_LEFTEYE, viewport, area);
@@ -643,6 +747,10 @@ void KX_KetsjiEngine::Render()
 
   BeginFrame();
 
+  m_numVisitedOperations = 0;
+  m_numOperations = 0;
+  ++m_numOperationMeasurements;
+
   std::vector<FrameRenderData> frameDataList;
   GetFrameRenderData(frameDataList);
 
@@ -1116,6 +1224,18 @@ void KX_KetsjiEngine::RenderDebugProperties()
           MT_Vector2(xcoord + (int)(2.2 * profile_indent), ycoord), boxSize, white);
       ycoord += const_ysize;
     }
+
+    debugDraw.RenderText2D("Bodies:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+    debugtxt = (boost::format("%u active / %u") % m_numActiveBodies % m_numBodies).str();
+    debugDraw.RenderText2D(
+        debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+    ycoord += const_ysize;
+
+    debugDraw.RenderText2D("Depsgraph ops:", MT_Vector2(xcoord + const_xindent, ycoord), white);
+    debugtxt = (boost::format("%u visited / %u") % m_numVisitedOperations % m_numOperations).str();
+    debugDraw.RenderText2D(
+        debugtxt, MT_Vector2(xcoord + const_xindent + profile_indent, ycoord), white);
+    ycoord += const_ysize;
   }
   // Add the ymargin for titles below the other section of debug info
   ycoord += title_y_top_margin;
@@ -1156,7 +1276,9 @@ void KX_KetsjiEngine::DrawDebugCameraFrustum(KX_Scene *scene,
     if (cam != cameraFrameData.m_renderCamera &&
         (m_showCameraFrustum == KX_DebugOption::FORCE || cam->GetShowCameraFrustum())) {
       const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(
-          cameraFrameData.m_eye, cam->GetWorldToCamera(), cam->GetCameraData()->m_perspective);
+          cameraFrameData.m_eye,
+          cam->GetRenderWorldToCamera(),
+          cam->GetCameraData()->m_perspective);
       const MT_Matrix4x4 projmat = GetCameraProjectionMatrix(
           scene, cam, cameraFrameData.m_eye, cameraFrameData.m_viewport, cameraFrameData.m_area);
       debugDraw.DrawCameraFrustum(projmat * viewmat);
@@ -1369,6 +1491,11 @@ double KX_KetsjiEngine::GetFrameTime(void) const
   return m_frameTime;
 }
 
+float KX_KetsjiEngine::GetInterpolationFactor() const
+{
+  return m_interpolationFactor;
+}
+
 double KX_KetsjiEngine::GetRealTime(void) const
 {
   return m_kxsystem->GetTimeInSeconds();
@@ -33,6 +33,7 @@
 #ifndef __KX_KETSJIENGINE_H__
 #define __KX_KETSJIENGINE_H__
 
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -92,7 +93,13 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /// Render the objects between their last two logic states?
+    INTERPOLATE_TRANSFORMS = (1 << 8),
+    /// Evaluate only the depsgraph operations affected by the tagged updates?
+    SPARSE_DEPSGRAPH = (1 << 9),
+    /// Step by the external clock advance with a non-fixed framerate, used by the input replay.
+    EXTERNAL_CLOCK_TIMESTEP = (1 << 10)
   };
 
  private:
@@ -165,6 +172,8 @@ class KX_KetsjiEngine {
   /// slower than real-time.
   double m_timescale;
   double m_previousRealTime;
+  /// Position of the rendered frame between the last two logic frames, 1 without interpolation.
+  float m_interpolationFactor;
 
   /// maximum number of consecutive logic frame
   int m_maxLogicFrame;
@@ -215,6 +224,21 @@ class KX_KetsjiEngine {
   static const std::string m_profileLabels[tc_numCategories];
   /// Last estimated framerate
   double m_average_framerate;
+  /// Number of physics bodies awake and in total at the last logic frame, for all the scenes.
+  unsigned int m_numActiveBodies;
+  unsigned int m_numBodies;
+  /// Sums of the body counts of all the logic frames, for the profile statistics.
+  double m_totalActiveBodies;
+  double m_totalBodies;
+  unsigned int m_numBodyMeasurements;
+  /// Number of depsgraph operations visited by the evaluations of the current frame, and number of
+  /// operations of the evaluated depsgraphs.
+  unsigned int m_numVisitedOperations;
+  unsigned int m_numOperations;
+  /// Sums of the operation counts of all the frames, for the profile statistics.
+  double m_totalVisitedOperations;
+  double m_totalOperations;
+  unsigned int m_numOperationMeasurements;
 
   /// Enable debug draw of culling bounding boxes.
   KX_DebugOption m_showBoundingBox;
@@ -282,6 +306,8 @@ class KX_KetsjiEngine {
   // include depsgraph time in tc_depsgraph category
   void CountDepsgraphTime();
   void EndCountDepsgraphTime();
+  /// Add the operation counts of a depsgraph evaluation to the profile statistics.
+  void AddDepsgraphStats(unsigned int numVisitedOperations, unsigned int numOperations);
   /* End of EEVEE integration */
 
   void EndFrame();
@@ -298,6 +324,10 @@ class KX_KetsjiEngine {
 #ifdef WITH_PYTHON
   PyObject *GetPyProfileDict();
 #endif
+  /** Write the statistics of all the profiling measurements since the engine creation
+   * as a JSON object, times are in milliseconds.
+   */
+  void WriteProfileJson(std::ostream &stream) const;
   void SetConverter(BL_BlenderConverter *converter);
   BL_BlenderConverter *GetConverter()
   {
@@ -386,6 +416,12 @@ class KX_KetsjiEngine {
    */
   double GetFrameTime(void) const;
 
+  /**
+   * Returns the factor used to interpolate the rendered transforms between the last two logic
+   * frames, 0 for the previous frame and 1 for the current frame
+   */
+  float GetInterpolationFactor() const;
+
   /**
    * Returns the real (system) time
    */
@@ -41,13 +41,16 @@
 #include "BLI_utildefines.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
+#include "DNA_scene_types.h"
 #include "MEM_guardedalloc.h"
 
 #include "BL_BlenderConverter.h"
 #include "CM_Message.h"
 #include "DetourStatNavMeshBuilder.h"
+#include "DetourTileNavMesh.h"
 #include "EXP_Value.h"
 #include "KX_Globals.h"
+#include "KX_NavMeshPathRequest.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
 #include "RAS_ITexVert.h"
@@ -585,7 +588,10 @@ static int polyFindVertex(const unsigned short *p,
 }
 
 KX_NavMeshObject::KX_NavMeshObject(void *sgReplicationInfo, SG_Callbacks callbacks)
-    : KX_GameObject(sgReplicationInfo, callbacks), m_navMesh(nullptr)
+    : KX_GameObject(sgReplicationInfo, callbacks),
+      m_navMesh(nullptr),
+      m_tiles(nullptr),
+      m_pathQueue(nullptr)
 {
 }
 
@@ -593,6 +599,10 @@ KX_NavMeshObject::~KX_NavMeshObject()
 {
   if (m_navMesh)
     delete m_navMesh;
+  if (m_tiles)
+    delete m_tiles;
+  if (m_pathQueue)
+    delete m_pathQueue;
 }
 
 CValue *KX_NavMeshObject::GetReplica()
@@ -606,6 +616,8 @@ void KX_NavMeshObject::ProcessReplica()
 {
   KX_GameObject::ProcessReplica();
   m_navMesh = nullptr; /* without this, building frees the navmesh we copied from */
+  m_tiles = nullptr;
+  m_pathQueue = nullptr;
   if (!BuildNavMesh()) {
     CM_FunctionError("unable to build navigation mesh");
     return;
@@ -792,18 +804,90 @@ bool KX_NavMeshObject::BuildVertIndArrays(float *&vertices,
   return true;
 }
 
+std::shared_ptr<KX_NavMeshTiles::Source> KX_NavMeshObject::BuildTileSource()
+{
+  float *vertices = nullptr, *dvertices = nullptr;
+  unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
+  int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
+  int vertsPerPoly = 0;
+  std::shared_ptr<KX_NavMeshTiles::Source> source;
+  if (BuildVertIndArrays(vertices,
+                         nverts,
+                         polys,
+                         npolys,
+                         dmeshes,
+                         dvertices,
+                         ndvertsuniq,
+                         dtris,
+                         ndtris,
+                         vertsPerPoly) &&
+      vertsPerPoly >= 3 && nverts > 0 && npolys > 0) {
+    if (dmeshes == nullptr) {
+      for (int i = 0; i < nverts; i++) {
+        flipAxes(&vertices[i * 3]);
+      }
+    }
+    source = std::make_shared<KX_NavMeshTiles::Source>(
+        vertices, nverts, polys, npolys, vertsPerPoly);
+  }
+
+  // The detail meshes are rebuilt per tile.
+  if (vertices) {
+    delete[] vertices;
+  }
+  if (dvertices) {
+    delete[] dvertices;
+  }
+  MEM_SAFE_FREE(polys);
+  MEM_SAFE_FREE(dmeshes);
+  MEM_SAFE_FREE(dtris);
+
+  return source;
+}
+
+bool KX_NavMeshObject::BuildTiledNavMesh()
+{
+  std::shared_ptr<KX_NavMeshTiles::Source> source = BuildTileSource();
+  if (!source) {
+    CM_Error("can't build navigation mesh data for object: " << m_name);
+    return false;
+  }
+
+  const RecastData &recastData = GetScene()->GetBlenderScene()->gm.recastData;
+  KX_NavMeshTiles::Settings settings;
+  settings.cellSize = recastData.cellsize;
+  settings.cellHeight = recastData.cellheight;
+  settings.tileCells = recastData.tilesize;
+  settings.portalHeight = recastData.agentmaxclimb;
+
+  m_tiles = new KX_NavMeshTiles(source, settings);
+  return m_tiles->Build();
+}
+
 bool KX_NavMeshObject::BuildNavMesh()
 {
+  // The polygon references of the running searches become invalid.
+  if (m_pathQueue) {
+    m_pathQueue->Restart();
+  }
   if (m_navMesh) {
     delete m_navMesh;
     m_navMesh = nullptr;
   }
+  if (m_tiles) {
+    delete m_tiles;
+    m_tiles = nullptr;
+  }
 
   if (GetMeshCount() == 0) {
     CM_Error("can't find mesh for navmesh object: " << m_name);
     return false;
   }
 
+  if (GetScene()->GetBlenderScene()->gm.recastData.tilesize > 0) {
+    return BuildTiledNavMesh();
+  }
+
   float *vertices = nullptr, *dvertices = nullptr;
   unsigned short *polys = nullptr, *dtris = nullptr, *dmeshes = nullptr;
   int nverts = 0, npolys = 0, ndvertsuniq = 0, ndtris = 0;
@@ -1000,11 +1084,123 @@ dtStatNavMesh *KX_NavMeshObject::GetNavMesh()
   return m_navMesh;
 }
 
+dtTiledNavMesh *KX_NavMeshObject::GetTiledNavMesh()
+{
+  return m_tiles ? m_tiles->GetNavMesh() : nullptr;
+}
+
+KX_NavMeshTiles *KX_NavMeshObject::GetTiles()
+{
+  return m_tiles;
+}
+
+void KX_NavMeshObject::TilesChanged()
+{
+  if (m_pathQueue) {
+    m_pathQueue->Restart();
+  }
+
+  KX_ObstacleSimulation *obssimulation = GetScene()->GetObstacleSimulation();
+  if (obssimulation) {
+    obssimulation->DestroyObstacleForObj(this);
+    obssimulation->AddObstaclesForNavMesh(this);
+  }
+}
+
+void KX_NavMeshObject::UpdateTiles()
+{
+  if (m_tiles && m_tiles->Update()) {
+    TilesChanged();
+  }
+}
+
+void KX_NavMeshObject::GetLocalBox(const MT_Vector3 &corner1,
+                                   const MT_Vector3 &corner2,
+                                   float bmin[3],
+                                   float bmax[3])
+{
+  INIT_MINMAX(bmin, bmax);
+  for (unsigned short i = 0; i < 8; ++i) {
+    const MT_Vector3 corner((i & 1) ? corner2.x() : corner1.x(),
+                            (i & 2) ? corner2.y() : corner1.y(),
+                            (i & 4) ? corner2.z() : corner1.z());
+    float pos[3];
+    TransformToLocalCoords(corner).getValue(pos);
+    flipAxes(pos);
+    minmax_v3v3_v3(bmin, bmax, pos);
+  }
+}
+
+unsigned int KX_NavMeshObject::RebuildTiles(const MT_Vector3 &corner1, const MT_Vector3 &corner2)
+{
+  if (!m_tiles) {
+    return 0;
+  }
+
+  // The mesh is read in the main thread, only the tiles are built asynchronously.
+  std::shared_ptr<KX_NavMeshTiles::Source> source = BuildTileSource();
+  if (!source) {
+    CM_Error("can't build navigation mesh data for object: " << m_name);
+    return 0;
+  }
+  m_tiles->SetSource(source);
+
+  float bmin[3], bmax[3];
+  GetLocalBox(corner1, corner2, bmin, bmax);
+  return m_tiles->RequestTiles(bmin, bmax);
+}
+
 void KX_NavMeshObject::DrawNavMesh(NavMeshRenderMode renderMode)
 {
+  MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
+
+  if (m_tiles) {
+    UpdateTiles();
+
+    const auto drawLine = [this, &color](const float *a, const float *b) {
+      const MT_Vector3 va = TransformToWorldCoords(MT_Vector3(a[0], a[2], a[1]));
+      const MT_Vector3 vb = TransformToWorldCoords(MT_Vector3(b[0], b[2], b[1]));
+      KX_RasterizerDrawDebugLine(va, vb, color);
+    };
+
+    const dtTiledNavMesh *navMesh = m_tiles->GetNavMesh();
+    for (int ti = 0; ti < DT_MAX_TILES; ++ti) {
+      const dtTileHeader *header = navMesh->getTile(ti)->header;
+      if (!header) {
+        continue;
+      }
+
+      for (int pi = 0; pi < header->npolys; ++pi) {
+        const dtTilePoly *poly = &header->polys[pi];
+        if (renderMode == RM_TRIS) {
+          const dtTilePolyDetail *pd = &header->dmeshes[pi];
+          for (int j = 0; j < pd->ntris; ++j) {
+            const unsigned char *t = &header->dtris[(pd->tbase + j) * 4];
+            const float *v[3];
+            for (int k = 0; k < 3; ++k) {
+              if (t[k] < poly->nv)
+                v[k] = &header->verts[poly->v[t[k]] * 3];
+              else
+                v[k] = &header->dverts[(pd->vbase + (t[k] - poly->nv)) * 3];
+            }
+            for (int k = 0; k < 3; k++)
+              drawLine(v[k], v[(k + 1) % 3]);
+          }
+        }
+        else if (renderMode == RM_POLYS || renderMode == RM_WALLS) {
+          for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
+            if (renderMode == RM_WALLS && !KX_NavMeshTiles::IsWallEdge(header, poly, j))
+              continue;
+            drawLine(&header->verts[poly->v[j] * 3], &header->verts[poly->v[i] * 3]);
+          }
+        }
+      }
+    }
+    return;
+  }
+
   if (!m_navMesh)
     return;
-  MT_Vector4 color(0.0f, 0.0f, 0.0f, 1.0f);
 
   switch (renderMode) {
     case RM_POLYS:
@@ -1086,7 +1282,7 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
                                float *path,
                                int maxPathLen)
 {
-  if (!m_navMesh)
+  if (!m_navMesh && !m_tiles)
     return 0;
   MT_Vector3 localfrom = TransformToLocalCoords(from);
   MT_Vector3 localto = TransformToLocalCoords(to);
@@ -1095,33 +1291,97 @@ int KX_NavMeshObject::FindPath(const MT_Vector3 &from,
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
-  dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
-  dtStatPolyRef ePolyRef = m_navMesh->findNearestPoly(epos, polyPickExt);
 
   int pathLen = 0;
-  if (sPolyRef && ePolyRef) {
-    dtStatPolyRef *polys = new dtStatPolyRef[maxPathLen];
-    int npolys;
-    npolys = m_navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
-    if (npolys) {
-      pathLen = m_navMesh->findStraightPath(spos, epos, polys, npolys, path, maxPathLen);
-      for (int i = 0; i < pathLen; i++) {
-        flipAxes(&path[i * 3]);
-        MT_Vector3 waypoint(&path[i * 3]);
-        waypoint = TransformToWorldCoords(waypoint);
-        waypoint.getValue(&path[i * 3]);
+  if (m_tiles) {
+    UpdateTiles();
+    dtTiledNavMesh *navMesh = m_tiles->GetNavMesh();
+    dtTilePolyRef sPolyRef = navMesh->findNearestPoly(spos, polyPickExt);
+    dtTilePolyRef ePolyRef = navMesh->findNearestPoly(epos, polyPickExt);
+    if (sPolyRef && ePolyRef) {
+      dtTilePolyRef *polys = new dtTilePolyRef[maxPathLen];
+      int npolys = navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
+      if (npolys) {
+        pathLen = navMesh->findStraightPath(spos, epos, polys, npolys, path, maxPathLen);
+      }
+
+      delete[] polys;
+    }
+  }
+  else {
+    dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
+    dtStatPolyRef ePolyRef = m_navMesh->findNearestPoly(epos, polyPickExt);
+    if (sPolyRef && ePolyRef) {
+      dtStatPolyRef *polys = new dtStatPolyRef[maxPathLen];
+      int npolys;
+      npolys = m_navMesh->findPath(sPolyRef, ePolyRef, spos, epos, polys, maxPathLen);
+      if (npolys) {
+        pathLen = m_navMesh->findStraightPath(spos, epos, polys, npolys, path, maxPathLen);
       }
+
+      delete[] polys;
     }
+  }
 
-    delete[] polys;
+  for (int i = 0; i < pathLen; i++) {
+    flipAxes(&path[i * 3]);
+    MT_Vector3 waypoint(&path[i * 3]);
+    waypoint = TransformToWorldCoords(waypoint);
+    waypoint.getValue(&path[i * 3]);
   }
 
   return pathLen;
 }
 
+KX_NavMeshPathQueue *KX_NavMeshObject::GetPathQueue()
+{
+  if (!m_pathQueue) {
+    m_pathQueue = new KX_NavMeshPathQueue(polyPickExt);
+  }
+  return m_pathQueue;
+}
+
+KX_NavMeshPathQueue::RequestPtr KX_NavMeshObject::RequestPath(const MT_Vector3 &from,
+                                                              const MT_Vector3 &to,
+                                                              int maxPathLen)
+{
+  float spos[3], epos[3];
+  TransformToLocalCoords(from).getValue(spos);
+  flipAxes(spos);
+  TransformToLocalCoords(to).getValue(epos);
+  flipAxes(epos);
+
+  KX_NavMeshPathQueue::RequestPtr request = GetPathQueue()->AddRequest(spos, epos, maxPathLen);
+  GetScene()->AddPathQueryNavMesh(this);
+  return request;
+}
+
+bool KX_NavMeshObject::UpdatePathQueries()
+{
+  if (!m_pathQueue) {
+    return false;
+  }
+
+  UpdateTiles();
+
+  std::vector<KX_NavMeshPathQueue::RequestPtr> finished;
+  m_pathQueue->Update(m_navMesh, GetTiledNavMesh(), finished);
+
+  for (const KX_NavMeshPathQueue::RequestPtr &request : finished) {
+    std::vector<float> &path = request->path;
+    for (unsigned int i = 0, size = path.size(); i < size; i += 3) {
+      flipAxes(&path[i]);
+      MT_Vector3 waypoint(&path[i]);
+      TransformToWorldCoords(waypoint).getValue(&path[i]);
+    }
+  }
+
+  return (m_pathQueue->GetNumRequests() > 0);
+}
+
 float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
 {
-  if (!m_navMesh)
+  if (!m_navMesh && !m_tiles)
     return 0.f;
   MT_Vector3 localfrom = TransformToLocalCoords(from);
   MT_Vector3 localto = TransformToLocalCoords(to);
@@ -1130,6 +1390,19 @@ float KX_NavMeshObject::Raycast(const MT_Vector3 &from, const MT_Vector3 &to)
   flipAxes(spos);
   localto.getValue(epos);
   flipAxes(epos);
+
+  if (m_tiles) {
+    UpdateTiles();
+    dtTiledNavMesh *navMesh = m_tiles->GetNavMesh();
+    dtTilePolyRef sPolyRef = navMesh->findNearestPoly(spos, polyPickExt);
+    float t = 0;
+    if (sPolyRef) {
+      dtTilePolyRef polys[MAX_PATH_LEN];
+      navMesh->raycast(sPolyRef, spos, epos, t, polys, MAX_PATH_LEN);
+    }
+    return t;
+  }
+
   dtStatPolyRef sPolyRef = m_navMesh->findNearestPoly(spos, polyPickExt);
   float t = 0;
   static dtStatPolyRef polys[MAX_PATH_LEN];
@@ -1190,15 +1463,28 @@ PyTypeObject KX_NavMeshObject::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Nav
                                        py_base_new};
 
 PyAttributeDef KX_NavMeshObject::Attributes[] = {
+    KX_PYATTRIBUTE_RO_FUNCTION("tileSize", KX_NavMeshObject, pyattr_get_tile_size),
+    KX_PYATTRIBUTE_RO_FUNCTION("pendingTiles", KX_NavMeshObject, pyattr_get_pending_tiles),
+    KX_PYATTRIBUTE_RW_FUNCTION("pathQueryBudget",
+                               KX_NavMeshObject,
+                               pyattr_get_path_query_budget,
+                               pyattr_set_path_query_budget),
+    KX_PYATTRIBUTE_RO_FUNCTION("pendingPaths", KX_NavMeshObject, pyattr_get_pending_paths),
     KX_PYATTRIBUTE_NULL  // Sentinel
 };
 
 // KX_PYMETHODTABLE_NOARGS(KX_GameObject, getD),
 PyMethodDef KX_NavMeshObject::Methods[] = {
     KX_PYMETHODTABLE(KX_NavMeshObject, findPath),
+    KX_PYMETHODTABLE(KX_NavMeshObject, findPathAsync),
     KX_PYMETHODTABLE(KX_NavMeshObject, raycast),
     KX_PYMETHODTABLE(KX_NavMeshObject, draw),
     KX_PYMETHODTABLE(KX_NavMeshObject, rebuild),
+    KX_PYMETHODTABLE(KX_NavMeshObject, rebuildTiles),
+    KX_PYMETHODTABLE(KX_NavMeshObject, loadTile),
+    KX_PYMETHODTABLE(KX_NavMeshObject, unloadTile),
+    KX_PYMETHODTABLE(KX_NavMeshObject, isTileLoaded),
+    KX_PYMETHODTABLE(KX_NavMeshObject, getTileIndex),
     {nullptr, nullptr}  // Sentinel
 };
 
@@ -1225,6 +1511,22 @@ KX_PYMETHODDEF_DOC(KX_NavMeshObject,
   return pathList;
 }
 
+KX_PYMETHODDEF_DOC(KX_NavMeshObject,
+                   findPathAsync,
+                   "findPathAsync(start, goal): queue a path request from start to goal points "
+                   "searched during the next frames\n"
+                   "Returns a KX_NavMeshPathRequest\n")
+{
+  PyObject *ob_from, *ob_to;
+  if (!PyArg_ParseTuple(args, "OO:findPathAsync", &ob_from, &ob_to))
+    return nullptr;
+  MT_Vector3 from, to;
+  if (!PyVecTo(ob_from, from) || !PyVecTo(ob_to, to))
+    return nullptr;
+
+  return (new KX_NavMeshPathRequest(RequestPath(from, to, MAX_PATH_LEN)))->NewProxy(true);
+}
+
 KX_PYMETHODDEF_DOC(KX_NavMeshObject,
                    raycast,
                    "raycast(start, goal): raycast from start to goal points\n"
@@ -1259,4 +1561,154 @@ KX_PYMETHODDEF_DOC_NOARGS(KX_NavMeshObject, rebuild, "rebuild(): rebuild navigat
   Py_RETURN_NONE;
 }
 
+static bool checkTiledNavMesh(KX_NavMeshTiles *tiles, const char *method)
+{
+  if (!tiles) {
+    PyErr_Format(PyExc_RuntimeError,
+                 "%s, navigation mesh is not tiled, set the scene navigation mesh tile size",
+                 method);
+    return false;
+  }
+  return true;
+}
+
+KX_PYMETHODDEF_DOC(KX_NavMeshObject,
+                   rebuildTiles,
+                   "rebuildTiles(corner1, corner2): rebuild asynchronously the tiles overlapping "
+                   "a box from the current mesh\n"
+                   "Returns the number of tiles scheduled\n")
+{
+  PyObject *ob_corner1, *ob_corner2;
+  if (!PyArg_ParseTuple(args, "OO:rebuildTiles", &ob_corner1, &ob_corner2))
+    return nullptr;
+  MT_Vector3 corner1, corner2;
+  if (!PyVecTo(ob_corner1, corner1) || !PyVecTo(ob_corner2, corner2))
+    return nullptr;
+  if (!checkTiledNavMesh(m_tiles, "navmesh.rebuildTiles(corner1, corner2)"))
+    return nullptr;
+
+  return PyLong_FromLong(RebuildTiles(corner1, corner2));
+}
+
+KX_PYMETHODDEF_DOC(KX_NavMeshObject,
+                   loadTile,
+                   "loadTile(x, y): build asynchronously a tile from the current mesh and add "
+                   "it to the navigation mesh\n")
+{
+  int x, y;
+  if (!PyArg_ParseTuple(args, "ii:loadTile", &x, &y))
+    return nullptr;
+  if (!checkTiledNavMesh(m_tiles, "navmesh.loadTile(x, y)"))
+    return nullptr;
+
+  m_tiles->RequestTile(x, y);
+  Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC(KX_NavMeshObject,
+                   unloadTile,
+                   "unloadTile(x, y): remove a tile from the navigation mesh\n"
+                   "Returns True if the tile was loaded\n")
+{
+  int x, y;
+  if (!PyArg_ParseTuple(args, "ii:unloadTile", &x, &y))
+    return nullptr;
+  if (!checkTiledNavMesh(m_tiles, "navmesh.unloadTile(x, y)"))
+    return nullptr;
+
+  const bool removed = m_tiles->RemoveTile(x, y);
+  if (removed) {
+    TilesChanged();
+  }
+  return PyBool_FromLong(removed);
+}
+
+KX_PYMETHODDEF_DOC(KX_NavMeshObject,
+                   isTileLoaded,
+                   "isTileLoaded(x, y): return True if a tile is in the navigation mesh\n")
+{
+  int x, y;
+  if (!PyArg_ParseTuple(args, "ii:isTileLoaded", &x, &y))
+    return nullptr;
+  if (!checkTiledNavMesh(m_tiles, "navmesh.isTileLoaded(x, y)"))
+    return nullptr;
+
+  UpdateTiles();
+  return PyBool_FromLong(m_tiles->IsTileLoaded(x, y));
+}
+
+KX_PYMETHODDEF_DOC(KX_NavMeshObject,
+                   getTileIndex,
+                   "getTileIndex(position): return the index (x, y) of the tile containing a "
+                   "point\n")
+{
+  PyObject *ob_pos;
+  if (!PyArg_ParseTuple(args, "O:getTileIndex", &ob_pos))
+    return nullptr;
+  MT_Vector3 pos;
+  if (!PyVecTo(ob_pos, pos))
+    return nullptr;
+  if (!checkTiledNavMesh(m_tiles, "navmesh.getTileIndex(position)"))
+    return nullptr;
+
+  float lpos[3];
+  TransformToLocalCoords(pos).getValue(lpos);
+  flipAxes(lpos);
+  int x, y;
+  m_tiles->GetTileIndex(lpos, x, y);
+  return Py_BuildValue("(ii)", x, y);
+}
+
+PyObject *KX_NavMeshObject::pyattr_get_tile_size(PyObjectPlus *self_v,
+                                                 const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyFloat_FromDouble(self->m_tiles ? self->m_tiles->GetTileSize() : 0.0f);
+}
+
+PyObject *KX_NavMeshObject::pyattr_get_pending_tiles(PyObjectPlus *self_v,
+                                                     const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  if (!self->m_tiles) {
+    return PyLong_FromLong(0);
+  }
+
+  self->UpdateTiles();
+  return PyLong_FromLong(self->m_tiles->GetNumPendingTiles());
+}
+
+PyObject *KX_NavMeshObject::pyattr_get_path_query_budget(PyObjectPlus *self_v,
+                                                         const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyLong_FromLong(self->GetPathQueue()->GetBudget());
+}
+
+int KX_NavMeshObject::pyattr_set_path_query_budget(PyObjectPlus *self_v,
+                                                   const KX_PYATTRIBUTE_DEF *attrdef,
+                                                   PyObject *value)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  const int budget = PyLong_AsLong(value);
+  if (budget == -1 && PyErr_Occurred()) {
+    PyErr_SetString(PyExc_TypeError, "navmesh.pathQueryBudget = int: expected an integer");
+    return PY_SET_ATTR_FAIL;
+  }
+  if (budget < 1) {
+    PyErr_SetString(PyExc_ValueError, "navmesh.pathQueryBudget = int: expected a value above 0");
+    return PY_SET_ATTR_FAIL;
+  }
+
+  self->GetPathQueue()->SetBudget(budget);
+  return PY_SET_ATTR_SUCCESS;
+}
+
+PyObject *KX_NavMeshObject::pyattr_get_pending_paths(PyObjectPlus *self_v,
+                                                     const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshObject *self = static_cast<KX_NavMeshObject *>(self_v);
+  return PyLong_FromLong(self->m_pathQueue ? self->m_pathQueue->GetNumRequests() : 0);
+}
+
 #endif  // WITH_PYTHON
@@ -27,11 +27,14 @@
 #ifndef __KX_NAVMESHOBJECT_H__
 #define __KX_NAVMESHOBJECT_H__
 
+#include <memory>
 #include <vector>
 
 #include "DetourStatNavMesh.h"
 #include "EXP_PyObjectPlus.h"
 #include "KX_GameObject.h"
+#include "KX_NavMeshPathQueue.h"
+#include "KX_NavMeshTiles.h"
 
 class RAS_MeshObject;
 class MT_Transform;
@@ -52,6 +55,26 @@ class KX_NavMeshObject : public KX_GameObject {
                           int &ndtris,
                           int &vertsPerPoly);
 
+  /// Tiled navigation mesh used instead of m_navMesh when the scene recast tile size is set.
+  KX_NavMeshTiles *m_tiles;
+
+  /// Return the polygons of the current mesh in recast coordinates, null on failure.
+  std::shared_ptr<KX_NavMeshTiles::Source> BuildTileSource();
+  bool BuildTiledNavMesh();
+  /// Asynchronous path requests, created by the first request.
+  KX_NavMeshPathQueue *m_pathQueue;
+
+  /** Replace the obstacles of the navigation mesh walls and restart the path searches after a
+   * tile change.
+   */
+  void TilesChanged();
+  KX_NavMeshPathQueue *GetPathQueue();
+  /// Return the bounds in recast coordinates of a box in world coordinates.
+  void GetLocalBox(const MT_Vector3 &corner1,
+                   const MT_Vector3 &corner2,
+                   float bmin[3],
+                   float bmax[3]);
+
  public:
   KX_NavMeshObject(void *sgReplicationInfo, SG_Callbacks callbacks);
   ~KX_NavMeshObject();
@@ -61,7 +84,26 @@ class KX_NavMeshObject : public KX_GameObject {
 
   bool BuildNavMesh();
   dtStatNavMesh *GetNavMesh();
+  /// Return the tiled navigation mesh, null if the navigation mesh is not tiled.
+  dtTiledNavMesh *GetTiledNavMesh();
+  KX_NavMeshTiles *GetTiles();
+
+  /// Add the tiles built since the last call to the navigation mesh.
+  void UpdateTiles();
+  /** Asynchronously rebuild the tiles overlapping a box in world coordinates from the current
+   * mesh, return the number of tiles scheduled.
+   */
+  unsigned int RebuildTiles(const MT_Vector3 &corner1, const MT_Vector3 &corner2);
+
   int FindPath(const MT_Vector3 &from, const MT_Vector3 &to, float *path, int maxPathLen);
+  /** Queue a path request searched by the next updates of the path queries, the request
+   * path is in world coordinates once its status isn't pending.
+   */
+  KX_NavMeshPathQueue::RequestPtr RequestPath(const MT_Vector3 &from,
+                                              const MT_Vector3 &to,
+                                              int maxPathLen);
+  /// Advance the path requests, return true if requests remain.
+  bool UpdatePathQueries();
   float Raycast(const MT_Vector3 &from, const MT_Vector3 &to);
 
   enum NavMeshRenderMode { RM_WALLS, RM_POLYS, RM_TRIS, RM_MAX };
@@ -76,9 +118,26 @@ class KX_NavMeshObject : public KX_GameObject {
   /* --------------------------------------------------------------------- */
 
   KX_PYMETHOD_DOC(KX_NavMeshObject, findPath);
+  KX_PYMETHOD_DOC(KX_NavMeshObject, findPathAsync);
   KX_PYMETHOD_DOC(KX_NavMeshObject, raycast);
   KX_PYMETHOD_DOC(KX_NavMeshObject, draw);
   KX_PYMETHOD_DOC_NOARGS(KX_NavMeshObject, rebuild);
+  KX_PYMETHOD_DOC(KX_NavMeshObject, rebuildTiles);
+  KX_PYMETHOD_DOC(KX_NavMeshObject, loadTile);
+  KX_PYMETHOD_DOC(KX_NavMeshObject, unloadTile);
+  KX_PYMETHOD_DOC(KX_NavMeshObject, isTileLoaded);
+  KX_PYMETHOD_DOC(KX_NavMeshObject, getTileIndex);
+
+  static PyObject *pyattr_get_tile_size(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_pending_tiles(PyObjectPlus *self_v,
+                                            const KX_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_path_query_budget(PyObjectPlus *self_v,
+                                                const KX_PYATTRIBUTE_DEF *attrdef);
+  static int pyattr_set_path_query_budget(PyObjectPlus *self_v,
+                                          const KX_PYATTRIBUTE_DEF *attrdef,
+                                          PyObject *value);
+  static PyObject *pyattr_get_pending_paths(PyObjectPlus *self_v,
+                                            const KX_PYATTRIBUTE_DEF *attrdef);
 #endif /* WITH_PYTHON */
 };
 
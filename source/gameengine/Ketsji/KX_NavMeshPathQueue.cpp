@@ -0,0 +1,465 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_NavMeshPathQueue.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_NavMeshPathQueue.h"
+
+#include <algorithm>
+
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "DetourNode.h"
+#include "DetourStatNavMesh.h"
+#include "DetourTileNavMesh.h"
+
+// Same node pool and heuristic as the detour path finding.
+#define SEARCH_MAX_NODES 2048
+#define SEARCH_NODES_HASH_SIZE 256
+#define SEARCH_HEURISTIC_SCALE 1.1f
+#define SEARCH_MAX_NEIGHBOURS 32
+
+#define MIN_SEARCHES 4
+#define MAX_SEARCHES 8
+#define DEFAULT_BUDGET 4096
+
+KX_NavMeshPathQueue::Request::Request(const float start[3], const float end[3], int maxPathLen)
+    : status(REQUEST_PENDING), maxPathLen(maxPathLen)
+{
+  copy_v3_v3(this->start, start);
+  copy_v3_v3(this->end, end);
+}
+
+KX_NavMeshPathQueue::KX_NavMeshPathQueue(const float pickExtents[3])
+    : m_statNavMesh(nullptr), m_tiledNavMesh(nullptr), m_budget(DEFAULT_BUDGET)
+{
+  copy_v3_v3(m_pickExtents, pickExtents);
+
+  const int numSearches = std::min(std::max(BLI_system_thread_count(), MIN_SEARCHES),
+                                   MAX_SEARCHES);
+  m_searches.resize(numSearches);
+  for (Search &search : m_searches) {
+    search.state = SEARCH_START;
+    search.succeeded = false;
+    search.startRef = 0;
+    search.endRef = 0;
+    search.nodePool = nullptr;
+    search.openList = nullptr;
+    search.lastBestNode = nullptr;
+    search.lastBestNodeCost = 0.0f;
+    search.budget = 0;
+    search.iterations = 0;
+  }
+}
+
+KX_NavMeshPathQueue::~KX_NavMeshPathQueue()
+{
+  // Requests still referenced by their users will never be searched.
+  for (Search &search : m_searches) {
+    if (search.request) {
+      search.request->status = REQUEST_FAILED;
+    }
+    delete search.nodePool;
+    delete search.openList;
+  }
+  for (const RequestPtr &request : m_requests) {
+    request->status = REQUEST_FAILED;
+  }
+}
+
+bool KX_NavMeshPathQueue::IsAbandoned(const RequestPtr &request)
+{
+  return (request.use_count() == 1 || request->status == REQUEST_CANCELLED);
+}
+
+int KX_NavMeshPathQueue::GetNeighbours(unsigned int ref,
+                                       unsigned int *neighbours,
+                                       float *mids) const
+{
+  int count = 0;
+
+  if (m_tiledNavMesh) {
+    const dtTilePoly *poly = m_tiledNavMesh->getPolyByRef(ref);
+    if (!poly) {
+      return -1;
+    }
+    const float *verts = m_tiledNavMesh->getPolyVertsByRef(ref);
+    const dtTileLink *links = m_tiledNavMesh->getPolyLinksByRef(ref);
+
+    for (int i = 0; i < poly->nlinks && count < SEARCH_MAX_NEIGHBOURS; ++i) {
+      const dtTileLink &link = links[poly->links + i];
+      if (!link.ref) {
+        continue;
+      }
+
+      float left[3], right[3];
+      copy_v3_v3(left, &verts[poly->v[link.e] * 3]);
+      copy_v3_v3(right, &verts[poly->v[(link.e + 1) % poly->nv] * 3]);
+      // Links at a tile border only cover a part of the edge.
+      if (link.side != 0xff) {
+        const int axis = (link.side == 0 || link.side == 2) ? 2 : 0;
+        const float smin = std::min(left[axis], right[axis]);
+        const float smax = std::max(left[axis], right[axis]);
+        const float s = (smax - smin) / 255.0f;
+        const float lmin = smin + link.bmin * s;
+        const float lmax = smin + link.bmax * s;
+        CLAMP(left[axis], lmin, lmax);
+        CLAMP(right[axis], lmin, lmax);
+      }
+
+      neighbours[count] = link.ref;
+      mid_v3_v3v3(&mids[count * 3], left, right);
+      ++count;
+    }
+  }
+  else {
+    const dtStatPoly *poly = m_statNavMesh->getPolyByRef((dtStatPolyRef)ref);
+    if (!poly) {
+      return -1;
+    }
+
+    for (int i = 0; i < poly->nv; ++i) {
+      if (!poly->n[i]) {
+        continue;
+      }
+
+      neighbours[count] = poly->n[i];
+      mid_v3_v3v3(&mids[count * 3],
+                  m_statNavMesh->getVertex(poly->v[i]),
+                  m_statNavMesh->getVertex(poly->v[(i + 1) % poly->nv]));
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+void KX_NavMeshPathQueue::StartSearch(Search &search)
+{
+  Request *request = search.request.get();
+
+  search.succeeded = false;
+  search.lastBestNode = nullptr;
+  search.polys.clear();
+
+  if (m_tiledNavMesh) {
+    search.startRef = m_tiledNavMesh->findNearestPoly(request->start, m_pickExtents);
+    search.endRef = m_tiledNavMesh->findNearestPoly(request->end, m_pickExtents);
+  }
+  else {
+    search.startRef = m_statNavMesh->findNearestPoly(request->start, m_pickExtents);
+    search.endRef = m_statNavMesh->findNearestPoly(request->end, m_pickExtents);
+  }
+
+  if (!search.startRef || !search.endRef) {
+    search.state = SEARCH_END;
+    return;
+  }
+
+  if (search.startRef == search.endRef) {
+    search.polys.push_back(search.startRef);
+    search.state = SEARCH_END;
+    return;
+  }
+
+  if (!search.nodePool) {
+    search.nodePool = new dtNodePool(SEARCH_MAX_NODES, SEARCH_NODES_HASH_SIZE);
+    search.openList = new dtNodeQueue(SEARCH_MAX_NODES);
+  }
+  search.nodePool->clear();
+  search.openList->clear();
+
+  dtNode *startNode = search.nodePool->getNode(search.startRef);
+  startNode->pidx = 0;
+  startNode->cost = 0.0f;
+  startNode->total = len_v3v3(request->start, request->end) * SEARCH_HEURISTIC_SCALE;
+  startNode->flags = DT_NODE_OPEN;
+  search.openList->push(startNode);
+
+  search.lastBestNode = startNode;
+  search.lastBestNodeCost = startNode->total;
+  search.state = SEARCH_RUNNING;
+}
+
+void KX_NavMeshPathQueue::ExpandSearch(Search &search)
+{
+  if (search.openList->empty()) {
+    search.state = SEARCH_END;
+    return;
+  }
+
+  const Request *request = search.request.get();
+  dtNodePool *nodePool = search.nodePool;
+
+  dtNode *bestNode = search.openList->pop();
+  bestNode->flags &= ~DT_NODE_OPEN;
+  bestNode->flags |= DT_NODE_CLOSED;
+
+  if (bestNode->id == search.endRef) {
+    search.lastBestNode = bestNode;
+    search.state = SEARCH_END;
+    return;
+  }
+
+  unsigned int neighbours[SEARCH_MAX_NEIGHBOURS];
+  float mids[SEARCH_MAX_NEIGHBOURS * 3];
+  const int numNeighbours = GetNeighbours(bestNode->id, neighbours, mids);
+  if (numNeighbours == -1) {
+    // The navigation mesh changed without restarting the search.
+    search.state = SEARCH_END;
+    return;
+  }
+
+  const dtNode *parentNode = nodePool->getNodeAtIdx(bestNode->pidx);
+  const unsigned int parentRef = parentNode ? parentNode->id : 0;
+
+  // The cost is computed between the middles of the crossed edges.
+  const float *p0 = request->start;
+  for (int i = 0; i < numNeighbours; ++i) {
+    if (neighbours[i] == parentRef) {
+      p0 = &mids[i * 3];
+      break;
+    }
+  }
+
+  const unsigned int bestNodeIdx = nodePool->getNodeIdx(bestNode);
+  for (int i = 0; i < numNeighbours; ++i) {
+    const unsigned int neighbour = neighbours[i];
+    if (neighbour == parentRef) {
+      continue;
+    }
+
+    const float *p1 = &mids[i * 3];
+    float cost = bestNode->cost + len_v3v3(p0, p1);
+    if (neighbour == search.endRef) {
+      cost += len_v3v3(p1, request->end);
+    }
+    const float heuristic = len_v3v3(p1, request->end) * SEARCH_HEURISTIC_SCALE;
+    const float total = cost + heuristic;
+
+    dtNode *node = nodePool->getNode(neighbour);
+    // The node pool is full, the path ends at the closest node found.
+    if (!node) {
+      continue;
+    }
+
+    if (node->flags != 0 && total > node->total) {
+      continue;
+    }
+
+    node->pidx = bestNodeIdx;
+    node->cost = cost;
+    node->total = total;
+    node->flags &= ~DT_NODE_CLOSED;
+
+    if (heuristic < search.lastBestNodeCost) {
+      search.lastBestNodeCost = heuristic;
+      search.lastBestNode = node;
+    }
+
+    if (node->flags & DT_NODE_OPEN) {
+      search.openList->modify(node);
+    }
+    else {
+      node->flags |= DT_NODE_OPEN;
+      search.openList->push(node);
+    }
+  }
+}
+
+void KX_NavMeshPathQueue::FinishSearch(Search &search)
+{
+  Request *request = search.request.get();
+
+  // Collect the polygons from the start, the path stops at the closest node to the goal.
+  if (search.lastBestNode) {
+    dtNodePool *nodePool = search.nodePool;
+    for (dtNode *node = search.lastBestNode; node; node = nodePool->getNodeAtIdx(node->pidx)) {
+      search.polys.push_back(node->id);
+    }
+    std::reverse(search.polys.begin(), search.polys.end());
+  }
+
+  const int npolys = std::min((int)search.polys.size(), request->maxPathLen);
+  if (npolys == 0) {
+    return;
+  }
+
+  request->path.resize(request->maxPathLen * 3);
+  int pathLen;
+  if (m_tiledNavMesh) {
+    pathLen = m_tiledNavMesh->findStraightPath(request->start,
+                                               request->end,
+                                               search.polys.data(),
+                                               npolys,
+                                               request->path.data(),
+                                               request->maxPathLen);
+  }
+  else {
+    std::vector<dtStatPolyRef> polys(search.polys.begin(), search.polys.begin() + npolys);
+    pathLen = m_statNavMesh->findStraightPath(request->start,
+                                              request->end,
+                                              polys.data(),
+                                              npolys,
+                                              request->path.data(),
+                                              request->maxPathLen);
+  }
+  request->path.resize(pathLen * 3);
+  search.succeeded = (pathLen > 0);
+}
+
+void KX_NavMeshPathQueue::RunSearch(Search &search)
+{
+  // Looking for the start and goal polygons costs one expansion.
+  if (search.state == SEARCH_START) {
+    StartSearch(search);
+    ++search.iterations;
+  }
+
+  while (search.state == SEARCH_RUNNING && search.iterations < search.budget) {
+    ExpandSearch(search);
+    ++search.iterations;
+  }
+
+  if (search.state == SEARCH_END) {
+    FinishSearch(search);
+  }
+}
+
+void KX_NavMeshPathQueue::RunSearchTask(void *__restrict userdata,
+                                        const int iter,
+                                        const TaskParallelTLS *__restrict /*tls*/)
+{
+  KX_NavMeshPathQueue *queue = (KX_NavMeshPathQueue *)userdata;
+  queue->RunSearch(*queue->m_activeSearches[iter]);
+}
+
+void KX_NavMeshPathQueue::Restart()
+{
+  // Put back the searched requests in front of the queue keeping their order.
+  for (auto it = m_searches.rbegin(); it != m_searches.rend(); ++it) {
+    if (it->request) {
+      m_requests.push_front(it->request);
+      it->request.reset();
+    }
+  }
+}
+
+KX_NavMeshPathQueue::RequestPtr KX_NavMeshPathQueue::AddRequest(const float start[3],
+                                                                const float end[3],
+                                                                int maxPathLen)
+{
+  RequestPtr request = std::make_shared<Request>(start, end, maxPathLen);
+  m_requests.push_back(request);
+  return request;
+}
+
+unsigned int KX_NavMeshPathQueue::GetNumRequests() const
+{
+  unsigned int numRequests = m_requests.size();
+  for (const Search &search : m_searches) {
+    if (search.request) {
+      ++numRequests;
+    }
+  }
+  return numRequests;
+}
+
+int KX_NavMeshPathQueue::GetBudget() const
+{
+  return m_budget;
+}
+
+void KX_NavMeshPathQueue::SetBudget(int budget)
+{
+  m_budget = std::max(budget, 1);
+}
+
+void KX_NavMeshPathQueue::Update(dtStatNavMesh *statNavMesh,
+                                 dtTiledNavMesh *tiledNavMesh,
+                                 std::vector<RequestPtr> &finished)
+{
+  m_statNavMesh = statNavMesh;
+  m_tiledNavMesh = tiledNavMesh;
+
+  if (!m_statNavMesh && !m_tiledNavMesh) {
+    Restart();
+    for (const RequestPtr &request : m_requests) {
+      request->status = REQUEST_FAILED;
+      finished.push_back(request);
+    }
+    m_requests.clear();
+    return;
+  }
+
+  int budget = m_budget;
+  // Searches finishing early leave their budget to the next requests.
+  while (budget > 0) {
+    m_activeSearches.clear();
+    for (Search &search : m_searches) {
+      if (search.request && IsAbandoned(search.request)) {
+        search.request.reset();
+      }
+
+      while (!search.request && !m_requests.empty()) {
+        RequestPtr request = m_requests.front();
+        m_requests.pop_front();
+        if (!IsAbandoned(request)) {
+          search.request = request;
+          search.state = SEARCH_START;
+        }
+      }
+
+      if (search.request) {
+        m_activeSearches.push_back(&search);
+      }
+    }
+
+    const int numSearches = m_activeSearches.size();
+    if (numSearches == 0) {
+      break;
+    }
+
+    const int searchBudget = std::max(budget / numSearches, 1);
+    for (Search *search : m_activeSearches) {
+      search->budget = searchBudget;
+      search->iterations = 0;
+    }
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (numSearches > 1);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, numSearches, this, RunSearchTask, &settings);
+
+    for (Search *search : m_activeSearches) {
+      budget -= search->iterations;
+      if (search->state == SEARCH_END) {
+        search->request->status = search->succeeded ? REQUEST_DONE : REQUEST_FAILED;
+        finished.push_back(search->request);
+        search->request.reset();
+      }
+    }
+  }
+}
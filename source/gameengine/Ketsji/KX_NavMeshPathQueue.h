@@ -0,0 +1,139 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_NavMeshPathQueue.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_NAVMESHPATHQUEUE_H__
+#define __KX_NAVMESHPATHQUEUE_H__
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+class dtStatNavMesh;
+class dtTiledNavMesh;
+class dtNodePool;
+class dtNodeQueue;
+struct dtNode;
+struct TaskParallelTLS;
+
+/** Queue of the asynchronous path requests of a navigation mesh.
+ * Each update runs a fixed number of A* node expansions shared between a few concurrent searches,
+ * the searches are run in parallel and own their node pool and open list. A search can last
+ * several updates, its result is delivered by the update finishing it.
+ */
+class KX_NavMeshPathQueue {
+ public:
+  enum RequestStatus { REQUEST_PENDING = 0, REQUEST_DONE, REQUEST_FAILED, REQUEST_CANCELLED };
+
+  /// Path request shared by the queue and its users, dropped when only the queue references it.
+  struct Request {
+    RequestStatus status;
+    /// Start and goal in recast coordinates.
+    float start[3];
+    float end[3];
+    int maxPathLen;
+    /** Straight path points, in recast coordinates when set by the queue, in world coordinates
+     * once the navigation mesh object delivered the request.
+     */
+    std::vector<float> path;
+
+    Request(const float start[3], const float end[3], int maxPathLen);
+  };
+
+  using RequestPtr = std::shared_ptr<Request>;
+
+ private:
+  enum SearchState { SEARCH_START = 0, SEARCH_RUNNING, SEARCH_END };
+
+  struct Search {
+    RequestPtr request;
+    SearchState state;
+    bool succeeded;
+    unsigned int startRef;
+    unsigned int endRef;
+    dtNodePool *nodePool;
+    dtNodeQueue *openList;
+    dtNode *lastBestNode;
+    float lastBestNodeCost;
+    /// Maximum and used number of node expansions in the current update.
+    int budget;
+    int iterations;
+    /// Polygon path reused between the searches.
+    std::vector<unsigned int> polys;
+  };
+
+  /// Navigation mesh searched by the current update.
+  dtStatNavMesh *m_statNavMesh;
+  dtTiledNavMesh *m_tiledNavMesh;
+  float m_pickExtents[3];
+
+  /// Requests waiting for a free search.
+  std::deque<RequestPtr> m_requests;
+  /// Concurrent searches, the node pools are allocated on first use.
+  std::vector<Search> m_searches;
+  /// Searches run by the current update.
+  std::vector<Search *> m_activeSearches;
+  /// Number of node expansions per update.
+  int m_budget;
+
+  static bool IsAbandoned(const RequestPtr &request);
+
+  /** Fill the polygons connected to a polygon and the middle of the shared edges.
+   * \return The number of neighbours or -1 if the polygon reference is invalid.
+   */
+  int GetNeighbours(unsigned int ref, unsigned int *neighbours, float *mids) const;
+
+  void StartSearch(Search &search);
+  void ExpandSearch(Search &search);
+  void FinishSearch(Search &search);
+  /// Run a search until it finishes or exceeds its budget, thread safe for distinct searches.
+  void RunSearch(Search &search);
+
+  static void RunSearchTask(void *__restrict userdata,
+                            const int iter,
+                            const TaskParallelTLS *__restrict tls);
+
+ public:
+  KX_NavMeshPathQueue(const float pickExtents[3]);
+  ~KX_NavMeshPathQueue();
+
+  /// Restart the running searches after a modification of the navigation mesh.
+  void Restart();
+
+  RequestPtr AddRequest(const float start[3], const float end[3], int maxPathLen);
+  /// Number of requests waiting or being searched.
+  unsigned int GetNumRequests() const;
+
+  int GetBudget() const;
+  void SetBudget(int budget);
+
+  /** Advance the searches by the node expansions budget.
+   * \param statNavMesh The navigation mesh to search, used when tiledNavMesh is null.
+   * \param finished Receives the requests finished by this update, their status is set.
+   */
+  void Update(dtStatNavMesh *statNavMesh,
+              dtTiledNavMesh *tiledNavMesh,
+              std::vector<RequestPtr> &finished);
+};
+
+#endif  // __KX_NAVMESHPATHQUEUE_H__
@@ -0,0 +1,135 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_NavMeshPathRequest.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_NavMeshPathRequest.h"
+
+#include "KX_PyMath.h"
+
+KX_NavMeshPathRequest::KX_NavMeshPathRequest(KX_NavMeshPathQueue::RequestPtr request)
+    : m_request(request)
+{
+}
+
+KX_NavMeshPathRequest::~KX_NavMeshPathRequest()
+{
+}
+
+#ifdef WITH_PYTHON
+
+PyTypeObject KX_NavMeshPathRequest::Type = {
+    PyVarObject_HEAD_INIT(nullptr, 0) "KX_NavMeshPathRequest",
+    sizeof(PyObjectPlus_Proxy),
+    0,
+    py_base_dealloc,
+    0,
+    0,
+    0,
+    0,
+    py_base_repr,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    Methods,
+    0,
+    0,
+    &PyObjectPlus::Type,
+    0,
+    0,
+    0,
+    0,
+    0,
+    0,
+    py_base_new};
+
+PyMethodDef KX_NavMeshPathRequest::Methods[] = {
+    KX_PYMETHODTABLE_NOARGS(KX_NavMeshPathRequest, cancel),
+    {nullptr, nullptr}  // Sentinel
+};
+
+PyAttributeDef KX_NavMeshPathRequest::Attributes[] = {
+    KX_PYATTRIBUTE_RO_FUNCTION("finished", KX_NavMeshPathRequest, pyattr_get_finished),
+    KX_PYATTRIBUTE_RO_FUNCTION("found", KX_NavMeshPathRequest, pyattr_get_found),
+    KX_PYATTRIBUTE_RO_FUNCTION("path", KX_NavMeshPathRequest, pyattr_get_path),
+    KX_PYATTRIBUTE_NULL  // Sentinel
+};
+
+KX_PYMETHODDEF_DOC_NOARGS(KX_NavMeshPathRequest,
+                          cancel,
+                          "cancel(): stop searching the path if the request is not finished\n")
+{
+  if (m_request->status == KX_NavMeshPathQueue::REQUEST_PENDING) {
+    m_request->status = KX_NavMeshPathQueue::REQUEST_CANCELLED;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *KX_NavMeshPathRequest::pyattr_get_finished(PyObjectPlus *self_v,
+                                                     const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshPathRequest *self = static_cast<KX_NavMeshPathRequest *>(self_v);
+  return PyBool_FromLong(self->m_request->status != KX_NavMeshPathQueue::REQUEST_PENDING);
+}
+
+PyObject *KX_NavMeshPathRequest::pyattr_get_found(PyObjectPlus *self_v,
+                                                  const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshPathRequest *self = static_cast<KX_NavMeshPathRequest *>(self_v);
+  return PyBool_FromLong(self->m_request->status == KX_NavMeshPathQueue::REQUEST_DONE);
+}
+
+PyObject *KX_NavMeshPathRequest::pyattr_get_path(PyObjectPlus *self_v,
+                                                 const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_NavMeshPathRequest *self = static_cast<KX_NavMeshPathRequest *>(self_v);
+  const KX_NavMeshPathQueue::Request &request = *self->m_request;
+
+  // The path is in recast coordinates until the request is delivered.
+  if (request.status != KX_NavMeshPathQueue::REQUEST_DONE) {
+    return PyList_New(0);
+  }
+
+  const int pathLen = request.path.size() / 3;
+  PyObject *pathList = PyList_New(pathLen);
+  for (int i = 0; i < pathLen; ++i) {
+    PyList_SET_ITEM(pathList, i, PyObjectFrom(MT_Vector3(&request.path[i * 3])));
+  }
+
+  return pathList;
+}
+
+#endif  // WITH_PYTHON
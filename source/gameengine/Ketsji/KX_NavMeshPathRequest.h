@@ -0,0 +1,50 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_NavMeshPathRequest.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_NAVMESHPATHREQUEST_H__
+#define __KX_NAVMESHPATHREQUEST_H__
+
+#include "EXP_PyObjectPlus.h"
+#include "KX_NavMeshPathQueue.h"
+
+/// Python handle of an asynchronous navigation mesh path request.
+class KX_NavMeshPathRequest : public PyObjectPlus {
+  Py_Header
+
+      private : KX_NavMeshPathQueue::RequestPtr m_request;
+
+ public:
+  KX_NavMeshPathRequest(KX_NavMeshPathQueue::RequestPtr request);
+  virtual ~KX_NavMeshPathRequest();
+
+#ifdef WITH_PYTHON
+  KX_PYMETHOD_DOC_NOARGS(KX_NavMeshPathRequest, cancel);
+
+  static PyObject *pyattr_get_finished(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_found(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+  static PyObject *pyattr_get_path(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+#endif
+};
+
+#endif  // __KX_NAVMESHPATHREQUEST_H__
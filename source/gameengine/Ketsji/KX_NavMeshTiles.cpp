@@ -0,0 +1,543 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_NavMeshTiles.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_NavMeshTiles.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <stdint.h>
+#include <string.h>
+#include <unordered_map>
+
+#include "BLI_math.h"
+#include "BLI_task.h"
+
+#include "CM_Message.h"
+#include "DetourTileNavMesh.h"
+#include "DetourTileNavMeshBuilder.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
+#include "Recast.h"
+
+/// Maximum number of vertices of a source polygon clipped by a tile.
+#define MAX_CLIP_VERTS 32
+
+struct KX_NavMeshTiles::TileTask {
+  std::shared_ptr<const Source> source;
+  int x;
+  int y;
+  unsigned int request;
+};
+
+KX_NavMeshTiles::Source::Source(
+    const float *verts, int nverts, const unsigned short *polygons, int npolys, int nvp)
+    : vertices(verts, verts + nverts * 3),
+      polys(npolys * nvp),
+      polyBounds(npolys * 4),
+      vertsPerPoly(nvp)
+{
+  for (unsigned short axis = 0; axis < 3; ++axis) {
+    bmin[axis] = FLT_MAX;
+    bmax[axis] = -FLT_MAX;
+  }
+
+  for (int i = 0; i < npolys; ++i) {
+    // The source polygons contain the adjacency after the vertex indices, it is not kept.
+    const unsigned short *poly = &polygons[i * nvp * 2];
+    float *bounds = &polyBounds[i * 4];
+    bounds[0] = bounds[1] = FLT_MAX;
+    bounds[2] = bounds[3] = -FLT_MAX;
+
+    for (int j = 0; j < nvp; ++j) {
+      polys[i * nvp + j] = poly[j];
+      if (poly[j] == 0xffff) {
+        continue;
+      }
+
+      const float *v = &verts[poly[j] * 3];
+      bounds[0] = std::min(bounds[0], v[0]);
+      bounds[1] = std::min(bounds[1], v[2]);
+      bounds[2] = std::max(bounds[2], v[0]);
+      bounds[3] = std::max(bounds[3], v[2]);
+      for (unsigned short axis = 0; axis < 3; ++axis) {
+        bmin[axis] = std::min(bmin[axis], v[axis]);
+        bmax[axis] = std::max(bmax[axis], v[axis]);
+      }
+    }
+  }
+}
+
+KX_NavMeshTiles::KX_NavMeshTiles(std::shared_ptr<const Source> source, const Settings &settings)
+    : m_source(source),
+      m_settings(settings),
+      m_tileSize(settings.tileCells * settings.cellSize),
+      m_lastRequest(0),
+      m_numPendingTiles(0)
+{
+  copy_v3_v3(m_origin, m_source->bmin);
+
+  m_navMesh = new dtTiledNavMesh();
+  m_navMesh->init(m_origin, m_tileSize, m_settings.portalHeight);
+
+  // The engine scheduler has no worker threads, tasks are executed in its background thread.
+  m_pool = BLI_task_pool_create_background(KX_GetActiveEngine()->GetTaskScheduler(), this);
+}
+
+KX_NavMeshTiles::~KX_NavMeshTiles()
+{
+  BLI_task_pool_cancel(m_pool);
+  BLI_task_pool_free(m_pool);
+
+  for (const BuiltTile &tile : m_builtTiles) {
+    delete[] tile.data;
+  }
+
+  delete m_navMesh;
+}
+
+/// Clip a polygon against an axis aligned plane, keeping the side of (v[axis] - value) * sign >= 0.
+static int clipPolygon(const float *in, int nin, float *out, int axis, float value, float sign)
+{
+  int nout = 0;
+  for (int i = 0; i < nin; ++i) {
+    const float *a = &in[i * 3];
+    const float *b = &in[((i + 1) % nin) * 3];
+    const float da = (a[axis] - value) * sign;
+    const float db = (b[axis] - value) * sign;
+
+    if (da >= 0.0f) {
+      copy_v3_v3(&out[nout * 3], a);
+      ++nout;
+    }
+    if ((da > 0.0f && db < 0.0f) || (da < 0.0f && db > 0.0f)) {
+      float *v = &out[nout * 3];
+      interp_v3_v3v3(v, a, b, da / (da - db));
+      // Vertices on the tile border must be exactly on it to be detected as portals.
+      v[axis] = value;
+      ++nout;
+    }
+  }
+
+  return nout;
+}
+
+bool KX_NavMeshTiles::BuildTileData(const Source &source,
+                                    const Settings &settings,
+                                    const float origin[3],
+                                    int x,
+                                    int y,
+                                    unsigned char *&data,
+                                    int &dataSize)
+{
+  static const int nvp = DT_TILE_VERTS_PER_POLYGON;
+
+  data = nullptr;
+  dataSize = 0;
+
+  const float tileSize = settings.tileCells * settings.cellSize;
+  const float bmin[3] = {origin[0] + x * tileSize, source.bmin[1], origin[2] + y * tileSize};
+  const float bmax[3] = {bmin[0] + tileSize, source.bmax[1], bmin[2] + tileSize};
+  const float ics = 1.0f / settings.cellSize;
+  const float ich = 1.0f / settings.cellHeight;
+  const int maxHeight = std::min((int)std::ceil((bmax[1] - bmin[1]) * ich), 0xfffe);
+
+  std::vector<unsigned short> verts;
+  std::unordered_map<uint64_t, unsigned short> vertMap;
+  // Vertex indices of the tile polygons, nvp per polygon.
+  std::vector<unsigned short> tilePolys;
+
+  const int npolys = source.polys.size() / source.vertsPerPoly;
+  for (int i = 0; i < npolys; ++i) {
+    const float *bounds = &source.polyBounds[i * 4];
+    if (bounds[2] < bmin[0] || bounds[0] > bmax[0] || bounds[3] < bmin[2] ||
+        bounds[1] > bmax[2]) {
+      continue;
+    }
+
+    float clip[2][MAX_CLIP_VERTS * 3];
+    int nv = 0;
+    const unsigned short *poly = &source.polys[i * source.vertsPerPoly];
+    for (int j = 0; j < source.vertsPerPoly && poly[j] != 0xffff; ++j) {
+      copy_v3_v3(&clip[0][nv * 3], &source.vertices[poly[j] * 3]);
+      ++nv;
+    }
+
+    nv = clipPolygon(clip[0], nv, clip[1], 0, bmin[0], 1.0f);
+    nv = clipPolygon(clip[1], nv, clip[0], 0, bmax[0], -1.0f);
+    nv = clipPolygon(clip[0], nv, clip[1], 2, bmin[2], 1.0f);
+    nv = clipPolygon(clip[1], nv, clip[0], 2, bmax[2], -1.0f);
+    if (nv < 3) {
+      continue;
+    }
+
+    // Quantize and weld the vertices, dropping the vertices merged with their predecessor.
+    unsigned short indices[MAX_CLIP_VERTS];
+    int nind = 0;
+    int area = 0;
+    int prevq[3] = {0, 0, 0};
+    for (int j = 0; j < nv; ++j) {
+      const float *v = &clip[0][j * 3];
+      const int q[3] = {
+          std::max(0, std::min((int)std::round((v[0] - bmin[0]) * ics), settings.tileCells)),
+          std::max(0, std::min((int)std::round((v[1] - bmin[1]) * ich), maxHeight)),
+          std::max(0, std::min((int)std::round((v[2] - bmin[2]) * ics), settings.tileCells))};
+      const uint64_t key = (uint64_t)q[0] | ((uint64_t)q[1] << 16) | ((uint64_t)q[2] << 32);
+
+      const auto it = vertMap.find(key);
+      unsigned short index;
+      if (it == vertMap.end()) {
+        if (verts.size() / 3 >= 0xfffe) {
+          return false;
+        }
+        index = verts.size() / 3;
+        vertMap.emplace(key, index);
+        verts.insert(verts.end(),
+                     {(unsigned short)q[0], (unsigned short)q[1], (unsigned short)q[2]});
+      }
+      else {
+        index = it->second;
+      }
+
+      if (nind == 0 || indices[nind - 1] != index) {
+        if (nind > 0) {
+          area += prevq[0] * q[2] - q[0] * prevq[2];
+        }
+        indices[nind++] = index;
+        copy_v3_v3_int(prevq, q);
+      }
+    }
+    if (nind > 1 && indices[nind - 1] == indices[0]) {
+      --nind;
+    }
+    if (nind < 3) {
+      continue;
+    }
+    // Close the shoelace sum to reject the polygons collapsed on a line.
+    const unsigned short *first = &verts[indices[0] * 3];
+    area += prevq[0] * first[2] - first[0] * prevq[2];
+    if (area == 0) {
+      continue;
+    }
+
+    // Split the convex polygons having too many vertices in fans.
+    for (int start = 1; start < nind - 1;) {
+      const int end = std::min(start + nvp - 2, nind - 1);
+      const size_t offset = tilePolys.size();
+      tilePolys.resize(offset + nvp, 0xffff);
+      tilePolys[offset] = indices[0];
+      for (int j = start; j <= end; ++j) {
+        tilePolys[offset + 1 + j - start] = indices[j];
+      }
+      start = end;
+    }
+  }
+
+  const int ntilepolys = tilePolys.size() / nvp;
+  if (ntilepolys == 0) {
+    // Empty tile.
+    return true;
+  }
+  if (ntilepolys > DT_MAX_POLYGONS) {
+    return false;
+  }
+
+  // Polygons with adjacency and the fan triangulation used as detail mesh.
+  std::vector<unsigned short> polys(ntilepolys * nvp * 2, 0xffff);
+  std::vector<unsigned short> dmeshes(ntilepolys * 4);
+  std::vector<unsigned char> dtris;
+  for (int i = 0; i < ntilepolys; ++i) {
+    std::copy_n(&tilePolys[i * nvp], nvp, &polys[i * nvp * 2]);
+
+    int nv = 0;
+    while (nv < nvp && tilePolys[i * nvp + nv] != 0xffff) {
+      ++nv;
+    }
+
+    unsigned short *dmesh = &dmeshes[i * 4];
+    dmesh[0] = 0;
+    dmesh[1] = nv;
+    dmesh[2] = dtris.size() / 4;
+    dmesh[3] = nv - 2;
+    for (int j = 1; j < nv - 1; ++j) {
+      dtris.insert(dtris.end(), {0, (unsigned char)j, (unsigned char)(j + 1), 0});
+    }
+  }
+
+  const int nverts = verts.size() / 3;
+  if (!buildMeshAdjacency(polys.data(), ntilepolys, nverts, nvp)) {
+    return false;
+  }
+
+  // The detail meshes have no other vertices than the polygon ones.
+  const float dverts[3] = {0.0f, 0.0f, 0.0f};
+  return dtCreateNavMeshTileData(verts.data(),
+                                 nverts,
+                                 polys.data(),
+                                 ntilepolys,
+                                 nvp,
+                                 dmeshes.data(),
+                                 dverts,
+                                 0,
+                                 dtris.data(),
+                                 dtris.size() / 4,
+                                 bmin,
+                                 bmax,
+                                 settings.cellSize,
+                                 settings.cellHeight,
+                                 settings.tileCells,
+                                 (int)std::ceil(settings.portalHeight * ich),
+                                 &data,
+                                 &dataSize);
+}
+
+void KX_NavMeshTiles::BuildTileTask(TaskPool *__restrict pool, void *taskdata, int /*threadid*/)
+{
+  KX_NavMeshTiles *self = (KX_NavMeshTiles *)BLI_task_pool_userdata(pool);
+  const TileTask *task = (TileTask *)taskdata;
+
+  BuiltTile tile;
+  tile.x = task->x;
+  tile.y = task->y;
+  tile.request = task->request;
+  tile.valid = BuildTileData(
+      *task->source, self->m_settings, self->m_origin, task->x, task->y, tile.data, tile.dataSize);
+
+  self->m_builtTilesLock.Lock();
+  self->m_builtTiles.push_back(tile);
+  self->m_builtTilesLock.Unlock();
+}
+
+void KX_NavMeshTiles::FreeTileTask(TaskPool *__restrict /*pool*/, void *taskdata, int /*threadid*/)
+{
+  // The task data owns a reference to the source.
+  delete (TileTask *)taskdata;
+}
+
+void KX_NavMeshTiles::GetTileRange(
+    const Source &source, int &minx, int &miny, int &maxx, int &maxy) const
+{
+  GetTileIndex(source.bmin, minx, miny);
+  GetTileIndex(source.bmax, maxx, maxy);
+}
+
+void KX_NavMeshTiles::ReplaceTile(int x, int y, unsigned char *data, int dataSize)
+{
+  m_navMesh->removeTileAt(x, y, nullptr, nullptr);
+
+  if (data && !m_navMesh->addTileAt(x, y, data, dataSize, true)) {
+    CM_Error("unable to add navigation mesh tile (" << x << ", " << y << "), too many tiles");
+    delete[] data;
+  }
+}
+
+struct BuildTilesData {
+  const KX_NavMeshTiles::Source *source;
+  const KX_NavMeshTiles::Settings *settings;
+  const float *origin;
+  int minx;
+  int miny;
+  int width;
+  std::vector<unsigned char *> data;
+  std::vector<int> dataSize;
+  std::vector<char> valid;
+};
+
+static void build_tile_func(void *__restrict userdata,
+                            const int iter,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  BuildTilesData *data = (BuildTilesData *)userdata;
+  const int x = data->minx + iter % data->width;
+  const int y = data->miny + iter / data->width;
+  data->valid[iter] = KX_NavMeshTiles::BuildTileData(*data->source,
+                                                     *data->settings,
+                                                     data->origin,
+                                                     x,
+                                                     y,
+                                                     data->data[iter],
+                                                     data->dataSize[iter]);
+}
+
+bool KX_NavMeshTiles::Build()
+{
+  int minx, miny, maxx, maxy;
+  GetTileRange(*m_source, minx, miny, maxx, maxy);
+
+  const int width = maxx - minx + 1;
+  const int numTiles = width * (maxy - miny + 1);
+  if (numTiles > DT_MAX_TILES) {
+    CM_Error("navigation mesh needs " << numTiles << " tiles, the maximum is " << DT_MAX_TILES
+                                      << ", increase the tile size");
+    return false;
+  }
+
+  BuildTilesData data;
+  data.source = m_source.get();
+  data.settings = &m_settings;
+  data.origin = m_origin;
+  data.minx = minx;
+  data.miny = miny;
+  data.width = width;
+  data.data.resize(numTiles, nullptr);
+  data.dataSize.resize(numTiles, 0);
+  data.valid.resize(numTiles, false);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (numTiles > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, numTiles, &data, build_tile_func, &settings);
+
+  // The tiles are connected in the main thread.
+  bool result = true;
+  for (int i = 0; i < numTiles; ++i) {
+    const int x = minx + i % width;
+    const int y = miny + i / width;
+    if (!data.valid[i]) {
+      CM_Error("unable to build navigation mesh tile (" << x << ", " << y
+                                                        << "), reduce the tile size");
+      result = false;
+    }
+    ReplaceTile(x, y, data.data[i], data.dataSize[i]);
+  }
+
+  return result;
+}
+
+void KX_NavMeshTiles::SetSource(std::shared_ptr<const Source> source)
+{
+  m_source = source;
+}
+
+dtTiledNavMesh *KX_NavMeshTiles::GetNavMesh() const
+{
+  return m_navMesh;
+}
+
+float KX_NavMeshTiles::GetTileSize() const
+{
+  return m_tileSize;
+}
+
+void KX_NavMeshTiles::GetTileIndex(const float pos[3], int &x, int &y) const
+{
+  x = (int)std::floor((pos[0] - m_origin[0]) / m_tileSize);
+  y = (int)std::floor((pos[2] - m_origin[2]) / m_tileSize);
+}
+
+bool KX_NavMeshTiles::IsTileLoaded(int x, int y) const
+{
+  return (m_navMesh->getTileAt(x, y) != nullptr);
+}
+
+void KX_NavMeshTiles::RequestTile(int x, int y)
+{
+  const unsigned int request = ++m_lastRequest;
+  m_requests[std::make_pair(x, y)] = request;
+  ++m_numPendingTiles;
+
+  TileTask *task = new TileTask{m_source, x, y, request};
+  BLI_task_pool_push_ex(m_pool, BuildTileTask, task, true, FreeTileTask, TASK_PRIORITY_LOW);
+}
+
+unsigned int KX_NavMeshTiles::RequestTiles(const float bmin[3], const float bmax[3])
+{
+  int minx, miny, maxx, maxy;
+  GetTileIndex(bmin, minx, miny);
+  GetTileIndex(bmax, maxx, maxy);
+
+  const int numTiles = (maxx - minx + 1) * (maxy - miny + 1);
+  if (numTiles > DT_MAX_TILES) {
+    CM_Error("too many navigation mesh tiles requested: " << numTiles);
+    return 0;
+  }
+
+  for (int y = miny; y <= maxy; ++y) {
+    for (int x = minx; x <= maxx; ++x) {
+      RequestTile(x, y);
+    }
+  }
+
+  return numTiles;
+}
+
+bool KX_NavMeshTiles::RemoveTile(int x, int y)
+{
+  // The pending build of the tile is discarded when it finishes.
+  m_requests.erase(std::make_pair(x, y));
+  return m_navMesh->removeTileAt(x, y, nullptr, nullptr);
+}
+
+unsigned int KX_NavMeshTiles::GetNumPendingTiles() const
+{
+  return m_numPendingTiles;
+}
+
+bool KX_NavMeshTiles::Update()
+{
+  if (m_numPendingTiles == 0) {
+    return false;
+  }
+
+  std::vector<BuiltTile> builtTiles;
+  m_builtTilesLock.Lock();
+  builtTiles.swap(m_builtTiles);
+  m_builtTilesLock.Unlock();
+
+  bool changed = false;
+  for (const BuiltTile &tile : builtTiles) {
+    --m_numPendingTiles;
+
+    const auto it = m_requests.find(std::make_pair(tile.x, tile.y));
+    // The tile was removed or requested again since this build.
+    if (it == m_requests.end() || it->second != tile.request) {
+      delete[] tile.data;
+      continue;
+    }
+    m_requests.erase(it);
+
+    if (!tile.valid) {
+      CM_Error("unable to build navigation mesh tile (" << tile.x << ", " << tile.y
+                                                        << "), reduce the tile size");
+      continue;
+    }
+
+    ReplaceTile(tile.x, tile.y, tile.data, tile.dataSize);
+    changed = true;
+  }
+
+  return changed;
+}
+
+bool KX_NavMeshTiles::IsWallEdge(const dtTileHeader *header, const dtTilePoly *poly, int edge)
+{
+  for (unsigned int i = poly->links, end = poly->links + poly->nlinks; i < end; ++i) {
+    if (header->links[i].e == edge) {
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,156 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_NavMeshTiles.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_NAVMESHTILES_H__
+#define __KX_NAVMESHTILES_H__
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "CM_Thread.h"
+
+class dtTiledNavMesh;
+struct dtTileHeader;
+struct dtTilePoly;
+struct TaskPool;
+
+/** Tiled navigation mesh built from the polygons of a navigation mesh object.
+ * The source polygons are clipped to each tile of a regular grid on the XZ plane (recast
+ * coordinates, Y up). All the tiles are built in parallel when the navigation mesh is created,
+ * then single tiles can be rebuilt or loaded in a task pool and removed at runtime, the built
+ * tiles are swapped in the navigation mesh by Update() on the main thread.
+ */
+class KX_NavMeshTiles {
+ public:
+  /// Source polygons of the tiles, never modified once shared with the tile build tasks.
+  struct Source {
+    /// Vertex positions in recast coordinates.
+    std::vector<float> vertices;
+    /// Vertex indices of the polygons, vertsPerPoly indices per polygon padded with 0xffff.
+    std::vector<unsigned short> polys;
+    /// XZ bounds of each polygon: minimum X, minimum Z, maximum X, maximum Z.
+    std::vector<float> polyBounds;
+    int vertsPerPoly;
+    float bmin[3];
+    float bmax[3];
+
+    Source(const float *verts, int nverts, const unsigned short *polygons, int npolys, int nvp);
+  };
+
+  struct Settings {
+    /// Quantization of the tile vertices.
+    float cellSize;
+    float cellHeight;
+    /// Number of cells on a tile side.
+    int tileCells;
+    /// Vertical tolerance when connecting the tile borders.
+    float portalHeight;
+  };
+
+ private:
+  /// Result of a tile build task.
+  struct BuiltTile {
+    int x;
+    int y;
+    unsigned int request;
+    /// Null if the tile is empty or the build failed.
+    unsigned char *data;
+    int dataSize;
+    bool valid;
+  };
+
+  struct TileTask;
+
+  dtTiledNavMesh *m_navMesh;
+  std::shared_ptr<const Source> m_source;
+  Settings m_settings;
+  /// World origin of the tile grid.
+  float m_origin[3];
+  float m_tileSize;
+
+  TaskPool *m_pool;
+  /// Identifier of the last request of each tile, older builds are discarded.
+  std::map<std::pair<int, int>, unsigned int> m_requests;
+  unsigned int m_lastRequest;
+  unsigned int m_numPendingTiles;
+  /// Tiles built by the tasks and not yet added to the navigation mesh.
+  std::vector<BuiltTile> m_builtTiles;
+  CM_ThreadSpinLock m_builtTilesLock;
+
+  static void BuildTileTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+  static void FreeTileTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+
+  void GetTileRange(const Source &source, int &minx, int &miny, int &maxx, int &maxy) const;
+  void ReplaceTile(int x, int y, unsigned char *data, int dataSize);
+
+ public:
+  KX_NavMeshTiles(std::shared_ptr<const Source> source, const Settings &settings);
+  ~KX_NavMeshTiles();
+
+  /** Build the detour data of a tile, thread safe.
+   * \param data Receives the tile data allocated with new[], null for an empty tile.
+   * \return False if the tile can't be built, e.g with more than DT_MAX_POLYGONS polygons.
+   */
+  static bool BuildTileData(const Source &source,
+                            const Settings &settings,
+                            const float origin[3],
+                            int x,
+                            int y,
+                            unsigned char *&data,
+                            int &dataSize);
+
+  /// Build all the tiles covering the source in parallel, blocking.
+  bool Build();
+
+  /** Replace the source polygons used by the next tile builds, the loaded tiles are kept
+   * until they are rebuilt.
+   */
+  void SetSource(std::shared_ptr<const Source> source);
+
+  dtTiledNavMesh *GetNavMesh() const;
+  float GetTileSize() const;
+
+  /// Tile containing a position in recast coordinates.
+  void GetTileIndex(const float pos[3], int &x, int &y) const;
+  bool IsTileLoaded(int x, int y) const;
+  /** Queue the asynchronous build of a tile from the current source, the tile currently
+   * loaded stays in the navigation mesh until the new one is swapped by Update().
+   */
+  void RequestTile(int x, int y);
+  /// Request all the tiles overlapping a box in recast coordinates, return the number of tiles.
+  unsigned int RequestTiles(const float bmin[3], const float bmax[3]);
+  /// Remove a tile immediately and cancel its pending build.
+  bool RemoveTile(int x, int y);
+  unsigned int GetNumPendingTiles() const;
+
+  /// Add the built tiles to the navigation mesh, return true if the navigation mesh changed.
+  bool Update();
+
+  /// Return true if a polygon edge of a loaded tile is not connected to another polygon.
+  static bool IsWallEdge(const dtTileHeader *header, const dtTilePoly *poly, int edge);
+};
+
+#endif  // __KX_NAVMESHTILES_H__
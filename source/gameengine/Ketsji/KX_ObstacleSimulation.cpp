@@ -31,6 +31,7 @@
 #include "BLI_math.h"
 #include "DNA_object_types.h"
 
+#include "DetourTileNavMesh.h"
 #include "KX_Globals.h"
 #include "KX_NavMeshObject.h"
 
@@ -230,6 +231,34 @@ void KX_ObstacleSimulation::AddObstacleForObj(KX_GameObject *gameobj)
 
 void KX_ObstacleSimulation::AddObstaclesForNavMesh(KX_NavMeshObject *navmeshobj)
 {
+  dtTiledNavMesh *tiledNavmesh = navmeshobj->GetTiledNavMesh();
+  if (tiledNavmesh) {
+    for (int ti = 0; ti < DT_MAX_TILES; ti++) {
+      const dtTileHeader *header = tiledNavmesh->getTile(ti)->header;
+      if (!header)
+        continue;
+
+      for (int pi = 0; pi < header->npolys; pi++) {
+        const dtTilePoly *poly = &header->polys[pi];
+
+        for (int i = 0, j = (int)poly->nv - 1; i < (int)poly->nv; j = i++) {
+          if (!KX_NavMeshTiles::IsWallEdge(header, poly, j))
+            continue;
+          const float *vj = &header->verts[poly->v[j] * 3];
+          const float *vi = &header->verts[poly->v[i] * 3];
+
+          KX_Obstacle *obstacle = CreateObstacle(navmeshobj);
+          obstacle->m_type = KX_OBSTACLE_NAV_MESH;
+          obstacle->m_shape = KX_OBSTACLE_SEGMENT;
+          obstacle->m_pos = MT_Vector3(vj[0], vj[2], vj[1]);
+          obstacle->m_pos2 = MT_Vector3(vi[0], vi[2], vi[1]);
+          obstacle->m_rad = 0;
+        }
+      }
+    }
+    return;
+  }
+
   dtStatNavMesh *navmesh = navmeshobj->GetNavMesh();
   if (navmesh) {
     int npoly = navmesh->getPolyCount();
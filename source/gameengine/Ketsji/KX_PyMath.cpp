@@ -38,6 +38,8 @@
 
 #  include "KX_PyMath.h"
 
+#  include <cstring>
+
 #  include "EXP_ListValue.h"
 #  include "EXP_Python.h"
 #  include "MT_Matrix4x4.h"
@@ -193,6 +195,29 @@ PyObject *PyObjectFrom(const MT_Vector2 &vec)
 #  endif
 }
 
+bool PyFloatBufferGet(
+    PyObject *pyval, Py_buffer *view, bool writable, unsigned int size, const char *error_prefix)
+{
+  const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+  if (PyObject_GetBuffer(pyval, view, flags) == -1) {
+    return false;
+  }
+
+  // Accept the native and explicit byte order formats: "f", "=f", "<f"...
+  const size_t formatlen = view->format ? strlen(view->format) : 0;
+  if (view->itemsize != sizeof(float) || formatlen == 0 || view->format[formatlen - 1] != 'f' ||
+      ((view->len / sizeof(float)) % size) != 0) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s, expected a contiguous buffer of floats with a multiple of %u items",
+                 error_prefix,
+                 size);
+    PyBuffer_Release(view);
+    return false;
+  }
+
+  return true;
+}
+
 PyObject *PyColorFromVector(const MT_Vector3 &vec)
 {
 #  ifdef USE_MATHUTILS
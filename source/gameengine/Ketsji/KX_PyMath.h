@@ -256,6 +256,14 @@ bool PyQuatTo(PyObject *pyval, MT_Quaternion &qrot);
 
 bool PyOrientationTo(PyObject *pyval, MT_Matrix3x3 &mat, const char *error_prefix);
 
+/**
+ * Gets a C contiguous buffer of floats, e.g a numpy array of float32, the view must be released
+ * with PyBuffer_Release on success.
+ * \param size The number of floats of the buffer must be a multiple of this size.
+ */
+bool PyFloatBufferGet(
+    PyObject *pyval, Py_buffer *view, bool writable, unsigned int size, const char *error_prefix);
+
 /**
  * Converts an MT_Matrix4x4 to a python object.
  */
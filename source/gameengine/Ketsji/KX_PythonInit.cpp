@@ -444,6 +444,23 @@ static PyObject *gPySetUseExternalClock(PyObject *, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *gPyGetUseTransformInterpolation(PyObject *)
+{
+  return PyBool_FromLong(
+      KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::INTERPOLATE_TRANSFORMS));
+}
+
+static PyObject *gPySetUseTransformInterpolation(PyObject *, PyObject *args)
+{
+  int interpolate;
+
+  if (!PyArg_ParseTuple(args, "p:setUseTransformInterpolation", &interpolate))
+    return nullptr;
+
+  KX_GetActiveEngine()->SetFlag(KX_KetsjiEngine::INTERPOLATE_TRANSFORMS, (bool)interpolate);
+  Py_RETURN_NONE;
+}
+
 static PyObject *gPyGetClockTime(PyObject *)
 {
   return PyFloat_FromDouble(KX_GetActiveEngine()->GetClockTime());
@@ -845,6 +862,14 @@ static struct PyMethodDef game_methods[] = {
      (PyCFunction)gPySetUseExternalClock,
      METH_VARARGS,
      (const char *)"Set if we use the time provided by an external clock"},
+    {"getUseTransformInterpolation",
+     (PyCFunction)gPyGetUseTransformInterpolation,
+     METH_NOARGS,
+     (const char *)"Get if the objects are rendered between their last two logic states"},
+    {"setUseTransformInterpolation",
+     (PyCFunction)gPySetUseTransformInterpolation,
+     METH_VARARGS,
+     (const char *)"Set if the objects are rendered between their last two logic states"},
     {"getClockTime",
      (PyCFunction)gPyGetClockTime,
      METH_NOARGS,
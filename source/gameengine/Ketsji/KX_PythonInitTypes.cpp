@@ -57,6 +57,7 @@
 #  include "KX_LodManager.h"
 #  include "KX_MeshProxy.h"
 #  include "KX_NavMeshObject.h"
+#  include "KX_NavMeshPathRequest.h"
 #  include "KX_NetworkMessageActuator.h"
 #  include "KX_NetworkMessageSensor.h"
 #  include "KX_PolyProxy.h"
@@ -250,6 +251,7 @@ PyMODINIT_FUNC initGameTypesPythonBinding(void)
     PyType_Ready_Attr(dict, SCA_ReplaceMeshActuator, init_getset);
     PyType_Ready_Attr(dict, KX_Scene, init_getset);
     PyType_Ready_Attr(dict, KX_NavMeshObject, init_getset);
+    PyType_Ready_Attr(dict, KX_NavMeshPathRequest, init_getset);
     PyType_Ready_Attr(dict, SCA_SceneActuator, init_getset);
     PyType_Ready_Attr(dict, SCA_SoundActuator, init_getset);
     PyType_Ready_Attr(dict, SCA_StateActuator, init_getset);
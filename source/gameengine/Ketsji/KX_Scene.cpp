@@ -47,6 +47,7 @@
 #include "BLI_utildefines.h"
 #include "DNA_lightprobe_types.h"
 #include "DNA_mesh_types.h"
+#include "DNA_object_types.h"
 #include "DNA_property_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_windowmanager_types.h"
@@ -59,6 +60,7 @@
 #include "GPU_viewport.h"
 #include "MEM_guardedalloc.h"
 #include "WM_api.h"
+#include "depsgraph/DEG_depsgraph_debug.h"
 #include "depsgraph/DEG_depsgraph_query.h"
 #include "windowmanager/wm_draw.h"
 
@@ -67,6 +69,7 @@
 #include "EXP_FloatValue.h"
 #include "EXP_ListValue.h"
 #include "KX_2DFilterManager.h"
+#include "KX_ActivityGrid.h"
 #include "KX_BlenderCanvas.h"
 #include "KX_BlenderMaterial.h"
 #include "KX_Camera.h"
@@ -77,10 +80,12 @@
 #include "KX_Light.h"
 #include "KX_LodManager.h"
 #include "KX_MotionState.h"
+#include "KX_NavMeshObject.h"
 #include "KX_NetworkMessageScene.h"
 #include "KX_ObstacleSimulation.h"
 #include "KX_PyMath.h"
 #include "KX_SG_NodeRelationships.h"
+#include "KX_SceneSnapshot.h"
 #include "PHY_IPhysicsController.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "RAS_2DFilter.h"
@@ -174,6 +179,10 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
   m_activity_culling = false;
+  m_activityGrid = new KX_ActivityGrid();
+  m_lodData.numSceneObjects = 0;
+  m_lodData.invalid = true;
+  m_lodSwitchCount = 0;
   m_objectlist = new CListValue<KX_GameObject>();
   m_parentlist = new CListValue<KX_GameObject>();
   m_lightlist = new CListValue<KX_LightObject>();
@@ -324,6 +333,10 @@ KX_Scene::~KX_Scene()
 
   // Flush depsgraph updates a last time at ge exit
   Depsgraph *depsgraph = BKE_scene_get_depsgraph(bmain, scene, view_layer, false);
+  if (depsgraph) {
+    // The depsgraph is still used by the editors after the game.
+    DEG_sparse_evaluation_set(depsgraph, false);
+  }
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
   /* End of EEVEE INTEGRATION */
@@ -341,6 +354,8 @@ KX_Scene::~KX_Scene()
   if (m_obstacleSimulation)
     delete m_obstacleSimulation;
 
+  delete m_activityGrid;
+
   if (m_animationPool) {
     BLI_task_pool_free(m_animationPool);
   }
@@ -632,6 +647,20 @@ bool KX_Scene::CameraIsInactive(KX_Camera *cam)
 static RAS_Rasterizer::FrameBufferType r = RAS_Rasterizer::RAS_FRAMEBUFFER_FILTER0;
 static RAS_Rasterizer::FrameBufferType s = RAS_Rasterizer::RAS_FRAMEBUFFER_EYE_LEFT0;
 
+void KX_Scene::UpdateDepsgraph(Depsgraph *depsgraph, Main *bmain)
+{
+  KX_KetsjiEngine *engine = KX_GetActiveEngine();
+  DEG_sparse_evaluation_set(depsgraph, engine->GetFlag(KX_KetsjiEngine::SPARSE_DEPSGRAPH));
+
+  BKE_scene_graph_update_tagged(depsgraph, bmain);
+
+  size_t numVisitedOperations;
+  size_t numOperations;
+  DEG_stats_evaluation(depsgraph, &numVisitedOperations, nullptr);
+  DEG_stats_simple(depsgraph, nullptr, &numOperations, nullptr);
+  engine->AddDepsgraphStats(numVisitedOperations, numOperations);
+}
+
 void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam, bool is_overlay_pass)
 {
   KX_KetsjiEngine *engine = KX_GetActiveEngine();
@@ -649,7 +678,7 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam, bool is_overlay_pass)
     depsgraph = BKE_scene_get_depsgraph(bmain, scene, view_layer, true);
   }
 
-  BKE_scene_graph_update_tagged(depsgraph, bmain);
+  UpdateDepsgraph(depsgraph, bmain);
 
   for (KX_GameObject *gameobj : GetObjectList()) {
     gameobj->TagForUpdate(is_overlay_pass);
@@ -770,7 +799,7 @@ void KX_Scene::RenderAfterCameraSetupImageRender(KX_Camera *cam,
     depsgraph = BKE_scene_get_depsgraph(bmain, scene, view_layer, true);
   }
 
-  BKE_scene_graph_update_tagged(depsgraph, bmain);
+  UpdateDepsgraph(depsgraph, bmain);
 
   for (KX_GameObject *gameobj : GetObjectList()) {
     gameobj->TagForUpdate(false);
@@ -857,6 +886,14 @@ CListValue<KX_FontObject> *KX_Scene::GetFontList() const
   return m_fontlist;
 }
 
+void KX_Scene::AddPathQueryNavMesh(KX_NavMeshObject *navmesh)
+{
+  if (std::find(m_pathQueryNavMeshes.begin(), m_pathQueryNavMeshes.end(), navmesh) ==
+      m_pathQueryNavMeshes.end()) {
+    m_pathQueryNavMeshes.push_back(navmesh);
+  }
+}
+
 void KX_Scene::SetFramingType(RAS_FrameSettings &frame_settings)
 {
   m_frame_settings = frame_settings;
@@ -876,6 +913,7 @@ const RAS_FrameSettings &KX_Scene::GetFramingType() const
 void KX_Scene::SetActivityCulling(bool b)
 {
   m_activity_culling = b;
+  m_activityGrid->Invalidate();
 }
 
 void KX_Scene::AddObjectDebugProperties(class KX_GameObject *gameobj)
@@ -960,6 +998,12 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
 
   // this is the list of object that are send to the graphics pipeline
   m_objectlist->Add(CM_AddRef(newobj));
+  if (m_activity_culling) {
+    m_activityGrid->AddObject(newobj);
+  }
+  if (newobj->GetLodManager()) {
+    InvalidateLodObjects();
+  }
   switch (newobj->GetGameObjectType()) {
     case SCA_IObject::OBJ_LIGHT: {
       m_lightlist->Add(CM_AddRef(static_cast<KX_LightObject *>(newobj)));
@@ -1477,10 +1521,17 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
     ret = (gameobj->Release() != nullptr);
   if (m_objectlist->RemoveValue(gameobj))
     ret = (gameobj->Release() != nullptr);
+  m_activityGrid->RemoveObject(gameobj);
+  if (gameobj->GetLodManager()) {
+    InvalidateLodObjects();
+  }
   if (m_parentlist->RemoveValue(gameobj))
     ret = (gameobj->Release() != nullptr);
   if (m_inactivelist->RemoveValue(gameobj))
     ret = (gameobj->Release() != nullptr);
+  m_pathQueryNavMeshes.erase(
+      std::remove(m_pathQueryNavMeshes.begin(), m_pathQueryNavMeshes.end(), gameobj),
+      m_pathQueryNavMeshes.end());
   if (m_fontlist->RemoveValue(static_cast<KX_FontObject *>(gameobj))) {
     ret = (gameobj->Release() != nullptr);
   }
@@ -1602,6 +1653,81 @@ void KX_Scene::PhysicsCullingCallback(KX_ClientObjectInfo *objectInfo, void *cul
   }
 }
 
+static void frustum_query_callback(KX_ClientObjectInfo *objectInfo, void *userData)
+{
+  KX_GameObject *gameobj = KX_GameObject::GetClientObject(objectInfo);
+  if (gameobj) {
+    ((std::vector<KX_GameObject *> *)userData)->push_back(gameobj);
+  }
+}
+
+void KX_Scene::GetObjectsInsideFrustum(const SG_Frustum &frustum,
+                                       std::vector<KX_GameObject *> &objects)
+{
+  objects.clear();
+
+  if (m_physicsEnvironment &&
+      m_physicsEnvironment->CullingTest(frustum_query_callback,
+                                        &objects,
+                                        frustum.GetPlanes(),
+                                        0,
+                                        nullptr,
+                                        frustum.GetMatrix())) {
+    return;
+  }
+
+  // Compute the world AABB of every object and test them in batch.
+  const unsigned int numObjects = m_objectlist->GetCount();
+  std::vector<float> boxes(numObjects * 6);
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    KX_GameObject *gameobj = m_objectlist->GetValue(i);
+    Object *blenderobj = gameobj->GetBlenderObject();
+    BoundBox *bb = blenderobj ? BKE_object_boundbox_get(blenderobj) : nullptr;
+
+    MT_Vector3 center(0.0f, 0.0f, 0.0f);
+    MT_Vector3 extents(0.0f, 0.0f, 0.0f);
+    if (bb) {
+      const MT_Vector3 min(bb->vec[0]);
+      const MT_Vector3 max(bb->vec[6]);
+      center = (min + max) * 0.5f;
+      extents = (max - min) * 0.5f;
+    }
+
+    const MT_Matrix3x3 &ori = gameobj->NodeGetWorldOrientation();
+    const MT_Vector3 &scale = gameobj->NodeGetWorldScaling();
+    const MT_Vector3 wcenter = gameobj->NodeGetWorldPosition() + ori * (center * scale);
+    float *box = &boxes[i * 6];
+    for (unsigned short axis = 0; axis < 3; ++axis) {
+      const float wextent = fabsf(ori[axis][0] * scale[0]) * extents[0] +
+                            fabsf(ori[axis][1] * scale[1]) * extents[1] +
+                            fabsf(ori[axis][2] * scale[2]) * extents[2];
+      box[axis] = wcenter[axis] - wextent;
+      box[axis + 3] = wcenter[axis] + wextent;
+    }
+  }
+
+  std::vector<unsigned char> mask((numObjects + 7) / 8);
+  frustum.AabbsInsideFrustum(boxes.data(), numObjects, mask.data());
+
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    if (mask[i >> 3] & (1 << (i & 7))) {
+      objects.push_back(m_objectlist->GetValue(i));
+    }
+  }
+}
+
+void KX_Scene::SaveSnapshot(std::vector<unsigned char> &data)
+{
+  KX_SceneSnapshot snapshot(this);
+  snapshot.Save(data);
+}
+
+int KX_Scene::RestoreSnapshot(const unsigned char *data, unsigned int size)
+{
+  KX_SceneSnapshot snapshot(this);
+  return snapshot.Restore(data, size);
+}
+
 void KX_Scene::RenderDebugProperties(RAS_DebugDraw &debugDraw,
                                      int xindent,
                                      int ysize,
@@ -1796,6 +1922,16 @@ void KX_Scene::LogicEndFrame()
   for (KX_FontObject *font : m_fontlist) {
     font->UpdateTextFromProperty();
   }
+
+  // The path requests of this frame are delivered to the next ones.
+  for (auto it = m_pathQueryNavMeshes.begin(); it != m_pathQueryNavMeshes.end();) {
+    if ((*it)->UpdatePathQueries()) {
+      ++it;
+    }
+    else {
+      it = m_pathQueryNavMeshes.erase(it);
+    }
+  }
 }
 
 /**
@@ -1833,16 +1969,96 @@ void KX_Scene::AppendToStaticObjects(KX_GameObject *gameobj)
 /************************End of TAA UTILS**************************/
 /*************************************End of EEVEE INTEGRATION*********************************/
 
+static void update_lod_level_func(void *__restrict userdata,
+                                  const int iter,
+                                  const TaskParallelTLS *__restrict /*tls*/)
+{
+  KX_Scene::LodData *data = (KX_Scene::LodData *)userdata;
+  data->levels[iter] = data->objects[iter]->ComputeLodLevel(data->distances[iter]);
+}
+
 void KX_Scene::UpdateObjectLods(KX_Camera *cam /*, const KX_CullingNodeList& nodes*/)
 {
-  const MT_Vector3 &cam_pos = cam->NodeGetWorldPosition();
-  const float lodfactor = cam->GetLodDistanceFactor();
+  // Only the objects owning a lod manager are evaluated.
+  if (m_lodData.invalid || m_lodData.numSceneObjects != m_objectlist->GetCount()) {
+    m_lodData.objects.clear();
+    for (KX_GameObject *gameobj : *m_objectlist) {
+      if (gameobj->GetLodManager()) {
+        m_lodData.objects.push_back(gameobj);
+      }
+    }
 
-  for (KX_GameObject *gameobj : GetObjectList()) {
-    gameobj->UpdateLod(cam_pos, 1.0f /*lodfactor*/);
+    const unsigned int size = m_lodData.objects.size();
+    for (std::vector<float> &positions : m_lodData.positions) {
+      positions.resize(size);
+    }
+    m_lodData.distances.resize(size);
+    m_lodData.levels.resize(size);
+
+    m_lodData.numSceneObjects = m_objectlist->GetCount();
+    m_lodData.invalid = false;
+  }
+
+  m_lodSwitchCount = 0;
+
+  const unsigned int numObjects = m_lodData.objects.size();
+  if (numObjects == 0) {
+    return;
+  }
+
+  // Distances between the drawn positions, interpolated between the logic frames.
+  const float factor = KX_GetActiveEngine()->GetInterpolationFactor();
+  const MT_Vector3 cam_pos = cam->GetSGNode()->GetInterpolatedWorldPosition(factor);
+  const float lodfactor = cam->GetLodDistanceFactor();
+  const float lodfactor2 = lodfactor * lodfactor;
+
+  float *__restrict posx = m_lodData.positions[0].data();
+  float *__restrict posy = m_lodData.positions[1].data();
+  float *__restrict posz = m_lodData.positions[2].data();
+  float *__restrict distances = m_lodData.distances.data();
+
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    const MT_Vector3 pos = m_lodData.objects[i]->GetSGNode()->GetInterpolatedWorldPosition(factor);
+    posx[i] = pos.x();
+    posy[i] = pos.y();
+    posz[i] = pos.z();
+  }
+
+  // Plain loop over contiguous arrays, vectorized by the compiler.
+  const float camx = cam_pos.x();
+  const float camy = cam_pos.y();
+  const float camz = cam_pos.z();
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    const float dx = posx[i] - camx;
+    const float dy = posy[i] - camy;
+    const float dz = posz[i] - camz;
+    distances[i] = (dx * dx + dy * dy + dz * dz) * lodfactor2;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (numObjects > 256);
+  settings.min_iter_per_thread = 128;
+  BLI_task_parallel_range(0, numObjects, &m_lodData, update_lod_level_func, &settings);
+
+  // Mesh and depsgraph changes are done in the main thread.
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    if (m_lodData.objects[i]->ApplyLodLevel(m_lodData.levels[i])) {
+      ++m_lodSwitchCount;
+    }
   }
 }
 
+void KX_Scene::InvalidateLodObjects()
+{
+  m_lodData.invalid = true;
+}
+
+int KX_Scene::GetLodSwitchCount() const
+{
+  return m_lodSwitchCount;
+}
+
 void KX_Scene::SetLodHysteresis(bool active)
 {
   m_isActivedHysteresis = active;
@@ -1863,28 +2079,27 @@ int KX_Scene::GetLodHysteresisValue(void)
   return m_lodHysteresisValue;
 }
 
+void KX_Scene::SavePreviousTransforms()
+{
+  for (KX_GameObject *gameobj : m_objectlist) {
+    gameobj->GetSGNode()->SavePreviousWorldTransform();
+  }
+}
+
 void KX_Scene::UpdateObjectActivity(void)
 {
   if (m_activity_culling) {
-    /* determine the activity criterium and set objects accordingly */
-    MT_Vector3 camloc = GetActiveCamera()->NodeGetWorldPosition();  // GetCameraLocation();
-
-    for (KX_GameObject *ob : *m_objectlist) {
-      if (!ob->GetIgnoreActivityCulling()) {
-        /* Simple test: more than 10 away from the camera, count
-         * Manhattan distance. */
-        MT_Vector3 obpos = ob->NodeGetWorldPosition();
-
-        if ((fabsf(camloc[0] - obpos[0]) > m_activity_box_radius) ||
-            (fabsf(camloc[1] - obpos[1]) > m_activity_box_radius) ||
-            (fabsf(camloc[2] - obpos[2]) > m_activity_box_radius)) {
-          ob->SuspendDynamics();
-        }
-        else {
-          ob->ResumeDynamics();
-        }
-      }
-    }
+    /* Objects are suspended when more than the box radius away from the camera on any axis,
+     * only moved objects and objects near the box boundary are tested. */
+    const MT_Vector3 &camloc = GetActiveCamera()->NodeGetWorldPosition();
+    m_activityGrid->Update(m_objectlist, camloc, m_activity_box_radius);
+  }
+}
+
+void KX_Scene::NotifyObjectMoved(KX_GameObject *gameobj)
+{
+  if (m_activity_culling) {
+    m_activityGrid->ObjectMoved(gameobj);
   }
 }
 
@@ -2072,6 +2287,8 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 
   GetObjectList()->MergeList(other->GetObjectList());
   other->GetObjectList()->ReleaseAndRemoveAll();
+  // The merged objects are not added one by one to the activity grid.
+  m_activityGrid->Invalidate();
 
   GetInactiveList()->MergeList(other->GetInactiveList());
   other->GetInactiveList()->ReleaseAndRemoveAll();
@@ -2204,6 +2421,10 @@ PyMethodDef KX_Scene::Methods[] = {
     KX_PYMETHODTABLE(KX_Scene, restart),
     KX_PYMETHODTABLE(KX_Scene, replace),
     KX_PYMETHODTABLE(KX_Scene, drawObstacleSimulation),
+    KX_PYMETHODTABLE_KEYWORDS(KX_Scene, getWorldTransforms),
+    KX_PYMETHODTABLE_KEYWORDS(KX_Scene, setWorldTransforms),
+    KX_PYMETHODTABLE_NOARGS(KX_Scene, saveSnapshot),
+    KX_PYMETHODTABLE_O(KX_Scene, restoreSnapshot),
 
     /* dict style access */
     KX_PYMETHODTABLE(KX_Scene, get),
@@ -2512,6 +2733,7 @@ PyAttributeDef KX_Scene::Attributes[] = {
         "activity_culling_radius", 0.5f, FLT_MAX, KX_Scene, m_activity_box_radius),
     KX_PYATTRIBUTE_BOOL_RO("dbvt_culling", KX_Scene, m_dbvt_culling),
     KX_PYATTRIBUTE_BOOL_RW("resetTaaSamples", KX_Scene, m_resetTaaSamples),
+    KX_PYATTRIBUTE_INT_RO("lodSwitchCount", KX_Scene, m_lodSwitchCount),
     KX_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -2606,6 +2828,221 @@ KX_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+enum { TRANSFORM_POSITION = 0, TRANSFORM_ORIENTATION, TRANSFORM_SCALE, TRANSFORM_MAX };
+
+static void ReleaseTransformBuffers(Py_buffer views[TRANSFORM_MAX])
+{
+  for (unsigned short i = 0; i < TRANSFORM_MAX; ++i) {
+    if (views[i].obj) {
+      PyBuffer_Release(&views[i]);
+    }
+  }
+}
+
+/** Convert the arguments of the bulk transform methods: a sequence of objects and a float buffer
+ * per transform, views[i].obj is null for the omitted buffers.
+ */
+static bool ConvertPythonToTransforms(SCA_LogicManager *logicmgr,
+                                      PyObject *args,
+                                      PyObject *kwds,
+                                      const char *format,
+                                      bool writable,
+                                      const char *error_prefix,
+                                      std::vector<KX_GameObject *> &objects,
+                                      Py_buffer views[TRANSFORM_MAX])
+{
+  static const char *kwlist[] = {"objects", "positions", "orientations", "scales", nullptr};
+  static const char *names[TRANSFORM_MAX] = {"positions", "orientations", "scales"};
+  static const unsigned short sizes[TRANSFORM_MAX] = {3, 9, 3};
+
+  PyObject *pyobjects;
+  PyObject *pybuffers[TRANSFORM_MAX] = {Py_None, Py_None, Py_None};
+
+  if (!PyArg_ParseTupleAndKeywords(args,
+                                   kwds,
+                                   format,
+                                   const_cast<char **>(kwlist),
+                                   &pyobjects,
+                                   &pybuffers[TRANSFORM_POSITION],
+                                   &pybuffers[TRANSFORM_ORIENTATION],
+                                   &pybuffers[TRANSFORM_SCALE])) {
+    return false;
+  }
+
+  PyObject *sequence = PySequence_Fast(pyobjects, "expected a sequence of KX_GameObject");
+  if (!sequence) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence);
+  PyObject **items = PySequence_Fast_ITEMS(sequence);
+  objects.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    if (!ConvertPythonToGameObject(logicmgr, items[i], &objects[i], false, error_prefix)) {
+      Py_DECREF(sequence);
+      return false;
+    }
+  }
+  Py_DECREF(sequence);
+
+  for (unsigned short i = 0; i < TRANSFORM_MAX; ++i) {
+    views[i].obj = nullptr;
+  }
+
+  for (unsigned short i = 0; i < TRANSFORM_MAX; ++i) {
+    if (pybuffers[i] == Py_None) {
+      continue;
+    }
+
+    if (!PyFloatBufferGet(pybuffers[i], &views[i], writable, sizes[i], error_prefix)) {
+      views[i].obj = nullptr;
+      ReleaseTransformBuffers(views);
+      return false;
+    }
+
+    if (views[i].len != (Py_ssize_t)(size * sizes[i] * sizeof(float))) {
+      PyErr_Format(PyExc_ValueError,
+                   "%s, %s must contain %u floats per object",
+                   error_prefix,
+                   names[i],
+                   sizes[i]);
+      ReleaseTransformBuffers(views);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene,
+                   getWorldTransforms,
+                   "getWorldTransforms(objects, positions=None, orientations=None, scales=None)\n"
+                   "Copy the world transform of the objects into writable float buffers.\n")
+{
+  std::vector<KX_GameObject *> objects;
+  Py_buffer views[TRANSFORM_MAX];
+  if (!ConvertPythonToTransforms(m_logicmgr,
+                                 args,
+                                 kwds,
+                                 "O|OOO:getWorldTransforms",
+                                 true,
+                                 "scene.getWorldTransforms(objects, ...): KX_Scene",
+                                 objects,
+                                 views)) {
+    return nullptr;
+  }
+
+  float *positions = (float *)views[TRANSFORM_POSITION].buf;
+  float *orientations = (float *)views[TRANSFORM_ORIENTATION].buf;
+  float *scales = (float *)views[TRANSFORM_SCALE].buf;
+
+  for (KX_GameObject *gameobj : objects) {
+    if (positions) {
+      gameobj->NodeGetWorldPosition().getValue(positions);
+      positions += 3;
+    }
+    if (orientations) {
+      // Row major like the mathutils matrices.
+      const MT_Matrix3x3 &orientation = gameobj->NodeGetWorldOrientation();
+      for (unsigned short row = 0; row < 3; ++row) {
+        for (unsigned short col = 0; col < 3; ++col) {
+          *orientations++ = orientation[row][col];
+        }
+      }
+    }
+    if (scales) {
+      gameobj->NodeGetWorldScaling().getValue(scales);
+      scales += 3;
+    }
+  }
+
+  ReleaseTransformBuffers(views);
+
+  Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC(KX_Scene,
+                   setWorldTransforms,
+                   "setWorldTransforms(objects, positions=None, orientations=None, scales=None)\n"
+                   "Set the world transform of the objects from float buffers.\n")
+{
+  std::vector<KX_GameObject *> objects;
+  Py_buffer views[TRANSFORM_MAX];
+  if (!ConvertPythonToTransforms(m_logicmgr,
+                                 args,
+                                 kwds,
+                                 "O|OOO:setWorldTransforms",
+                                 false,
+                                 "scene.setWorldTransforms(objects, ...): KX_Scene",
+                                 objects,
+                                 views)) {
+    return nullptr;
+  }
+
+  const float *positions = (const float *)views[TRANSFORM_POSITION].buf;
+  const float *orientations = (const float *)views[TRANSFORM_ORIENTATION].buf;
+  const float *scales = (const float *)views[TRANSFORM_SCALE].buf;
+
+  for (KX_GameObject *gameobj : objects) {
+    if (positions) {
+      gameobj->NodeSetWorldPosition(MT_Vector3(positions));
+      positions += 3;
+    }
+    if (orientations) {
+      const float *o = orientations;
+      gameobj->NodeSetGlobalOrientation(
+          MT_Matrix3x3(o[0], o[1], o[2], o[3], o[4], o[5], o[6], o[7], o[8]));
+      orientations += 9;
+    }
+    if (scales) {
+      gameobj->NodeSetWorldScale(MT_Vector3(scales));
+      scales += 3;
+    }
+    // Update once for all the transforms and in order, children set after their parent use its
+    // new transform.
+    gameobj->NodeUpdateGS(0.0f);
+    gameobj->GetSGNode()->ResetPreviousWorldTransform();
+  }
+
+  ReleaseTransformBuffers(views);
+
+  Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC_NOARGS(KX_Scene,
+                          saveSnapshot,
+                          "saveSnapshot()\n"
+                          "Save the state of the objects, return the snapshot as bytes.\n")
+{
+  std::vector<unsigned char> data;
+  SaveSnapshot(data);
+
+  return PyBytes_FromStringAndSize((const char *)data.data(), data.size());
+}
+
+KX_PYMETHODDEF_DOC_O(KX_Scene,
+                     restoreSnapshot,
+                     "restoreSnapshot(data)\n"
+                     "Restore the state of the objects saved in a snapshot,\n"
+                     "return the number of restored objects.\n")
+{
+  Py_buffer view;
+  if (PyObject_GetBuffer(value, &view, PyBUF_SIMPLE) == -1) {
+    return nullptr;
+  }
+
+  const int numRestored = RestoreSnapshot((const unsigned char *)view.buf, view.len);
+  PyBuffer_Release(&view);
+
+  if (numRestored == -1) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.restoreSnapshot(data): KX_Scene, data is not a valid snapshot");
+    return nullptr;
+  }
+
+  return PyLong_FromLong(numRestored);
+}
+
 /* Matches python dict.get(key, [default]) */
 KX_PYMETHODDEF_DOC(KX_Scene, get, "")
 {
@@ -70,6 +70,8 @@ class KX_Camera;
 class KX_FontObject;
 class KX_GameObject;
 class KX_LightObject;
+class KX_LodLevel;
+class KX_NavMeshObject;
 class RAS_MeshObject;
 class RAS_BucketManager;
 class RAS_MaterialBucket;
@@ -85,6 +87,7 @@ class btCollisionShape;
 class BL_BlenderSceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
+class KX_ActivityGrid;
 struct TaskPool;
 
 /*********EEVEE INTEGRATION************/
@@ -107,6 +110,21 @@ class KX_Scene : public CValue, public SCA_IScene {
     double curtime;
   };
 
+  /// Objects owning a lod manager and their data used to compute the lod levels.
+  struct LodData {
+    std::vector<KX_GameObject *> objects;
+    /// Object positions stored by component to vectorize the distance computation.
+    std::vector<float> positions[3];
+    /// Squared distances to the camera scaled by the camera lod factor.
+    std::vector<float> distances;
+    /// New levels of the objects, nullptr if unchanged.
+    std::vector<KX_LodLevel *> levels;
+    /// Number of objects in the scene when the lod object list was built.
+    int numSceneObjects;
+    /// True when the lod object list must be rebuilt.
+    bool invalid;
+  };
+
  private:
   Py_Header
 
@@ -159,6 +177,8 @@ class KX_Scene : public CValue, public SCA_IScene {
   CListValue<KX_Camera> *m_cameralist;
   /// The set of fonts for this scene
   CListValue<KX_FontObject> *m_fontlist;
+  /// Navigation meshes with pending path requests.
+  std::vector<KX_NavMeshObject *> m_pathQueryNavMeshes;
 
   SG_QList m_sghead;  // list of nodes that needs scenegraph update
                       // the Dlist is not object that must be updated
@@ -255,6 +275,11 @@ class KX_Scene : public CValue, public SCA_IScene {
    */
   bool m_activity_culling;
 
+  /**
+   * Spatial grid of the objects used by the activity culling.
+   */
+  KX_ActivityGrid *m_activityGrid;
+
   /**
    * Toggle to enable or disable culling via DBVT broadphase of Bullet.
    */
@@ -291,6 +316,10 @@ class KX_Scene : public CValue, public SCA_IScene {
   AnimationPoolData m_animationPoolData;
   TaskPool *m_animationPool;
 
+  LodData m_lodData;
+  /// Number of objects which changed of lod level during the last update.
+  int m_lodSwitchCount;
+
   /**
    * LOD Hysteresis settings
    */
@@ -314,6 +343,8 @@ class KX_Scene : public CValue, public SCA_IScene {
   bool m_isRuntime;  // Too lazy to put that in protected
   std::vector<Object *> m_hiddenObjectsDuringRuntime;
 
+  /// Evaluate the tagged updates of the scene depsgraph and add the evaluation to the profile.
+  void UpdateDepsgraph(struct Depsgraph *depsgraph, struct Main *bmain);
   void RenderAfterCameraSetup(KX_Camera *cam, bool is_overlay_pass);
   void RenderAfterCameraSetupImageRender(KX_Camera *cam,
                                          RAS_Rasterizer *rasty,
@@ -389,6 +420,20 @@ class KX_Scene : public CValue, public SCA_IScene {
   CListValue<KX_Camera> *GetCameraList() const;
   void SetCameraList(CListValue<KX_Camera> *camList);
   CListValue<KX_FontObject> *GetFontList() const;
+  /// Update the path requests of a navigation mesh at the end of the logic frames.
+  void AddPathQueryNavMesh(KX_NavMeshObject *navmesh);
+
+  /** Find the objects whose bounds intersect a frustum. The physics culling tree is used if the
+   * physics environment has one, else the bounding boxes of the objects are tested.
+   */
+  void GetObjectsInsideFrustum(const SG_Frustum &frustum, std::vector<KX_GameObject *> &objects);
+
+  /// Save the state of the objects in a binary snapshot, see KX_SceneSnapshot.
+  void SaveSnapshot(std::vector<unsigned char> &data);
+  /** Restore the state of the objects saved in a snapshot.
+   * \return The number of restored objects or -1 if the data is not a valid snapshot.
+   */
+  int RestoreSnapshot(const unsigned char *data, unsigned int size);
 
   /** Find the currently active camera. */
   KX_Camera *GetActiveCamera();
@@ -469,6 +514,10 @@ class KX_Scene : public CValue, public SCA_IScene {
 
   /// Update the mesh for objects based on level of detail settings
   void UpdateObjectLods(KX_Camera *cam /*, const KX_CullingNodeList& nodes*/);
+  /// Request to rebuild the list of objects using level of detail.
+  void InvalidateLodObjects();
+  /// Return the number of objects which changed of lod level during the last update.
+  int GetLodSwitchCount() const;
 
   // LoD Hysteresis functions
   void SetLodHysteresis(bool active);
@@ -479,11 +528,17 @@ class KX_Scene : public CValue, public SCA_IScene {
   // Update the activity box settings for objects in this scene, if needed.
   void UpdateObjectActivity(void);
 
+  /// Save the world transforms before a logic frame, they are interpolated by the render.
+  void SavePreviousTransforms();
+
   // Enable/disable activity culling.
   void SetActivityCulling(bool b);
 
   // Set the radius of the activity culling box.
   void SetActivityCullingRadius(float f);
+
+  // Notify the activity culling that the object transform changed.
+  void NotifyObjectMoved(KX_GameObject *gameobj);
   // use of DBVT tree for camera culling
   void SetDbvtCulling(bool b)
   {
@@ -547,6 +602,10 @@ class KX_Scene : public CValue, public SCA_IScene {
   KX_PYMETHOD_DOC(KX_Scene, replace);
   KX_PYMETHOD_DOC(KX_Scene, get);
   KX_PYMETHOD_DOC(KX_Scene, drawObstacleSimulation);
+  KX_PYMETHOD_DOC(KX_Scene, getWorldTransforms);
+  KX_PYMETHOD_DOC(KX_Scene, setWorldTransforms);
+  KX_PYMETHOD_DOC_NOARGS(KX_Scene, saveSnapshot);
+  KX_PYMETHOD_DOC_O(KX_Scene, restoreSnapshot);
 
   /* attributes */
   static PyObject *pyattr_get_name(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
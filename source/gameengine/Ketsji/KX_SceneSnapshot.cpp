@@ -0,0 +1,384 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_SceneSnapshot.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_SceneSnapshot.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "EXP_BoolValue.h"
+#include "EXP_FloatValue.h"
+#include "EXP_IntValue.h"
+#include "EXP_StringValue.h"
+#include "KX_GameObject.h"
+#include "KX_Scene.h"
+#include "SG_Node.h"
+
+/// Identifier and version of the snapshot data, the version changes with the layout.
+static const char SNAPSHOT_MAGIC[4] = {'B', 'G', 'S', 'S'};
+#define SNAPSHOT_VERSION 1
+
+KX_SceneSnapshot::KX_SceneSnapshot(KX_Scene *scene)
+    : m_scene(scene), m_writeData(nullptr), m_readData(nullptr), m_readSize(0), m_readOffset(0)
+{
+}
+
+KX_SceneSnapshot::~KX_SceneSnapshot()
+{
+}
+
+template <class Type> void KX_SceneSnapshot::Write(const Type &value)
+{
+  const unsigned char *bytes = (const unsigned char *)&value;
+  m_writeData->insert(m_writeData->end(), bytes, bytes + sizeof(Type));
+}
+
+void KX_SceneSnapshot::WriteString(const std::string &str)
+{
+  Write<unsigned int>(str.size());
+  m_writeData->insert(m_writeData->end(), str.begin(), str.end());
+}
+
+template <class Type> bool KX_SceneSnapshot::Read(Type &value)
+{
+  if (m_readSize - m_readOffset < sizeof(Type)) {
+    return false;
+  }
+
+  memcpy(&value, m_readData + m_readOffset, sizeof(Type));
+  m_readOffset += sizeof(Type);
+  return true;
+}
+
+bool KX_SceneSnapshot::ReadString(std::string &str)
+{
+  unsigned int size;
+  if (!Read(size) || m_readSize - m_readOffset < size) {
+    return false;
+  }
+
+  str.assign((const char *)m_readData + m_readOffset, size);
+  m_readOffset += size;
+  return true;
+}
+
+void KX_SceneSnapshot::WriteObject(KX_GameObject *gameobj, unsigned int rank)
+{
+  WriteString(gameobj->GetName());
+  Write(rank);
+  Write(gameobj->GetState());
+
+  const SG_Node *node = gameobj->GetSGNode();
+  float position[3];
+  float orientation[9];
+  float scale[3];
+  node->GetLocalPosition().getValue(position);
+  node->GetLocalOrientation().getValue3x3(orientation);
+  node->GetLocalScale().getValue(scale);
+  Write(position);
+  Write(orientation);
+  Write(scale);
+
+  PHY_IPhysicsController *controller = gameobj->GetPhysicsController();
+  Write<unsigned char>(controller != nullptr);
+  if (controller) {
+    PHY_DynamicsState dynamics;
+    controller->GetDynamicsState(dynamics);
+    Write(dynamics);
+  }
+
+  // Only the properties of basic types are saved, the count is written once they are known.
+  const unsigned int countOffset = m_writeData->size();
+  unsigned int numProperties = 0;
+  Write(numProperties);
+  for (const std::string &name : gameobj->GetPropertyNames()) {
+    CValue *prop = gameobj->GetProperty(name);
+    const unsigned char type = prop->GetValueType();
+    switch (type) {
+      case VALUE_INT_TYPE: {
+        WriteString(name);
+        Write(type);
+        Write(((CIntValue *)prop)->GetInt());
+        break;
+      }
+      case VALUE_FLOAT_TYPE: {
+        WriteString(name);
+        Write(type);
+        Write(((CFloatValue *)prop)->GetFloat());
+        break;
+      }
+      case VALUE_BOOL_TYPE: {
+        WriteString(name);
+        Write(type);
+        Write<unsigned char>(((CBoolValue *)prop)->GetBool());
+        break;
+      }
+      case VALUE_STRING_TYPE: {
+        WriteString(name);
+        Write(type);
+        WriteString(prop->GetText());
+        break;
+      }
+      default: {
+        continue;
+      }
+    }
+    ++numProperties;
+  }
+  memcpy(m_writeData->data() + countOffset, &numProperties, sizeof(numProperties));
+
+  std::vector<BL_ActionState> actions;
+  gameobj->GetActionStates(actions);
+  Write<unsigned int>(actions.size());
+  for (const BL_ActionState &action : actions) {
+    Write(action.layer);
+    WriteString(action.name);
+    Write(action.start);
+    Write(action.end);
+    Write(action.frame);
+    Write(action.blendin);
+    Write(action.blendframe);
+    Write(action.layerWeight);
+    Write(action.speed);
+    Write(action.priority);
+    Write(action.playMode);
+    Write(action.ipoFlags);
+    Write(action.blendMode);
+  }
+}
+
+bool KX_SceneSnapshot::ReadObject(ObjectState &state)
+{
+  unsigned char hasDynamics;
+  if (!ReadString(state.name) || !Read(state.rank) || !Read(state.logicState) ||
+      !Read(state.position) || !Read(state.orientation) || !Read(state.scale) ||
+      !Read(hasDynamics)) {
+    return false;
+  }
+
+  state.hasDynamics = hasDynamics;
+  if (state.hasDynamics && !Read(state.dynamics)) {
+    return false;
+  }
+
+  // Each property or action takes at least a byte, reject the counts bigger than the data.
+  unsigned int numProperties;
+  if (!Read(numProperties) || numProperties > m_readSize - m_readOffset) {
+    return false;
+  }
+  state.properties.resize(numProperties);
+  for (PropertyState &prop : state.properties) {
+    if (!ReadString(prop.name) || !Read(prop.type)) {
+      return false;
+    }
+
+    bool valid;
+    switch (prop.type) {
+      case VALUE_INT_TYPE: {
+        valid = Read(prop.intValue);
+        break;
+      }
+      case VALUE_FLOAT_TYPE: {
+        valid = Read(prop.floatValue);
+        break;
+      }
+      case VALUE_BOOL_TYPE: {
+        unsigned char value = 0;
+        valid = Read(value);
+        prop.intValue = value;
+        break;
+      }
+      case VALUE_STRING_TYPE: {
+        valid = ReadString(prop.stringValue);
+        break;
+      }
+      default: {
+        valid = false;
+        break;
+      }
+    }
+
+    if (!valid) {
+      return false;
+    }
+  }
+
+  unsigned int numActions;
+  if (!Read(numActions) || numActions > m_readSize - m_readOffset) {
+    return false;
+  }
+  state.actions.resize(numActions);
+  for (BL_ActionState &action : state.actions) {
+    if (!Read(action.layer) || !ReadString(action.name) || !Read(action.start) ||
+        !Read(action.end) || !Read(action.frame) || !Read(action.blendin) ||
+        !Read(action.blendframe) || !Read(action.layerWeight) || !Read(action.speed) ||
+        !Read(action.priority) || !Read(action.playMode) || !Read(action.ipoFlags) ||
+        !Read(action.blendMode)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void KX_SceneSnapshot::RestoreObject(KX_GameObject *gameobj, const ObjectState &state)
+{
+  gameobj->SetState(state.logicState);
+
+  /* Only the modified transforms are set, setting the transform of a physics body wakes it up
+   * and turns a static body into a kinematic one.
+   */
+  const SG_Node *node = gameobj->GetSGNode();
+  float position[3];
+  float orientation[9];
+  float scale[3];
+  node->GetLocalPosition().getValue(position);
+  node->GetLocalOrientation().getValue3x3(orientation);
+  node->GetLocalScale().getValue(scale);
+
+  if (memcmp(position, state.position, sizeof(position)) != 0) {
+    gameobj->NodeSetLocalPosition(MT_Vector3(state.position));
+  }
+  if (memcmp(orientation, state.orientation, sizeof(orientation)) != 0) {
+    MT_Matrix3x3 mat;
+    mat.setValue3x3(state.orientation);
+    gameobj->NodeSetLocalOrientation(mat);
+  }
+  if (memcmp(scale, state.scale, sizeof(scale)) != 0) {
+    gameobj->NodeSetLocalScale(MT_Vector3(state.scale));
+  }
+  // The restored state is not a continuation of the rendered one.
+  gameobj->GetSGNode()->ResetPreviousWorldTransform();
+
+  PHY_IPhysicsController *controller = gameobj->GetPhysicsController();
+  if (controller && state.hasDynamics) {
+    controller->SetDynamicsState(state.dynamics);
+  }
+
+  for (const PropertyState &propState : state.properties) {
+    CValue *value;
+    switch (propState.type) {
+      case VALUE_INT_TYPE: {
+        value = new CIntValue(propState.intValue);
+        break;
+      }
+      case VALUE_FLOAT_TYPE: {
+        value = new CFloatValue(propState.floatValue);
+        break;
+      }
+      case VALUE_BOOL_TYPE: {
+        value = new CBoolValue(propState.intValue != 0);
+        break;
+      }
+      default: {
+        value = new CStringValue(propState.stringValue, "");
+        break;
+      }
+    }
+
+    // Keep the existing property as it can be referenced, e.g. by the timer properties manager.
+    CValue *prop = gameobj->GetProperty(propState.name);
+    if (prop && prop->GetValueType() == propState.type) {
+      prop->SetValue(value);
+    }
+    else {
+      gameobj->SetProperty(propState.name, value);
+    }
+    value->Release();
+  }
+
+  gameobj->SetActionStates(state.actions);
+}
+
+void KX_SceneSnapshot::Save(std::vector<unsigned char> &data)
+{
+  CListValue<KX_GameObject> *objects = m_scene->GetObjectList();
+
+  data.clear();
+  m_writeData = &data;
+
+  Write(SNAPSHOT_MAGIC);
+  Write<unsigned int>(SNAPSHOT_VERSION);
+  Write<unsigned int>(objects->GetCount());
+
+  std::unordered_map<std::string, unsigned int> ranks;
+  for (KX_GameObject *gameobj : objects) {
+    WriteObject(gameobj, ranks[gameobj->GetName()]++);
+  }
+
+  m_writeData = nullptr;
+}
+
+int KX_SceneSnapshot::Restore(const unsigned char *data, unsigned int size)
+{
+  m_readData = data;
+  m_readSize = size;
+  m_readOffset = 0;
+
+  char magic[4];
+  unsigned int version;
+  unsigned int numObjects;
+  if (!Read(magic) || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 || !Read(version) ||
+      version != SNAPSHOT_VERSION || !Read(numObjects) ||
+      numObjects > m_readSize - m_readOffset) {
+    return -1;
+  }
+
+  // Read all the objects before restoring any of them, invalid data must not restore anything.
+  std::vector<ObjectState> states;
+  states.reserve(numObjects);
+  for (unsigned int i = 0; i < numObjects; ++i) {
+    states.emplace_back();
+    if (!ReadObject(states.back())) {
+      return -1;
+    }
+  }
+
+  m_readData = nullptr;
+
+  std::unordered_map<std::string, std::vector<KX_GameObject *>> objectsByName;
+  for (KX_GameObject *gameobj : m_scene->GetObjectList()) {
+    objectsByName[gameobj->GetName()].push_back(gameobj);
+  }
+
+  int numRestored = 0;
+  for (const ObjectState &state : states) {
+    const auto it = objectsByName.find(state.name);
+    if (it == objectsByName.end() || state.rank >= it->second.size()) {
+      continue;
+    }
+
+    RestoreObject(it->second[state.rank], state);
+    ++numRestored;
+  }
+
+  // Propagate the restored local transforms to the world transforms of the hierarchies.
+  for (KX_GameObject *gameobj : m_scene->GetObjectList()) {
+    if (!gameobj->GetSGNode()->GetSGParent()) {
+      gameobj->NodeUpdateGS(0.0f);
+    }
+  }
+
+  return numRestored;
+}
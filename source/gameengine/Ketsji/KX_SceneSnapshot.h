@@ -0,0 +1,100 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_SceneSnapshot.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_SCENESNAPSHOT_H__
+#define __KX_SCENESNAPSHOT_H__
+
+#include <string>
+#include <vector>
+
+#include "BL_Action.h"
+#include "PHY_IPhysicsController.h"
+
+class KX_Scene;
+class KX_GameObject;
+
+/** Binary snapshot of the state of the objects of a scene.
+ * For each object it saves the local transform, the logic state, the velocities and sleeping
+ * state of the physics body, the game properties of basic types and the playing actions.
+ * The objects are identified by their name and their rank among the objects of the same name, the
+ * objects added or removed since the snapshot are not recreated or removed by a restore.
+ * The data is in the native byte order and is meant to be restored by the same build.
+ */
+class KX_SceneSnapshot {
+ private:
+  struct PropertyState {
+    std::string name;
+    unsigned char type;
+    long long intValue;
+    float floatValue;
+    std::string stringValue;
+  };
+
+  struct ObjectState {
+    std::string name;
+    unsigned int rank;
+    unsigned int logicState;
+    float position[3];
+    float orientation[9];
+    float scale[3];
+    bool hasDynamics;
+    PHY_DynamicsState dynamics;
+    std::vector<PropertyState> properties;
+    std::vector<BL_ActionState> actions;
+  };
+
+  KX_Scene *m_scene;
+
+  /// Data written by Save.
+  std::vector<unsigned char> *m_writeData;
+  /// Data read by Restore and read position.
+  const unsigned char *m_readData;
+  unsigned int m_readSize;
+  unsigned int m_readOffset;
+
+  template <class Type> void Write(const Type &value);
+  void WriteString(const std::string &str);
+  void WriteObject(KX_GameObject *gameobj, unsigned int rank);
+
+  /// \return False if the value is past the end of the data.
+  template <class Type> bool Read(Type &value);
+  bool ReadString(std::string &str);
+  bool ReadObject(ObjectState &state);
+
+  void RestoreObject(KX_GameObject *gameobj, const ObjectState &state);
+
+ public:
+  KX_SceneSnapshot(KX_Scene *scene);
+  ~KX_SceneSnapshot();
+
+  /// Save the state of the scene objects, the data is replaced.
+  void Save(std::vector<unsigned char> &data);
+  /** Restore the state of the scene objects.
+   * \return The number of restored objects or -1 if the data is not a valid snapshot,
+   * nothing is restored in this case.
+   */
+  int Restore(const unsigned char *data, unsigned int size);
+};
+
+#endif  // __KX_SCENESNAPSHOT_H__
@@ -103,3 +103,8 @@ double KX_TimeCategoryLogger::GetAverage()
 
   return time;
 }
+
+const KX_TimeLogger &KX_TimeCategoryLogger::GetLogger(TimeCategory tc) const
+{
+  return m_loggers.at(tc);
+}
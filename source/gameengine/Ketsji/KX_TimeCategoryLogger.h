@@ -115,6 +115,11 @@ class KX_TimeCategoryLogger {
    */
   double GetAverage();
 
+  /**
+   * Returns the logger of a category, used to read the statistics of all the measurements.
+   */
+  const KX_TimeLogger &GetLogger(TimeCategory tc) const;
+
  protected:
   /// Storage for the loggers.
   TimeLoggerMap m_loggers;
@@ -31,8 +31,16 @@
 
 #include "KX_TimeLogger.h"
 
+#include <algorithm>
+
 KX_TimeLogger::KX_TimeLogger(unsigned int maxNumMeasurements)
-    : m_maxNumMeasurements(maxNumMeasurements), m_logStart(0), m_logging(false)
+    : m_maxNumMeasurements(maxNumMeasurements),
+      m_logStart(0),
+      m_logging(false),
+      m_total(0.0),
+      m_minimum(0.0),
+      m_maximum(0.0),
+      m_numTotalMeasurements(0)
 {
 }
 
@@ -77,6 +85,20 @@ void KX_TimeLogger::NextMeasurement(double now)
   // End logging to current measurement
   EndLog(now);
 
+  // Accumulate the finished measurement in the statistics
+  if (m_measurements.size() > 0) {
+    const double m = m_measurements[0];
+    if (m_numTotalMeasurements == 0) {
+      m_minimum = m_maximum = m;
+    }
+    else {
+      m_minimum = std::min(m_minimum, m);
+      m_maximum = std::max(m_maximum, m);
+    }
+    m_total += m;
+    ++m_numTotalMeasurements;
+  }
+
   // Add a new measurement at the front
   double m = 0.0;
   m_measurements.push_front(m);
@@ -103,3 +125,23 @@ double KX_TimeLogger::GetAverage() const
 
   return avg;
 }
+
+double KX_TimeLogger::GetTotal() const
+{
+  return m_total;
+}
+
+double KX_TimeLogger::GetMinimum() const
+{
+  return m_minimum;
+}
+
+double KX_TimeLogger::GetMaximum() const
+{
+  return m_maximum;
+}
+
+unsigned int KX_TimeLogger::GetNumTotalMeasurements() const
+{
+  return m_numTotalMeasurements;
+}
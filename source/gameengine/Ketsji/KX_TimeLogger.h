@@ -88,6 +88,15 @@ class KX_TimeLogger {
    */
   double GetAverage() const;
 
+  /// Returns the sum of all the finished measurements since the logger creation.
+  double GetTotal() const;
+  /// Returns the shortest finished measurement.
+  double GetMinimum() const;
+  /// Returns the longest finished measurement.
+  double GetMaximum() const;
+  /// Returns the number of finished measurements since the logger creation.
+  unsigned int GetNumTotalMeasurements() const;
+
  protected:
   /// Storage for the measurements.
   std::deque<double> m_measurements;
@@ -100,6 +109,12 @@ class KX_TimeLogger {
 
   /// State of logging.
   bool m_logging;
+
+  /// Statistics of all the finished measurements, not limited by m_maxNumMeasurements.
+  double m_total;
+  double m_minimum;
+  double m_maximum;
+  unsigned int m_numTotalMeasurements;
 };
 
 #endif  // __KX_TIMELOGGER_H__
@@ -30,6 +30,9 @@
 
 #include "LA_Launcher.h"
 
+#include <algorithm>
+#include <fstream>
+
 #include "../../blender/python/BPY_extern.h"
 #include "BKE_idprop.h"
 #include "BKE_layer.h"
@@ -47,6 +50,7 @@
 #include "CM_Message.h"
 #include "DEV_EventConsumer.h"
 #include "DEV_InputDevice.h"
+#include "DEV_InputRecord.h"
 #include "DEV_Joystick.h"
 #include "GHOST_ISystem.h"
 #include "GHOST_IWindow.h"
@@ -85,6 +89,7 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_kxsystem(nullptr),
       m_inputDevice(nullptr),
       m_eventConsumer(nullptr),
+      m_inputRecord(nullptr),
       m_canvas(nullptr),
       m_rasterizer(nullptr),
       m_converter(nullptr),
@@ -99,6 +104,8 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_context(C)
 {
   m_pythonConsole.use = false;
+  m_benchmark.numFrames = 0;
+  m_benchmark.frame = 0;
 }
 
 LA_Launcher::~LA_Launcher()
@@ -145,13 +152,32 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  bool interpolateTransforms = (gm.flag & GAME_INTERPOLATE_TRANSFORMS) != 0;
+  const std::string recordInput = SYS_GetCommandLineString(syshandle, "record_input", "");
+  const std::string replayInput = SYS_GetCommandLineString(syshandle, "replay_input", "");
+  const int benchmarkFrames = SYS_GetCommandLineInt(syshandle, "benchmark_frames", 0);
+  const bool logAsync = (SYS_GetCommandLineInt(syshandle, "log_async", 0) != 0);
+  const bool logJson = (SYS_GetCommandLineInt(syshandle, "log_json", 0) != 0);
+  const int logRateLimit = SYS_GetCommandLineInt(syshandle, "log_rate_limit", 0);
+  const bool sparseDepsgraph = (SYS_GetCommandLineInt(syshandle, "depsgraph_sparse", 1) != 0);
+
+  CM_Logger::SetFormat(logJson ? CM_Logger::FORMAT_JSON : CM_Logger::FORMAT_TEXT);
+  if (logAsync) {
+    CM_Logger::StartAsync(std::max(logRateLimit, 0));
+  }
+
+  m_benchmark.numFrames = std::max(benchmarkFrames, 0);
+  m_benchmark.frame = 0;
+  m_benchmark.output = SYS_GetCommandLineString(syshandle, "benchmark_output", "");
 
   const KX_KetsjiEngine::FlagType flags = (KX_KetsjiEngine::FlagType)(
       (fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
       (frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
       (restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
+      (interpolateTransforms ? KX_KetsjiEngine::INTERPOLATE_TRANSFORMS : 0) |
       (properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
-      (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
+      (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0) |
+      (sparseDepsgraph ? KX_KetsjiEngine::SPARSE_DEPSGRAPH : 0));
 
   m_rasterizer = new RAS_Rasterizer();
 
@@ -190,8 +216,30 @@ void LA_Launcher::InitEngine()
 
   // Create the inputdevices.
   m_inputDevice = new DEV_InputDevice();
-  m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
-  m_system->addEventConsumer(m_eventConsumer);
+
+  if (!replayInput.empty()) {
+    m_inputRecord = new DEV_InputRecord(replayInput, DEV_InputRecord::MODE_REPLAY);
+  }
+  else if (!recordInput.empty()) {
+    m_inputRecord = new DEV_InputRecord(recordInput, DEV_InputRecord::MODE_RECORD);
+  }
+  if (m_inputRecord && !m_inputRecord->IsValid()) {
+    delete m_inputRecord;
+    m_inputRecord = nullptr;
+  }
+
+  if (m_inputRecord && m_inputRecord->GetMode() == DEV_InputRecord::MODE_REPLAY) {
+    // The replayed events replace the window events, send the ones recorded before the first
+    // frame.
+    m_inputRecord->ReadEvents(m_inputDevice);
+  }
+  else {
+    if (m_inputRecord) {
+      m_inputDevice->SetRecord(m_inputRecord);
+    }
+    m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
+    m_system->addEventConsumer(m_eventConsumer);
+  }
 
   // Create a ketsjisystem (only needed for timing and stuff).
   m_kxsystem = new LA_System();
@@ -220,6 +268,17 @@ void LA_Launcher::InitEngine()
   m_ketsjiEngine->SetFlag(flags, true);
   m_ketsjiEngine->SetRender(true);
 
+  if (m_inputRecord && m_inputRecord->GetMode() == DEV_InputRecord::MODE_REPLAY) {
+    // The clock is given by the record for each frame, and steps as it was recorded.
+    m_ketsjiEngine->SetFlag(KX_KetsjiEngine::USE_EXTERNAL_CLOCK, true);
+    m_ketsjiEngine->SetFlag(KX_KetsjiEngine::EXTERNAL_CLOCK_TIMESTEP, true);
+    CM_Message("Replaying input record \"" << replayInput << "\"");
+  }
+  else if (m_benchmark.numFrames > 0) {
+    // The clock is advanced by the launcher to not depend on the machine speed.
+    m_ketsjiEngine->SetFlag(KX_KetsjiEngine::USE_EXTERNAL_CLOCK, true);
+  }
+
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
   m_ketsjiEngine->SetMaxPhysicsFrame(gm.maxphystep);
@@ -277,6 +336,10 @@ void LA_Launcher::ExitEngine()
   DEV_Joystick::Close();
   m_ketsjiEngine->StopEngine();
 
+  if (m_benchmark.numFrames > 0) {
+    WriteBenchmark();
+  }
+
 #ifdef WITH_PYTHON
 
   /* Clears the dictionary by hand:
@@ -326,6 +389,11 @@ void LA_Launcher::ExitEngine()
   if (m_eventConsumer) {
     m_system->removeEventConsumer(m_eventConsumer);
     delete m_eventConsumer;
+    m_eventConsumer = nullptr;
+  }
+  if (m_inputRecord) {
+    delete m_inputRecord;
+    m_inputRecord = nullptr;
   }
   if (m_rasterizer) {
     delete m_rasterizer;
@@ -348,6 +416,9 @@ void LA_Launcher::ExitEngine()
   AUD_Device_stopAll(BKE_sound_get_device());
 #endif  // WITH_AUDASPACE
 
+  // Write the pending messages, the logger is started again with the next game.
+  CM_Logger::StopAsync();
+
   m_exitRequested = KX_ExitRequest::NO_REQUEST;
 }
 
@@ -443,9 +514,34 @@ bool LA_Launcher::EngineNextFrame()
   // Check if we can create a python console debugging.
   HandlePythonConsole();
 #endif
+  const bool replayInput = (m_inputRecord &&
+                            m_inputRecord->GetMode() == DEV_InputRecord::MODE_REPLAY);
+  if (replayInput) {
+    double clockTime;
+    if (!m_inputRecord->ReadFrame(clockTime)) {
+      CM_Message("Input replay finished after " << m_inputRecord->GetNumFrames() << " frames");
+      m_exitRequested = KX_ExitRequest::OUTSIDE;
+      return false;
+    }
+    m_ketsjiEngine->SetClockTime(clockTime);
+  }
+  else if (m_benchmark.numFrames > 0) {
+    m_ketsjiEngine->SetClockTime(m_ketsjiEngine->GetClockTime() +
+                                 m_ketsjiEngine->GetTimeScale() / m_ketsjiEngine->GetTicRate());
+  }
+
   // Kick the engine.
   bool renderFrame = m_ketsjiEngine->NextFrame();
 
+  if (m_benchmark.numFrames > 0 && ++m_benchmark.frame == m_benchmark.numFrames) {
+    m_ketsjiEngine->RequestExit(KX_ExitRequest::QUIT_GAME);
+  }
+
+  if (m_inputRecord && !replayInput) {
+    // Events dispatched after this point are used in the next frame.
+    m_inputRecord->WriteFrame(m_ketsjiEngine->GetClockTime());
+  }
+
   // First check if we want to exit.
   m_exitRequested = m_ketsjiEngine->GetExitCode();
   m_exitString = m_ketsjiEngine->GetExitString();
@@ -459,6 +555,10 @@ bool LA_Launcher::EngineNextFrame()
   m_system->processEvents(false);
   m_system->dispatchEvents();
 
+  if (replayInput) {
+    m_inputRecord->ReadEvents(m_inputDevice);
+  }
+
   if (m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_ketsjiEngine->GetExitKey())
           .Find(SCA_InputEvent::ACTIVE) &&
       !m_inputDevice->GetHookExitKey()) {
@@ -476,6 +576,24 @@ bool LA_Launcher::EngineNextFrame()
   return (m_exitRequested == KX_ExitRequest::NO_REQUEST);
 }
 
+void LA_Launcher::WriteBenchmark()
+{
+  if (m_benchmark.output.empty()) {
+    m_ketsjiEngine->WriteProfileJson(std::cout);
+    return;
+  }
+
+  std::ofstream stream(m_benchmark.output);
+  if (!stream) {
+    CM_Error("failed to write benchmark output \"" << m_benchmark.output << "\"");
+    return;
+  }
+
+  m_ketsjiEngine->WriteProfileJson(stream);
+  CM_Message("Benchmark of " << m_benchmark.frame << " frames written to \""
+                             << m_benchmark.output << "\"");
+}
+
 void LA_Launcher::EngineMainLoop()
 {
 #ifdef WITH_PYTHON
@@ -41,6 +41,7 @@ class KX_NetworkMessageManager;
 class RAS_ICanvas;
 class DEV_EventConsumer;
 class DEV_InputDevice;
+class DEV_InputRecord;
 class GHOST_ISystem;
 struct Scene;
 struct Main;
@@ -68,6 +69,8 @@ class LA_Launcher {
   /// The game engine's input device abstraction.
   DEV_InputDevice *m_inputDevice;
   DEV_EventConsumer *m_eventConsumer;
+  /// Optional record or replay of the input events.
+  DEV_InputRecord *m_inputRecord;
   /// The game engine's canvas abstraction.
   RAS_ICanvas *m_canvas;
   /// The rasterizer.
@@ -106,6 +109,17 @@ class LA_Launcher {
     std::vector<SCA_IInputDevice::SCA_EnumInputs> keys;
   } m_pythonConsole;
 
+  /// Run of a fixed number of frames with a clock advanced of one logic tic per frame.
+  struct Benchmark {
+    unsigned int numFrames;
+    unsigned int frame;
+    /// File receiving the JSON profile statistics, standard output if empty.
+    std::string output;
+  } m_benchmark;
+
+  /// Write the profile statistics of the benchmark run.
+  void WriteBenchmark();
+
 #ifdef WITH_PYTHON
   void HandlePythonConsole();
 #endif  // WITH_PYTHON
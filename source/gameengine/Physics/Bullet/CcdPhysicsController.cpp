@@ -823,12 +823,24 @@ bool CcdPhysicsController::SynchronizeMotionStates(float time)
     m_MotionState->CalculateWorldTransformations();
   }
 
-  const MT_Vector3 &scale = m_MotionState->GetWorldScaling();
-  GetCollisionShape()->setLocalScaling(ToBullet(scale));
+  SynchronizeScaling();
 
   return true;
 }
 
+void CcdPhysicsController::SynchronizeScaling()
+{
+  btCollisionShape *shape = GetCollisionShape();
+  if (!shape || GetSoftBody()) {
+    return;
+  }
+
+  const btVector3 scale = ToBullet(m_MotionState->GetWorldScaling());
+  if (shape->getLocalScaling() != scale) {
+    shape->setLocalScaling(scale);
+  }
+}
+
 /**
  * WriteMotionStateToDynamics synchronizes dynas, kinematic and deformable entities (and do 'late
  * binding')
@@ -1375,6 +1387,44 @@ void CcdPhysicsController::SetActive(bool active)
 {
 }
 
+void CcdPhysicsController::GetDynamicsState(PHY_DynamicsState &state)
+{
+  const btRigidBody *body = GetRigidBody();
+  for (unsigned short i = 0; i < 3; ++i) {
+    state.linearVelocity[i] = body ? body->getLinearVelocity()[i] : 0.0f;
+    state.angularVelocity[i] = body ? body->getAngularVelocity()[i] : 0.0f;
+  }
+
+  if (m_object) {
+    state.activationState = m_object->getActivationState();
+    state.deactivationTime = m_object->getDeactivationTime();
+  }
+  else {
+    state.activationState = ACTIVE_TAG;
+    state.deactivationTime = 0.0f;
+  }
+}
+
+void CcdPhysicsController::SetDynamicsState(const PHY_DynamicsState &state)
+{
+  if (!m_object) {
+    return;
+  }
+
+  btRigidBody *body = GetRigidBody();
+  // Unlike SetLinearVelocity, don't turn the static objects into kinematic ones.
+  if (body && !body->isStaticOrKinematicObject()) {
+    body->setLinearVelocity(btVector3(
+        state.linearVelocity[0], state.linearVelocity[1], state.linearVelocity[2]));
+    body->setAngularVelocity(btVector3(
+        state.angularVelocity[0], state.angularVelocity[1], state.angularVelocity[2]));
+    body->clearForces();
+  }
+
+  m_object->forceActivationState(state.activationState);
+  m_object->setDeactivationTime(state.deactivationTime);
+}
+
 float CcdPhysicsController::GetLinearDamping() const
 {
   const btRigidBody *body = GetRigidBody();
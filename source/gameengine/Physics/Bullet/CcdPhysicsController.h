@@ -654,6 +654,9 @@ class CcdPhysicsController : public PHY_IPhysicsController {
    */
   virtual bool SynchronizeMotionStates(float time);
 
+  /// Copy the world scale of the motion state to the collision shape if it changed.
+  void SynchronizeScaling();
+
   /**
    * Called for every physics simulation step. Use this method for
    * things like limiting linear and angular velocity.
@@ -694,6 +697,9 @@ class CcdPhysicsController : public PHY_IPhysicsController {
   virtual void Jump();
   virtual void SetActive(bool active);
 
+  virtual void GetDynamicsState(PHY_DynamicsState &state);
+  virtual void SetDynamicsState(const PHY_DynamicsState &state);
+
   virtual float GetLinearDamping() const;
   virtual float GetAngularDamping() const;
   virtual void SetLinearDamping(float damping);
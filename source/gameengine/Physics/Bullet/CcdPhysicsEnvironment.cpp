@@ -749,17 +749,37 @@ void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
   }
 }
 
+void CcdPhysicsEnvironment::UpdateActiveControllers(bool syncScaling)
+{
+  m_activeControllers.clear();
+
+  const btCollisionObjectArray &objects = m_dynamicsWorld->getCollisionObjectArray();
+  for (int i = 0, size = objects.size(); i < size; ++i) {
+    btCollisionObject *object = objects[i];
+    CcdPhysicsController *ctrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+    if (!ctrl) {
+      continue;
+    }
+    if (object->isActive()) {
+      m_activeControllers.push_back(ctrl);
+    }
+    else if (syncScaling) {
+      ctrl->SynchronizeScaling();
+    }
+  }
+}
+
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
   int i;
 
   // Update Bullet global variables.
   gDeactivationTime = m_deactivationTime;
   gContactBreakingThreshold = m_contactBreakingThreshold;
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
+  UpdateActiveControllers(true);
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
   }
 
   float subStep = timeStep / float(m_numTimeSubSteps);
@@ -768,16 +788,23 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
   // uncomment next line to see where Bullet spend its time (printf in console)
   // CProfileManager::dumpAll();
 
+  // The objects put to sleep by the step are synchronized a last time.
+  m_deactivatedControllers.clear();
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
+    if (!ctrl->GetCollisionObject()->isActive()) {
+      m_deactivatedControllers.push_back(ctrl);
+    }
+  }
+  UpdateActiveControllers(false);
+
   ProcessFhSprings(curTime, i * subStep);
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
+  }
+  for (CcdPhysicsController *ctrl : m_deactivatedControllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
   }
-
-  // for (it=m_controllers.begin(); it!=m_controllers.end(); it++)
-  //{
-  //	(*it)->SynchronizeMotionStates(timeStep);
-  //}
 
   for (i = 0; i < m_wrapperVehicles.size(); i++) {
     WrapperVehicle *veh = m_wrapperVehicles[i];
@@ -789,6 +816,12 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
   return true;
 }
 
+void CcdPhysicsEnvironment::GetNumBodies(unsigned int &numActive, unsigned int &numTotal) const
+{
+  numActive = m_activeControllers.size();
+  numTotal = m_controllers.size();
+}
+
 class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultCallback {
   btCollisionObject *m_owner;
   btCollisionObject *m_parent;
@@ -819,129 +852,138 @@ class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultC
 
 void CcdPhysicsEnvironment::ProcessFhSprings(double curTime, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
   const float step = interval * KX_GetActiveEngine()->GetTicRate();
+  // Ray always points down the z axis in world space.
+  const btVector3 rayDirLocal(0.0f, 0.0f, -10.0f);
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    CcdPhysicsController *ctrl = (*it);
+  /* Cast the rays of all the awake bodies with a spring before applying any spring, the rays only
+   * depend on the positions which are not modified by the springs. */
+  m_fhRays.resize(0);
+  for (CcdPhysicsController *ctrl : m_activeControllers) {
     btRigidBody *body = ctrl->GetRigidBody();
+    const CcdConstructionInfo &cci = ctrl->GetConstructionInfo();
 
-    if (body && (ctrl->GetConstructionInfo().m_do_fh || ctrl->GetConstructionInfo().m_do_rot_fh)) {
-      // re-implement SM_FhObject.cpp using btCollisionWorld::rayTest and info from
-      // ctrl->getConstructionInfo() send a ray from {0.0, 0.0, 0.0} towards {0.0, 0.0, -10.0}, in
-      // local coordinates
-      CcdPhysicsController *parentCtrl = ctrl->GetParentCtrl();
-      btRigidBody *parentBody = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
-      btRigidBody *cl_object = parentBody ? parentBody : body;
-
-      if (body->isStaticOrKinematicObject())
-        continue;
-
-      btVector3 rayDirLocal(0.0f, 0.0f, -10.0f);
-
-      // m_dynamicsWorld
-      // ctrl->GetRigidBody();
-      btVector3 rayFromWorld = body->getCenterOfMassPosition();
-      // btVector3	rayToWorld = rayFromWorld + body->getCenterOfMassTransform().getBasis() *
-      // rayDirLocal; ray always points down the z axis in world space...
-      btVector3 rayToWorld = rayFromWorld + rayDirLocal;
-
-      ClosestRayResultCallbackNotMe resultCallback(rayFromWorld, rayToWorld, body, parentBody);
-
-      m_dynamicsWorld->rayTest(rayFromWorld, rayToWorld, resultCallback);
-      if (resultCallback.hasHit()) {
-        // we hit this one: resultCallback.m_collisionObject;
-        CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
-            resultCallback.m_collisionObject->getUserPointer());
-
-        if (controller) {
-          if (controller->GetConstructionInfo().m_fh_distance < SIMD_EPSILON)
-            continue;
-
-          btRigidBody *hit_object = controller->GetRigidBody();
-          if (!hit_object)
-            continue;
-
-          CcdConstructionInfo &hitObjShapeProps = controller->GetConstructionInfo();
-
-          float distance = resultCallback.m_closestHitFraction * rayDirLocal.length() -
-                           ctrl->GetConstructionInfo().m_radius;
-          if (distance >= hitObjShapeProps.m_fh_distance)
-            continue;
-
-          // btVector3 ray_dir = cl_object->getCenterOfMassTransform().getBasis()*
-          // rayDirLocal.normalized();
-          btVector3 ray_dir = rayDirLocal.normalized();
-          btVector3 normal = resultCallback.m_hitNormalWorld;
-          normal.normalize();
-
-          if (ctrl->GetConstructionInfo().m_do_fh) {
-            btVector3 lspot = cl_object->getCenterOfMassPosition() +
-                              rayDirLocal * resultCallback.m_closestHitFraction;
-
-            lspot -= hit_object->getCenterOfMassPosition();
-            btVector3 rel_vel = cl_object->getLinearVelocity() -
-                                hit_object->getVelocityInLocalPoint(lspot);
-            btScalar rel_vel_ray = ray_dir.dot(rel_vel);
-            btScalar spring_extent = 1.0f - distance / hitObjShapeProps.m_fh_distance;
-
-            btScalar i_spring = spring_extent * hitObjShapeProps.m_fh_spring;
-            btScalar i_damp = rel_vel_ray * hitObjShapeProps.m_fh_damping;
-
-            cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
-                                         (-(i_spring + i_damp) * ray_dir) * step);
-            if (hitObjShapeProps.m_fh_normal) {
-              cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
-                                           (i_spring + i_damp) *
-                                               (normal - normal.dot(ray_dir) * ray_dir) * step);
-            }
+    if (!body || !(cci.m_do_fh || cci.m_do_rot_fh) || body->isStaticOrKinematicObject()) {
+      continue;
+    }
 
-            btVector3 lateral = rel_vel - rel_vel_ray * ray_dir;
+    // re-implement SM_FhObject.cpp using btCollisionWorld::rayTest and info from
+    // ctrl->getConstructionInfo() send a ray from {0.0, 0.0, 0.0} towards {0.0, 0.0, -10.0}, in
+    // local coordinates
+    CcdPhysicsController *parentCtrl = ctrl->GetParentCtrl();
+    btRigidBody *parentBody = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
 
-            if (ctrl->GetConstructionInfo().m_do_anisotropic) {
-              // Bullet basis contains no scaling/shear etc.
-              const btMatrix3x3 &lcs = cl_object->getCenterOfMassTransform().getBasis();
-              btVector3 loc_lateral = lateral * lcs;
-              const btVector3 &friction_scaling = cl_object->getAnisotropicFriction();
-              loc_lateral *= friction_scaling;
-              lateral = lcs * loc_lateral;
-            }
+    btVector3 rayFromWorld = body->getCenterOfMassPosition();
+    btVector3 rayToWorld = rayFromWorld + rayDirLocal;
 
-            btScalar rel_vel_lateral = lateral.length();
+    ClosestRayResultCallbackNotMe resultCallback(rayFromWorld, rayToWorld, body, parentBody);
 
-            if (rel_vel_lateral > SIMD_EPSILON) {
-              btScalar friction_factor = hit_object->getFriction();  // cl_object->getFriction();
+    m_dynamicsWorld->rayTest(rayFromWorld, rayToWorld, resultCallback);
+    if (!resultCallback.hasHit()) {
+      continue;
+    }
 
-              btScalar max_friction = friction_factor * btMax(btScalar(0.0), i_spring);
+    // we hit this one: resultCallback.m_collisionObject;
+    CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
+        resultCallback.m_collisionObject->getUserPointer());
+    if (!controller) {
+      continue;
+    }
 
-              btScalar rel_mom_lateral = rel_vel_lateral / cl_object->getInvMass();
+    FhRay &ray = m_fhRays.expand();
+    ray.ctrl = ctrl;
+    ray.object = parentBody ? parentBody : body;
+    ray.hitCtrl = controller;
+    ray.hitFraction = resultCallback.m_closestHitFraction;
+    ray.hitNormal = resultCallback.m_hitNormalWorld;
+  }
 
-              btVector3 friction = (rel_mom_lateral > max_friction) ?
-                                       -lateral * (max_friction / rel_vel_lateral) :
-                                       -lateral;
+  for (int i = 0, size = m_fhRays.size(); i < size; ++i) {
+    const FhRay &ray = m_fhRays[i];
+    CcdPhysicsController *ctrl = ray.ctrl;
+    CcdPhysicsController *controller = ray.hitCtrl;
+    btRigidBody *cl_object = ray.object;
 
-              cl_object->applyCentralImpulse(friction * step);
-            }
-          }
+    if (controller->GetConstructionInfo().m_fh_distance < SIMD_EPSILON)
+      continue;
 
-          if (ctrl->GetConstructionInfo().m_do_rot_fh) {
-            btVector3 up2 = cl_object->getWorldTransform().getBasis().getColumn(2);
+    btRigidBody *hit_object = controller->GetRigidBody();
+    if (!hit_object)
+      continue;
 
-            btVector3 t_spring = up2.cross(normal) * hitObjShapeProps.m_fh_spring;
-            btVector3 ang_vel = cl_object->getAngularVelocity();
+    CcdConstructionInfo &hitObjShapeProps = controller->GetConstructionInfo();
 
-            // only rotations that tilt relative to the normal are damped
-            ang_vel -= ang_vel.dot(normal) * normal;
+    float distance = ray.hitFraction * rayDirLocal.length() - ctrl->GetConstructionInfo().m_radius;
+    if (distance >= hitObjShapeProps.m_fh_distance)
+      continue;
 
-            btVector3 t_damp = ang_vel * hitObjShapeProps.m_fh_damping;
+    // btVector3 ray_dir = cl_object->getCenterOfMassTransform().getBasis()*
+    // rayDirLocal.normalized();
+    btVector3 ray_dir = rayDirLocal.normalized();
+    btVector3 normal = ray.hitNormal;
+    normal.normalize();
+
+    if (ctrl->GetConstructionInfo().m_do_fh) {
+      btVector3 lspot = cl_object->getCenterOfMassPosition() + rayDirLocal * ray.hitFraction;
+
+      lspot -= hit_object->getCenterOfMassPosition();
+      btVector3 rel_vel = cl_object->getLinearVelocity() -
+                          hit_object->getVelocityInLocalPoint(lspot);
+      btScalar rel_vel_ray = ray_dir.dot(rel_vel);
+      btScalar spring_extent = 1.0f - distance / hitObjShapeProps.m_fh_distance;
+
+      btScalar i_spring = spring_extent * hitObjShapeProps.m_fh_spring;
+      btScalar i_damp = rel_vel_ray * hitObjShapeProps.m_fh_damping;
+
+      cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
+                                   (-(i_spring + i_damp) * ray_dir) * step);
+      if (hitObjShapeProps.m_fh_normal) {
+        cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
+                                     (i_spring + i_damp) *
+                                         (normal - normal.dot(ray_dir) * ray_dir) * step);
+      }
 
-            cl_object->setAngularVelocity(cl_object->getAngularVelocity() +
-                                          (t_spring - t_damp) * step);
-          }
-        }
+      btVector3 lateral = rel_vel - rel_vel_ray * ray_dir;
+
+      if (ctrl->GetConstructionInfo().m_do_anisotropic) {
+        // Bullet basis contains no scaling/shear etc.
+        const btMatrix3x3 &lcs = cl_object->getCenterOfMassTransform().getBasis();
+        btVector3 loc_lateral = lateral * lcs;
+        const btVector3 &friction_scaling = cl_object->getAnisotropicFriction();
+        loc_lateral *= friction_scaling;
+        lateral = lcs * loc_lateral;
+      }
+
+      btScalar rel_vel_lateral = lateral.length();
+
+      if (rel_vel_lateral > SIMD_EPSILON) {
+        btScalar friction_factor = hit_object->getFriction();  // cl_object->getFriction();
+
+        btScalar max_friction = friction_factor * btMax(btScalar(0.0), i_spring);
+
+        btScalar rel_mom_lateral = rel_vel_lateral / cl_object->getInvMass();
+
+        btVector3 friction = (rel_mom_lateral > max_friction) ?
+                                 -lateral * (max_friction / rel_vel_lateral) :
+                                 -lateral;
+
+        cl_object->applyCentralImpulse(friction * step);
       }
     }
+
+    if (ctrl->GetConstructionInfo().m_do_rot_fh) {
+      btVector3 up2 = cl_object->getWorldTransform().getBasis().getColumn(2);
+
+      btVector3 t_spring = up2.cross(normal) * hitObjShapeProps.m_fh_spring;
+      btVector3 ang_vel = cl_object->getAngularVelocity();
+
+      // only rotations that tilt relative to the normal are damped
+      ang_vel -= ang_vel.dot(normal) * normal;
+
+      btVector3 t_damp = ang_vel * hitObjShapeProps.m_fh_damping;
+
+      cl_object->setAngularVelocity(cl_object->getAngularVelocity() + (t_spring - t_damp) * step);
+    }
   }
 }
 
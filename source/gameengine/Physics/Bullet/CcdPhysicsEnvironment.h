@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "BulletDynamics/ConstraintSolver/btContactSolverInfo.h"
+#include "LinearMath/btAlignedObjectArray.h"
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
 
@@ -96,6 +97,29 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   float m_angularDeactivationThreshold;
   float m_contactBreakingThreshold;
 
+  /// Ray cast of a FH spring, the springs are applied once all the rays are cast.
+  struct FhRay {
+    CcdPhysicsController *ctrl;
+    /// Body receiving the spring, the parent body for a compound child.
+    btRigidBody *object;
+    CcdPhysicsController *hitCtrl;
+    btScalar hitFraction;
+    btVector3 hitNormal;
+  };
+  btAlignedObjectArray<FhRay> m_fhRays;
+
+  /// Controllers of the awake collision objects, in the order of the dynamics world.
+  std::vector<CcdPhysicsController *> m_activeControllers;
+  /// Controllers of the collision objects put to sleep by the last simulation step.
+  std::vector<CcdPhysicsController *> m_deactivatedControllers;
+
+  /** Update the active controllers from the activation state of the collision objects.
+   * The sleeping objects are not moved by the simulation, their motion states and FH springs
+   * don't need to be processed.
+   * \param syncScaling Also synchronize the collision shape scale of the sleeping objects, the
+   * children of a scaled parent are only scaled by the scene graph and never woken up.
+   */
+  void UpdateActiveControllers(bool syncScaling);
   void ProcessFhSprings(double curTime, float timeStep);
 
  public:
@@ -137,6 +161,7 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval);
+  virtual void GetNumBodies(unsigned int &numActive, unsigned int &numTotal) const;
 
   /**
    * Called by Bullet for every physical simulation (sub)tick.
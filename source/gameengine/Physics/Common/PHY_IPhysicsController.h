@@ -45,6 +45,16 @@ class MT_Matrix3x3;
 class KX_GameObject;
 class RAS_MeshObject;
 
+/// Dynamics of a body saved and restored by the scene snapshots.
+struct PHY_DynamicsState {
+  /// World velocities.
+  float linearVelocity[3];
+  float angularVelocity[3];
+  /// Sleeping state and time spent under the sleeping thresholds.
+  int activationState;
+  float deactivationTime;
+};
+
 /**
  * PHY_IPhysicsController is the abstract simplified Interface to a physical object.
  * It contains the IMotionState and IDeformableMesh Interfaces.
@@ -113,6 +123,10 @@ class PHY_IPhysicsController : public PHY_IController {
 
   virtual void SetActive(bool active) = 0;
 
+  virtual void GetDynamicsState(PHY_DynamicsState &state) = 0;
+  /// Restore the velocities and the sleeping state, the transform is left unchanged.
+  virtual void SetDynamicsState(const PHY_DynamicsState &state) = 0;
+
   // reading out information from physics
   virtual MT_Vector3 GetLinearVelocity() = 0;
   virtual MT_Vector3 GetAngularVelocity() = 0;
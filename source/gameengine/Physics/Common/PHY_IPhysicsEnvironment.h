@@ -113,6 +113,12 @@ class PHY_IPhysicsEnvironment {
   }
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval) = 0;
+  /// Return the number of bodies awake during the last step and the total number of bodies.
+  virtual void GetNumBodies(unsigned int &numActive, unsigned int &numTotal) const
+  {
+    numActive = 0;
+    numTotal = 0;
+  }
   /// draw debug lines (make sure to call this during the render phase, otherwise lines are not
   /// drawn properly)
   virtual void DebugDrawWorld()
@@ -1,7 +1,13 @@
 #include "SG_Frustum.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "MT_Frustum.h"
 
+/// Number of shapes tested by plane at once in the batched tests.
+#define BATCH_SIZE 64
+
 SG_Frustum::SG_Frustum(const MT_Matrix4x4 &matrix) : m_matrix(matrix)
 {
   // Near clip plane
@@ -272,3 +278,78 @@ SG_Frustum::TestType SG_Frustum::FrustumInsideFrustum(const SG_Frustum &frustum)
 
   return INSIDE;
 }
+
+/* The batched tests loop over the planes then over a block of shapes, the inner loops have no
+ * branch and are vectorized by the compiler. */
+
+static void packMask(const unsigned char *outside,
+                     unsigned int first,
+                     unsigned int count,
+                     unsigned char *mask)
+{
+  for (unsigned int i = 0; i < count; ++i) {
+    const unsigned int index = first + i;
+    if (!outside[i]) {
+      mask[index >> 3] |= (1 << (index & 7));
+    }
+  }
+}
+
+void SG_Frustum::SpheresInsideFrustum(const float *spheres,
+                                      unsigned int count,
+                                      unsigned char *mask) const
+{
+  memset(mask, 0, (count + 7) / 8);
+
+  unsigned char outside[BATCH_SIZE];
+  for (unsigned int first = 0; first < count; first += BATCH_SIZE) {
+    const unsigned int size = std::min(count - first, (unsigned int)BATCH_SIZE);
+    const float *block = spheres + first * 4;
+    memset(outside, 0, size);
+
+    for (const MT_Vector4 &plane : m_planes) {
+      const float a = plane[0];
+      const float b = plane[1];
+      const float c = plane[2];
+      const float d = plane[3];
+      for (unsigned int i = 0; i < size; ++i) {
+        const float *sphere = block + i * 4;
+        const float distance = a * sphere[0] + b * sphere[1] + c * sphere[2] + d;
+        outside[i] |= (distance < -sphere[3]);
+      }
+    }
+
+    packMask(outside, first, size, mask);
+  }
+}
+
+void SG_Frustum::AabbsInsideFrustum(const float *boxes, unsigned int count, unsigned char *mask)
+    const
+{
+  memset(mask, 0, (count + 7) / 8);
+
+  unsigned char outside[BATCH_SIZE];
+  for (unsigned int first = 0; first < count; first += BATCH_SIZE) {
+    const unsigned int size = std::min(count - first, (unsigned int)BATCH_SIZE);
+    const float *block = boxes + first * 6;
+    memset(outside, 0, size);
+
+    for (const MT_Vector4 &plane : m_planes) {
+      const float a = plane[0];
+      const float b = plane[1];
+      const float c = plane[2];
+      const float d = plane[3];
+      // Offset of the box corner the most on the positive side of the plane.
+      const unsigned short ox = (a < 0.0f) ? 0 : 3;
+      const unsigned short oy = (b < 0.0f) ? 1 : 4;
+      const unsigned short oz = (c < 0.0f) ? 2 : 5;
+      for (unsigned int i = 0; i < size; ++i) {
+        const float *box = block + i * 6;
+        const float distance = a * box[ox] + b * box[oy] + c * box[oz] + d;
+        outside[i] |= (distance < 0.0f);
+      }
+    }
+
+    packMask(outside, first, size, mask);
+  }
+}
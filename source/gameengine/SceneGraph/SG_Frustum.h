@@ -30,6 +30,17 @@ class SG_Frustum {
                              const MT_Vector3 &max,
                              const MT_Matrix4x4 &mat) const;
   TestType FrustumInsideFrustum(const SG_Frustum &frustum) const;
+
+  /** Test many spheres, the bit i of the mask is set if the sphere i is not outside.
+   * \param spheres The center and radius of each sphere: x, y, z, radius.
+   * \param mask Bit mask of (count + 7) / 8 bytes, the first sphere is the lowest bit.
+   */
+  void SpheresInsideFrustum(const float *spheres, unsigned int count, unsigned char *mask) const;
+  /** Test many world AABBs, the bit i of the mask is set if the box i is not outside.
+   * Conservative as the test only uses the frustum planes.
+   * \param boxes The bounds of each box: min x, min y, min z, max x, max y, max z.
+   */
+  void AabbsInsideFrustum(const float *boxes, unsigned int count, unsigned char *mask) const;
 };
 
 #endif  // __SG_FRUSTUM_H__
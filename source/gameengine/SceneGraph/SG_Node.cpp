@@ -50,6 +50,7 @@ SG_Node::SG_Node(void *clientobj, void *clientinfo, SG_Callbacks &callbacks)
       m_worldPosition(0.0f, 0.0f, 0.0f),
       m_worldRotation(1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f),
       m_worldScaling(1.0f, 1.0f, 1.0f),
+      m_hasPrevWorldTransform(false),
       m_parent_relation(nullptr),
       m_familly(new SG_Familly()),
       m_modified(true),
@@ -70,6 +71,8 @@ SG_Node::SG_Node(const SG_Node &other)
       m_worldPosition(other.m_worldPosition),
       m_worldRotation(other.m_worldRotation),
       m_worldScaling(other.m_worldScaling),
+      // A replica has no previous logic state, it appears at its current transform.
+      m_hasPrevWorldTransform(false),
       m_parent_relation(other.m_parent_relation->NewCopy()),
       m_familly(new SG_Familly()),
       m_dirty(DIRTY_NONE)
@@ -560,6 +563,53 @@ MT_Transform SG_Node::GetWorldTransform() const
       m_worldRotation.scaled(m_worldScaling[0], m_worldScaling[1], m_worldScaling[2]));
 }
 
+void SG_Node::SavePreviousWorldTransform()
+{
+  m_prevWorldPosition = m_worldPosition;
+  m_prevWorldRotation = m_worldRotation.getRotation();
+  m_prevWorldScaling = m_worldScaling;
+  m_hasPrevWorldTransform = true;
+}
+
+MT_Transform SG_Node::GetInterpolatedWorldTransform(float factor) const
+{
+  if (!m_hasPrevWorldTransform || factor >= 1.0f) {
+    return GetWorldTransform();
+  }
+
+  const MT_Vector3 position = m_prevWorldPosition.lerp(m_worldPosition, factor);
+  const MT_Matrix3x3 rotation(m_prevWorldRotation.slerp(m_worldRotation.getRotation(), factor));
+  const MT_Vector3 scaling = m_prevWorldScaling.lerp(m_worldScaling, factor);
+
+  return MT_Transform(position, rotation.scaled(scaling[0], scaling[1], scaling[2]));
+}
+
+MT_Vector3 SG_Node::GetInterpolatedWorldPosition(float factor) const
+{
+  if (!m_hasPrevWorldTransform || factor >= 1.0f) {
+    return m_worldPosition;
+  }
+
+  return m_prevWorldPosition.lerp(m_worldPosition, factor);
+}
+
+MT_Matrix3x3 SG_Node::GetInterpolatedWorldOrientation(float factor) const
+{
+  if (!m_hasPrevWorldTransform || factor >= 1.0f) {
+    return m_worldRotation;
+  }
+
+  return MT_Matrix3x3(m_prevWorldRotation.slerp(m_worldRotation.getRotation(), factor));
+}
+
+void SG_Node::ResetPreviousWorldTransform()
+{
+  m_hasPrevWorldTransform = false;
+  for (SG_Node *child : m_children) {
+    child->ResetPreviousWorldTransform();
+  }
+}
+
 MT_Transform SG_Node::GetLocalTransform() const
 {
   return MT_Transform(
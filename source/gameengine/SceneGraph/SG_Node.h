@@ -335,6 +335,21 @@ class SG_Node : public SG_QList {
   MT_Transform GetWorldTransform() const;
   MT_Transform GetLocalTransform() const;
 
+  /// Save the world transform as the previous logic state used by the render interpolation.
+  void SavePreviousWorldTransform();
+  /** Interpolate the world transform between the previous and the current logic states.
+   * \param factor 0 for the previous state, 1 for the current state.
+   */
+  MT_Transform GetInterpolatedWorldTransform(float factor) const;
+  /// Interpolate only the world position, see GetInterpolatedWorldTransform.
+  MT_Vector3 GetInterpolatedWorldPosition(float factor) const;
+  /// Interpolate only the world orientation, see GetInterpolatedWorldTransform.
+  MT_Matrix3x3 GetInterpolatedWorldOrientation(float factor) const;
+  /** Drop the previous logic state of the node and its children, used after a discontinuous
+   * move (teleport, parenting, snapshot restore) so the render doesn't sweep through space.
+   */
+  void ResetPreviousWorldTransform();
+
   bool ComputeWorldTransforms(const SG_Node *parent, bool &parentUpdated);
 
   const std::shared_ptr<SG_Familly> &GetFamilly() const;
@@ -390,6 +405,12 @@ class SG_Node : public SG_QList {
   MT_Matrix3x3 m_worldRotation;
   MT_Vector3 m_worldScaling;
 
+  /// World transform of the previous logic frame, valid once saved.
+  MT_Vector3 m_prevWorldPosition;
+  MT_Quaternion m_prevWorldRotation;
+  MT_Vector3 m_prevWorldScaling;
+  bool m_hasPrevWorldTransform;
+
   std::unique_ptr<SG_ParentRelation> m_parent_relation;
 
   std::shared_ptr<SG_Familly> m_familly;
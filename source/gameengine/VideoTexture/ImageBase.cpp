@@ -30,6 +30,7 @@
 
 #include "ImageBase.h"
 
+#include <algorithm>
 #include <string.h>
 #include <structmember.h>
 #include <vector>
@@ -244,7 +245,9 @@ void ImageBase::init(short width, short height)
       // release previous and create new buffer
       if (m_image)
         MEM_freeN(m_image);
-      m_image = (unsigned int *)MEM_mallocN(m_imgSize * sizeof(unsigned int), "ImageBase init");
+      // aligned as the buffer can be exchanged with video frames (see swapImage)
+      m_image = (unsigned int *)MEM_mallocN_aligned(
+          m_imgSize * sizeof(unsigned int), 32, "ImageBase init");
     }
     // new image size
     m_size[0] = width;
@@ -254,6 +257,21 @@ void ImageBase::init(short width, short height)
   }
 }
 
+// exchange image buffer
+bool ImageBase::swapImage(unsigned int *&buffer, short width, short height)
+{
+  // the buffer can be used as is only if no conversion is needed
+  if (m_avail || m_exports > 0 || m_pyfilter != nullptr || m_scaleChange ||
+      width != m_size[0] || height != m_size[1])
+    return false;
+  // the caller gets the previous buffer which is at least as large as the new one
+  std::swap(m_image, buffer);
+  m_imgSize = width * height;
+  // image is available
+  m_avail = true;
+  return true;
+}
+
 // find source
 ImageSourceList::iterator ImageBase::findSource(const char *id)
 {
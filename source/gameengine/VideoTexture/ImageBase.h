@@ -184,6 +184,10 @@ class ImageBase {
   /// initialize image data
   void init(short width, short height);
 
+  /// exchange the image buffer with a buffer holding a ready to use image of the same size,
+  /// return false if the image must be converted instead (filter, scaling or exported buffer)
+  bool swapImage(unsigned int *&buffer, short width, short height);
+
   /// find source
   ImageSourceList::iterator findSource(const char *id);
 
@@ -206,6 +210,13 @@ class ImageBase {
 
   /// template for image conversion
   template<class FLT, class SRC> void convImage(FLT &filter, SRC srcBuff, short *srcSize)
+  {
+    convImage(filter, srcBuff, srcSize, m_flip);
+  }
+
+  /// template for image conversion with a given vertical flip
+  template<class FLT, class SRC>
+  void convImage(FLT &filter, SRC srcBuff, short *srcSize, bool flip)
   {
     // destination buffer
     unsigned int *dstBuff = m_image;
@@ -214,7 +225,7 @@ class ImageBase {
     // if no scaling is needed
     if (srcSize[0] == m_size[0] && srcSize[1] == m_size[1])
       // if flipping isn't required
-      if (!m_flip)
+      if (!flip)
         // copy bitmap
         for (short y = 0; y < m_size[1]; ++y)
           for (short x = 0; x < m_size[0]; ++x, ++dstBuff, srcBuff += pixSize)
@@ -235,7 +246,7 @@ class ImageBase {
       // interpolation accumulator
       int accHeight = srcSize[1] >> 1;
       // if flipping is required
-      if (m_flip)
+      if (flip)
         // go to last row of image
         srcBuff += srcSize[0] * (srcSize[1] - 1) * pixSize;
       // process image rows
@@ -258,7 +269,7 @@ class ImageBase {
               accWidth -= srcSize[0];
               // convert pixel
               *dstBuff = filter.convert(
-                  srcBuff, x, m_flip ? srcSize[1] - y - 1 : y, srcSize, pixSize);
+                  srcBuff, x, flip ? srcSize[1] - y - 1 : y, srcSize, pixSize);
               // next pixel
               ++dstBuff;
             }
@@ -271,7 +282,7 @@ class ImageBase {
           // move source pointer to next row
           srcBuff += pixSize * srcSize[0];
         // if y flipping is required
-        if (m_flip)
+        if (flip)
           // go to previous row of image
           srcBuff -= 2 * pixSize * srcSize[0];
       }
@@ -280,6 +291,12 @@ class ImageBase {
 
   // template for specific filter preprocessing
   template<class F, class SRC> void filterImage(F &filt, SRC srcBuff, short *srcSize)
+  {
+    filterImage(filt, srcBuff, srcSize, m_flip);
+  }
+
+  // template for specific filter preprocessing with a given vertical flip
+  template<class F, class SRC> void filterImage(F &filt, SRC srcBuff, short *srcSize, bool flip)
   {
     // find first filter in chain
     FilterBase *firstFilter = nullptr;
@@ -293,13 +310,13 @@ class ImageBase {
       // set specified filter as first in chain
       firstFilter->setPrevious(&pyFilt, false);
       // convert video image
-      convImage(*(m_pyfilter->m_filter), srcBuff, srcSize);
+      convImage(*(m_pyfilter->m_filter), srcBuff, srcSize, flip);
       // delete added filter
       firstFilter->setPrevious(nullptr, false);
     }
     // otherwise use given filter for conversion
     else
-      convImage(filt, srcBuff, srcSize);
+      convImage(filt, srcBuff, srcSize, flip);
     // source was processed
     m_avail = true;
   }
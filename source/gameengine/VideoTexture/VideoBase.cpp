@@ -52,7 +52,7 @@ void VideoBase::init(short width, short height)
 }
 
 // process video frame
-void VideoBase::process(BYTE *sample)
+void VideoBase::process(BYTE *sample, bool flip)
 {
   // if scale was changed
   if (m_scaleChange)
@@ -66,14 +66,14 @@ void VideoBase::process(BYTE *sample)
       case RGBA32: {
         FilterRGBA32 filtRGBA;
         // use filter object for format to convert image
-        filterImage(filtRGBA, sample, m_orgSize);
+        filterImage(filtRGBA, sample, m_orgSize, flip);
         // finish
         break;
       }
       case RGB24: {
         FilterRGB24 filtRGB;
         // use filter object for format to convert image
-        filterImage(filtRGB, sample, m_orgSize);
+        filterImage(filtRGB, sample, m_orgSize, flip);
         // finish
         break;
       }
@@ -81,7 +81,7 @@ void VideoBase::process(BYTE *sample)
         // use filter object for format to convert image
         FilterYV12 filtYUV;
         filtYUV.setBuffs(sample, m_orgSize);
-        filterImage(filtYUV, sample, m_orgSize);
+        filterImage(filtYUV, sample, m_orgSize, flip);
         // finish
         break;
       }
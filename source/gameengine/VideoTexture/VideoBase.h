@@ -169,7 +169,13 @@ class VideoBase : public ImageBase {
   void init(short width, short height);
 
   /// process source data
-  void process(BYTE *sample);
+  void process(BYTE *sample)
+  {
+    process(sample, m_flip);
+  }
+
+  /// process source data with a given vertical flip
+  void process(BYTE *sample, bool flip);
 };
 
 // python fuctions
@@ -39,6 +39,7 @@
 #    endif
 #  endif
 
+#  include <algorithm>
 #  include <stdint.h>
 #  include <string>
 
@@ -69,7 +70,8 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_frame(nullptr),
       m_frameDeinterlaced(nullptr),
       m_frameRGB(nullptr),
-      m_imgConvertCtx(nullptr),
+      m_chromaShift(0),
+      m_planeCount(0),
       m_deinterlace(false),
       m_preseek(0),
       m_videoStream(-1),
@@ -88,9 +90,10 @@ VideoFFmpeg::VideoFFmpeg(HRESULT *hRslt)
       m_stopThread(false),
       m_cacheStarted(false)
 {
-  // set video format
-  m_format = RGB24;
-  // force flip because ffmpeg always return the image in the wrong orientation for texture
+  // set video format, frames are always converted to RGBA
+  m_format = RGBA32;
+  // force flip because ffmpeg always return the image in the wrong orientation for texture,
+  // the flip is done during the conversion to RGBA (see convertFrame)
   setFlip(true);
   // construction is OK
   *hRslt = S_OK;
@@ -120,6 +123,7 @@ bool VideoFFmpeg::release()
 {
   // release
   stopCache();
+  freeCache();
   if (m_codecCtx) {
     avcodec_close(m_codecCtx);
     m_codecCtx = nullptr;
@@ -138,14 +142,10 @@ bool VideoFFmpeg::release()
     m_frameDeinterlaced = nullptr;
   }
   if (m_frameRGB) {
-    MEM_freeN(m_frameRGB->data[0]);
-    av_free(m_frameRGB);
+    freeFrameRGB(m_frameRGB);
     m_frameRGB = nullptr;
   }
-  if (m_imgConvertCtx) {
-    sws_freeContext(m_imgConvertCtx);
-    m_imgConvertCtx = nullptr;
-  }
+  freeConvert();
   m_codec = nullptr;
   m_status = SourceStopped;
   m_lastFrame = -1;
@@ -156,25 +156,145 @@ AVFrame *VideoFFmpeg::allocFrameRGB()
 {
   AVFrame *frame;
   frame = av_frame_alloc();
-  if (m_format == RGBA32) {
-    avpicture_fill((AVPicture *)frame,
-                   (uint8_t *)MEM_callocN(
-                       avpicture_get_size(AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height),
-                       "ffmpeg rgba"),
-                   AV_PIX_FMT_RGBA,
-                   m_codecCtx->width,
-                   m_codecCtx->height);
+  // the buffer is aligned because it can be exchanged with the image buffer (see processFrame)
+  avpicture_fill((AVPicture *)frame,
+                 (uint8_t *)MEM_mallocN_aligned(
+                     avpicture_get_size(AV_PIX_FMT_RGBA, m_codecCtx->width, m_codecCtx->height),
+                     FRAME_BUFFER_ALIGN,
+                     "ffmpeg rgba"),
+                 AV_PIX_FMT_RGBA,
+                 m_codecCtx->width,
+                 m_codecCtx->height);
+  return frame;
+}
+
+void VideoFFmpeg::freeFrameRGB(AVFrame *frame)
+{
+  MEM_freeN(frame->data[0]);
+  av_free(frame);
+}
+
+bool VideoFFmpeg::initConvert(void)
+{
+  const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(m_codecCtx->pix_fmt);
+  if (desc == nullptr)
+    return false;
+
+  const int width = m_codecCtx->width;
+  const int height = m_codecCtx->height;
+  m_chromaShift = desc->log2_chroma_h;
+  m_planeCount = av_pix_fmt_count_planes(m_codecCtx->pix_fmt);
+
+  // split the conversion in bands of rows converted in parallel,
+  // palette formats share their palette plane between all rows and are converted at once
+  int sliceCount = 1;
+  if (!(desc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL))) {
+    sliceCount = std::max(std::min(BLI_system_thread_count(), height / CONVERT_SLICE_MIN_HEIGHT),
+                          1);
   }
-  else {
-    avpicture_fill((AVPicture *)frame,
-                   (uint8_t *)MEM_callocN(
-                       avpicture_get_size(AV_PIX_FMT_RGB24, m_codecCtx->width, m_codecCtx->height),
-                       "ffmpeg rgb"),
-                   AV_PIX_FMT_RGB24,
-                   m_codecCtx->width,
-                   m_codecCtx->height);
+  // bands must start on a chroma row
+  const int chromaRows = 1 << m_chromaShift;
+  const int sliceHeight = ((height + sliceCount - 1) / sliceCount + chromaRows - 1) &
+                          ~(chromaRows - 1);
+
+  for (int start = 0; start < height; start += sliceHeight) {
+    ConvertSlice slice;
+    slice.start = start;
+    slice.height = std::min(sliceHeight, height - start);
+    slice.context = sws_getContext(width,
+                                   slice.height,
+                                   m_codecCtx->pix_fmt,
+                                   width,
+                                   slice.height,
+                                   AV_PIX_FMT_RGBA,
+                                   SWS_FAST_BILINEAR,
+                                   nullptr,
+                                   nullptr,
+                                   nullptr);
+    if (!slice.context) {
+      freeConvert();
+      return false;
+    }
+    m_convertSlices.push_back(slice);
   }
-  return frame;
+  return true;
+}
+
+void VideoFFmpeg::freeConvert(void)
+{
+  for (ConvertSlice &slice : m_convertSlices) {
+    sws_freeContext(slice.context);
+  }
+  m_convertSlices.clear();
+}
+
+// data shared by the threads converting a frame
+struct ConvertData {
+  VideoFFmpeg *video;
+  AVFrame *input;
+  AVFrame *output;
+};
+
+void VideoFFmpeg::convertSliceFunc(void *__restrict userdata,
+                                   const int iter,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ConvertData *data = (ConvertData *)userdata;
+  VideoFFmpeg *video = data->video;
+  const ConvertSlice &slice = video->m_convertSlices[iter];
+  const int height = video->m_codecCtx->height;
+
+  const uint8_t *src[4] = {data->input->data[0],
+                           data->input->data[1],
+                           data->input->data[2],
+                           data->input->data[3]};
+  if (video->m_convertSlices.size() > 1) {
+    for (int i = 0; i < video->m_planeCount; ++i) {
+      // only the chroma planes are subsampled, luma and alpha planes are not
+      const int row = (i == 1 || i == 2) ? slice.start >> video->m_chromaShift : slice.start;
+      src[i] += row * data->input->linesize[i];
+    }
+  }
+
+  // write the rows bottom-up, this is the orientation expected by the textures
+  const int stride = data->output->linesize[0];
+  uint8_t *dst[4] = {data->output->data[0] + (height - 1 - slice.start) * stride};
+  int dstStride[4] = {-stride};
+
+  sws_scale(slice.context, src, data->input->linesize, 0, slice.height, dst, dstStride);
+}
+
+void VideoFFmpeg::convertFrame(AVFrame *input, AVFrame *output)
+{
+  ConvertData data = {this, input, output};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (m_convertSlices.size() > 1);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, m_convertSlices.size(), &data, convertSliceFunc, &settings);
+}
+
+void VideoFFmpeg::processFrame(AVFrame *frame)
+{
+  // the frame is already flipped, if no other processing is required just exchange buffers
+  if (m_flip) {
+    unsigned int *buffer = (unsigned int *)frame->data[0];
+    if (swapImage(buffer, m_orgSize[0], m_orgSize[1])) {
+      // the frame gets the previous image buffer, it will be overwritten by the next decode
+      frame->data[0] = (uint8_t *)buffer;
+      return;
+    }
+  }
+  // otherwise copy it, inverting the flip as the rows are already stored bottom-up
+  process((BYTE *)frame->data[0], !m_flip);
+}
+
+// decoding timestamp of a frame, with threaded decoding the frame is returned several packets
+// after the one it was decoded from
+static int64_t getFrameDts(AVFrame *frame, AVPacket *packet)
+{
+  return (frame->pkt_dts != AV_NOPTS_VALUE) ? frame->pkt_dts : packet->dts;
 }
 
 // set initial parameters
@@ -227,6 +347,13 @@ int VideoFFmpeg::openStream(const char *filename,
     return -1;
   }
   codecCtx->workaround_bugs = 1;
+  if (!m_isImage) {
+    // decode on all cores, frame threading delays the output by one frame per thread which is
+    // absorbed by the frame cache, capture devices only use slice threading to keep latency low
+    codecCtx->thread_count = BLI_system_thread_count();
+    codecCtx->thread_type = (inputFormat != nullptr) ? FF_THREAD_SLICE :
+                                                       FF_THREAD_FRAME | FF_THREAD_SLICE;
+  }
   if (avcodec_open2(codecCtx, codec, nullptr) < 0) {
     avformat_close_input(&formatCtx);
     return -1;
@@ -259,41 +386,11 @@ int VideoFFmpeg::openStream(const char *filename,
       m_codecCtx->width,
       m_codecCtx->height);
 
-  // check if the pixel format supports Alpha
-  if (m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32 ||
-      m_codecCtx->pix_fmt == AV_PIX_FMT_RGB32_1 || m_codecCtx->pix_fmt == AV_PIX_FMT_BGR32_1) {
-    // allocate buffer to store final decoded frame
-    m_format = RGBA32;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGBA,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
-  }
-  else {
-    // allocate buffer to store final decoded frame
-    m_format = RGB24;
-    // allocate sws context
-    m_imgConvertCtx = sws_getContext(m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     m_codecCtx->pix_fmt,
-                                     m_codecCtx->width,
-                                     m_codecCtx->height,
-                                     AV_PIX_FMT_RGB24,
-                                     SWS_FAST_BILINEAR,
-                                     nullptr,
-                                     nullptr,
-                                     nullptr);
-  }
+  // allocate buffer to store final decoded frame
   m_frameRGB = allocFrameRGB();
 
-  if (!m_imgConvertCtx) {
+  // allocate sws contexts
+  if (!initConvert()) {
     avcodec_close(m_codecCtx);
     m_codecCtx = nullptr;
     avformat_close_input(&m_formatCtx);
@@ -303,8 +400,7 @@ int VideoFFmpeg::openStream(const char *filename,
     MEM_freeN(m_frameDeinterlaced->data[0]);
     av_free(m_frameDeinterlaced);
     m_frameDeinterlaced = nullptr;
-    MEM_freeN(m_frameRGB->data[0]);
-    av_free(m_frameRGB);
+    freeFrameRGB(m_frameRGB);
     m_frameRGB = nullptr;
     return -1;
   }
@@ -379,60 +475,39 @@ void *VideoFFmpeg::cacheThread(void *data)
     }
     if (currentFrame != nullptr) {
       // this frame is out of free and busy queue, we can manipulate it without locking
-      frameFinished = 0;
-      while (!frameFinished &&
+      bool frameReady = false;
+      while (!frameReady &&
              (cachePacket = (CachePacket *)video->m_packetCacheBase.first) != nullptr) {
         BLI_remlink(&video->m_packetCacheBase, cachePacket);
-        // use m_frame because when caching, it is not used in main thread
-        // we can't use currentFrame directly because we need to convert to RGB first
-        avcodec_decode_video2(
-            video->m_codecCtx, video->m_frame, &frameFinished, &cachePacket->packet);
-        if (frameFinished) {
-          AVFrame *input = video->m_frame;
-
-          /* This means the data wasnt read properly, this check stops crashing */
-          if (input->data[0] != 0 || input->data[1] != 0 || input->data[2] != 0 ||
-              input->data[3] != 0) {
-            if (video->m_deinterlace) {
-              if (avpicture_deinterlace((AVPicture *)video->m_frameDeinterlaced,
-                                        (const AVPicture *)video->m_frame,
-                                        video->m_codecCtx->pix_fmt,
-                                        video->m_codecCtx->width,
-                                        video->m_codecCtx->height) >= 0) {
-                input = video->m_frameDeinterlaced;
-              }
-            }
-            // convert to RGB24
-            sws_scale(video->m_imgConvertCtx,
-                      input->data,
-                      input->linesize,
-                      0,
-                      video->m_codecCtx->height,
-                      currentFrame->frame->data,
-                      currentFrame->frame->linesize);
-            // move frame to queue, this frame is necessarily the next one
-            video->m_curPosition = (long)((cachePacket->packet.dts - startTs) *
-                                              (video->m_baseFrameRate * timeBase) +
-                                          0.5);
-            currentFrame->framePosition = video->m_curPosition;
-            pthread_mutex_lock(&video->m_cacheMutex);
-            BLI_addtail(&video->m_frameCacheBase, currentFrame);
-            pthread_mutex_unlock(&video->m_cacheMutex);
-            currentFrame = nullptr;
-          }
-        }
+        frameReady = video->decodeCacheFrame(
+            &cachePacket->packet, currentFrame, timeBase, startTs);
         av_free_packet(&cachePacket->packet);
         BLI_addtail(&video->m_packetCacheFree, cachePacket);
       }
-      if (currentFrame && endOfFile) {
-        // no more packet and end of file => put a special frame that indicates that
-        currentFrame->framePosition = -1;
+      if (!frameReady && endOfFile) {
+        // threaded decoding keeps the last frames in the codec, drain them with empty packets
+        AVPacket flushPacket;
+        av_init_packet(&flushPacket);
+        flushPacket.data = nullptr;
+        flushPacket.size = 0;
+        frameReady = video->decodeCacheFrame(&flushPacket, currentFrame, timeBase, startTs);
+        if (!frameReady) {
+          // no more packet and end of file => put a special frame that indicates that
+          currentFrame->framePosition = -1;
+          pthread_mutex_lock(&video->m_cacheMutex);
+          BLI_addtail(&video->m_frameCacheBase, currentFrame);
+          pthread_mutex_unlock(&video->m_cacheMutex);
+          currentFrame = nullptr;
+          // no need to stay any longer in this thread
+          break;
+        }
+      }
+      if (frameReady) {
+        // move frame to queue, this frame is necessarily the next one
         pthread_mutex_lock(&video->m_cacheMutex);
         BLI_addtail(&video->m_frameCacheBase, currentFrame);
         pthread_mutex_unlock(&video->m_cacheMutex);
         currentFrame = nullptr;
-        // no need to stay any longer in this thread
-        break;
       }
     }
     // small sleep to avoid unnecessary looping
@@ -447,6 +522,44 @@ void *VideoFFmpeg::cacheThread(void *data)
   return 0;
 }
 
+// decode a packet in the cache thread, return true if a complete frame was stored in cacheFrame
+bool VideoFFmpeg::decodeCacheFrame(AVPacket *packet,
+                                   CacheFrame *cacheFrame,
+                                   double timeBase,
+                                   int64_t startTs)
+{
+  int frameFinished = 0;
+  // use m_frame because when caching, it is not used in main thread
+  // we can't use cacheFrame directly because we need to convert to RGBA first
+  avcodec_decode_video2(m_codecCtx, m_frame, &frameFinished, packet);
+  if (!frameFinished) {
+    return false;
+  }
+
+  AVFrame *input = m_frame;
+  /* This means the data wasnt read properly, this check stops crashing */
+  if (input->data[0] == 0 && input->data[1] == 0 && input->data[2] == 0 && input->data[3] == 0) {
+    return false;
+  }
+
+  if (m_deinterlace) {
+    if (avpicture_deinterlace((AVPicture *)m_frameDeinterlaced,
+                              (const AVPicture *)m_frame,
+                              m_codecCtx->pix_fmt,
+                              m_codecCtx->width,
+                              m_codecCtx->height) >= 0) {
+      input = m_frameDeinterlaced;
+    }
+  }
+  // convert to RGBA
+  convertFrame(input, cacheFrame->frame);
+  m_curPosition = (long)((getFrameDts(m_frame, packet) - startTs) *
+                             (m_baseFrameRate * timeBase) +
+                         0.5);
+  cacheFrame->framePosition = m_curPosition;
+  return true;
+}
+
 // start thread to cache video frame from file/capture/stream
 // this function should be called only when the position in the stream is set for the
 // first frame to cache
@@ -454,7 +567,8 @@ bool VideoFFmpeg::startCache()
 {
   if (!m_cacheStarted && m_isThreaded) {
     m_stopThread = false;
-    for (int i = 0; i < CACHE_FRAME_SIZE; i++) {
+    // frames are kept between restarts of the cache, only allocate the missing ones
+    for (int i = BLI_listbase_count(&m_frameCacheFree); i < CACHE_FRAME_SIZE; i++) {
       CacheFrame *frame = new CacheFrame();
       frame->frame = allocFrameRGB();
       BLI_addtail(&m_frameCacheFree, frame);
@@ -475,21 +589,10 @@ void VideoFFmpeg::stopCache()
   if (m_cacheStarted) {
     m_stopThread = true;
     BLI_threadpool_end(&m_thread);
-    // now delete the cache
-    CacheFrame *frame;
+    // now delete the cache, the frames are kept for reuse as the cache is restarted
+    // on every seek and loop
     CachePacket *packet;
-    while ((frame = (CacheFrame *)m_frameCacheBase.first) != nullptr) {
-      BLI_remlink(&m_frameCacheBase, frame);
-      MEM_freeN(frame->frame->data[0]);
-      av_free(frame->frame);
-      delete frame;
-    }
-    while ((frame = (CacheFrame *)m_frameCacheFree.first) != nullptr) {
-      BLI_remlink(&m_frameCacheFree, frame);
-      MEM_freeN(frame->frame->data[0]);
-      av_free(frame->frame);
-      delete frame;
-    }
+    BLI_movelisttolist(&m_frameCacheFree, &m_frameCacheBase);
     while ((packet = (CachePacket *)m_packetCacheBase.first) != nullptr) {
       BLI_remlink(&m_packetCacheBase, packet);
       av_free_packet(&packet->packet);
@@ -503,6 +606,16 @@ void VideoFFmpeg::stopCache()
   }
 }
 
+void VideoFFmpeg::freeCache()
+{
+  CacheFrame *frame;
+  while ((frame = (CacheFrame *)m_frameCacheFree.first) != nullptr) {
+    BLI_remlink(&m_frameCacheFree, frame);
+    freeFrameRGB(frame->frame);
+    delete frame;
+  }
+}
+
 void VideoFFmpeg::releaseFrame(AVFrame *frame)
 {
   if (frame == m_frameRGB) {
@@ -793,7 +906,7 @@ void VideoFFmpeg::calcImage(unsigned int texId, double ts)
         // init image, if needed
         init(short(m_codecCtx->width), short(m_codecCtx->height));
         // process image
-        process((BYTE *)(frame->data[0]));
+        processFrame(frame);
         // finished with the frame, release it so that cache can reuse it
         releaseFrame(frame);
         // in case it is an image, automatically stop reading it
@@ -897,7 +1010,9 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
         if (packet.stream_index == m_videoStream) {
           avcodec_decode_video2(m_codecCtx, m_frame, &frameFinished, &packet);
           if (frameFinished) {
-            m_curPosition = (long)((packet.dts - startTs) * (m_baseFrameRate * timeBase) + 0.5);
+            m_curPosition = (long)((getFrameDts(m_frame, &packet) - startTs) *
+                                       (m_baseFrameRate * timeBase) +
+                                   0.5);
           }
         }
         av_free_packet(&packet);
@@ -974,7 +1089,7 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
                counter < 10 && m_isImage);
 
       // remember dts to compute exact frame number
-      dts = packet.dts;
+      dts = getFrameDts(m_frame, &packet);
       if (frameFinished && !posFound) {
         if (dts >= targetTs) {
           posFound = 1;
@@ -1001,14 +1116,8 @@ AVFrame *VideoFFmpeg::grabFrame(long position)
             input = m_frameDeinterlaced;
           }
         }
-        // convert to RGB24
-        sws_scale(m_imgConvertCtx,
-                  input->data,
-                  input->linesize,
-                  0,
-                  m_codecCtx->height,
-                  m_frameRGB->data,
-                  m_frameRGB->linesize);
+        // convert to RGBA
+        convertFrame(input, m_frameRGB);
         av_free_packet(&packet);
         frameLoaded = true;
         break;
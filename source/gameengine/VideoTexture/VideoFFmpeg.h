@@ -38,12 +38,16 @@
 #  endif
 extern "C" {
 #  include "BLI_blenlib.h"
+#  include "BLI_task.h"
 #  include "BLI_threads.h"
 #  include "DNA_listBase.h"
 #  include "ffmpeg_compat.h"
+#  include <libavutil/pixdesc.h>
 #  include <pthread.h>
 }
 
+#  include <vector>
+
 #  if LIBAVFORMAT_VERSION_INT < (49 << 16)
 #    define FFMPEG_OLD_FRAME_RATE 1
 #  else
@@ -66,6 +70,10 @@ static inline AVCodecContext *get_codec_from_stream(AVStream *stream)
 
 #  define CACHE_FRAME_SIZE 10
 #  define CACHE_PACKET_SIZE 30
+// minimal number of rows converted by one thread
+#  define CONVERT_SLICE_MIN_HEIGHT 64
+// alignment of decoded frame buffers
+#  define FRAME_BUFFER_ALIGN 32
 
 // type VideoFFmpeg declaration
 class VideoFFmpeg : public VideoBase {
@@ -128,10 +136,19 @@ class VideoFFmpeg : public VideoBase {
   AVFrame *m_frame;
   // deinterlaced frame if codec requires it
   AVFrame *m_frameDeinterlaced;
-  // decoded RGB24 frame if codec requires it
+  // decoded RGBA frame if codec requires it
   AVFrame *m_frameRGB;
-  // conversion from raw to RGB is done with sws_scale
-  struct SwsContext *m_imgConvertCtx;
+  // conversion from raw to RGBA is done with sws_scale, one context per band of rows
+  struct ConvertSlice {
+    struct SwsContext *context;
+    int start;
+    int height;
+  };
+  std::vector<ConvertSlice> m_convertSlices;
+  // vertical chroma subsampling of the raw frame, bands must start on a chroma row
+  int m_chromaShift;
+  // number of planes of the raw frame
+  int m_planeCount;
   // should the codec be deinterlaced?
   bool m_deinterlace;
   // number of frame of preseek
@@ -200,6 +217,15 @@ class VideoFFmpeg : public VideoBase {
   /// in case of caching, put the frame back in free queue
   void releaseFrame(AVFrame *frame);
 
+  /// create the conversion contexts, return false if the pixel format is not supported
+  bool initConvert(void);
+  /// release the conversion contexts
+  void freeConvert(void);
+  /// convert a raw frame to RGBA, rows are stored bottom-up
+  void convertFrame(AVFrame *input, AVFrame *output);
+  /// send decoded frame to the image, without copy when possible
+  void processFrame(AVFrame *frame);
+
   /// start thread to load the video file/capture/stream
   bool startCache();
   void stopCache();
@@ -225,7 +251,17 @@ class VideoFFmpeg : public VideoBase {
   pthread_mutex_t m_cacheMutex;
 
   AVFrame *allocFrameRGB();
+  void freeFrameRGB(AVFrame *frame);
+  bool decodeCacheFrame(AVPacket *packet,
+                        CacheFrame *cacheFrame,
+                        double timeBase,
+                        int64_t startTs);
+  /// free the frames kept for reuse between cache restarts
+  void freeCache();
   static void *cacheThread(void *);
+  static void convertSliceFunc(void *__restrict userdata,
+                               const int iter,
+                               const TaskParallelTLS *__restrict tls);
 };
 
 inline VideoFFmpeg *getFFmpeg(PyImage *self)
@@ -0,0 +1,153 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_ghash.h"
+#include "BLI_ghash_lockfree.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+}
+
+#define NUM_RUN_AVERAGED 10
+
+/* Number of lookups, and number of different keys they use. */
+#define NUM_LOOKUPS 10000000
+#define NUM_KEYS 1000
+
+/* Number of keys added from all threads. */
+#define NUM_ADDS 1000000
+
+namespace {
+
+struct LockedGHashData {
+  GHash *ghash;
+  ThreadRWMutex lock;
+};
+
+/* Lookup with a read lock and add missing keys with a write lock, the way the vector font
+ * characters were cached. */
+void locked_ghash_lookup_cb(void *__restrict userdata,
+                            const int index,
+                            const TaskParallelTLS *__restrict /*tls*/)
+{
+  LockedGHashData *data = (LockedGHashData *)userdata;
+  void *key = POINTER_FROM_UINT((unsigned int)index % NUM_KEYS);
+
+  BLI_rw_mutex_lock(&data->lock, THREAD_LOCK_READ);
+  void *val = BLI_ghash_lookup(data->ghash, key);
+  BLI_rw_mutex_unlock(&data->lock);
+
+  if (val == NULL) {
+    BLI_rw_mutex_lock(&data->lock, THREAD_LOCK_WRITE);
+    if (BLI_ghash_lookup(data->ghash, key) == NULL) {
+      BLI_ghash_insert(data->ghash, key, key);
+    }
+    BLI_rw_mutex_unlock(&data->lock);
+  }
+}
+
+void lockfree_ghash_lookup_cb(void *__restrict userdata,
+                              const int index,
+                              const TaskParallelTLS *__restrict /*tls*/)
+{
+  LockfreeGHash *ghash = (LockfreeGHash *)userdata;
+  void *key = POINTER_FROM_UINT((unsigned int)index % NUM_KEYS);
+
+  if (BLI_ghash_lockfree_lookup(ghash, key) == NULL) {
+    BLI_ghash_lockfree_add(ghash, key, key);
+  }
+}
+
+void locked_ghash_add_cb(void *__restrict userdata,
+                         const int index,
+                         const TaskParallelTLS *__restrict /*tls*/)
+{
+  LockedGHashData *data = (LockedGHashData *)userdata;
+
+  BLI_rw_mutex_lock(&data->lock, THREAD_LOCK_WRITE);
+  BLI_ghash_insert(data->ghash, POINTER_FROM_INT(index), POINTER_FROM_INT(index));
+  BLI_rw_mutex_unlock(&data->lock);
+}
+
+void lockfree_ghash_add_cb(void *__restrict userdata,
+                           const int index,
+                           const TaskParallelTLS *__restrict /*tls*/)
+{
+  LockfreeGHash *ghash = (LockfreeGHash *)userdata;
+  BLI_ghash_lockfree_add(ghash, POINTER_FROM_INT(index), POINTER_FROM_INT(index));
+}
+
+void ghash_lockfree_test_do(const char *id,
+                            const int num_items,
+                            TaskParallelRangeFunc locked_func,
+                            TaskParallelRangeFunc lockfree_func,
+                            const unsigned int nentries_reserve)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    LockedGHashData data;
+    data.ghash = BLI_ghash_int_new_ex(__func__, nentries_reserve);
+    BLI_rw_mutex_init(&data.lock);
+
+    const double init_time = PIL_check_seconds_timer();
+    BLI_task_parallel_range(0, num_items, &data, locked_func, &settings);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+
+    BLI_rw_mutex_end(&data.lock);
+    BLI_ghash_free(data.ghash, NULL, NULL);
+  }
+
+  printf("\t%s: locked GHash done in %fs on average over %d runs\n",
+         id,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    LockfreeGHash *ghash = BLI_ghash_lockfree_int_new_ex(__func__, nentries_reserve);
+
+    const double init_time = PIL_check_seconds_timer();
+    BLI_task_parallel_range(0, num_items, ghash, lockfree_func, &settings);
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+
+    BLI_ghash_lockfree_free(ghash, NULL, NULL);
+  }
+
+  printf("\t%s: LockfreeGHash done in %fs on average over %d runs\n",
+         id,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+}
+
+}  // namespace
+
+TEST(ghash_lockfree, LookupOrAdd)
+{
+  ghash_lockfree_test_do("Lookup or add, 10M lookups of 1K keys",
+                         NUM_LOOKUPS,
+                         locked_ghash_lookup_cb,
+                         lockfree_ghash_lookup_cb,
+                         0);
+}
+
+TEST(ghash_lockfree, Add)
+{
+  ghash_lockfree_test_do(
+      "Add, 1M keys", NUM_ADDS, locked_ghash_add_cb, lockfree_ghash_add_cb, 0);
+}
+
+TEST(ghash_lockfree, AddReserved)
+{
+  ghash_lockfree_test_do(
+      "Add, 1M reserved keys", NUM_ADDS, locked_ghash_add_cb, lockfree_ghash_add_cb, NUM_ADDS);
+}
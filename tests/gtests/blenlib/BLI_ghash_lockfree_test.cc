@@ -0,0 +1,115 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "atomic_ops.h"
+
+extern "C" {
+#include "BLI_ghash_lockfree.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+}
+
+#define TESTCASE_SIZE 100000
+
+namespace {
+
+struct ConcurrentAddData {
+  LockfreeGHash *ghash;
+  unsigned int num_added;
+};
+
+void concurrent_add_cb(void *__restrict userdata,
+                       const int index,
+                       const TaskParallelTLS *__restrict /*tls*/)
+{
+  ConcurrentAddData *data = (ConcurrentAddData *)userdata;
+  /* Every key is added by two iterations. */
+  const unsigned int key = (unsigned int)index / 2;
+  if (BLI_ghash_lockfree_add(data->ghash, POINTER_FROM_UINT(key), POINTER_FROM_UINT(key + 1))) {
+    atomic_add_and_fetch_u(&data->num_added, 1);
+  }
+  EXPECT_EQ(BLI_ghash_lockfree_lookup(data->ghash, POINTER_FROM_UINT(key)),
+            POINTER_FROM_UINT(key + 1));
+}
+
+void count_cb(void *userdata, void *key, void *val)
+{
+  EXPECT_EQ(POINTER_AS_UINT(key) + 1, POINTER_AS_UINT(val));
+  atomic_add_and_fetch_u((unsigned int *)userdata, 1);
+}
+
+}  // namespace
+
+/* Add and lookup from a single thread. */
+TEST(ghash_lockfree, AddLookup)
+{
+  LockfreeGHash *ghash = BLI_ghash_lockfree_int_new_ex(__func__, 0);
+
+  for (unsigned int i = 0; i < TESTCASE_SIZE; i++) {
+    EXPECT_TRUE(
+        BLI_ghash_lockfree_add(ghash, POINTER_FROM_UINT(i), POINTER_FROM_UINT(i + 1)));
+  }
+  for (unsigned int i = 0; i < TESTCASE_SIZE; i++) {
+    EXPECT_FALSE(BLI_ghash_lockfree_add(ghash, POINTER_FROM_UINT(i), NULL));
+  }
+
+  EXPECT_EQ(BLI_ghash_lockfree_len(ghash), TESTCASE_SIZE);
+  for (unsigned int i = 0; i < TESTCASE_SIZE; i++) {
+    EXPECT_EQ(BLI_ghash_lockfree_lookup(ghash, POINTER_FROM_UINT(i)), POINTER_FROM_UINT(i + 1));
+  }
+  EXPECT_FALSE(BLI_ghash_lockfree_haskey(ghash, POINTER_FROM_UINT(TESTCASE_SIZE)));
+  EXPECT_EQ(BLI_ghash_lockfree_lookup(ghash, POINTER_FROM_UINT(TESTCASE_SIZE)), nullptr);
+
+  LockfreeGHash *ghash_copy = BLI_ghash_lockfree_copy(ghash, NULL, NULL);
+  EXPECT_EQ(BLI_ghash_lockfree_len(ghash_copy), TESTCASE_SIZE);
+  for (unsigned int i = 0; i < TESTCASE_SIZE; i++) {
+    EXPECT_EQ(BLI_ghash_lockfree_lookup(ghash_copy, POINTER_FROM_UINT(i)),
+              POINTER_FROM_UINT(i + 1));
+  }
+
+  BLI_ghash_lockfree_free(ghash, NULL, NULL);
+  BLI_ghash_lockfree_free(ghash_copy, NULL, NULL);
+}
+
+/* String keys in a set. */
+TEST(ghash_lockfree, StringSet)
+{
+  LockfreeGSet *gset = BLI_gset_lockfree_str_new_ex(__func__, 4);
+  char keys[][8] = {"one", "two", "three", "four", "five", "six"};
+  char key_dup[] = "three";
+
+  for (int i = 0; i < ARRAY_SIZE(keys); i++) {
+    EXPECT_TRUE(BLI_gset_lockfree_add(gset, keys[i]));
+  }
+  EXPECT_FALSE(BLI_gset_lockfree_add(gset, key_dup));
+  EXPECT_TRUE(BLI_gset_lockfree_haskey(gset, key_dup));
+  EXPECT_FALSE(BLI_gset_lockfree_haskey(gset, "seven"));
+  EXPECT_EQ(BLI_gset_lockfree_len(gset), ARRAY_SIZE(keys));
+
+  BLI_gset_lockfree_free(gset, NULL);
+}
+
+/* Add the same keys from many threads, each key must be added once. */
+TEST(ghash_lockfree, ConcurrentAdd)
+{
+  ConcurrentAddData data;
+  data.ghash = BLI_ghash_lockfree_int_new_ex(__func__, 0);
+  data.num_added = 0;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, TESTCASE_SIZE * 2, &data, concurrent_add_cb, &settings);
+
+  EXPECT_EQ(data.num_added, TESTCASE_SIZE);
+  EXPECT_EQ(BLI_ghash_lockfree_len(data.ghash), TESTCASE_SIZE);
+
+  unsigned int num_visited = 0;
+  BLI_ghash_lockfree_foreach_parallel(data.ghash, count_cb, &num_visited);
+  EXPECT_EQ(num_visited, TESTCASE_SIZE);
+
+  BLI_ghash_lockfree_free(data.ghash, NULL, NULL);
+}
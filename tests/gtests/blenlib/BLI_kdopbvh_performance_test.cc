@@ -0,0 +1,221 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_kdopbvh.h"
+#include "BLI_math_geom.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+}
+
+#include "stubs/bf_intern_eigen_stubs.h"
+
+#define NUM_RUN_AVERAGED 3
+
+/* A grid of (GRID_RES - 1)^2 quads, about a million triangles. */
+#define GRID_RES 708
+/* Rays are cast from a RAYS_RES^2 image. */
+#define RAYS_RES 512
+
+namespace {
+
+struct RayCastMesh {
+  float (*verts)[3];
+  unsigned int (*tris)[3];
+  int tris_len;
+};
+
+void raycast_mesh_callback(void *userdata, int index, const BVHTreeRay *ray, BVHTreeRayHit *hit)
+{
+  const RayCastMesh *mesh = (const RayCastMesh *)userdata;
+  const unsigned int *tri = mesh->tris[index];
+  float dist;
+
+  if (isect_ray_tri_watertight_v3(ray->origin,
+                                  ray->isect_precalc,
+                                  mesh->verts[tri[0]],
+                                  mesh->verts[tri[1]],
+                                  mesh->verts[tri[2]],
+                                  &dist,
+                                  NULL) &&
+      (dist < hit->dist)) {
+    hit->index = index;
+    hit->dist = dist;
+    madd_v3_v3v3fl(hit->co, ray->origin, ray->direction, dist);
+  }
+}
+
+/* A wavy grid in the [0, 1] square,
+ * with triangles of different sizes (as most meshes have) so the balancing matters. */
+void raycast_mesh_create(RayCastMesh *mesh)
+{
+  mesh->verts = (float(*)[3])MEM_mallocN(sizeof(*mesh->verts) * GRID_RES * GRID_RES, __func__);
+  mesh->tris_len = (GRID_RES - 1) * (GRID_RES - 1) * 2;
+  mesh->tris = (unsigned int(*)[3])MEM_mallocN(sizeof(*mesh->tris) * mesh->tris_len, __func__);
+
+  for (int y = 0; y < GRID_RES; y++) {
+    for (int x = 0; x < GRID_RES; x++) {
+      float *co = mesh->verts[y * GRID_RES + x];
+      co[0] = powf((float)x / (float)(GRID_RES - 1), 3.0f);
+      co[1] = (float)y / (float)(GRID_RES - 1);
+      co[2] = 0.1f * sinf(co[0] * 20.0f) * cosf(co[1] * 20.0f);
+    }
+  }
+
+  unsigned int(*tri)[3] = mesh->tris;
+  for (unsigned int y = 0; y < GRID_RES - 1; y++) {
+    for (unsigned int x = 0; x < GRID_RES - 1; x++) {
+      const unsigned int v = y * GRID_RES + x;
+      ARRAY_SET_ITEMS(tri[0], v, v + 1, v + GRID_RES + 1);
+      ARRAY_SET_ITEMS(tri[1], v, v + GRID_RES + 1, v + GRID_RES);
+      tri += 2;
+    }
+  }
+}
+
+void raycast_mesh_free(RayCastMesh *mesh)
+{
+  MEM_freeN(mesh->verts);
+  MEM_freeN(mesh->tris);
+}
+
+BVHTree *raycast_mesh_tree_create(const RayCastMesh *mesh, const int balance_flag)
+{
+  BVHTree *tree = BLI_bvhtree_new(mesh->tris_len, 0.0f, 4, 6);
+  for (int i = 0; i < mesh->tris_len; i++) {
+    float co[3][3];
+    for (int j = 0; j < 3; j++) {
+      copy_v3_v3(co[j], mesh->verts[mesh->tris[i][j]]);
+    }
+    BLI_bvhtree_insert(tree, i, co[0], 3);
+  }
+  BLI_bvhtree_balance_ex(tree, balance_flag);
+  return tree;
+}
+
+/* Rays from a camera above the grid through the pixels of an image,
+ * or from random points to random points of the grid. */
+void raycast_rays_create(float (*co)[3], float (*dir)[3], const bool random)
+{
+  RNG *rng = BLI_rng_new(0);
+  for (int y = 0; y < RAYS_RES; y++) {
+    for (int x = 0; x < RAYS_RES; x++) {
+      const int i = y * RAYS_RES + x;
+      float target[3];
+      if (random) {
+        ARRAY_SET_ITEMS(co[i], BLI_rng_get_float(rng), BLI_rng_get_float(rng), 1.0f);
+        ARRAY_SET_ITEMS(target, BLI_rng_get_float(rng), BLI_rng_get_float(rng), 0.0f);
+      }
+      else {
+        ARRAY_SET_ITEMS(co[i], 0.5f, -0.5f, 1.0f);
+        ARRAY_SET_ITEMS(target, (float)x / (float)RAYS_RES, (float)y / (float)RAYS_RES, 0.0f);
+      }
+      sub_v3_v3v3(dir[i], target, co[i]);
+      normalize_v3(dir[i]);
+    }
+  }
+  BLI_rng_free(rng);
+}
+
+void raycast_hits_init(BVHTreeRayHit *hits, const int rays_len)
+{
+  for (int i = 0; i < rays_len; i++) {
+    hits[i].index = -1;
+    hits[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+}
+
+void kdopbvh_raycast_test_do(const char *id, const bool random)
+{
+  const int rays_len = RAYS_RES * RAYS_RES;
+  RayCastMesh mesh;
+  raycast_mesh_create(&mesh);
+
+  float(*co)[3] = (float(*)[3])MEM_mallocN(sizeof(*co) * rays_len, __func__);
+  float(*dir)[3] = (float(*)[3])MEM_mallocN(sizeof(*dir) * rays_len, __func__);
+  BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hits) * rays_len, __func__);
+  raycast_rays_create(co, dir, random);
+
+  const int balance_flags[2] = {0, BVH_BALANCE_SAH};
+  const char *balance_names[2] = {"median", "SAH"};
+
+  for (int b = 0; b < 2; b++) {
+    BVHTree *tree = NULL;
+
+    double averaged_timing = 0.0;
+    for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+      if (tree) {
+        BLI_bvhtree_free(tree);
+      }
+      const double init_time = PIL_check_seconds_timer();
+      tree = raycast_mesh_tree_create(&mesh, balance_flags[b]);
+      averaged_timing += PIL_check_seconds_timer() - init_time;
+    }
+    printf("\t%s: %s build done in %fs on average over %d runs\n",
+           id,
+           balance_names[b],
+           averaged_timing / NUM_RUN_AVERAGED,
+           NUM_RUN_AVERAGED);
+
+    averaged_timing = 0.0;
+    for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+      raycast_hits_init(hits, rays_len);
+      const double init_time = PIL_check_seconds_timer();
+      for (int j = 0; j < rays_len; j++) {
+        BLI_bvhtree_ray_cast(tree, co[j], dir[j], 0.0f, &hits[j], raycast_mesh_callback, &mesh);
+      }
+      averaged_timing += PIL_check_seconds_timer() - init_time;
+    }
+    printf("\t%s: %s single ray-casts done in %fs on average over %d runs\n",
+           id,
+           balance_names[b],
+           averaged_timing / NUM_RUN_AVERAGED,
+           NUM_RUN_AVERAGED);
+
+    averaged_timing = 0.0;
+    for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+      raycast_hits_init(hits, rays_len);
+      const double init_time = PIL_check_seconds_timer();
+      BLI_bvhtree_ray_cast_batch(tree,
+                                 co,
+                                 dir,
+                                 rays_len,
+                                 0.0f,
+                                 hits,
+                                 raycast_mesh_callback,
+                                 &mesh,
+                                 BVH_RAYCAST_DEFAULT);
+      averaged_timing += PIL_check_seconds_timer() - init_time;
+    }
+    printf("\t%s: %s batch ray-cast done in %fs on average over %d runs\n",
+           id,
+           balance_names[b],
+           averaged_timing / NUM_RUN_AVERAGED,
+           NUM_RUN_AVERAGED);
+
+    BLI_bvhtree_free(tree);
+  }
+
+  raycast_mesh_free(&mesh);
+  MEM_freeN(co);
+  MEM_freeN(dir);
+  MEM_freeN(hits);
+}
+
+}  // namespace
+
+TEST(kdopbvh, RayCastCamera)
+{
+  kdopbvh_raycast_test_do("1M triangles, 262K camera rays", false);
+}
+
+TEST(kdopbvh, RayCastRandom)
+{
+  kdopbvh_raycast_test_do("1M triangles, 262K random rays", true);
+}
@@ -9,6 +9,7 @@
 extern "C" {
 #include "BLI_compiler_attrs.h"
 #include "BLI_kdopbvh.h"
+#include "BLI_math_geom.h"
 #include "BLI_math_vector.h"
 #include "BLI_rand.h"
 }
@@ -136,3 +137,136 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+static void raycast_tris_callback(void *userdata,
+                                  int index,
+                                  const BVHTreeRay *ray,
+                                  BVHTreeRayHit *hit)
+{
+  const float(*tris)[3][3] = (const float(*)[3][3])userdata;
+  float dist;
+
+  if (isect_ray_tri_v3(
+          ray->origin, ray->direction, UNPACK3(tris[index]), &dist, NULL) &&
+      (dist < hit->dist)) {
+    hit->index = index;
+    hit->dist = dist;
+    madd_v3_v3v3fl(hit->co, ray->origin, ray->direction, dist);
+  }
+}
+
+/**
+ * Cast rays at random triangles with a median and a SAH balanced tree,
+ * one at a time and in a batch, all must give the same hits.
+ * Without callback the hits are the bounding volumes of the triangles.
+ */
+static void raycast_test(int tris_len,
+                         int rays_len,
+                         char tree_type,
+                         char axis,
+                         float radius,
+                         int random_seed,
+                         bool use_callback = true)
+{
+  BVHTree_RayCastCallback callback = use_callback ? raycast_tris_callback : NULL;
+  struct RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(tris_len, 0.0, tree_type, axis);
+  BVHTree *tree_sah = BLI_bvhtree_new(tris_len, 0.0, tree_type, axis);
+
+  float(*tris)[3][3] = (float(*)[3][3])MEM_mallocN(sizeof(*tris) * tris_len, __func__);
+  for (int i = 0; i < tris_len; i++) {
+    float center[3];
+    rng_v3_round(center, 3, rng, 1000, 1.0f);
+    for (int j = 0; j < 3; j++) {
+      rng_v3_round(tris[i][j], 3, rng, 1000, 0.1f);
+      add_v3_v3(tris[i][j], center);
+    }
+    BLI_bvhtree_insert(tree, i, tris[i][0], 3);
+    BLI_bvhtree_insert(tree_sah, i, tris[i][0], 3);
+  }
+  BLI_bvhtree_balance(tree);
+  BLI_bvhtree_balance_ex(tree_sah, BVH_BALANCE_SAH);
+  EXPECT_EQ(BLI_bvhtree_get_len(tree_sah), tris_len);
+
+  float(*co)[3] = (float(*)[3])MEM_mallocN(sizeof(*co) * rays_len, __func__);
+  float(*dir)[3] = (float(*)[3])MEM_mallocN(sizeof(*dir) * rays_len, __func__);
+  BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hits) * rays_len, __func__);
+  for (int i = 0; i < rays_len; i++) {
+    float target[3];
+    rng_v3_round(co[i], 3, rng, 1000, 2.0f);
+    rng_v3_round(target, 3, rng, 1000, 1.0f);
+    sub_v3_v3v3(dir[i], target, co[i]);
+    normalize_v3(dir[i]);
+    hits[i].index = -1;
+    hits[i].dist = BVH_RAYCAST_DIST_MAX;
+  }
+
+  BLI_bvhtree_ray_cast_batch(tree_sah,
+                             co,
+                             dir,
+                             rays_len,
+                             radius,
+                             hits,
+                             callback,
+                             tris,
+                             BVH_RAYCAST_DEFAULT);
+
+  for (int i = 0; i < rays_len; i++) {
+    BVHTreeRayHit hit = {-1};
+    hit.dist = BVH_RAYCAST_DIST_MAX;
+    BVHTreeRayHit hit_sah = hit;
+
+    BLI_bvhtree_ray_cast(tree, co[i], dir[i], radius, &hit, callback, tris);
+    BLI_bvhtree_ray_cast(tree_sah, co[i], dir[i], radius, &hit_sah, callback, tris);
+
+    EXPECT_EQ(hit_sah.index, hits[i].index);
+    if (hit_sah.index != -1) {
+      EXPECT_EQ(hit_sah.dist, hits[i].dist);
+    }
+    /* Without callback, rays starting inside several bounding volumes hit them all at a zero
+     * distance, each tree can give any of them. */
+    if (use_callback) {
+      EXPECT_EQ(hit.index, hit_sah.index);
+      if (hit.index != -1) {
+        EXPECT_EQ(hit.dist, hit_sah.dist);
+      }
+    }
+  }
+
+  BLI_bvhtree_free(tree);
+  BLI_bvhtree_free(tree_sah);
+  BLI_rng_free(rng);
+  MEM_freeN(tris);
+  MEM_freeN(co);
+  MEM_freeN(dir);
+  MEM_freeN(hits);
+}
+
+TEST(kdopbvh, RayCast_Binary)
+{
+  raycast_test(2000, 1001, 2, 6, 0.0f, 1234);
+}
+TEST(kdopbvh, RayCast_Quad)
+{
+  raycast_test(2000, 1001, 4, 8, 0.0f, 123);
+}
+TEST(kdopbvh, RayCast_26DOP)
+{
+  raycast_test(2000, 1001, 8, 26, 0.0f, 12);
+}
+TEST(kdopbvh, RayCast_Radius)
+{
+  raycast_test(2000, 1001, 4, 8, 0.05f, 1);
+}
+TEST(kdopbvh, RayCast_Radius_26DOP)
+{
+  raycast_test(2000, 1001, 8, 26, 0.05f, 2);
+}
+TEST(kdopbvh, RayCast_Radius_26DOP_NoCallback)
+{
+  raycast_test(2000, 1001, 8, 26, 0.05f, 3, false);
+}
+TEST(kdopbvh, RayCast_Few)
+{
+  raycast_test(3, 5, 4, 8, 0.0f, 1);
+}
@@ -0,0 +1,171 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_kdtree.h"
+#include "BLI_math_vector.h"
+#include "BLI_rand.h"
+#include "BLI_utildefines.h"
+}
+
+#include <float.h>
+
+/* More points than the threshold used to balance from multiple threads. */
+#define POINTS_NUM 50000
+#define SEARCH_NUM 1000
+
+static void generate_points(float (*points)[3], int points_num, unsigned int seed)
+{
+  RNG *rng = BLI_rng_new(seed);
+  for (int i = 0; i < points_num; i++) {
+    for (int j = 0; j < 3; j++) {
+      points[i][j] = BLI_rng_get_float(rng);
+    }
+  }
+  BLI_rng_free(rng);
+}
+
+/* Brute force nearest point, skipping removed points. */
+static int find_nearest_naive(const float (*points)[3],
+                              const bool *points_removed,
+                              int points_num,
+                              const float co[3])
+{
+  int index = -1;
+  float dist_sq_min = FLT_MAX;
+  for (int i = 0; i < points_num; i++) {
+    if (points_removed && points_removed[i]) {
+      continue;
+    }
+    const float dist_sq = len_squared_v3v3(points[i], co);
+    if (dist_sq < dist_sq_min) {
+      dist_sq_min = dist_sq;
+      index = i;
+    }
+  }
+  return index;
+}
+
+TEST(kdtree, FindNearestBalanced)
+{
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+  float(*search)[3] = (float(*)[3])MEM_mallocN(sizeof(*search) * SEARCH_NUM, __func__);
+  generate_points(points, POINTS_NUM, 0);
+  generate_points(search, SEARCH_NUM, 1);
+
+  KDTree_3d *tree = BLI_kdtree_3d_new(POINTS_NUM);
+  for (int i = 0; i < POINTS_NUM; i++) {
+    BLI_kdtree_3d_insert(tree, i, points[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  for (int i = 0; i < SEARCH_NUM; i++) {
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, search[i], NULL),
+              find_nearest_naive(points, NULL, POINTS_NUM, search[i]));
+  }
+
+  BLI_kdtree_3d_free(tree);
+  MEM_freeN(points);
+  MEM_freeN(search);
+}
+
+TEST(kdtree, SearchBatch)
+{
+  const unsigned int nearest_len_capacity = 4;
+  const float range = 0.05f;
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+  float(*search)[3] = (float(*)[3])MEM_mallocN(sizeof(*search) * SEARCH_NUM, __func__);
+  generate_points(points, POINTS_NUM, 0);
+  generate_points(search, SEARCH_NUM, 1);
+
+  KDTree_3d *tree = BLI_kdtree_3d_new(POINTS_NUM);
+  for (int i = 0; i < POINTS_NUM; i++) {
+    BLI_kdtree_3d_insert(tree, i, points[i]);
+  }
+  BLI_kdtree_3d_balance(tree);
+
+  KDTreeNearest_3d *nearest = (KDTreeNearest_3d *)MEM_mallocN(
+      sizeof(*nearest) * SEARCH_NUM * nearest_len_capacity, __func__);
+  KDTreeNearest_3d **nearest_range = (KDTreeNearest_3d **)MEM_mallocN(
+      sizeof(*nearest_range) * SEARCH_NUM, __func__);
+  int *nearest_len = (int *)MEM_mallocN(sizeof(*nearest_len) * SEARCH_NUM, __func__);
+
+  BLI_kdtree_3d_find_nearest_batch(tree, search, SEARCH_NUM, nearest);
+  for (int i = 0; i < SEARCH_NUM; i++) {
+    EXPECT_EQ(nearest[i].index, BLI_kdtree_3d_find_nearest(tree, search[i], NULL));
+  }
+
+  BLI_kdtree_3d_find_nearest_n_batch(
+      tree, search, SEARCH_NUM, nearest, nearest_len_capacity, nearest_len);
+  for (int i = 0; i < SEARCH_NUM; i++) {
+    KDTreeNearest_3d nearest_single[4];
+    EXPECT_EQ(nearest_len[i],
+              BLI_kdtree_3d_find_nearest_n(tree, search[i], nearest_single, nearest_len_capacity));
+    for (int j = 0; j < nearest_len[i]; j++) {
+      EXPECT_EQ(nearest[i * nearest_len_capacity + j].index, nearest_single[j].index);
+    }
+  }
+
+  BLI_kdtree_3d_range_search_batch(tree, search, SEARCH_NUM, range, nearest_range, nearest_len);
+  for (int i = 0; i < SEARCH_NUM; i++) {
+    KDTreeNearest_3d *nearest_single;
+    EXPECT_EQ(nearest_len[i], BLI_kdtree_3d_range_search(tree, search[i], &nearest_single, range));
+    for (int j = 0; j < nearest_len[i]; j++) {
+      EXPECT_EQ(nearest_range[i][j].dist, nearest_single[j].dist);
+    }
+    MEM_SAFE_FREE(nearest_single);
+    MEM_SAFE_FREE(nearest_range[i]);
+  }
+
+  BLI_kdtree_3d_free(tree);
+  MEM_freeN(nearest);
+  MEM_freeN(nearest_range);
+  MEM_freeN(nearest_len);
+  MEM_freeN(points);
+  MEM_freeN(search);
+}
+
+TEST(kdtree, InsertRemoveDynamic)
+{
+  float(*points)[3] = (float(*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+  float(*search)[3] = (float(*)[3])MEM_mallocN(sizeof(*search) * SEARCH_NUM, __func__);
+  bool *points_removed = (bool *)MEM_callocN(sizeof(*points_removed) * POINTS_NUM, __func__);
+  generate_points(points, POINTS_NUM, 0);
+  generate_points(search, SEARCH_NUM, 1);
+
+  /* Start from an empty tree, it grows with the inserted points. */
+  KDTree_3d *tree = BLI_kdtree_3d_new(0);
+  BLI_kdtree_3d_balance(tree);
+  EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, search[0], NULL), -1);
+
+  for (int i = 0; i < POINTS_NUM; i++) {
+    BLI_kdtree_3d_insert_dynamic(tree, i, points[i]);
+  }
+  for (int i = 0; i < POINTS_NUM; i += 3) {
+    EXPECT_TRUE(BLI_kdtree_3d_remove_dynamic(tree, i, points[i]));
+    points_removed[i] = true;
+  }
+  EXPECT_FALSE(BLI_kdtree_3d_remove_dynamic(tree, 0, points[0]));
+  EXPECT_FALSE(BLI_kdtree_3d_remove_dynamic(tree, 1, points[2]));
+
+  for (int i = 0; i < SEARCH_NUM; i++) {
+    EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, search[i], NULL),
+              find_nearest_naive(points, points_removed, POINTS_NUM, search[i]));
+  }
+
+  /* Points inserted in order don't make the tree too deep. */
+  for (int i = 0; i < POINTS_NUM; i += 3) {
+    float co[3] = {(float)i, 0.0f, 0.0f};
+    BLI_kdtree_3d_insert_dynamic(tree, i, co);
+  }
+  float co[3] = {(float)POINTS_NUM, 0.0f, 0.0f};
+  EXPECT_EQ(BLI_kdtree_3d_find_nearest(tree, co, NULL), (POINTS_NUM - 1) / 3 * 3);
+
+  BLI_kdtree_3d_free(tree);
+  MEM_freeN(points);
+  MEM_freeN(search);
+  MEM_freeN(points_removed);
+}
@@ -13,6 +13,7 @@ extern "C" {
 #include "BLI_utildefines.h"
 
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_mempool.h"
 #include "BLI_task.h"
 
@@ -296,3 +297,96 @@ TEST(task, ListBaseIter100k)
 {
   task_listbase_test("ListBase parallel iteration - Threaded - 100000 items", 100000, true);
 }
+
+/* *** Task pool throughput with tiny tasks. *** */
+
+#define NUM_TINY_TASKS 1000000
+#define NUM_TINY_TASKS_RUN_AVERAGED 10
+
+static void task_pool_tiny_func(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+  uint32_t *count = (uint32_t *)BLI_task_pool_userdata(pool);
+  atomic_add_and_fetch_uint32(count, POINTER_AS_UINT(taskdata));
+}
+
+/* Push the tasks from the worker threads, by splitting the range of tasks in halves. */
+static void task_pool_tiny_spawn_func(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+  uint num = POINTER_AS_UINT(taskdata);
+  while (num > 1) {
+    const uint half = num / 2;
+    BLI_task_pool_push_from_thread(pool,
+                                   task_pool_tiny_spawn_func,
+                                   POINTER_FROM_UINT(half),
+                                   false,
+                                   TASK_PRIORITY_HIGH,
+                                   threadid);
+    num -= half;
+  }
+  task_pool_tiny_func(pool, POINTER_FROM_UINT(1), threadid);
+}
+
+static void task_pool_tiny_test_do(const char *id, const bool spawn_from_tasks)
+{
+  printf("\n========== STARTING %s ==========\n", id);
+
+  BLI_threadapi_init();
+
+  const int max_threads = BLI_system_thread_count();
+  for (int num_threads = 1;; num_threads = min_ii(num_threads * 2, max_threads)) {
+    TaskScheduler *scheduler = BLI_task_scheduler_create(num_threads);
+
+    double averaged_timing = 0.0;
+    for (int i = 0; i < NUM_TINY_TASKS_RUN_AVERAGED; i++) {
+      uint32_t count = 0;
+      TaskPool *pool = BLI_task_pool_create(scheduler, &count);
+
+      const double init_time = PIL_check_seconds_timer();
+      if (spawn_from_tasks) {
+        BLI_task_pool_push(pool,
+                           task_pool_tiny_spawn_func,
+                           POINTER_FROM_UINT(NUM_TINY_TASKS),
+                           false,
+                           TASK_PRIORITY_HIGH);
+      }
+      else {
+        for (int j = 0; j < NUM_TINY_TASKS; j++) {
+          BLI_task_pool_push(
+              pool, task_pool_tiny_func, POINTER_FROM_UINT(1), false, TASK_PRIORITY_HIGH);
+        }
+      }
+      BLI_task_pool_work_and_wait(pool);
+      averaged_timing += PIL_check_seconds_timer() - init_time;
+
+      BLI_task_pool_free(pool);
+      EXPECT_EQ(count, NUM_TINY_TASKS);
+    }
+    averaged_timing /= NUM_TINY_TASKS_RUN_AVERAGED;
+
+    printf("\t%d threads: done in %fs on average over %d runs, %.2f M tasks/s\n",
+           num_threads,
+           averaged_timing,
+           NUM_TINY_TASKS_RUN_AVERAGED,
+           NUM_TINY_TASKS / averaged_timing * 1e-6);
+
+    BLI_task_scheduler_free(scheduler);
+
+    if (num_threads == max_threads) {
+      break;
+    }
+  }
+
+  BLI_threadapi_exit();
+
+  printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(task, PoolTinyTasks1000k)
+{
+  task_pool_tiny_test_do("Task pool throughput - 1000K tiny tasks pushed from main thread", false);
+}
+
+TEST(task, PoolTinyTasksSpawn1000k)
+{
+  task_pool_tiny_test_do("Task pool throughput - 1000K tiny tasks pushed from tasks", true);
+}
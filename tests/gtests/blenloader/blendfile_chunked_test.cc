@@ -0,0 +1,235 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "blendfile_loading_base_test.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "BKE_appdir.h"
+#include "BKE_customdata.h"
+#include "BKE_global.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+
+#include "BLO_blend_defs.h"
+#include "BLO_readfile.h"
+#include "BLO_writefile.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+}
+
+/* Enough vertices for several frames of #BLEND_CHUNK_FRAME_SIZE. */
+#define MESH_VERTS_NUM 200000
+
+class BlendfileChunkedTest : public BlendfileLoadingBaseTest {
+ protected:
+  virtual void SetUp()
+  {
+    BlendfileLoadingBaseTest::SetUp();
+    BKE_tempdir_init(NULL);
+  }
+
+  std::string temp_filepath(const char *filename)
+  {
+    char filepath[FILE_MAX];
+    BLI_join_dirfile(filepath, sizeof(filepath), BKE_tempdir_session(), filename);
+    return filepath;
+  }
+
+  /* Add a mesh with MESH_VERTS_NUM vertices to the loaded file. */
+  void mesh_add()
+  {
+    Mesh *mesh = BKE_mesh_add(bfile->main, "ChunkedMesh");
+    mesh->totvert = MESH_VERTS_NUM;
+    CustomData_add_layer(&mesh->vdata, CD_MVERT, CD_CALLOC, NULL, mesh->totvert);
+    BKE_mesh_update_customdata_pointers(mesh, false);
+    for (int i = 0; i < mesh->totvert; i++) {
+      mesh->mvert[i].co[0] = (float)i;
+      mesh->mvert[i].co[1] = (float)(i % 1000);
+      mesh->mvert[i].co[2] = (float)(i / 1000);
+    }
+  }
+
+  /* Check the mesh of mesh_add() in the loaded file. */
+  void mesh_check()
+  {
+    const Mesh *mesh = (const Mesh *)BLI_findstring(
+        &bfile->main->meshes, "MEChunkedMesh", offsetof(ID, name));
+    ASSERT_NE(mesh, nullptr);
+    ASSERT_EQ(mesh->totvert, MESH_VERTS_NUM);
+    ASSERT_NE(mesh->mvert, nullptr);
+    for (int i = 0; i < mesh->totvert; i++) {
+      EXPECT_EQ(mesh->mvert[i].co[0], (float)i);
+      EXPECT_EQ(mesh->mvert[i].co[1], (float)(i % 1000));
+      EXPECT_EQ(mesh->mvert[i].co[2], (float)(i / 1000));
+    }
+  }
+
+  bool blendfile_load_abs(const std::string &filepath)
+  {
+    bfile = BLO_read_from_file(filepath.c_str(), BLO_READ_SKIP_NONE, NULL /* reports */);
+    return bfile != nullptr;
+  }
+
+  /* Save the loaded file with the chunked compression, with the mesh of mesh_add(). */
+  bool chunked_save(const std::string &filepath)
+  {
+    if (!blendfile_load("modifier_stack/array_test.blend")) {
+      return false;
+    }
+    mesh_add();
+    const bool ok = BLO_write_file(
+        bfile->main, filepath.c_str(), G_FILE_COMPRESS_CHUNKED, NULL, NULL);
+    blendfile_free();
+    EXPECT_TRUE(ok);
+    return ok;
+  }
+
+  static std::vector<char> file_read(const std::string &filepath)
+  {
+    std::vector<char> data;
+    FILE *file = fopen(filepath.c_str(), "rb");
+    if (file) {
+      char buffer[4096];
+      size_t len;
+      while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + len);
+      }
+      fclose(file);
+    }
+    return data;
+  }
+
+  static void file_write(const std::string &filepath, const std::vector<char> &data)
+  {
+    FILE *file = fopen(filepath.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(fwrite(data.data(), 1, data.size(), file), data.size());
+    fclose(file);
+  }
+
+  static void put_uint32(char *dst, uint32_t value)
+  {
+    for (int i = 0; i < 4; i++) {
+      dst[i] = (char)((value >> (i * 8)) & 0xff);
+    }
+  }
+
+  static uint64_t get_uint64(const char *src)
+  {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+      value |= (uint64_t)(unsigned char)src[i] << (i * 8);
+    }
+    return value;
+  }
+
+  /* The corrupted file must be refused without crashing. */
+  void expect_load_fails(const std::vector<char> &data, const char *filename)
+  {
+    const std::string filepath = temp_filepath(filename);
+    file_write(filepath, data);
+    EXPECT_FALSE(blendfile_load_abs(filepath)) << filename;
+    blendfile_free();
+  }
+};
+
+TEST_F(BlendfileChunkedTest, SaveLoad)
+{
+  const std::string filepath = temp_filepath("chunked.blend");
+  if (!chunked_save(filepath)) {
+    return;
+  }
+
+  const std::vector<char> data = file_read(filepath);
+  ASSERT_GT(data.size(), (size_t)(BLEND_CHUNK_MAGIC_LEN + BLEND_CHUNK_TRAILER_SIZE));
+  EXPECT_EQ(memcmp(data.data(), BLEND_CHUNK_MAGIC, BLEND_CHUNK_MAGIC_LEN), 0);
+  /* The mesh alone is larger than a frame. */
+  const uint64_t frames_num = get_uint64(&data[data.size() - BLEND_CHUNK_TRAILER_SIZE + 8]);
+  EXPECT_GT(frames_num, (uint64_t)1);
+
+  ASSERT_TRUE(blendfile_load_abs(filepath));
+  mesh_check();
+  depsgraph_create(DAG_EVAL_RENDER);
+  EXPECT_NE(nullptr, this->depsgraph);
+}
+
+TEST_F(BlendfileChunkedTest, LoadCorrupted)
+{
+  const std::string filepath = temp_filepath("chunked_corrupted.blend");
+  if (!chunked_save(filepath)) {
+    return;
+  }
+
+  const std::vector<char> data = file_read(filepath);
+  ASSERT_GT(data.size(), (size_t)(BLEND_CHUNK_MAGIC_LEN + BLEND_CHUNK_TRAILER_SIZE));
+  const size_t trailer = data.size() - BLEND_CHUNK_TRAILER_SIZE;
+  const uint64_t index_offset = get_uint64(&data[trailer]);
+  ASSERT_LT(index_offset, (uint64_t)trailer);
+
+  /* Truncated, without the trailer. */
+  {
+    std::vector<char> corrupted(data.begin(), data.end() - BLEND_CHUNK_TRAILER_SIZE / 2);
+    expect_load_fails(corrupted, "chunked_truncated.blend");
+  }
+  /* Truncated to the magic only. */
+  {
+    std::vector<char> corrupted(data.begin(), data.begin() + BLEND_CHUNK_MAGIC_LEN);
+    expect_load_fails(corrupted, "chunked_magic_only.blend");
+  }
+  /* Index offset past the index. */
+  {
+    std::vector<char> corrupted = data;
+    put_uint32(&corrupted[trailer], (uint32_t)trailer + 1);
+    expect_load_fails(corrupted, "chunked_index_offset.blend");
+  }
+  /* Frame count not matching the index size. */
+  {
+    std::vector<char> corrupted = data;
+    put_uint32(&corrupted[trailer + 8], 0xffffffff);
+    expect_load_fails(corrupted, "chunked_frames_num.blend");
+  }
+  /* Frame uncompressed size larger than a frame. */
+  {
+    std::vector<char> corrupted = data;
+    put_uint32(&corrupted[index_offset + 12], BLEND_CHUNK_FRAME_SIZE + 1);
+    expect_load_fails(corrupted, "chunked_frame_size.blend");
+  }
+  /* Frame compressed size past the index. */
+  {
+    std::vector<char> corrupted = data;
+    put_uint32(&corrupted[index_offset + 8], 0x7fffffff);
+    expect_load_fails(corrupted, "chunked_frame_compressed_size.blend");
+  }
+  /* Compressed data of the first frame overwritten. */
+  {
+    std::vector<char> corrupted = data;
+    const uint64_t frame_offset = get_uint64(&corrupted[index_offset]);
+    for (size_t i = 0; i < 64 && frame_offset + i < index_offset; i++) {
+      corrupted[frame_offset + i] = (char)0xa5;
+    }
+    expect_load_fails(corrupted, "chunked_frame_data.blend");
+  }
+}
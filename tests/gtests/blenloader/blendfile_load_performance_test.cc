@@ -0,0 +1,62 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "blendfile_loading_base_test.h"
+
+#include "BLO_readfile.h"
+
+#include "PIL_time.h"
+
+DEFINE_string(load_benchmark_file,
+              "modifier_stack/array_test.blend",
+              "Blend file of the test assets directory loaded by the loading benchmark, "
+              "preferably a large one.");
+
+#define NUM_RUN_AVERAGED 5
+
+class BlendfileLoadPerformanceTest : public BlendfileLoadingBaseTest {
+};
+
+TEST_F(BlendfileLoadPerformanceTest, LoadPhases)
+{
+  BlendFileReadTimings timings = {0};
+  double total = 0.0;
+
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = PIL_check_seconds_timer();
+    if (!blendfile_load(FLAGS_load_benchmark_file.c_str())) {
+      return;
+    }
+    total += PIL_check_seconds_timer() - init_time;
+
+    timings.read += bfile->timings.read;
+    timings.reconstruct += bfile->timings.reconstruct;
+    timings.link += bfile->timings.link;
+    timings.versioning += bfile->timings.versioning;
+    blendfile_free();
+  }
+
+  printf("\t%s: loaded in %fs on average over %d runs\n",
+         FLAGS_load_benchmark_file.c_str(),
+         total / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+  printf("\t\tread: %fs, reconstruct: %fs, link: %fs, versioning: %fs\n",
+         timings.read / NUM_RUN_AVERAGED,
+         timings.reconstruct / NUM_RUN_AVERAGED,
+         timings.link / NUM_RUN_AVERAGED,
+         timings.versioning / NUM_RUN_AVERAGED);
+
+  EXPECT_LE(timings.read + timings.reconstruct + timings.link + timings.versioning, total);
+}
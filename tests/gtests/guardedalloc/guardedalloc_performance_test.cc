@@ -0,0 +1,166 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#define NUM_RUN_AVERAGED 10
+#define NUM_BLOCKS 100000
+#define NUM_THREADS 8
+
+namespace {
+
+double SecondsTimer()
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+size_t BlockSize(size_t index)
+{
+  /* Small sizes typical of list items, values and container nodes. */
+  return 8 + (index * 13) % 120;
+}
+
+/* Allocate many small blocks and free them in interleaved order, as a frame does. */
+void AllocFreeBlocks(int seed)
+{
+  std::vector<void *> blocks(NUM_BLOCKS);
+  for (int pass = 0; pass < 4; pass++) {
+    for (size_t i = 0; i < NUM_BLOCKS; i++) {
+      blocks[i] = MEM_mallocN(BlockSize(i + (size_t)seed), __func__);
+    }
+    for (size_t i = 0; i < NUM_BLOCKS; i += 2) {
+      MEM_freeN(blocks[i]);
+    }
+    for (size_t i = 1; i < NUM_BLOCKS; i += 2) {
+      MEM_freeN(blocks[i]);
+    }
+  }
+}
+
+/* Allocate and immediately free, the best case of a cache. */
+void AllocFreeChurn(int seed)
+{
+  for (size_t i = 0; i < NUM_BLOCKS * 4; i++) {
+    void *ptr = MEM_mallocN(BlockSize(i + (size_t)seed), __func__);
+    MEM_freeN(ptr);
+  }
+}
+
+void AllocFreeThreads(void (*func)(int), int num_threads)
+{
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back(func, i);
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+}
+
+/* Blocks allocated by one thread and freed by another, as with task results. */
+void AllocFreeCrossThreads(int num_threads)
+{
+  std::vector<std::vector<void *>> blocks(num_threads);
+  for (int pass = 0; pass < 4; pass++) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+      threads.emplace_back([&blocks, i, num_threads]() {
+        std::vector<void *> &to_free = blocks[(i + 1) % num_threads];
+        for (void *ptr : to_free) {
+          MEM_freeN(ptr);
+        }
+        to_free.clear();
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    threads.clear();
+    for (int i = 0; i < num_threads; i++) {
+      threads.emplace_back([&blocks, i]() {
+        for (size_t j = 0; j < NUM_BLOCKS; j++) {
+          blocks[i].push_back(MEM_mallocN(BlockSize(j + (size_t)i), __func__));
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+  }
+
+  for (std::vector<void *> &thread_blocks : blocks) {
+    for (void *ptr : thread_blocks) {
+      MEM_freeN(ptr);
+    }
+  }
+}
+
+void alloc_performance_test_do(const char *id)
+{
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = SecondsTimer();
+    AllocFreeBlocks(i);
+    averaged_timing += SecondsTimer() - init_time;
+  }
+  printf("\t%s: single thread done in %fs on average over %d runs\n",
+         id,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = SecondsTimer();
+    AllocFreeThreads(AllocFreeBlocks, NUM_THREADS);
+    averaged_timing += SecondsTimer() - init_time;
+  }
+  printf("\t%s: %d threads done in %fs on average over %d runs\n",
+         id,
+         NUM_THREADS,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = SecondsTimer();
+    AllocFreeThreads(AllocFreeChurn, NUM_THREADS);
+    averaged_timing += SecondsTimer() - init_time;
+  }
+  printf("\t%s: %d threads churn done in %fs on average over %d runs\n",
+         id,
+         NUM_THREADS,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+
+  averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = SecondsTimer();
+    AllocFreeCrossThreads(NUM_THREADS);
+    averaged_timing += SecondsTimer() - init_time;
+  }
+  printf("\t%s: %d threads cross-thread free done in %fs on average over %d runs\n",
+         id,
+         NUM_THREADS,
+         averaged_timing / NUM_RUN_AVERAGED,
+         NUM_RUN_AVERAGED);
+}
+
+}  // namespace
+
+/* The lock-free test has to run first, there is no way back from the thread cache allocator. */
+TEST(guardedalloc, LockfreePerformance)
+{
+  alloc_performance_test_do("Lock-free allocator");
+}
+
+TEST(guardedalloc, ThreadcachePerformance)
+{
+  MEM_use_threadcache_allocator();
+  alloc_performance_test_do("Thread cache allocator");
+}
@@ -0,0 +1,201 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "MEM_guardedalloc.h"
+
+#define NUM_THREADS 8
+#define NUM_BLOCKS 10000
+
+namespace {
+
+size_t BlockSize(size_t index)
+{
+  /* Mostly small sizes with a few blocks above the size classes. */
+  return (index % 97 == 0) ? 4096 + index : 1 + (index * 37) % 700;
+}
+
+void AllocFreeThread(std::vector<void *> *to_free, std::vector<void *> *allocated, int seed)
+{
+  for (void *ptr : *to_free) {
+    MEM_freeN(ptr);
+  }
+  to_free->clear();
+
+  for (size_t i = 0; i < NUM_BLOCKS; i++) {
+    const size_t len = BlockSize(i + (size_t)seed);
+    char *ptr = (char *)MEM_mallocN(len, __func__);
+    memset(ptr, seed, len);
+    allocated->push_back(ptr);
+    if (i % 3 == 0) {
+      MEM_freeN(allocated->back());
+      allocated->pop_back();
+    }
+  }
+}
+
+}  // namespace
+
+TEST(guardedalloc, ThreadcacheLockfreeBlocks)
+{
+  /* Blocks allocated before the switch are freed by the lock-free allocator. */
+  void *small = MEM_mallocN(16, __func__);
+  void *big = MEM_mallocN(1 << 16, __func__);
+  const size_t mem_in_use = MEM_get_memory_in_use();
+
+  MEM_use_threadcache_allocator();
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+  EXPECT_EQ(MEM_allocN_len(small), (size_t)16);
+
+  MEM_freeN(small);
+  MEM_freeN(big);
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use - 16 - (size_t)(1 << 16));
+}
+
+TEST(guardedalloc, ThreadcacheAccounting)
+{
+  MEM_use_threadcache_allocator();
+
+  const size_t mem_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  std::vector<void *> blocks;
+  size_t total = 0;
+  for (size_t i = 0; i < NUM_BLOCKS; i++) {
+    const size_t len = BlockSize(i);
+    blocks.push_back(MEM_mallocN(len, __func__));
+    EXPECT_EQ(MEM_allocN_len(blocks.back()), (len + 3) & ~(size_t)3);
+    total += MEM_allocN_len(blocks.back());
+  }
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use + total);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use + NUM_BLOCKS);
+  EXPECT_GE(MEM_get_peak_memory(), mem_in_use + total);
+
+  for (void *ptr : blocks) {
+    MEM_freeN(ptr);
+  }
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST(guardedalloc, ThreadcacheRealloc)
+{
+  MEM_use_threadcache_allocator();
+
+  const size_t mem_in_use = MEM_get_memory_in_use();
+
+  char *ptr = (char *)MEM_callocN(10, __func__);
+  for (int i = 0; i < 10; i++) {
+    EXPECT_EQ(ptr[i], 0);
+    ptr[i] = (char)i;
+  }
+
+  /* Grow through the size classes up to a lock-free block and shrink back. */
+  for (size_t len = 20; len < 4000; len *= 2) {
+    ptr = (char *)MEM_recallocN(ptr, len);
+    EXPECT_EQ(MEM_allocN_len(ptr), len);
+    EXPECT_EQ(ptr[9], 9);
+    EXPECT_EQ(ptr[len - 1], 0);
+  }
+  ptr = (char *)MEM_reallocN(ptr, 12);
+  EXPECT_EQ(ptr[9], 9);
+
+  char *dup = (char *)MEM_dupallocN(ptr);
+  EXPECT_EQ(memcmp(ptr, dup, 12), 0);
+  MEM_freeN(dup);
+  MEM_freeN(ptr);
+
+  int *aligned = (int *)MEM_mallocN_aligned(sizeof(int) * 10, 64, __func__);
+  EXPECT_EQ((size_t)aligned % 64, 0);
+  aligned = (int *)MEM_reallocN(aligned, sizeof(int) * 5);
+  EXPECT_EQ((size_t)aligned % 64, 0);
+  MEM_freeN(aligned);
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+}
+
+TEST(guardedalloc, ThreadcacheThreads)
+{
+  MEM_use_threadcache_allocator();
+
+  const size_t mem_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  std::vector<void *> blocks[NUM_THREADS];
+  std::vector<void *> next_blocks[NUM_THREADS];
+
+  /* Every round frees the blocks allocated by another thread in the previous round. */
+  for (int round = 0; round < 4; round++) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < NUM_THREADS; i++) {
+      threads.emplace_back(
+          AllocFreeThread, &blocks[(i + 1) % NUM_THREADS], &next_blocks[i], round * 10 + i);
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    for (int i = 0; i < NUM_THREADS; i++) {
+      blocks[i].swap(next_blocks[i]);
+    }
+  }
+
+  for (int i = 0; i < NUM_THREADS; i++) {
+    for (void *ptr : blocks[i]) {
+      MEM_freeN(ptr);
+    }
+  }
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
+
+TEST(guardedalloc, ThreadcacheConcurrentMemoryInUse)
+{
+  MEM_use_threadcache_allocator();
+
+  const size_t mem_in_use = MEM_get_memory_in_use();
+  const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+
+  /* The threads only allocate, so the memory in use read while they run stays between the
+   * values before and after, the counters of a thread must not be counted twice. */
+  std::vector<void *> blocks[NUM_THREADS];
+  std::vector<std::thread> threads;
+  for (int i = 0; i < NUM_THREADS; i++) {
+    threads.emplace_back(
+        [](std::vector<void *> *allocated) {
+          for (size_t j = 0; j < NUM_BLOCKS; j++) {
+            allocated->push_back(MEM_mallocN(16, __func__));
+          }
+        },
+        &blocks[i]);
+  }
+
+  const size_t total = (size_t)NUM_THREADS * NUM_BLOCKS * 16;
+  for (int i = 0; i < 1000; i++) {
+    const size_t len = MEM_get_memory_in_use();
+    EXPECT_GE(len, mem_in_use);
+    EXPECT_LE(len, mem_in_use + total);
+    EXPECT_LE(MEM_get_memory_blocks_in_use(), blocks_in_use + NUM_THREADS * NUM_BLOCKS);
+  }
+
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use + total);
+
+  for (int i = 0; i < NUM_THREADS; i++) {
+    for (void *ptr : blocks[i]) {
+      MEM_freeN(ptr);
+    }
+  }
+
+  EXPECT_EQ(MEM_get_memory_in_use(), mem_in_use);
+  EXPECT_EQ(MEM_get_memory_blocks_in_use(), blocks_in_use);
+}
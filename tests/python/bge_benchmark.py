@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Game engine throughput benchmark.
+
+Generates the scenarios of bge_benchmark_scenarios.py, runs each one in the player
+for a fixed number of frames with "-g benchmark_frames" and gathers the profile
+statistics of all scenarios in a single JSON file.
+"""
+
+import argparse
+import json
+import os
+import pathlib
+import subprocess
+import sys
+
+
+def generate_scenarios(args, outdir):
+    script = pathlib.Path(__file__).parent / "bge_benchmark_scenarios.py"
+    command = [
+        args.blender, "--background", "-noaudio", "--factory-startup",
+        "--python", str(script), "--",
+        "--outdir", str(outdir),
+        "--count", str(args.count),
+    ]
+    for name in args.scenario or ():
+        command += ["--scenario", name]
+    subprocess.run(command, check=True)
+
+
+def run_scenario(args, blendfile):
+    output = blendfile.with_suffix(".json")
+    if output.exists():
+        output.unlink()
+
+    command = [
+        args.blenderplayer,
+        "-w", "320", "240",
+        "-g", "benchmark_frames", "=", str(args.frames),
+        "-g", "benchmark_output", "=", str(output),
+        str(blendfile),
+    ]
+    subprocess.run(command, check=True, timeout=args.timeout)
+
+    with open(output) as f:
+        return json.load(f)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--blender", required=True)
+    parser.add_argument("--blenderplayer", required=True)
+    parser.add_argument("--outdir", required=True)
+    parser.add_argument("--output", help="File receiving the JSON results, standard output if not set")
+    parser.add_argument("--frames", type=int, default=600)
+    parser.add_argument("--count", type=int, default=500)
+    parser.add_argument("--timeout", type=int, default=600)
+    parser.add_argument("--scenario", action="append")
+    args = parser.parse_args()
+
+    outdir = pathlib.Path(args.outdir)
+    outdir.mkdir(parents=True, exist_ok=True)
+
+    generate_scenarios(args, outdir)
+
+    results = {
+        "frames": args.frames,
+        "count": args.count,
+        "scenarios": {},
+    }
+    failed = False
+    for blendfile in sorted(outdir.glob("*.blend")):
+        name = blendfile.stem
+        if args.scenario and name not in args.scenario:
+            continue
+        try:
+            results["scenarios"][name] = run_scenario(args, blendfile)
+        except (subprocess.SubprocessError, OSError, ValueError) as ex:
+            print("Scenario %r failed: %s" % (name, ex), file=sys.stderr)
+            failed = True
+
+    text = json.dumps(results, indent=2, sort_keys=True)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        print(text)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,351 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Generate the game engine benchmark scenarios, each one in its own .blend file.
+
+  blender --background --factory-startup --python bge_benchmark_scenarios.py -- \
+    --outdir <dir> [--count <objects>] [--scenario <name>]
+
+The files are then run by bge_benchmark.py with the player.
+"""
+
+import argparse
+import math
+import os
+import sys
+
+import bpy
+
+
+COMPONENT_MODULE = "bench_component.py"
+COMPONENT_CODE = '''\
+import bge
+from collections import OrderedDict
+
+
+class Component(bge.types.KX_PythonComponent):
+    args = OrderedDict()
+
+    def start(self, args):
+        self.angle = 0.0
+
+    def update(self):
+        self.angle += 0.01
+        self.object.applyRotation((0.0, 0.0, 0.01), True)
+'''
+
+SPAWNER_MODULE = "bench_spawner.py"
+SPAWNER_CODE = '''\
+import bge
+
+
+def spawn(cont):
+    owner = cont.owner
+    scene = owner.scene
+    for i in range(owner["count"]):
+        # Objects live one frame, they are freed by the engine at the next frame.
+        scene.addObject("Spawned", owner, 1)
+'''
+
+SNAPSHOT_MODULE = "bench_snapshot.py"
+SNAPSHOT_CODE = '''\
+import bge
+
+
+def rollback(cont):
+    # Save a snapshot every frame and roll back to the one saved 8 frames ago.
+    owner = cont.owner
+    scene = owner.scene
+    snapshots = owner.get("snapshots")
+    if snapshots is None:
+        snapshots = owner["snapshots"] = []
+    snapshots.append(scene.saveSnapshot())
+    if len(snapshots) > 8:
+        scene.restoreSnapshot(snapshots.pop(0))
+'''
+
+
+def new_scene():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.render.engine = 'BLENDER_EEVEE'
+    return scene
+
+
+def link_object(name, data=None):
+    ob = bpy.data.objects.new(name, data)
+    bpy.context.scene.collection.objects.link(ob)
+    return ob
+
+
+def set_active(ob):
+    bpy.context.view_layer.objects.active = ob
+
+
+def add_camera():
+    cam = link_object("Camera", bpy.data.cameras.new("Camera"))
+    cam.location = (0.0, -60.0, 40.0)
+    cam.rotation_euler = (math.radians(55.0), 0.0, 0.0)
+    bpy.context.scene.camera = cam
+
+
+def add_ground(size=200.0):
+    mesh = bpy.data.meshes.new("Ground")
+    half = size / 2.0
+    mesh.from_pydata([(-half, -half, 0.0), (half, -half, 0.0), (half, half, 0.0), (-half, half, 0.0)],
+                     [], [(0, 1, 2, 3)])
+    return link_object("Ground", mesh)
+
+
+def cube_mesh():
+    mesh = bpy.data.meshes.get("Cube")
+    if mesh is None:
+        mesh = bpy.data.meshes.new("Cube")
+        verts = [(x, y, z) for x in (-0.5, 0.5) for y in (-0.5, 0.5) for z in (-0.5, 0.5)]
+        faces = [(0, 1, 3, 2), (4, 6, 7, 5), (0, 4, 5, 1), (2, 3, 7, 6), (0, 2, 6, 4), (1, 5, 7, 3)]
+        mesh.from_pydata(verts, [], faces)
+    return mesh
+
+
+def grid_positions(count, spacing, height=1.0):
+    side = max(1, int(math.ceil(math.sqrt(count))))
+    offset = (side - 1) * spacing / 2.0
+    for i in range(count):
+        yield ((i % side) * spacing - offset, (i // side) * spacing - offset, height)
+
+
+def add_text(name, code):
+    text = bpy.data.texts.new(name)
+    text.write(code)
+    return text
+
+
+def scenario_rigid_bodies(count):
+    add_ground()
+    mesh = cube_mesh()
+    for i, pos in enumerate(grid_positions(count, 1.5, 5.0)):
+        ob = link_object("Body.%d" % i, mesh)
+        ob.location = pos
+        ob.game.physics_type = 'RIGID_BODY'
+
+
+def scenario_add_objects(count):
+    add_ground()
+    # Objects added at runtime must come from an excluded collection.
+    spawned = bpy.data.collections.new("Spawned")
+    bpy.context.scene.collection.children.link(spawned)
+    ob = bpy.data.objects.new("Spawned", cube_mesh())
+    spawned.objects.link(ob)
+    bpy.context.view_layer.layer_collection.children["Spawned"].exclude = True
+
+    add_text(SPAWNER_MODULE, SPAWNER_CODE)
+    spawner = link_object("Spawner")
+    set_active(spawner)
+    spawner.game.properties.new(name="count", type='INT')
+    spawner.game.properties["count"].value = count
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=spawner.name)
+    bpy.ops.logic.controller_add(type='PYTHON', object=spawner.name)
+    sensor = spawner.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = spawner.game.controllers[-1]
+    controller.mode = 'MODULE'
+    controller.module = "bench_spawner.spawn"
+    sensor.link(controller)
+
+
+def scenario_python_components(count):
+    add_text(COMPONENT_MODULE, COMPONENT_CODE)
+    mesh = cube_mesh()
+    for i, pos in enumerate(grid_positions(count, 1.5)):
+        ob = link_object("Component.%d" % i, mesh)
+        ob.location = pos
+        set_active(ob)
+        bpy.ops.logic.add_python_component(component_name="bench_component.Component")
+
+
+def scenario_steering_agents(count):
+    navmesh = add_ground(100.0)
+    navmesh.name = "Navmesh"
+    navmesh.game.physics_type = 'NAVMESH'
+
+    target = link_object("Target")
+    target.location = (40.0, 40.0, 0.0)
+
+    mesh = cube_mesh()
+    for i, pos in enumerate(grid_positions(count, 1.5, 0.5)):
+        ob = link_object("Agent.%d" % i, mesh)
+        ob.location = pos
+        set_active(ob)
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+        bpy.ops.logic.controller_add(type='LOGIC_AND', object=ob.name)
+        bpy.ops.logic.actuator_add(type='STEERING', object=ob.name)
+        actuator = ob.game.actuators[-1]
+        actuator.mode = 'PATHFOLLOWING'
+        actuator.navmesh = navmesh
+        actuator.target = target
+        controller = ob.game.controllers[-1]
+        ob.game.sensors[-1].link(controller)
+        actuator.link(controller)
+
+
+def scenario_armatures(count, bones=8):
+    action = bpy.data.actions.new("Wave")
+    armature = bpy.data.armatures.new("Armature")
+
+    # Build the bones in edit mode with a template object.
+    template = link_object("Template", armature)
+    set_active(template)
+    bpy.ops.object.mode_set(mode='EDIT')
+    parent = None
+    for b in range(bones):
+        bone = armature.edit_bones.new("Bone.%d" % b)
+        bone.head = (0.0, 0.0, b)
+        bone.tail = (0.0, 0.0, b + 1.0)
+        bone.parent = parent
+        bone.use_connect = parent is not None
+        parent = bone
+    bpy.ops.object.mode_set(mode='OBJECT')
+
+    # Key a wave on all bones.
+    template.animation_data_create()
+    template.animation_data.action = action
+    for b in range(bones):
+        pbone = template.pose.bones["Bone.%d" % b]
+        pbone.rotation_mode = 'XYZ'
+        for frame, angle in ((1, -0.3), (25, 0.3), (49, -0.3)):
+            pbone.rotation_euler = (angle, 0.0, 0.0)
+            pbone.keyframe_insert("rotation_euler", frame=frame)
+    bpy.data.objects.remove(template)
+
+    for i, pos in enumerate(grid_positions(count, 3.0, 0.0)):
+        ob = link_object("Armature.%d" % i, armature)
+        ob.location = pos
+        set_active(ob)
+        bpy.ops.logic.sensor_add(type='ALWAYS', object=ob.name)
+        bpy.ops.logic.controller_add(type='LOGIC_AND', object=ob.name)
+        bpy.ops.logic.actuator_add(type='ACTION', object=ob.name)
+        actuator = ob.game.actuators[-1]
+        actuator.play_mode = 'LOOPEND'
+        actuator.action = action
+        actuator.frame_start = 1.0
+        actuator.frame_end = 49.0
+        controller = ob.game.controllers[-1]
+        ob.game.sensors[-1].link(controller)
+        actuator.link(controller)
+
+
+def scenario_collision_sensors(count):
+    add_ground()
+    mesh = cube_mesh()
+    for i, pos in enumerate(grid_positions(count, 1.2, 3.0)):
+        ob = link_object("Collider.%d" % i, mesh)
+        ob.location = pos
+        ob.game.physics_type = 'DYNAMIC'
+        set_active(ob)
+        bpy.ops.logic.sensor_add(type='COLLISION', object=ob.name)
+        bpy.ops.logic.controller_add(type='LOGIC_AND', object=ob.name)
+        ob.game.sensors[-1].link(ob.game.controllers[-1])
+
+
+def scenario_contact_pairs(count):
+    # Cubes packed side by side on the ground, each one touches the ground and up to four
+    # neighbours, about 3 contact pairs per cube: the default count gives 10k pairs per tick.
+    add_ground()
+    mesh = cube_mesh()
+    for i, pos in enumerate(grid_positions(count * 20 // 3, 1.0, 0.5)):
+        ob = link_object("Contact.%d" % i, mesh)
+        ob.location = pos
+        ob.game.physics_type = 'DYNAMIC'
+        set_active(ob)
+        bpy.ops.logic.sensor_add(type='COLLISION', object=ob.name)
+        bpy.ops.logic.controller_add(type='LOGIC_AND', object=ob.name)
+        ob.game.sensors[-1].link(ob.game.controllers[-1])
+
+
+def scenario_snapshots(count):
+    scenario_rigid_bodies(count)
+    for ob in bpy.data.objects:
+        if ob.name.startswith("Body."):
+            ob.game.properties.new(name="health", type='INT')
+            ob.game.properties.new(name="speed", type='FLOAT')
+
+    add_text(SNAPSHOT_MODULE, SNAPSHOT_CODE)
+    manager = link_object("Snapshots")
+    set_active(manager)
+    bpy.ops.logic.sensor_add(type='ALWAYS', object=manager.name)
+    bpy.ops.logic.controller_add(type='PYTHON', object=manager.name)
+    sensor = manager.game.sensors[-1]
+    sensor.use_pulse_true_level = True
+    controller = manager.game.controllers[-1]
+    controller.mode = 'MODULE'
+    controller.module = "bench_snapshot.rollback"
+    sensor.link(controller)
+
+
+def scenario_sleeping_props(count):
+    # Props resting on the ground fall asleep after the deactivation time, a few of them hover
+    # on the ground force field: the physics cost should follow the awake bodies only.
+    ground = add_ground()
+    ground.game.fh_distance = 1.0
+    ground.game.fh_force = 0.5
+    mesh = cube_mesh()
+    for i, pos in enumerate(grid_positions(count * 40, 1.5, 0.5)):
+        ob = link_object("Prop.%d" % i, mesh)
+        ob.location = pos
+        ob.game.physics_type = 'RIGID_BODY'
+        ob.game.use_material_physics_fh = (i % 100 == 0)
+
+
+SCENARIOS = {
+    "rigid_bodies": scenario_rigid_bodies,
+    "add_objects": scenario_add_objects,
+    "python_components": scenario_python_components,
+    "steering_agents": scenario_steering_agents,
+    "armatures": scenario_armatures,
+    "collision_sensors": scenario_collision_sensors,
+    "contact_pairs": scenario_contact_pairs,
+    "snapshots": scenario_snapshots,
+    "sleeping_props": scenario_sleeping_props,
+}
+
+
+def main():
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--outdir", required=True)
+    parser.add_argument("--count", type=int, default=500)
+    parser.add_argument("--scenario", action="append", choices=sorted(SCENARIOS.keys()))
+    args = parser.parse_args(argv)
+
+    os.makedirs(args.outdir, exist_ok=True)
+
+    for name in (args.scenario or sorted(SCENARIOS.keys())):
+        new_scene()
+        add_camera()
+        SCENARIOS[name](args.count)
+        filepath = os.path.join(args.outdir, name + ".blend")
+        bpy.ops.wm.save_as_mainfile(filepath=filepath)
+        print("Generated scenario %r with %d objects: %s" % (name, args.count, filepath))
+
+
+if __name__ == "__main__":
+    main()
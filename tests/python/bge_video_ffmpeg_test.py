@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Decoding of a movie clip by bge.texture.VideoFFmpeg in the player.
+
+A lossless clip, red on the top half and blue on the bottom half, is rendered by the sequencer.
+The player decodes its first frame with and without the vertical flip, the flipped image
+(texture orientation) starts with the bottom rows of the clip.
+"""
+
+import argparse
+import json
+import pathlib
+import subprocess
+import sys
+import unittest
+
+from modules.test_utils import AbstractBlenderRunnerTest
+
+
+WIDTH = 64
+HEIGHT = 32
+FRAMES = 8
+TOP_COLOR = (255, 0, 0)
+BOTTOM_COLOR = (0, 0, 255)
+
+GENERATE_SCRIPT = '''\
+import bpy
+
+bpy.ops.wm.read_factory_settings(use_empty=True)
+scene = bpy.context.scene
+scene.render.engine = 'BLENDER_EEVEE'
+scene.view_settings.view_transform = 'Standard'
+scene.render.resolution_x = {width}
+scene.render.resolution_y = {height}
+scene.render.resolution_percentage = 100
+scene.frame_start = 1
+scene.frame_end = {frames}
+
+# Lossless clip so the decoded colors are exact.
+scene.render.image_settings.file_format = 'FFMPEG'
+scene.render.image_settings.color_mode = 'RGB'
+scene.render.ffmpeg.format = 'QUICKTIME'
+scene.render.ffmpeg.codec = 'QTRLE'
+scene.render.use_file_extension = False
+scene.render.filepath = {clip!r}
+
+sequences = scene.sequence_editor_create().sequences
+bottom = sequences.new_effect("Bottom", 'COLOR', 1, frame_start=1, frame_end={frames} + 1)
+bottom.color = {bottom_color!r}
+top = sequences.new_effect("Top", 'COLOR', 2, frame_start=1, frame_end={frames} + 1)
+top.color = {top_color!r}
+top.blend_type = 'ALPHA_OVER'
+top.use_translation = True
+top.transform.offset_y = {height} // 2
+
+bpy.ops.render.render(animation=True)
+sequences.remove(top)
+sequences.remove(bottom)
+
+# Game decoding the clip, the results are written by the module below.
+text = bpy.data.texts.new("video_decode.py")
+text.write({module!r})
+camera = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+scene.collection.objects.link(camera)
+scene.camera = camera
+decoder = bpy.data.objects.new("Decoder", None)
+scene.collection.objects.link(decoder)
+bpy.context.view_layer.objects.active = decoder
+for name, value in (("clip", {clip!r}), ("output", {output!r})):
+    prop = decoder.game.properties.new(name=name, type='STRING')
+    prop.value = value
+bpy.ops.logic.sensor_add(type='ALWAYS', object=decoder.name)
+bpy.ops.logic.controller_add(type='PYTHON', object=decoder.name)
+sensor = decoder.game.sensors[-1]
+sensor.use_pulse_true_level = True
+controller = decoder.game.controllers[-1]
+controller.mode = 'MODULE'
+controller.module = "video_decode.decode"
+sensor.link(controller)
+
+bpy.ops.wm.save_as_mainfile(filepath={blendfile!r})
+'''
+
+DECODE_MODULE = '''\
+import json
+import bge
+
+# Maximum number of logic frames waiting for the decoded frames.
+MAX_TICKS = 300
+
+
+def row_color(image, size, row):
+    offset = (row * size[0] + size[0] // 2) * 4
+    return [image[offset + i] & 0xff for i in range(3)]
+
+
+def decode(cont):
+    owner = cont.owner
+    videos = owner.get("videos")
+    if videos is None:
+        videos = owner["videos"] = {}
+        for flip in (True, False):
+            video = bge.texture.VideoFFmpeg(owner["clip"])
+            video.flip = flip
+            video.play()
+            videos["flip" if flip else "noflip"] = video
+        owner["results"] = {}
+        owner["ticks"] = 0
+
+    results = owner["results"]
+    for name, video in videos.items():
+        if name in results:
+            continue
+        video.refresh()
+        image = bge.texture.imageToArray(video, 'RGBA')
+        if image:
+            size = video.size
+            results[name] = {
+                "size": list(size),
+                "first_row": row_color(image, size, 0),
+                "last_row": row_color(image, size, size[1] - 1),
+            }
+
+    owner["ticks"] += 1
+    if len(results) == len(videos) or owner["ticks"] > MAX_TICKS:
+        with open(owner["output"], "w") as f:
+            json.dump(results, f)
+        bge.logic.endGame()
+'''
+
+
+class VideoFFmpegDecodeTest(AbstractBlenderRunnerTest):
+    @classmethod
+    def setUpClass(cls):
+        cls.blender = args.blender
+        cls.blenderplayer = args.blenderplayer
+        cls.testdir = pathlib.Path(args.outdir)
+        cls.testdir.mkdir(parents=True, exist_ok=True)
+
+    def decode(self):
+        clip = self.testdir / "clip.mov"
+        blendfile = self.testdir / "video_decode.blend"
+        output = self.testdir / "results.json"
+        for path in (clip, blendfile, output):
+            if path.exists():
+                path.unlink()
+
+        script = GENERATE_SCRIPT.format(
+            width=WIDTH, height=HEIGHT, frames=FRAMES,
+            top_color=tuple(c / 255.0 for c in TOP_COLOR),
+            bottom_color=tuple(c / 255.0 for c in BOTTOM_COLOR),
+            clip=clip.as_posix(), output=output.as_posix(), blendfile=blendfile.as_posix(),
+            module=DECODE_MODULE)
+        self.run_blender('', script)
+        self.assertTrue(clip.exists(), "Clip not rendered")
+
+        command = [self.blenderplayer, "-w", "320", "240", str(blendfile)]
+        subprocess.run(command, check=True, timeout=300)
+
+        with open(output) as f:
+            return json.load(f)
+
+    def assertColor(self, color, expected):
+        for value, expected_value in zip(color, expected):
+            self.assertAlmostEqual(value, expected_value, delta=2)
+
+    def test_first_frame(self):
+        results = self.decode()
+
+        for name in ("flip", "noflip"):
+            self.assertIn(name, results, "No frame decoded")
+            self.assertEqual(results[name]["size"], [WIDTH, HEIGHT])
+
+        # The flipped image starts with the bottom rows of the clip.
+        self.assertColor(results["flip"]["first_row"], BOTTOM_COLOR)
+        self.assertColor(results["flip"]["last_row"], TOP_COLOR)
+        self.assertColor(results["noflip"]["first_row"], TOP_COLOR)
+        self.assertColor(results["noflip"]["last_row"], BOTTOM_COLOR)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--blender', required=True)
+    parser.add_argument('--blenderplayer', required=True)
+    parser.add_argument('--outdir', required=True)
+    args, remaining = parser.parse_known_args()
+
+    unittest.main(argv=sys.argv[0:1] + remaining)